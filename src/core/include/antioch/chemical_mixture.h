@@ -43,6 +43,7 @@
 #include <vector>
 #include <map>
 #include <string>
+#include <unordered_map>
 
 namespace Antioch
 {
@@ -144,6 +145,11 @@ namespace Antioch
 
     const std::map<std::string,Species>& species_name_map() const;
 
+    //! Hashed lookup of the index of species name
+    /*! Returns false, leaving s untouched, if name is not in the mixture.
+        Meant for per-entry lookups while parsing mechanisms. */
+    bool species_index( const std::string & name, Species & s ) const;
+
     const std::map<Species,std::string>& species_inverse_name_map() const;
 
     const std::map<std::string,Species>& active_species_name_map() const;
@@ -229,6 +235,9 @@ namespace Antioch
     std::map<std::string,Species> _species_name_map;
     std::map<Species,std::string> _species_inv_name_map;
 
+    //! Same content as _species_name_map, for constant time lookups
+    std::unordered_map<std::string,Species> _species_index;
+
   };
 
 
@@ -261,6 +270,18 @@ namespace Antioch
     return _species_name_map;
   }
 
+  template<typename CoeffType>
+  inline
+  bool ChemicalMixture<CoeffType>::species_index( const std::string & name, Species & s ) const
+  {
+    typename std::unordered_map<std::string,Species>::const_iterator it = _species_index.find(name);
+    if( it == _species_index.end() )
+      return false;
+
+    s = it->second;
+    return true;
+  }
+
   template<typename CoeffType>
   inline
   const std::map<Species,std::string>& ChemicalMixture<CoeffType>::species_inverse_name_map() const
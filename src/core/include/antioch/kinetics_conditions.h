@@ -29,6 +29,7 @@
 
 // Antioch
 #include "antioch/antioch_asserts.h"
+#include "antioch/cmath_shims.h"
 #include "antioch/particle_flux.h"
 #include "antioch/temp_cache.h"
 
@@ -47,12 +48,17 @@ namespace Antioch{
 
       Pressure is given by the molecular composition of the mixture,
       we are in a gaz phase, so the state equation will give pressure (typically
-      ideal gas).
+      ideal gas). The pressure-dependent reactions (PlogReaction,
+      ChebyshevReaction) take it from the ideal gas law, \f$P = [M] \mathrm{R} T\f$,
+      unless it is given here, in which case it is an independent
+      variable of the rate constants.
 
       The idea is to avoid any copy of anything as much as we can, 
       we store pointers but deal only with references. Nothing
       belongs to this object, if there is any cleaning to do,
       it must be done elsewhere.
+      The pressure is the exception: it is copied, together with
+      its logarithm, so that it may be given as a temporary.
 
       Might be interesting to see about the "double" case
       for temperature: faster to copy instead of copying
@@ -66,6 +72,12 @@ namespace Antioch{
         public:
 
           KineticsConditions(const StateType & temperature);
+
+          //! Conditions with an explicit pressure (Pa)
+          /*! The pressure is copied, temporaries are fine, and
+              its logarithm is computed once here. */
+          KineticsConditions(const StateType & temperature, const StateType & pressure);
+
           ~KineticsConditions();
 
           void add_particle_flux(const ParticleFlux<VectorStateType> & pf, unsigned int nr);
@@ -81,12 +93,29 @@ namespace Antioch{
 
           const ParticleFlux<VectorStateType> & particle_flux(int nr) const;
 
+          //! true if the pressure has been given
+          bool has_pressure() const;
+
+          //! returns the pressure P, only if has_pressure()
+          const StateType & P() const;
+
+          //! returns ln(P), only if has_pressure()
+          const StateType & lnP() const;
+
         private:
 
           KineticsConditions();
 
           TempCache<StateType> _temperature; 
 
+          //! false if not given, _pressure and _lnP
+          //! are then left default constructed
+          bool _has_pressure;
+
+          StateType _pressure;
+
+          StateType _lnP;
+
         // pointer's not const, particle flux is
           std::map<unsigned int,ParticleFlux<VectorStateType> const * const > _map_pf; 
 
@@ -96,7 +125,19 @@ namespace Antioch{
   template <typename StateType, typename VectorStateType>
   inline
   KineticsConditions<StateType,VectorStateType>::KineticsConditions(const StateType & temperature):
-        _temperature(temperature)
+        _temperature(temperature),
+        _has_pressure(false)
+  {
+    return;
+  }
+
+  template <typename StateType, typename VectorStateType>
+  inline
+  KineticsConditions<StateType,VectorStateType>::KineticsConditions(const StateType & temperature, const StateType & pressure):
+        _temperature(temperature),
+        _has_pressure(true),
+        _pressure(pressure),
+        _lnP(ant_log(pressure))
   {
     return;
   }
@@ -144,6 +185,29 @@ namespace Antioch{
      return _temperature;
   }
 
+  template <typename StateType, typename VectorStateType>
+  inline
+  bool KineticsConditions<StateType,VectorStateType>::has_pressure() const
+  {
+     return _has_pressure;
+  }
+
+  template <typename StateType, typename VectorStateType>
+  inline
+  const StateType & KineticsConditions<StateType,VectorStateType>::P() const
+  {
+     antioch_assert(_has_pressure);
+     return _pressure;
+  }
+
+  template <typename StateType, typename VectorStateType>
+  inline
+  const StateType & KineticsConditions<StateType,VectorStateType>::lnP() const
+  {
+     antioch_assert(_has_pressure);
+     return _lnP;
+  }
+
 } //end namespace Antioch
 
 #endif
@@ -0,0 +1,462 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+
+
+
+
+
+#ifndef ANTIOCH_ACTIVE_REACTION_SUBSET_H
+#define ANTIOCH_ACTIVE_REACTION_SUBSET_H
+
+// Antioch
+#include "antioch/antioch_asserts.h"
+#include "antioch/reaction.h"
+#include "antioch/equilibrium_factors.h"
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace Antioch
+{
+  template<typename CoeffType>
+  class ReactionSet;
+
+  //! Mask of the reactions of a ReactionSet to be evaluated
+  /*!
+   * In largely inert regions most reactions are negligible. The
+   * ReactionSet and KineticsEvaluator overloads taking a subset evaluate
+   * only its active reactions; the others have a rate of progress of
+   * exactly zero and contribute nothing to the sources or the Jacobian.
+   * CompiledReactionSet and KineticsBatchEvaluator take no subset and
+   * always evaluate all the reactions.
+   *
+   * update() keeps the reactions whose importance, the larger of their
+   * forward and backward rates of progress, is not negligible. The net
+   * rate is no measure of it: a fast reaction in partial equilibrium
+   * has a small net rate but drives the species it shares with the
+   * others. Every reaction, active or not, is tested at each update so
+   * that a skipped reaction is switched back on as soon as it matters.
+   *
+   * The update meant for each step, update(conditions, molar_densities, ...),
+   * works from the previous evaluations. ReactionSet::compute_reaction_rates()
+   * records, for each reaction it evaluates with this subset, its forward
+   * and backward rates of progress and its backward rate coefficient. The
+   * active reactions keep their recorded importance; the inactive ones are
+   * tested against a cheap estimate, the forward rate coefficient at the
+   * given temperature and the last backward rate coefficient times the
+   * concentration products, with no equilibrium constant. The update from
+   * the full state, which evaluates every reaction, is meant for the first
+   * step and for occasional refreshes, per cluster of cells.
+   *
+   * All reactions are active at construction.
+   */
+  template<typename CoeffType=double>
+  class ActiveReactionSubset
+  {
+  public:
+
+    ActiveReactionSubset( const ReactionSet<CoeffType>& reaction_set );
+
+    ~ActiveReactionSubset();
+
+    const ReactionSet<CoeffType>& reaction_set() const;
+
+    unsigned int n_reactions() const;
+
+    unsigned int n_species() const;
+
+    //! Activate every reaction
+    void activate_all();
+
+    //! Switch reaction \p rxn on or off
+    /*! Rebuilds the lists, use update() to set the whole mask. */
+    void set_active( const unsigned int rxn, const bool active );
+
+    //! \returns true if reaction \p rxn is evaluated
+    bool is_active( const unsigned int rxn ) const;
+
+    //! \returns true if species \p s takes part in an active reaction
+    bool is_active_species( const unsigned int s ) const;
+
+    unsigned int n_active_reactions() const;
+
+    //! Active reaction indices, increasing
+    const std::vector<unsigned int>& active_reactions() const;
+
+    //! Keep the reactions that are not negligible, from the previous evaluations
+    /*!
+     * An active reaction keeps the largest importance recorded by the
+     * evaluations since the last update. An inactive reaction, or an
+     * active one not evaluated since, is estimated from the forward rate
+     * coefficient at \p conditions and the last recorded backward rate
+     * coefficient, times the concentration products of \p molar_densities.
+     * For a cluster of cells, give its highest temperature. Much cheaper
+     * than an evaluation of all the reactions: no equilibrium constant,
+     * no thermodynamics. \returns the number of active reactions.
+     */
+    template <typename VectorStateType>
+    unsigned int update( const KineticsConditions<CoeffType,VectorStateType>& conditions,
+                         const VectorStateType& molar_densities,
+                         const CoeffType relative_tolerance,
+                         const CoeffType absolute_tolerance = 0 );
+
+    //! Keep the reactions that are not negligible at the given state
+    /*!
+     * Evaluates every reaction, as ReactionSet::compute_reaction_activities(),
+     * and records them for the update above. It costs more than a full
+     * compute_reaction_rates(): use it for the first step and for
+     * occasional refreshes, not at each step. \returns the number of
+     * active reactions.
+     */
+    template <typename VectorStateType>
+    unsigned int update( const KineticsConditions<CoeffType,VectorStateType>& conditions,
+                         const VectorStateType& molar_densities,
+                         const VectorStateType& h_RT_minus_s_R,
+                         const CoeffType relative_tolerance,
+                         const CoeffType absolute_tolerance = 0 );
+
+    //! Keep the reactions whose importance estimate is not negligible
+    /*!
+     * Reaction rxn is active if
+     * \f$ a_{rxn} > \max(\epsilon_a, \epsilon_r \max_r a_r) \f$,
+     * \p activities giving the estimates \f$a_r\f$ for all reactions,
+     * as from ReactionSet::compute_reaction_activities(); net rates of
+     * progress would drop reactions in partial equilibrium. For a cluster
+     * of cells, the largest value over the cells bounds the importance of
+     * each reaction. \returns the number of active reactions.
+     */
+    template <typename VectorReactionsType>
+    unsigned int update( const VectorReactionsType& activities,
+                         const CoeffType relative_tolerance,
+                         const CoeffType absolute_tolerance = 0 );
+
+    //! Record the rates of reaction \p rxn, as evaluated with this subset
+    /*!
+     * Called by ReactionSet::compute_reaction_rates(); the evaluations
+     * with derivatives record nothing, so the reactions they evaluate are
+     * estimated at the next update. \p kbkwd is the
+     * backward rate coefficient, zero if irreversible. For vector states,
+     * and over the evaluations since the last update, the largest values
+     * are kept.
+     */
+    template <typename StateType>
+    void record_rates( const unsigned int rxn,
+                       const StateType& kfwd_times_reactants,
+                       const StateType& kbkwd_times_products,
+                       const StateType& kbkwd ) const;
+
+  private:
+
+    ActiveReactionSubset();
+
+    //! rebuild the reaction and species lists from _active
+    void build_lists();
+
+    const ReactionSet<CoeffType>& _reaction_set;
+
+    std::vector<bool> _active;
+
+    std::vector<unsigned int> _active_reactions;
+
+    //! number of active reactions each species takes part in
+    std::vector<unsigned int> _species_usage;
+
+    //! work storage of the state based update(), kept across updates
+    EquilibriumFactors<CoeffType> _equilibrium_factors;
+
+    std::vector<CoeffType> _net_reaction_rates;
+
+    std::vector<CoeffType> _activities;
+
+    // records of the evaluations, written through a const subset
+
+    //! largest importance since the last update, if _recorded
+    mutable std::vector<CoeffType> _recorded_activities;
+
+    mutable std::vector<bool> _recorded;
+
+    //! last backward rate coefficients, zero until evaluated
+    mutable std::vector<CoeffType> _kbkwd;
+  };
+
+  /* ------------------------- Inline Functions -------------------------*/
+  template<typename CoeffType>
+  inline
+  ActiveReactionSubset<CoeffType>::ActiveReactionSubset( const ReactionSet<CoeffType>& reaction_set )
+    : _reaction_set( reaction_set ),
+      _active( reaction_set.n_reactions(), true ),
+      _species_usage( reaction_set.n_species(), 0 ),
+      _equilibrium_factors( reaction_set, 0 ),
+      _net_reaction_rates( reaction_set.n_reactions(), 0 ),
+      _activities( reaction_set.n_reactions(), 0 ),
+      _recorded_activities( reaction_set.n_reactions(), 0 ),
+      _recorded( reaction_set.n_reactions(), false ),
+      _kbkwd( reaction_set.n_reactions(), 0 )
+  {
+    this->build_lists();
+  }
+
+  template<typename CoeffType>
+  inline
+  ActiveReactionSubset<CoeffType>::~ActiveReactionSubset()
+  {
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  const ReactionSet<CoeffType>& ActiveReactionSubset<CoeffType>::reaction_set() const
+  {
+    return _reaction_set;
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int ActiveReactionSubset<CoeffType>::n_reactions() const
+  {
+    return _active.size();
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int ActiveReactionSubset<CoeffType>::n_species() const
+  {
+    return _species_usage.size();
+  }
+
+  template<typename CoeffType>
+  inline
+  void ActiveReactionSubset<CoeffType>::activate_all()
+  {
+    std::fill( _active.begin(), _active.end(), true );
+    this->build_lists();
+  }
+
+  template<typename CoeffType>
+  inline
+  void ActiveReactionSubset<CoeffType>::set_active( const unsigned int rxn, const bool active )
+  {
+    antioch_assert_less( rxn, this->n_reactions() );
+
+    if( _active[rxn] == active )
+      return;
+
+    _active[rxn] = active;
+    this->build_lists();
+  }
+
+  template<typename CoeffType>
+  inline
+  bool ActiveReactionSubset<CoeffType>::is_active( const unsigned int rxn ) const
+  {
+    antioch_assert_less( rxn, this->n_reactions() );
+    return _active[rxn];
+  }
+
+  template<typename CoeffType>
+  inline
+  bool ActiveReactionSubset<CoeffType>::is_active_species( const unsigned int s ) const
+  {
+    antioch_assert_less( s, this->n_species() );
+    return _species_usage[s] > 0;
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int ActiveReactionSubset<CoeffType>::n_active_reactions() const
+  {
+    return _active_reactions.size();
+  }
+
+  template<typename CoeffType>
+  inline
+  const std::vector<unsigned int>& ActiveReactionSubset<CoeffType>::active_reactions() const
+  {
+    return _active_reactions;
+  }
+
+  template<typename CoeffType>
+  template<typename VectorStateType>
+  inline
+  unsigned int ActiveReactionSubset<CoeffType>::update( const KineticsConditions<CoeffType,VectorStateType>& conditions,
+                                                        const VectorStateType& molar_densities,
+                                                        const CoeffType relative_tolerance,
+                                                        const CoeffType absolute_tolerance )
+  {
+    using std::abs;
+    using std::max;
+
+    antioch_assert_equal_to( molar_densities.size(), this->n_species() );
+
+    const CoeffType total_concentration = Antioch::total_concentration<CoeffType>( molar_densities );
+
+    for( unsigned int rxn = 0; rxn < this->n_reactions(); rxn++ )
+      {
+        if( _active[rxn] && _recorded[rxn] )
+          {
+            _activities[rxn] = _recorded_activities[rxn];
+            continue;
+          }
+
+        const Reaction<CoeffType>& reaction = _reaction_set.reaction(rxn);
+
+        CoeffType fwd = reaction.compute_forward_rate_coefficient( molar_densities, conditions,
+                                                                   total_concentration );
+        for( unsigned int ro = 0; ro < reaction.n_reactants(); ro++ )
+          {
+            const unsigned int n = reaction.reactant_integer_partial_order(ro);
+            if( n )
+              for( unsigned int k = 0; k < n; k++ )
+                fwd *= molar_densities[reaction.reactant_id(ro)];
+            else
+              fwd *= ant_pow( molar_densities[reaction.reactant_id(ro)],
+                              reaction.reactant_partial_order(ro) );
+          }
+
+        CoeffType bkwd = _kbkwd[rxn];
+        if( bkwd != 0 )
+          for( unsigned int po = 0; po < reaction.n_products(); po++ )
+            {
+              const unsigned int n = reaction.product_integer_partial_order(po);
+              if( n )
+                for( unsigned int k = 0; k < n; k++ )
+                  bkwd *= molar_densities[reaction.product_id(po)];
+              else
+                bkwd *= ant_pow( molar_densities[reaction.product_id(po)],
+                                 reaction.product_partial_order(po) );
+            }
+
+        _activities[rxn] = max( abs(fwd), abs(bkwd) );
+      }
+
+    return this->update( _activities, relative_tolerance, absolute_tolerance );
+  }
+
+  template<typename CoeffType>
+  template<typename VectorStateType>
+  inline
+  unsigned int ActiveReactionSubset<CoeffType>::update( const KineticsConditions<CoeffType,VectorStateType>& conditions,
+                                                        const VectorStateType& molar_densities,
+                                                        const VectorStateType& h_RT_minus_s_R,
+                                                        const CoeffType relative_tolerance,
+                                                        const CoeffType absolute_tolerance )
+  {
+    // evaluated with every reaction active, which records them all
+    this->activate_all();
+    std::fill( _recorded.begin(), _recorded.end(), false );
+
+    _reaction_set.compute_reaction_rates( conditions, _equilibrium_factors, molar_densities,
+                                          h_RT_minus_s_R, *this, _net_reaction_rates );
+
+    std::copy( _recorded_activities.begin(), _recorded_activities.end(), _activities.begin() );
+
+    return this->update( _activities, relative_tolerance, absolute_tolerance );
+  }
+
+  template<typename CoeffType>
+  template<typename VectorReactionsType>
+  inline
+  unsigned int ActiveReactionSubset<CoeffType>::update( const VectorReactionsType& activities,
+                                                        const CoeffType relative_tolerance,
+                                                        const CoeffType absolute_tolerance )
+  {
+    using std::abs;
+
+    antioch_assert_equal_to( activities.size(), this->n_reactions() );
+    antioch_assert_greater_equal( relative_tolerance, 0 );
+    antioch_assert_greater_equal( absolute_tolerance, 0 );
+
+    CoeffType max_activity = 0;
+    for( unsigned int rxn = 0; rxn < this->n_reactions(); rxn++ )
+      max_activity = std::max( max_activity, static_cast<CoeffType>(abs(activities[rxn])) );
+
+    const CoeffType threshold = std::max( absolute_tolerance, relative_tolerance * max_activity );
+
+    for( unsigned int rxn = 0; rxn < this->n_reactions(); rxn++ )
+      _active[rxn] = ( abs(activities[rxn]) > threshold );
+
+    this->build_lists();
+
+    // the next records start from the evaluations after this update
+    std::fill( _recorded.begin(), _recorded.end(), false );
+
+    return this->n_active_reactions();
+  }
+
+  template<typename CoeffType>
+  template<typename StateType>
+  inline
+  void ActiveReactionSubset<CoeffType>::record_rates( const unsigned int rxn,
+                                                      const StateType& kfwd_times_reactants,
+                                                      const StateType& kbkwd_times_products,
+                                                      const StateType& kbkwd ) const
+  {
+    using std::abs;
+    using std::max;
+
+    antioch_assert_less( rxn, this->n_reactions() );
+
+    const CoeffType activity = max( static_cast<CoeffType>(Antioch::max(abs(kfwd_times_reactants))),
+                                    static_cast<CoeffType>(Antioch::max(abs(kbkwd_times_products))) );
+
+    if( _recorded[rxn] )
+      _recorded_activities[rxn] = max( _recorded_activities[rxn], activity );
+    else
+      _recorded_activities[rxn] = activity;
+
+    _recorded[rxn] = true;
+
+    _kbkwd[rxn] = static_cast<CoeffType>(Antioch::max(kbkwd));
+  }
+
+  template<typename CoeffType>
+  inline
+  void ActiveReactionSubset<CoeffType>::build_lists()
+  {
+    _active_reactions.clear();
+    std::fill( _species_usage.begin(), _species_usage.end(), 0 );
+
+    for( unsigned int rxn = 0; rxn < this->n_reactions(); rxn++ )
+      {
+        if( !_active[rxn] )
+          continue;
+
+        _active_reactions.push_back(rxn);
+
+        const Reaction<CoeffType>& reaction = _reaction_set.reaction(rxn);
+        for( unsigned int r = 0; r < reaction.n_reactants(); r++ )
+          _species_usage[reaction.reactant_id(r)]++;
+        for( unsigned int p = 0; p < reaction.n_products(); p++ )
+          _species_usage[reaction.product_id(p)]++;
+      }
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_ACTIVE_REACTION_SUBSET_H
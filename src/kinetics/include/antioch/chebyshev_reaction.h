@@ -0,0 +1,502 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+#ifndef ANTIOCH_CHEBYSHEV_REACTION_H
+#define ANTIOCH_CHEBYSHEV_REACTION_H
+
+// Antioch
+#include "antioch/antioch_asserts.h"
+#include "antioch/cmath_shims.h"
+#include "antioch/math_constants.h"
+#include "antioch/physical_constants.h"
+#include "antioch/reaction.h"
+#include "antioch/kinetics_conditions.h"
+
+//C++
+#include <cmath>
+#include <string>
+#include <vector>
+#include <iostream>
+
+namespace Antioch
+{
+  //!A single reaction mechanism.
+  /*!\class ChebyshevReaction
+ *
+    This class encapsulates a pressure-dependent reaction given by a
+    Chebyshev expansion over \f$[T_{min},T_{max}]\times[P_{min},P_{max}]\f$:
+    \f[
+        \log_{10} k(T,P) = \sum_{t=0}^{N_T-1}\sum_{p=0}^{N_P-1} a_{tp}\,\phi_t(\tilde{T})\,\phi_p(\tilde{P})
+    \f]
+    with \f$\phi_n\f$ the Chebyshev polynomials of the first kind and
+    \f[
+        \tilde{T} = \frac{2T^{-1} - T_{min}^{-1} - T_{max}^{-1}}{T_{max}^{-1} - T_{min}^{-1}},\qquad
+        \tilde{P} = \frac{2\ln P - \ln P_{min} - \ln P_{max}}{\ln P_{max} - \ln P_{min}}
+    \f]
+    The coefficients \f$a_{tp}\f$ are those of \f$k\f$ in SI units. The
+    pressure is given by the KineticsConditions or, if not, by the
+    ideal gas law \f$P = [M] \mathrm{R} T\f$ (see PlogReaction for the
+    derivatives). There are no forward rates, hence no kinetics model.
+
+    The coefficients are stored scaled to \f$\ln k\f$, and \f$\tilde{T}\f$
+    and \f$\tilde{P}\f$ as affine functions of \f$1/T\f$ and \f$\ln P\f$.
+    The polynomials and their derivatives are evaluated by their
+    three-term recurrence, \f$\phi_{n+1} = 2x\phi_n - \phi_{n-1}\f$, with
+    no storage, so that an evaluation takes one exponential.
+  */
+  template<typename CoeffType=double>
+  class ChebyshevReaction: public Reaction<CoeffType>
+  {
+  public:
+
+    //! Construct a single reaction mechanism.
+    ChebyshevReaction( const unsigned int n_species,
+                       const std::string &equation,
+                       const bool &reversible = true,
+                       const KineticsModel::KineticsModel kin = KineticsModel::KOOIJ);
+
+    ~ChebyshevReaction();
+
+    //! Temperature range (K), 300 K to 2500 K by default as in ChemKin
+    void set_temperature_range( const CoeffType Tmin, const CoeffType Tmax );
+
+    //! Pressure range (Pa), 0.001 atm to 100 atm by default as in ChemKin
+    void set_pressure_range( const CoeffType Pmin, const CoeffType Pmax );
+
+    //! \f$\log_{10}\f$ coefficients of k in SI units, temperature-major: a_tp is \p coefficients[t*n_P + p]
+    void set_coefficients( const unsigned int n_T, const unsigned int n_P,
+                           const std::vector<CoeffType>& coefficients );
+
+    CoeffType Tmin() const;
+
+    CoeffType Tmax() const;
+
+    CoeffType Pmin() const;
+
+    CoeffType Pmax() const;
+
+    //! Number of temperature polynomials
+    unsigned int n_temperature_coefficients() const;
+
+    //! Number of pressure polynomials
+    unsigned int n_pressure_coefficients() const;
+
+    //! \f$\log_{10}\f$ coefficient a_tp
+    CoeffType coefficient( const unsigned int t, const unsigned int p ) const;
+
+    //!
+    template <typename StateType, typename VectorStateType>
+    StateType compute_forward_rate_coefficient( const VectorStateType& molar_densities,
+                                                const KineticsConditions<StateType,VectorStateType>& conditions ) const;
+
+    //!
+    template <typename StateType, typename VectorStateType>
+    void compute_forward_rate_coefficient_and_derivatives( const VectorStateType& molar_densities,
+                                                           const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                           StateType& kfwd,
+                                                           StateType& dkfwd_dT,
+                                                           VectorStateType& dkfwd_dX) const;
+
+    //! \p total_concentration is sum_s c_s, for the ideal gas pressure; unused if \p conditions carry the pressure
+    template <typename StateType, typename VectorStateType>
+    StateType compute_forward_rate_coefficient( const VectorStateType& molar_densities,
+                                                const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                const StateType& total_concentration ) const;
+
+    //! \p total_concentration is sum_s c_s, for the ideal gas pressure; unused if \p conditions carry the pressure
+    template <typename StateType, typename VectorStateType>
+    void compute_forward_rate_coefficient_and_derivatives( const VectorStateType& molar_densities,
+                                                           const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                           const StateType& total_concentration,
+                                                           StateType& kfwd,
+                                                           StateType& dkfwd_dT,
+                                                           VectorStateType& dkfwd_dX) const;
+
+  private:
+
+    //! ln(k) and, if \p dlnk_dx is not NULL, its derivatives with respect to x = T~ and y = P~
+    template <typename StateType>
+    void log_rate( const StateType& x, const StateType& y,
+                   StateType& lnk, StateType* dlnk_dx, StateType* dlnk_dy ) const;
+
+    //! ln(P), from the conditions or the ideal gas law
+    template <typename StateType, typename VectorStateType>
+    StateType log_pressure( const KineticsConditions<StateType,VectorStateType>& conditions,
+                            const StateType& total_concentration ) const;
+
+    //! T~ = _T_scale/T + _T_shift, P~ = _P_scale ln(P) + _P_shift
+    void update_scalings();
+
+    CoeffType _Tmin, _Tmax, _Pmin, _Pmax;
+
+    CoeffType _T_scale, _T_shift, _P_scale, _P_shift;
+
+    unsigned int _n_T, _n_P;
+
+    //! a_tp, as given
+    std::vector<CoeffType> _coefficients;
+
+    //! ln(10) a_tp
+    std::vector<CoeffType> _ln_coefficients;
+  };
+
+  /* ------------------------- Inline Functions -------------------------*/
+  template<typename CoeffType>
+  inline
+  ChebyshevReaction<CoeffType>::ChebyshevReaction( const unsigned int n_species,
+                                                   const std::string &equation,
+                                                   const bool &reversible,
+                                                   const KineticsModel::KineticsModel kin)
+    :Reaction<CoeffType>(n_species,equation,reversible,ReactionType::CHEBYSHEV,kin),
+     _Tmin(300),
+     _Tmax(2500),
+     _Pmin(101.325),
+     _Pmax(1.01325e7),
+     _n_T(0),
+     _n_P(0)
+  {
+    this->update_scalings();
+    return;
+  }
+
+
+  template<typename CoeffType>
+  inline
+  ChebyshevReaction<CoeffType>::~ChebyshevReaction()
+  {
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  void ChebyshevReaction<CoeffType>::set_temperature_range( const CoeffType Tmin, const CoeffType Tmax )
+  {
+    antioch_assert_greater(Tmin,0);
+    antioch_assert_greater(Tmax,Tmin);
+
+    _Tmin = Tmin;
+    _Tmax = Tmax;
+    this->update_scalings();
+  }
+
+  template<typename CoeffType>
+  inline
+  void ChebyshevReaction<CoeffType>::set_pressure_range( const CoeffType Pmin, const CoeffType Pmax )
+  {
+    antioch_assert_greater(Pmin,0);
+    antioch_assert_greater(Pmax,Pmin);
+
+    _Pmin = Pmin;
+    _Pmax = Pmax;
+    this->update_scalings();
+  }
+
+  template<typename CoeffType>
+  inline
+  void ChebyshevReaction<CoeffType>::set_coefficients( const unsigned int n_T, const unsigned int n_P,
+                                                       const std::vector<CoeffType>& coefficients )
+  {
+    antioch_assert_greater(n_T,0);
+    antioch_assert_greater(n_P,0);
+    antioch_assert_equal_to(coefficients.size(),n_T*n_P);
+
+    _n_T = n_T;
+    _n_P = n_P;
+    _coefficients = coefficients;
+    _ln_coefficients.resize(coefficients.size());
+    for( unsigned int i = 0; i < coefficients.size(); i++ )
+      _ln_coefficients[i] = coefficients[i]/Constants::log10_to_log<CoeffType>();
+  }
+
+  template<typename CoeffType>
+  inline
+  void ChebyshevReaction<CoeffType>::update_scalings()
+  {
+    using std::log;
+
+    // T~ = (2/T - 1/Tmin - 1/Tmax)/(1/Tmax - 1/Tmin)
+    const CoeffType inv_range = 1/(1/_Tmax - 1/_Tmin);
+    _T_scale = 2 * inv_range;
+    _T_shift = -(1/_Tmin + 1/_Tmax) * inv_range;
+
+    // P~ = (2 lnP - lnPmin - lnPmax)/(lnPmax - lnPmin)
+    const CoeffType inv_log_range = 1/(log(_Pmax) - log(_Pmin));
+    _P_scale = 2 * inv_log_range;
+    _P_shift = -(log(_Pmin) + log(_Pmax)) * inv_log_range;
+  }
+
+  template<typename CoeffType>
+  inline
+  CoeffType ChebyshevReaction<CoeffType>::Tmin() const
+  {
+    return _Tmin;
+  }
+
+  template<typename CoeffType>
+  inline
+  CoeffType ChebyshevReaction<CoeffType>::Tmax() const
+  {
+    return _Tmax;
+  }
+
+  template<typename CoeffType>
+  inline
+  CoeffType ChebyshevReaction<CoeffType>::Pmin() const
+  {
+    return _Pmin;
+  }
+
+  template<typename CoeffType>
+  inline
+  CoeffType ChebyshevReaction<CoeffType>::Pmax() const
+  {
+    return _Pmax;
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int ChebyshevReaction<CoeffType>::n_temperature_coefficients() const
+  {
+    return _n_T;
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int ChebyshevReaction<CoeffType>::n_pressure_coefficients() const
+  {
+    return _n_P;
+  }
+
+  template<typename CoeffType>
+  inline
+  CoeffType ChebyshevReaction<CoeffType>::coefficient( const unsigned int t, const unsigned int p ) const
+  {
+    antioch_assert_less(t,_n_T);
+    antioch_assert_less(p,_n_P);
+    return _coefficients[t*_n_P + p];
+  }
+
+  template<typename CoeffType>
+  template<typename StateType>
+  inline
+  void ChebyshevReaction<CoeffType>::log_rate( const StateType& x, const StateType& y,
+                                               StateType& lnk, StateType* dlnk_dx, StateType* dlnk_dy ) const
+  {
+    antioch_assert_greater(_n_T,0);
+
+    const StateType zero = zero_clone(x);
+    const StateType one = constant_clone(x,1);
+
+    // phi_t(x), phi_t-1(x) and their derivatives
+    StateType phi_x = one, phi_x_previous = zero;
+    StateType dphi_x = zero, dphi_x_previous = zero;
+
+    StateType phi_y = one, phi_y_previous = zero, phi_y_next = zero;
+    StateType dphi_y = zero, dphi_y_previous = zero, dphi_y_next = zero;
+
+    StateType beta = zero, dbeta_dy = zero;
+    StateType phi_x_next = zero, dphi_x_next = zero;
+
+    lnk = zero;
+    if( dlnk_dx )
+      {
+        *dlnk_dx = zero;
+        *dlnk_dy = zero;
+      }
+
+    for( unsigned int t = 0; t < _n_T; t++ )
+      {
+        // beta_t = sum_p a_tp phi_p(y), the recurrence in y is rerun
+        // for each t rather than stored
+        const CoeffType* a_t = &_ln_coefficients[t*_n_P];
+        beta = a_t[0] * one;
+        dbeta_dy = zero;
+        phi_y = one;
+        phi_y_previous = zero;
+        dphi_y = zero;
+        dphi_y_previous = zero;
+        for( unsigned int p = 1; p < _n_P; p++ )
+          {
+            if( p == 1 )
+              {
+                phi_y_next = y;
+                dphi_y_next = one;
+              }
+            else
+              {
+                phi_y_next = 2 * y * phi_y - phi_y_previous;
+                dphi_y_next = 2 * phi_y + 2 * y * dphi_y - dphi_y_previous;
+              }
+            phi_y_previous = phi_y;
+            phi_y = phi_y_next;
+            dphi_y_previous = dphi_y;
+            dphi_y = dphi_y_next;
+
+            beta += a_t[p] * phi_y;
+            if( dlnk_dx )
+              dbeta_dy += a_t[p] * dphi_y;
+          }
+
+        if( t == 1 )
+          {
+            phi_x_previous = phi_x;
+            phi_x = x;
+            dphi_x_previous = dphi_x;
+            dphi_x = one;
+          }
+        else if( t > 1 )
+          {
+            phi_x_next = 2 * x * phi_x - phi_x_previous;
+            dphi_x_next = 2 * phi_x + 2 * x * dphi_x - dphi_x_previous;
+            phi_x_previous = phi_x;
+            phi_x = phi_x_next;
+            dphi_x_previous = dphi_x;
+            dphi_x = dphi_x_next;
+          }
+
+        lnk += beta * phi_x;
+        if( dlnk_dx )
+          {
+            *dlnk_dx += beta * dphi_x;
+            *dlnk_dy += dbeta_dy * phi_x;
+          }
+      }
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  StateType ChebyshevReaction<CoeffType>::log_pressure( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                        const StateType& total_concentration ) const
+  {
+    if( conditions.has_pressure() )
+      return conditions.lnP();
+
+    return ant_log( total_concentration * Constants::R_universal<CoeffType>() * conditions.T() );
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  StateType ChebyshevReaction<CoeffType>::compute_forward_rate_coefficient
+    ( const VectorStateType& molar_densities,
+      const KineticsConditions<StateType,VectorStateType>& conditions) const
+  {
+    // log_pressure() ignores the total concentration if the pressure
+    // is given, it is not summed for nothing then
+    const StateType conc = conditions.has_pressure() ?
+      zero_clone(conditions.T()) : total_concentration<StateType>(molar_densities);
+
+    return this->compute_forward_rate_coefficient( molar_densities, conditions, conc );
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  StateType ChebyshevReaction<CoeffType>::compute_forward_rate_coefficient
+    ( const VectorStateType& /* molar_densities */,
+      const KineticsConditions<StateType,VectorStateType>& conditions,
+      const StateType& total_concentration ) const
+  {
+    const StateType x = _T_scale/conditions.T() + _T_shift;
+    const StateType y = _P_scale * this->log_pressure(conditions,total_concentration) + _P_shift;
+
+    StateType lnk = zero_clone(x);
+    this->log_rate(x,y,lnk,static_cast<StateType*>(NULL),static_cast<StateType*>(NULL));
+
+    StateType kfwd = ant_exp(lnk);
+
+    antioch_assert(!has_nan(kfwd));
+
+    return kfwd;
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void ChebyshevReaction<CoeffType>::compute_forward_rate_coefficient_and_derivatives
+    ( const VectorStateType& molar_densities,
+      const KineticsConditions<StateType,VectorStateType>& conditions,
+      StateType& kfwd,
+      StateType& dkfwd_dT,
+      VectorStateType& dkfwd_dX) const
+  {
+    // as above, the total concentration is not needed if the pressure is given
+    const StateType conc = conditions.has_pressure() ?
+      zero_clone(conditions.T()) : total_concentration<StateType>(molar_densities);
+
+    this->compute_forward_rate_coefficient_and_derivatives( molar_densities, conditions, conc,
+                                                            kfwd, dkfwd_dT, dkfwd_dX );
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void ChebyshevReaction<CoeffType>::compute_forward_rate_coefficient_and_derivatives
+    ( const VectorStateType& /* molar_densities */,
+      const KineticsConditions<StateType,VectorStateType>& conditions,
+      const StateType& total_concentration,
+      StateType& kfwd,
+      StateType& dkfwd_dT,
+      VectorStateType& dkfwd_dX) const
+  {
+    antioch_assert_equal_to(dkfwd_dX.size(),this->n_species());
+
+    const StateType& T = conditions.T();
+    const StateType x = _T_scale/T + _T_shift;
+    const StateType y = _P_scale * this->log_pressure(conditions,total_concentration) + _P_shift;
+
+    StateType lnk = zero_clone(x);
+    StateType dlnk_dx = zero_clone(x);
+    StateType dlnk_dy = zero_clone(x);
+    this->log_rate(x,y,lnk,&dlnk_dx,&dlnk_dy);
+
+    kfwd = ant_exp(lnk);
+
+    antioch_assert(!has_nan(kfwd));
+
+    // dx/dT = -_T_scale/T^2, dy/dlnP = _P_scale
+    dkfwd_dT = -kfwd * dlnk_dx * _T_scale/(T*T);
+
+    // the given pressure is independent of T and of the concentrations
+    if( conditions.has_pressure() )
+      {
+        Antioch::set_zero(dkfwd_dX);
+        return;
+      }
+
+    // P = [M] R T: dlnP/dT = 1/T, dlnP/dc_i = 1/[M]
+    const StateType dkfwd_dlnP = kfwd * dlnk_dy * _P_scale;
+    dkfwd_dT += dkfwd_dlnP/T;
+
+    const StateType dkfwd_dc = dkfwd_dlnP/total_concentration;
+    for( unsigned int s = 0; s < this->n_species(); s++ )
+      dkfwd_dX[s] = dkfwd_dc;
+  }
+
+} // namespace Antioch
+
+#endif // ANTIOCH_CHEBYSHEV_REACTION_H
@@ -0,0 +1,483 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+
+
+
+#ifndef ANTIOCH_CHEMISTRY_JACOBIAN_H
+#define ANTIOCH_CHEMISTRY_JACOBIAN_H
+
+// Antioch
+#include "antioch/antioch_asserts.h"
+#include "antioch/chemical_mixture.h"
+#include "antioch/reaction_set.h"
+#include "antioch/kinetics_evaluator.h"
+#include "antioch/kinetics_conditions.h"
+#include "antioch/kinetics_jacobian_pattern.h"
+#include "antioch/temp_cache.h"
+
+// C++
+#include <vector>
+
+namespace Antioch
+{
+  namespace ChemistryVariables
+  {
+    enum ChemistryVariables { CONSERVATIVE = 0, //!< \f$ (\rho_0, \dots, \rho_{n-1}, \rho e) \f$
+                              PRIMITIVE };      //!< \f$ (Y_0, \dots, Y_{n-1}, T, P) \f$
+  }
+
+  //! Chemical source terms and their Jacobian in the flow variables
+  /*!
+   * The equations are the species mass sources \f$ \dot{\omega}_s \f$
+   * followed by one energy source:
+   * - CONSERVATIVE: the source of \f$ \rho e \f$, zero since \f$ e \f$
+   *   includes the formation energies. The species sources depend on
+   *   \f$ \rho e \f$ through the temperature.
+   * - PRIMITIVE: the heat release rate
+   *   \f$ -\sum_s h_s \dot{\omega}_s \f$, the source of the temperature
+   *   equation \f$ \rho c_p dT/dt \f$ at constant pressure.
+   *
+   * The Jacobian is assembled in one pass over the derivatives of
+   * KineticsEvaluator, the mass units, the temperature chain rule and
+   * the energy row being applied on the fly.
+   *
+   * Both variable sets couple every species to the temperature or the
+   * density, so the Jacobian is dense. It is however a sparse matrix
+   * plus a rank one term, \f$ J = A + u v^T \f$, where \f$ A \f$ has the
+   * pattern of the species source Jacobian at fixed temperature and
+   * density (KineticsJacobianPattern) bordered by the temperature
+   * column and the energy row. compute_sparse() returns this form,
+   * which suits sparse factorizations with a Sherman-Morrison update
+   * or Jacobian-vector products.
+   *
+   * \p ThermoEvaluator must provide h, cp, h_RT_minus_s_R and
+   * dh_RT_minus_s_R_dT, as NASAEvaluator does. The class holds work
+   * arrays and so must be created within each thread.
+   */
+  template<typename CoeffType, typename ThermoEvaluator>
+  class ChemistryJacobian
+  {
+  public:
+
+    ChemistryJacobian( const ReactionSet<CoeffType>& reaction_set,
+                       const ThermoEvaluator& thermo,
+                       ChemistryVariables::ChemistryVariables variables );
+
+    ~ChemistryJacobian();
+
+    ChemistryVariables::ChemistryVariables variables() const;
+
+    unsigned int n_species() const;
+
+    //! n_species()+1, the species then the energy
+    unsigned int n_equations() const;
+
+    //! n_species()+1 (CONSERVATIVE) or n_species()+2 (PRIMITIVE)
+    unsigned int n_variables() const;
+
+    //! Sources and dense Jacobian at partial densities \p rho_s and temperature \p T
+    /*! \p jacobian is row major, n_equations() x n_variables(). */
+    void compute( const std::vector<CoeffType>& rho_s, const CoeffType T,
+                  std::vector<CoeffType>& sources,
+                  std::vector<CoeffType>& jacobian );
+
+    //! \name Sparse structure of A, compressed rows
+    //! @{
+    unsigned int n_nonzeros() const;
+
+    //! Row i owns the entries [offsets()[i],offsets()[i+1])
+    const std::vector<unsigned int>& offsets() const;
+
+    //! Column of each stored entry
+    const std::vector<unsigned int>& indices() const;
+    //! @}
+
+    //! Sources and Jacobian as \f$ J = A + u v^T \f$
+    /*! \p values holds A on the sparse structure, \p u has
+     *  n_equations() entries and \p v n_variables(). */
+    void compute_sparse( const std::vector<CoeffType>& rho_s, const CoeffType T,
+                         std::vector<CoeffType>& sources,
+                         std::vector<CoeffType>& values,
+                         std::vector<CoeffType>& u,
+                         std::vector<CoeffType>& v );
+
+  private:
+
+    ChemistryJacobian();
+
+    //! Density, thermodynamics and the rank one factor v at (rho_s, T)
+    void evaluate_state( const std::vector<CoeffType>& rho_s, const CoeffType T,
+                         std::vector<CoeffType>& v );
+
+    const ChemicalMixture<CoeffType>& _chem_mixture;
+
+    const ThermoEvaluator& _thermo;
+
+    KineticsEvaluator<CoeffType> _kinetics;
+
+    const KineticsJacobianPattern<CoeffType> _species_pattern;
+
+    ChemistryVariables::ChemistryVariables _variables;
+
+    std::vector<unsigned int> _offsets;
+
+    std::vector<unsigned int> _indices;
+
+    //! position in the values of A of each species pattern entry
+    std::vector<unsigned int> _species_positions;
+
+    //! last state
+    CoeffType _rho;
+    std::vector<CoeffType> _molar_densities;
+    std::vector<CoeffType> _h_RT_minus_s_R;
+    std::vector<CoeffType> _dh_RT_minus_s_R_dT;
+    std::vector<CoeffType> _h_s;
+    std::vector<CoeffType> _cp_s;
+
+    //! kinetics derivatives, mole units
+    std::vector<CoeffType> _mole_sources;
+    std::vector<CoeffType> _dmole_dT;
+    std::vector<std::vector<CoeffType> > _dmole_dX_s;
+    std::vector<CoeffType> _sparse_dmole_dX_s;
+  };
+
+  /* ------------------------- Inline Functions -------------------------*/
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  ChemistryJacobian<CoeffType,ThermoEvaluator>::ChemistryJacobian( const ReactionSet<CoeffType>& reaction_set,
+                                                                   const ThermoEvaluator& thermo,
+                                                                   ChemistryVariables::ChemistryVariables variables )
+    : _chem_mixture( reaction_set.chemical_mixture() ),
+      _thermo( thermo ),
+      _kinetics( reaction_set, 0 ),
+      _species_pattern( _kinetics.stoichiometry_matrix(), SparseMatrixLayout::CSR ),
+      _variables( variables ),
+      _rho( 0 ),
+      _molar_densities( reaction_set.n_species(), 0 ),
+      _h_RT_minus_s_R( reaction_set.n_species(), 0 ),
+      _dh_RT_minus_s_R_dT( reaction_set.n_species(), 0 ),
+      _h_s( reaction_set.n_species(), 0 ),
+      _cp_s( reaction_set.n_species(), 0 ),
+      _mole_sources( reaction_set.n_species(), 0 ),
+      _dmole_dT( reaction_set.n_species(), 0 ),
+      _dmole_dX_s( reaction_set.n_species(), std::vector<CoeffType>(reaction_set.n_species(), 0) )
+  {
+    const unsigned int n_species = reaction_set.n_species();
+    const bool primitive = ( _variables == ChemistryVariables::PRIMITIVE );
+
+    _sparse_dmole_dX_s.resize( _species_pattern.n_nonzeros(), 0 );
+    _species_positions.resize( _species_pattern.n_nonzeros() );
+
+    // species rows: the species pattern, then the temperature column
+    const std::vector<unsigned int>& species_offsets = _species_pattern.offsets();
+    const std::vector<unsigned int>& species_indices = _species_pattern.indices();
+
+    _offsets.push_back(0);
+    for( unsigned int s = 0; s < n_species; s++ )
+      {
+        for( unsigned int k = species_offsets[s]; k < species_offsets[s+1]; k++ )
+          {
+            _species_positions[k] = _indices.size();
+            _indices.push_back( species_indices[k] );
+          }
+
+        if( primitive )
+          _indices.push_back( n_species );
+
+        _offsets.push_back( _indices.size() );
+      }
+
+    // energy row: heat release rate, dense but for the pressure
+    if( primitive )
+      for( unsigned int k = 0; k <= n_species; k++ )
+        _indices.push_back(k);
+
+    _offsets.push_back( _indices.size() );
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  ChemistryJacobian<CoeffType,ThermoEvaluator>::~ChemistryJacobian()
+  {
+    return;
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  ChemistryVariables::ChemistryVariables ChemistryJacobian<CoeffType,ThermoEvaluator>::variables() const
+  {
+    return _variables;
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  unsigned int ChemistryJacobian<CoeffType,ThermoEvaluator>::n_species() const
+  {
+    return _chem_mixture.n_species();
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  unsigned int ChemistryJacobian<CoeffType,ThermoEvaluator>::n_equations() const
+  {
+    return this->n_species() + 1;
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  unsigned int ChemistryJacobian<CoeffType,ThermoEvaluator>::n_variables() const
+  {
+    return this->n_species() + ( _variables == ChemistryVariables::PRIMITIVE ? 2 : 1 );
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  unsigned int ChemistryJacobian<CoeffType,ThermoEvaluator>::n_nonzeros() const
+  {
+    return _indices.size();
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  const std::vector<unsigned int>& ChemistryJacobian<CoeffType,ThermoEvaluator>::offsets() const
+  {
+    return _offsets;
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  const std::vector<unsigned int>& ChemistryJacobian<CoeffType,ThermoEvaluator>::indices() const
+  {
+    return _indices;
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  void ChemistryJacobian<CoeffType,ThermoEvaluator>::evaluate_state( const std::vector<CoeffType>& rho_s,
+                                                                     const CoeffType T,
+                                                                     std::vector<CoeffType>& v )
+  {
+    const unsigned int n_species = this->n_species();
+
+    antioch_assert_equal_to( rho_s.size(), n_species );
+    antioch_assert_equal_to( v.size(), this->n_variables() );
+
+    _rho = rho_s[0];
+    CoeffType rho_R = rho_s[0]*_chem_mixture.R(0);
+    for( unsigned int s = 1; s < n_species; s++ )
+      {
+        _rho += rho_s[s];
+        rho_R += rho_s[s]*_chem_mixture.R(s);
+      }
+
+    for( unsigned int s = 0; s < n_species; s++ )
+      _molar_densities[s] = rho_s[s]/_chem_mixture.M(s);
+
+    const TempCache<CoeffType> cache(T);
+
+    _thermo.h_RT_minus_s_R( cache, _h_RT_minus_s_R );
+    _thermo.dh_RT_minus_s_R_dT( cache, _dh_RT_minus_s_R_dT );
+
+    for( unsigned int s = 0; s < n_species; s++ )
+      {
+        _h_s[s] = _thermo.h( cache, s );
+        _cp_s[s] = _thermo.cp( cache, s );
+      }
+
+    if( _variables == ChemistryVariables::CONSERVATIVE )
+      {
+        // T(rho_s, rho e): dT/drho_k = -e_k/(rho cv), dT/d(rho e) = 1/(rho cv)
+        CoeffType rho_cv = 0;
+        for( unsigned int s = 0; s < n_species; s++ )
+          rho_cv += rho_s[s]*( _cp_s[s] - _chem_mixture.R(s) );
+
+        for( unsigned int k = 0; k < n_species; k++ )
+          v[k] = -( _h_s[k] - _chem_mixture.R(k)*T )/rho_cv;
+        v[n_species] = 1/rho_cv;
+      }
+    else
+      {
+        // rho = P/(R_mix T): drho/dY_k = -rho R_k/R_mix, drho/dT = -rho/T, drho/dP = rho/P
+        const CoeffType R_mix = rho_R/_rho;
+        const CoeffType P = rho_R*T;
+
+        for( unsigned int k = 0; k < n_species; k++ )
+          v[k] = -_rho*_chem_mixture.R(k)/R_mix;
+        v[n_species] = -_rho/T;
+        v[n_species+1] = _rho/P;
+      }
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  void ChemistryJacobian<CoeffType,ThermoEvaluator>::compute( const std::vector<CoeffType>& rho_s,
+                                                              const CoeffType T,
+                                                              std::vector<CoeffType>& sources,
+                                                              std::vector<CoeffType>& jacobian )
+  {
+    const unsigned int n_species = this->n_species();
+    const unsigned int n_variables = this->n_variables();
+
+    antioch_assert_equal_to( sources.size(), this->n_equations() );
+    antioch_assert_equal_to( jacobian.size(), this->n_equations()*n_variables );
+
+    std::vector<CoeffType> v( n_variables );
+    this->evaluate_state( rho_s, T, v );
+
+    const KineticsConditions<CoeffType> conditions(T);
+    _kinetics.compute_mole_sources_and_derivs( conditions, _molar_densities, _h_RT_minus_s_R,
+                                               _dh_RT_minus_s_R_dT, _mole_sources, _dmole_dT,
+                                               _dmole_dX_s );
+
+    const bool primitive = ( _variables == ChemistryVariables::PRIMITIVE );
+
+    CoeffType* energy_row = &jacobian[n_species*n_variables];
+    for( unsigned int k = 0; k < n_variables; k++ )
+      energy_row[k] = 0;
+    sources[n_species] = 0;
+
+    for( unsigned int s = 0; s < n_species; s++ )
+      {
+        const CoeffType M_s = _chem_mixture.M(s);
+        const std::vector<CoeffType>& dmole_dX = _dmole_dX_s[s];
+        CoeffType* row = &jacobian[s*n_variables];
+
+        sources[s] = M_s*_mole_sources[s];
+        const CoeffType dw_dT = M_s*_dmole_dT[s];
+
+        // u_s, the factor of the rank one term
+        CoeffType u_s = dw_dT;
+
+        if( primitive )
+          {
+            // d/drho_t at fixed T, scaled to d/dY_t at fixed rho
+            u_s = 0;
+            for( unsigned int t = 0; t < n_species; t++ )
+              {
+                row[t] = M_s/_chem_mixture.M(t)*dmole_dX[t];
+                u_s += rho_s[t]*row[t];
+                row[t] *= _rho;
+              }
+            u_s /= _rho;
+
+            for( unsigned int t = 0; t < n_species; t++ )
+              row[t] += u_s*v[t];
+            row[n_species] = dw_dT + u_s*v[n_species];
+            row[n_species+1] = u_s*v[n_species+1];
+
+            for( unsigned int k = 0; k < n_variables; k++ )
+              energy_row[k] -= _h_s[s]*row[k];
+            energy_row[n_species] -= _cp_s[s]*sources[s];
+            sources[n_species] -= _h_s[s]*sources[s];
+          }
+        else
+          {
+            for( unsigned int t = 0; t < n_species; t++ )
+              row[t] = M_s/_chem_mixture.M(t)*dmole_dX[t] + u_s*v[t];
+            row[n_species] = u_s*v[n_species];
+          }
+      }
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  void ChemistryJacobian<CoeffType,ThermoEvaluator>::compute_sparse( const std::vector<CoeffType>& rho_s,
+                                                                     const CoeffType T,
+                                                                     std::vector<CoeffType>& sources,
+                                                                     std::vector<CoeffType>& values,
+                                                                     std::vector<CoeffType>& u,
+                                                                     std::vector<CoeffType>& v )
+  {
+    const unsigned int n_species = this->n_species();
+
+    antioch_assert_equal_to( sources.size(), this->n_equations() );
+    antioch_assert_equal_to( values.size(), this->n_nonzeros() );
+    antioch_assert_equal_to( u.size(), this->n_equations() );
+
+    this->evaluate_state( rho_s, T, v );
+
+    const KineticsConditions<CoeffType> conditions(T);
+    _kinetics.compute_mole_sources_and_sparse_derivs( conditions, _molar_densities, _h_RT_minus_s_R,
+                                                      _dh_RT_minus_s_R_dT, _species_pattern,
+                                                      _mole_sources, _dmole_dT, _sparse_dmole_dX_s );
+
+    const bool primitive = ( _variables == ChemistryVariables::PRIMITIVE );
+    const std::vector<unsigned int>& species_offsets = _species_pattern.offsets();
+    const std::vector<unsigned int>& species_indices = _species_pattern.indices();
+
+    sources[n_species] = 0;
+    u[n_species] = 0;
+
+    // energy row, stored densely over Y_0 .. Y_{n-1}, T
+    CoeffType* energy_row = primitive ? &values[_offsets[n_species]] : NULL;
+    if( primitive )
+      for( unsigned int k = 0; k <= n_species; k++ )
+        energy_row[k] = 0;
+
+    for( unsigned int s = 0; s < n_species; s++ )
+      {
+        const CoeffType M_s = _chem_mixture.M(s);
+
+        sources[s] = M_s*_mole_sources[s];
+        const CoeffType dw_dT = M_s*_dmole_dT[s];
+
+        if( primitive )
+          {
+            CoeffType u_s = 0;
+            for( unsigned int k = species_offsets[s]; k < species_offsets[s+1]; k++ )
+              {
+                const unsigned int t = species_indices[k];
+                const CoeffType dw_drho = M_s/_chem_mixture.M(t)*_sparse_dmole_dX_s[k];
+
+                u_s += rho_s[t]*dw_drho;
+
+                CoeffType& a = values[_species_positions[k]];
+                a = _rho*dw_drho;
+                energy_row[t] -= _h_s[s]*a;
+              }
+            u[s] = u_s/_rho;
+
+            // temperature column closes the row
+            values[_offsets[s+1]-1] = dw_dT;
+            energy_row[n_species] -= _h_s[s]*dw_dT + _cp_s[s]*sources[s];
+
+            u[n_species] -= _h_s[s]*u[s];
+            sources[n_species] -= _h_s[s]*sources[s];
+          }
+        else
+          {
+            for( unsigned int k = species_offsets[s]; k < species_offsets[s+1]; k++ )
+              values[_species_positions[k]] = M_s/_chem_mixture.M(species_indices[k])*_sparse_dmole_dX_s[k];
+
+            u[s] = dw_dT;
+          }
+      }
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_CHEMISTRY_JACOBIAN_H
@@ -0,0 +1,360 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+
+
+
+#ifndef ANTIOCH_CHEMISTRY_MAPPINGS_H
+#define ANTIOCH_CHEMISTRY_MAPPINGS_H
+
+// Antioch
+#include "antioch/antioch_asserts.h"
+#include "antioch/chemical_mixture.h"
+#include "antioch/reaction_set.h"
+#include "antioch/kinetics_evaluator.h"
+#include "antioch/kinetics_conditions.h"
+#include "antioch/temp_cache.h"
+#include "antioch/chemistry_jacobian.h"
+#include "antioch/homogeneous_reactor.h"
+
+// C++
+#include <cmath>
+#include <vector>
+
+namespace Antioch
+{
+  //! Chemical source terms as a mapping of (Y_s, T, P), for ISATTable
+  /*!
+   * The outputs are the species mass sources followed by the heat
+   * release rate \f$ -\sum_s h_s \dot{\omega}_s \f$. The gradient is the
+   * PRIMITIVE ChemistryJacobian, whose variables are these inputs.
+   */
+  template<typename CoeffType, typename ThermoEvaluator>
+  class ChemistrySourceMapping
+  {
+  public:
+
+    ChemistrySourceMapping( const ReactionSet<CoeffType>& reaction_set,
+                            const ThermoEvaluator& thermo );
+
+    ~ChemistrySourceMapping();
+
+    //! n_species()+2, mass fractions, temperature and pressure
+    unsigned int n_inputs() const;
+
+    //! n_species()+1, mass sources and heat release rate
+    unsigned int n_outputs() const;
+
+    void evaluate( const std::vector<CoeffType>& x, std::vector<CoeffType>& f );
+
+    //! Gradient at \p x, \p f being evaluate() at \p x
+    void gradient( const std::vector<CoeffType>& x, const std::vector<CoeffType>& f,
+                   std::vector<CoeffType>& A );
+
+  private:
+
+    ChemistrySourceMapping();
+
+    //! Partial densities of the input state
+    void set_state( const std::vector<CoeffType>& x );
+
+    const ChemicalMixture<CoeffType>& _chem_mixture;
+
+    const ThermoEvaluator& _thermo;
+
+    KineticsEvaluator<CoeffType> _kinetics;
+
+    ChemistryJacobian<CoeffType,ThermoEvaluator> _jacobian;
+
+    std::vector<CoeffType> _mass_fractions;
+    std::vector<CoeffType> _rho_s;
+    std::vector<CoeffType> _molar_densities;
+    std::vector<CoeffType> _h_RT_minus_s_R;
+    std::vector<CoeffType> _mass_sources;
+
+    //! sources computed along with the Jacobian
+    std::vector<CoeffType> _f_jacobian;
+  };
+
+  //! Reaction mapping of a constant pressure reactor, for ISATTable
+  /*!
+   * Maps \f$ (Y_s, T, P) \f$ to the mass fractions and temperature after
+   * a time step of the HomogeneousReactor. The gradient is computed by
+   * forward differences, one reactor integration per input, with steps
+   * set_perturbation() times \f$ \max(|x_j|, 1) \f$. The integrator
+   * tolerances of the reactor must be well below the perturbation.
+   */
+  template<typename CoeffType, typename ThermoEvaluator>
+  class ReactorStateMapping
+  {
+  public:
+
+    ReactorStateMapping( HomogeneousReactor<CoeffType,ThermoEvaluator>& reactor,
+                         const CoeffType dt );
+
+    ~ReactorStateMapping();
+
+    void set_time_step( const CoeffType dt );
+
+    //! Relative forward difference step, defaults to 1e-6
+    void set_perturbation( const CoeffType perturbation );
+
+    //! n_species()+2, mass fractions, temperature and pressure
+    unsigned int n_inputs() const;
+
+    //! n_species()+1, mass fractions and temperature
+    unsigned int n_outputs() const;
+
+    void evaluate( const std::vector<CoeffType>& x, std::vector<CoeffType>& f );
+
+    //! Gradient at \p x, \p f being evaluate() at \p x
+    void gradient( const std::vector<CoeffType>& x, const std::vector<CoeffType>& f,
+                   std::vector<CoeffType>& A );
+
+  private:
+
+    ReactorStateMapping();
+
+    HomogeneousReactor<CoeffType,ThermoEvaluator>& _reactor;
+
+    CoeffType _dt;
+
+    CoeffType _perturbation;
+
+    std::vector<CoeffType> _x_perturbed;
+    std::vector<CoeffType> _f_perturbed;
+    std::vector<CoeffType> _mass_fractions;
+  };
+
+  /* ------------------------- Inline Functions -------------------------*/
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  ChemistrySourceMapping<CoeffType,ThermoEvaluator>::ChemistrySourceMapping( const ReactionSet<CoeffType>& reaction_set,
+                                                                             const ThermoEvaluator& thermo )
+    : _chem_mixture( reaction_set.chemical_mixture() ),
+      _thermo( thermo ),
+      _kinetics( reaction_set, 0 ),
+      _jacobian( reaction_set, thermo, ChemistryVariables::PRIMITIVE ),
+      _mass_fractions( reaction_set.n_species(), 0 ),
+      _rho_s( reaction_set.n_species(), 0 ),
+      _molar_densities( reaction_set.n_species(), 0 ),
+      _h_RT_minus_s_R( reaction_set.n_species(), 0 ),
+      _mass_sources( reaction_set.n_species(), 0 ),
+      _f_jacobian( reaction_set.n_species() + 1, 0 )
+  {
+    return;
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  ChemistrySourceMapping<CoeffType,ThermoEvaluator>::~ChemistrySourceMapping()
+  {
+    return;
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  unsigned int ChemistrySourceMapping<CoeffType,ThermoEvaluator>::n_inputs() const
+  {
+    return _chem_mixture.n_species() + 2;
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  unsigned int ChemistrySourceMapping<CoeffType,ThermoEvaluator>::n_outputs() const
+  {
+    return _chem_mixture.n_species() + 1;
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  void ChemistrySourceMapping<CoeffType,ThermoEvaluator>::set_state( const std::vector<CoeffType>& x )
+  {
+    const unsigned int n_species = _chem_mixture.n_species();
+
+    antioch_assert_equal_to( x.size(), this->n_inputs() );
+
+    for( unsigned int s = 0; s < n_species; s++ )
+      _mass_fractions[s] = x[s];
+
+    const CoeffType T = x[n_species];
+    const CoeffType rho = x[n_species+1]/( _chem_mixture.R(_mass_fractions)*T );
+
+    for( unsigned int s = 0; s < n_species; s++ )
+      _rho_s[s] = rho*_mass_fractions[s];
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  void ChemistrySourceMapping<CoeffType,ThermoEvaluator>::evaluate( const std::vector<CoeffType>& x,
+                                                                    std::vector<CoeffType>& f )
+  {
+    const unsigned int n_species = _chem_mixture.n_species();
+
+    antioch_assert_equal_to( f.size(), this->n_outputs() );
+
+    this->set_state( x );
+
+    const CoeffType T = x[n_species];
+    for( unsigned int s = 0; s < n_species; s++ )
+      _molar_densities[s] = _rho_s[s]/_chem_mixture.M(s);
+
+    const TempCache<CoeffType> cache(T);
+    _thermo.h_RT_minus_s_R( cache, _h_RT_minus_s_R );
+
+    _kinetics.compute_mass_sources( KineticsConditions<CoeffType>(T), _molar_densities,
+                                    _h_RT_minus_s_R, _mass_sources );
+
+    f[n_species] = 0;
+    for( unsigned int s = 0; s < n_species; s++ )
+      {
+        f[s] = _mass_sources[s];
+        f[n_species] -= _thermo.h( cache, s )*_mass_sources[s];
+      }
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  void ChemistrySourceMapping<CoeffType,ThermoEvaluator>::gradient( const std::vector<CoeffType>& x,
+                                                                    const std::vector<CoeffType>& /*f*/,
+                                                                    std::vector<CoeffType>& A )
+  {
+    // the inputs are the primitive variables of the Jacobian, in the same order
+    antioch_assert_equal_to( A.size(), _jacobian.n_equations()*_jacobian.n_variables() );
+
+    this->set_state( x );
+
+    // the sources come out of the same kinetics pass as the derivatives
+    _jacobian.compute( _rho_s, x[_chem_mixture.n_species()], _f_jacobian, A );
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  ReactorStateMapping<CoeffType,ThermoEvaluator>::ReactorStateMapping( HomogeneousReactor<CoeffType,ThermoEvaluator>& reactor,
+                                                                       const CoeffType dt )
+    : _reactor( reactor ),
+      _dt( dt ),
+      _perturbation( 1e-6 ),
+      _x_perturbed( reactor.n_species() + 2, 0 ),
+      _f_perturbed( reactor.n_species() + 1, 0 ),
+      _mass_fractions( reactor.n_species(), 0 )
+  {
+    antioch_assert_equal_to( reactor.type(), ReactorType::CONSTANT_PRESSURE );
+    antioch_assert_greater( dt, CoeffType(0) );
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  ReactorStateMapping<CoeffType,ThermoEvaluator>::~ReactorStateMapping()
+  {
+    return;
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  void ReactorStateMapping<CoeffType,ThermoEvaluator>::set_time_step( const CoeffType dt )
+  {
+    antioch_assert_greater( dt, CoeffType(0) );
+    _dt = dt;
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  void ReactorStateMapping<CoeffType,ThermoEvaluator>::set_perturbation( const CoeffType perturbation )
+  {
+    antioch_assert_greater( perturbation, CoeffType(0) );
+    _perturbation = perturbation;
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  unsigned int ReactorStateMapping<CoeffType,ThermoEvaluator>::n_inputs() const
+  {
+    return _reactor.n_species() + 2;
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  unsigned int ReactorStateMapping<CoeffType,ThermoEvaluator>::n_outputs() const
+  {
+    return _reactor.n_species() + 1;
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  void ReactorStateMapping<CoeffType,ThermoEvaluator>::evaluate( const std::vector<CoeffType>& x,
+                                                                 std::vector<CoeffType>& f )
+  {
+    const unsigned int n_species = _reactor.n_species();
+
+    antioch_assert_equal_to( x.size(), this->n_inputs() );
+    antioch_assert_equal_to( f.size(), this->n_outputs() );
+
+    for( unsigned int s = 0; s < n_species; s++ )
+      _mass_fractions[s] = x[s];
+    CoeffType T = x[n_species];
+
+    _reactor.set_pressure( x[n_species+1] );
+    _reactor.advance( _mass_fractions, T, _dt );
+
+    for( unsigned int s = 0; s < n_species; s++ )
+      f[s] = _mass_fractions[s];
+    f[n_species] = T;
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  void ReactorStateMapping<CoeffType,ThermoEvaluator>::gradient( const std::vector<CoeffType>& x,
+                                                                 const std::vector<CoeffType>& f,
+                                                                 std::vector<CoeffType>& A )
+  {
+    using std::abs;
+    using std::max;
+
+    const unsigned int n_inputs = this->n_inputs();
+    const unsigned int n_outputs = this->n_outputs();
+
+    antioch_assert_equal_to( f.size(), n_outputs );
+    antioch_assert_equal_to( A.size(), n_outputs*n_inputs );
+
+    _x_perturbed = x;
+    for( unsigned int j = 0; j < n_inputs; j++ )
+      {
+        const CoeffType dx = _perturbation*max( abs(x[j]), CoeffType(1) );
+        _x_perturbed[j] = x[j] + dx;
+
+        this->evaluate( _x_perturbed, _f_perturbed );
+
+        for( unsigned int i = 0; i < n_outputs; i++ )
+          A[i*n_inputs+j] = ( _f_perturbed[i] - f[i] )/dx;
+
+        _x_perturbed[j] = x[j];
+      }
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_CHEMISTRY_MAPPINGS_H
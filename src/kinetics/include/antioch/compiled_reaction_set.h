@@ -0,0 +1,1666 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+
+
+#ifndef ANTIOCH_COMPILED_REACTION_SET_H
+#define ANTIOCH_COMPILED_REACTION_SET_H
+
+// Antioch
+#include "antioch/antioch_asserts.h"
+#include "antioch/cmath_shims.h"
+#include "antioch/metaprogramming.h"
+#include "antioch/math_constants.h"
+#include "antioch/physical_constants.h"
+#include "antioch/vector_math.h"
+#include "antioch/kinetics_conditions.h"
+#include "antioch/reaction_set.h"
+#include "antioch/equilibrium_factors.h"
+
+// C++
+#include <algorithm>
+#include <vector>
+
+namespace Antioch
+{
+
+  //! Structure-of-arrays snapshot of a ReactionSet
+  /*!
+   * The reactions of a finished ReactionSet are regrouped by chemical
+   * process and kinetics model, the parameters of each group being stored
+   * in contiguous arrays. Each group is then evaluated in its own loop,
+   * without going through the switches of Reaction::compute_forward_rate_coefficient
+   * and KineticsType::operator().
+   *
+   * Elementary and three-body reactions with an analytical kinetics model
+   * are compiled. Lindemann and Troe falloff reactions (with or without
+   * third-body efficiencies) whose low and high pressure limits are
+   * analytical are packed by falloff model: the parameters of k_0, k_inf
+   * and of F_cent (alpha, T*, T**, T***) are stored in contiguous arrays,
+   * so that F_cent and its derivative, which depend on the temperature
+   * only, are evaluated for all the reactions and cells of a batch at
+   * once. The other reactions (duplicate, photochemical)
+   * are still evaluated through their Reaction object. The stoichiometry
+   * and partial orders of all reactions are flattened, and the rates of
+   * progress are computed with exactly the same operations as in
+   * Reaction::compute_rate_of_progress, so the results are bit-compatible
+   * with ReactionSet::compute_reaction_rates.
+   *
+   * The exponentials, logarithms and powers of compute_batch_reaction_rates
+   * are evaluated over whole arrays of cells with vector_exp, vector_log
+   * and vector_pow. By default they forward to <cmath> (MathAccuracy::LIBM)
+   * and the results stay bit-compatible; set_math_accuracy() switches to
+   * the vectorized kernels of vector_math.h, within 1 ulp (FULL) or about
+   * 1e-12 (FAST) of the <cmath> results.
+   *
+   * This is a snapshot: if the ReactionSet is modified afterwards (parameters,
+   * reactions added or removed), compile() must be called again.
+   *
+   * The rate table of the ReactionSet (ReactionSet::enable_rate_table) is
+   * not used: all the forward rate coefficients are evaluated from the
+   * kinetics models, and match those of the ReactionSet only within the
+   * table tolerance when one is enabled. There is no ActiveReactionSubset
+   * overload either, all the reactions are always evaluated.
+   */
+  template<typename CoeffType=double>
+  class CompiledReactionSet
+  {
+  public:
+
+    //! Constructor, compiles the reaction set.
+    CompiledReactionSet( const ReactionSet<CoeffType>& reaction_set );
+
+    ~CompiledReactionSet();
+
+    //! (Re)build the arrays from the reaction set.
+    void compile();
+
+    const ReactionSet<CoeffType>& reaction_set() const;
+
+    //! \returns the number of species.
+    unsigned int n_species() const;
+
+    //! \returns the number of reactions.
+    unsigned int n_reactions() const;
+
+    //! \returns the number of compiled (chemical process, kinetics model) groups.
+    unsigned int n_groups() const;
+
+    //! \returns the number of reactions evaluated through their Reaction object.
+    unsigned int n_generic_reactions() const;
+
+    //! \returns the number of falloff reactions evaluated from the packed falloff groups.
+    unsigned int n_falloff_reactions() const;
+
+    //! \returns the index in the reaction set of the i-th packed falloff reaction.
+    unsigned int falloff_reaction( unsigned int i ) const;
+
+    //! Accuracy of exp, log and pow in compute_batch_reaction_rates, LIBM by default.
+    void set_math_accuracy( MathAccuracy::MathAccuracy accuracy );
+
+    MathAccuracy::MathAccuracy math_accuracy() const;
+
+    //! Work arrays of the batch computations
+    /*!
+     * Resized on use for the batch at hand, so that after the first
+     * batch of a given size nothing is allocated anymore. Like
+     * EquilibriumFactors, one per thread.
+     */
+    struct BatchWork
+    {
+      std::vector<CoeffType> lnT, P0_RT, total_concentration;
+      std::vector<CoeffType> work, work2, work3, work4, powers;
+      std::vector<CoeffType> numerator_exponent, denominator_exponent;
+      std::vector<CoeffType> P0_RT_powers, exp_h, abs_h;
+      std::vector<CoeffType> cell_molar_densities;
+
+      //! packed falloff group, [i*n_cells + c]
+      std::vector<CoeffType> k0, kinf, M, F, dF_dT, dF_dM;
+      std::vector<CoeffType> E, Fcent, logs, logF;
+    };
+
+    //! Compute the rates of progress for each reaction
+    /*!
+     * Same interface and same results as ReactionSet::compute_reaction_rates.
+     */
+    template <typename StateType, typename VectorStateType, typename VectorReactionsType>
+    void compute_reaction_rates( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                 const VectorStateType& molar_densities,
+                                 const VectorStateType& h_RT_minus_s_R,
+                                 VectorReactionsType& net_reaction_rates ) const;
+
+    //! Compute the rates of progress for each reaction
+    /*! As above, with \p equilibrium_factors, built on reaction_set(), as work storage. */
+    template <typename StateType, typename VectorStateType, typename VectorReactionsType>
+    void compute_reaction_rates( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                 EquilibriumFactors<CoeffType,StateType>& equilibrium_factors,
+                                 const VectorStateType& molar_densities,
+                                 const VectorStateType& h_RT_minus_s_R,
+                                 VectorReactionsType& net_reaction_rates ) const;
+
+    //! Compute the rates of progress of a batch of cells
+    /*!
+     * The inputs are species-major, molar_densities[s*n_cells + c], the
+     * output is reaction-major, net_reaction_rates[rxn*n_cells + c]. The
+     * innermost loops run over contiguous cells so that they can be
+     * vectorized; each cell gets the same operations as compute_reaction_rates.
+     */
+    void compute_batch_reaction_rates( const unsigned int n_cells,
+                                       const std::vector<CoeffType>& T,
+                                       const std::vector<CoeffType>& molar_densities,
+                                       const std::vector<CoeffType>& h_RT_minus_s_R,
+                                       std::vector<CoeffType>& net_reaction_rates ) const;
+
+    //! Compute the rates of progress of a batch of cells
+    /*! As above, with \p batch_work as work storage. */
+    void compute_batch_reaction_rates( const unsigned int n_cells,
+                                       BatchWork& batch_work,
+                                       const std::vector<CoeffType>& T,
+                                       const std::vector<CoeffType>& molar_densities,
+                                       const std::vector<CoeffType>& h_RT_minus_s_R,
+                                       std::vector<CoeffType>& net_reaction_rates ) const;
+
+    //! Forward rate coefficients of the packed falloff reactions and their derivatives, for a batch of cells
+    /*!
+     * Same layouts as compute_batch_reaction_rates: the molar densities are
+     * species-major, the outputs reaction-major, [rxn*n_cells + c], and only the
+     * rows of the falloff reactions, falloff_reaction(i), are written.
+     * The derivative with respect to the molar densities is the one with
+     * respect to the third-body concentration [M], returned in \p dkfwd_dM:
+     * dkfwd_dX[s] = epsilon_s * dkfwd_dM, epsilon_s being the third-body
+     * efficiency of species s (1 for the falloff reactions without efficiencies).
+     * Same results as Reaction::compute_forward_rate_coefficient_and_derivatives,
+     * up to rounding.
+     */
+    void compute_batch_falloff_rate_coefficients_and_derivatives( const unsigned int n_cells,
+                                                                   const std::vector<CoeffType>& T,
+                                                                   const std::vector<CoeffType>& molar_densities,
+                                                                   std::vector<CoeffType>& kfwd,
+                                                                   std::vector<CoeffType>& dkfwd_dT,
+                                                                   std::vector<CoeffType>& dkfwd_dM ) const;
+
+  private:
+
+    CompiledReactionSet();
+
+    //! Reactions sharing a chemical process and a kinetics model
+    /*!
+     * Only the parameters used by the kinetics model are filled,
+     * the efficiencies are stored only for three-body reactions,
+     * as the non-unity corrections of reaction i in
+     * [efficiency_offsets[i],efficiency_offsets[i+1]).
+     */
+    struct RateGroup
+    {
+      ReactionType::ReactionType         type;
+      KineticsModel::KineticsModel       model;
+      std::vector<unsigned int>          reactions;
+      std::vector<CoeffType>             Cf;
+      std::vector<CoeffType>             eta;
+      std::vector<CoeffType>             Ea;
+      std::vector<CoeffType>             D;
+      std::vector<unsigned int>          efficiency_offsets;
+      std::vector<unsigned int>          efficiency_species;
+      std::vector<CoeffType>             efficiency_values;
+    };
+
+    //! Falloff reactions sharing a falloff model
+    /*!
+     * k_0 and k_inf are stored in the Van't Hoff form Cf*exp(eta*ln(T) - Ea/T + D*T),
+     * the parameters unused by the kinetics model being zero, which gives
+     * exactly the values of the other analytical models. The efficiencies
+     * are stored for the three-body falloff reactions only, as in RateGroup.
+     * T2_weight is 0 for the Troe reactions without T**, for which T2 is 0.
+     */
+    struct FalloffGroup
+    {
+      bool                               troe;
+      std::vector<unsigned int>          reactions;
+      std::vector<CoeffType>             Cf_0, eta_0, Ea_0, D_0;
+      std::vector<CoeffType>             Cf_inf, eta_inf, Ea_inf, D_inf;
+      std::vector<CoeffType>             alpha, T1, T2, T3, T2_weight;
+      std::vector<unsigned int>          efficiency_offsets;
+      std::vector<unsigned int>          efficiency_species;
+      std::vector<CoeffType>             efficiency_values;
+    };
+
+    //! true if the reaction can be compiled into a RateGroup
+    bool is_compilable( const Reaction<CoeffType>& reaction ) const;
+
+    //! true if the reaction can be packed into a FalloffGroup
+    bool is_falloff_compilable( const Reaction<CoeffType>& reaction ) const;
+
+    //! add the reaction to its group, creating the group if needed
+    void add_to_group( unsigned int rxn );
+
+    //! add the falloff reaction to its group, creating the group if needed
+    void add_to_falloff_group( unsigned int rxn );
+
+    //! rate *= X^order, by repeated multiplication for integer orders as in Reaction
+    template <typename StateType>
+    static void multiply_partial_order_power( StateType& rate,
+                                              const StateType& X,
+                                              const CoeffType order,
+                                              const unsigned int integer_order );
+
+    //! Forward rate coefficients of the reactions of a group
+    template <typename StateType, typename VectorStateType, typename VectorReactionsType>
+    void compute_forward_rate_coefficients( const RateGroup& group,
+                                            const KineticsConditions<StateType,VectorStateType>& conditions,
+                                            const VectorStateType& molar_densities,
+                                            const StateType& total_concentration,
+                                            VectorReactionsType& kfwd ) const;
+
+    //! Forward rate coefficients of the reactions of a falloff group
+    template <typename StateType, typename VectorStateType, typename VectorReactionsType>
+    void compute_falloff_rate_coefficients( const FalloffGroup& group,
+                                            const KineticsConditions<StateType,VectorStateType>& conditions,
+                                            const VectorStateType& molar_densities,
+                                            const StateType& total_concentration,
+                                            VectorReactionsType& kfwd ) const;
+
+    //! Forward rate coefficients of the reactions of a falloff group, for a batch of cells
+    /*! The derivatives are computed along if \p dkfwd_dT and \p dkfwd_dM are not NULL. */
+    void compute_batch_falloff_rate_coefficients( const FalloffGroup& group,
+                                                  const unsigned int n_cells,
+                                                  BatchWork& batch_work,
+                                                  const CoeffType* T,
+                                                  const CoeffType* lnT,
+                                                  const CoeffType* molar_densities,
+                                                  const CoeffType* total_concentration,
+                                                  CoeffType* kfwd,
+                                                  CoeffType* dkfwd_dT,
+                                                  CoeffType* dkfwd_dM ) const;
+
+    //! Forward rate coefficients of the reactions of a group, for a batch of cells
+    void compute_batch_forward_rate_coefficients( const RateGroup& group,
+                                                  const unsigned int n_cells,
+                                                  const CoeffType* T,
+                                                  const CoeffType* lnT,
+                                                  const CoeffType* molar_densities,
+                                                  const CoeffType* total_concentration,
+                                                  CoeffType* M,
+                                                  CoeffType* kfwd ) const;
+
+    const ReactionSet<CoeffType>& _reaction_set;
+
+    std::vector<RateGroup> _groups;
+
+    std::vector<FalloffGroup> _falloff_groups;
+
+    std::vector<unsigned int> _falloff_reactions;
+
+    std::vector<unsigned int> _generic_reactions;
+
+    //! reactions split by reversibility
+    std::vector<unsigned int> _irreversible_reactions;
+    std::vector<unsigned int> _reversible_reactions;
+
+    //! flattened reactants, reaction rxn owns [_reactant_offsets[rxn],_reactant_offsets[rxn+1])
+    std::vector<unsigned int> _reactant_offsets;
+    std::vector<unsigned int> _reactant_ids;
+    std::vector<CoeffType>    _reactant_stoichiometry;
+    std::vector<CoeffType>    _reactant_partial_orders;
+    std::vector<unsigned int> _reactant_integer_orders;
+
+    //! flattened products, reaction rxn owns [_product_offsets[rxn],_product_offsets[rxn+1])
+    std::vector<unsigned int> _product_offsets;
+    std::vector<unsigned int> _product_ids;
+    std::vector<CoeffType>    _product_stoichiometry;
+    std::vector<CoeffType>    _product_partial_orders;
+    std::vector<unsigned int> _product_integer_orders;
+
+    std::vector<int>          _gamma;
+    std::vector<CoeffType>    _max_rate;
+
+    //! range of _gamma, 0 included
+    int _min_gamma;
+    int _max_gamma;
+
+    //! Scaling for equilibrium constant
+    const CoeffType _P0_R;
+
+    MathAccuracy::MathAccuracy _math_accuracy;
+  };
+
+  /* ------------------------- Inline Functions -------------------------*/
+  template<typename CoeffType>
+  inline
+  CompiledReactionSet<CoeffType>::CompiledReactionSet( const ReactionSet<CoeffType>& reaction_set )
+    : _reaction_set(reaction_set),
+      _min_gamma(0),
+      _max_gamma(0),
+      _P0_R(1.0e5/Constants::R_universal<CoeffType>()), //SI, as in ReactionSet
+      _math_accuracy(MathAccuracy::LIBM)
+  {
+    this->compile();
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  CompiledReactionSet<CoeffType>::~CompiledReactionSet()
+  {
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  const ReactionSet<CoeffType>& CompiledReactionSet<CoeffType>::reaction_set() const
+  {
+    return _reaction_set;
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int CompiledReactionSet<CoeffType>::n_species() const
+  {
+    return _reaction_set.n_species();
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int CompiledReactionSet<CoeffType>::n_reactions() const
+  {
+    return _gamma.size();
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int CompiledReactionSet<CoeffType>::n_groups() const
+  {
+    return _groups.size();
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int CompiledReactionSet<CoeffType>::n_generic_reactions() const
+  {
+    return _generic_reactions.size();
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int CompiledReactionSet<CoeffType>::n_falloff_reactions() const
+  {
+    return _falloff_reactions.size();
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int CompiledReactionSet<CoeffType>::falloff_reaction( unsigned int i ) const
+  {
+    antioch_assert_less( i, _falloff_reactions.size() );
+    return _falloff_reactions[i];
+  }
+
+  template<typename CoeffType>
+  inline
+  void CompiledReactionSet<CoeffType>::set_math_accuracy( MathAccuracy::MathAccuracy accuracy )
+  {
+    _math_accuracy = accuracy;
+  }
+
+  template<typename CoeffType>
+  inline
+  MathAccuracy::MathAccuracy CompiledReactionSet<CoeffType>::math_accuracy() const
+  {
+    return _math_accuracy;
+  }
+
+  template<typename CoeffType>
+  inline
+  bool CompiledReactionSet<CoeffType>::is_compilable( const Reaction<CoeffType>& reaction ) const
+  {
+    if( reaction.type() != ReactionType::ELEMENTARY &&
+        reaction.type() != ReactionType::THREE_BODY )
+      return false;
+
+    if( reaction.n_rate_constants() != 1 )
+      return false;
+
+    return reaction.forward_rate().type() != KineticsModel::PHOTOCHEM;
+  }
+
+  template<typename CoeffType>
+  inline
+  bool CompiledReactionSet<CoeffType>::is_falloff_compilable( const Reaction<CoeffType>& reaction ) const
+  {
+    if( reaction.type() != ReactionType::LINDEMANN_FALLOFF &&
+        reaction.type() != ReactionType::TROE_FALLOFF &&
+        reaction.type() != ReactionType::LINDEMANN_FALLOFF_THREE_BODY &&
+        reaction.type() != ReactionType::TROE_FALLOFF_THREE_BODY )
+      return false;
+
+    if( reaction.n_rate_constants() != 2 )
+      return false;
+
+    return reaction.forward_rate(0).type() != KineticsModel::PHOTOCHEM &&
+           reaction.forward_rate(1).type() != KineticsModel::PHOTOCHEM;
+  }
+
+  template<typename CoeffType>
+  template<typename StateType>
+  inline
+  void CompiledReactionSet<CoeffType>::multiply_partial_order_power( StateType& rate,
+                                                                     const StateType& X,
+                                                                     const CoeffType order,
+                                                                     const unsigned int integer_order )
+  {
+    if( integer_order )
+      for( unsigned int n = 0; n < integer_order; n++ )
+        rate *= X;
+    else
+      rate *= ant_pow( X, order );
+  }
+
+  template<typename CoeffType>
+  inline
+  void CompiledReactionSet<CoeffType>::add_to_group( unsigned int rxn )
+  {
+    const Reaction<CoeffType>& reaction = _reaction_set.reaction(rxn);
+    const KineticsType<CoeffType>& rate = reaction.forward_rate();
+
+    unsigned int g = 0;
+    for( ; g < _groups.size(); g++ )
+      {
+        if( _groups[g].type == reaction.type() && _groups[g].model == rate.type() )
+          break;
+      }
+
+    if( g == _groups.size() )
+      {
+        _groups.push_back( RateGroup() );
+        _groups.back().type  = reaction.type();
+        _groups.back().model = rate.type();
+        _groups.back().efficiency_offsets.assign(1,0);
+      }
+
+    RateGroup& group = _groups[g];
+    group.reactions.push_back(rxn);
+
+    // Reduced parameters, exactly as used by the rate objects
+    switch( rate.type() )
+      {
+      case(KineticsModel::CONSTANT):
+        {
+          group.Cf.push_back( static_cast<const ConstantRate<CoeffType>&>(rate).Cf() );
+        }
+        break;
+
+      case(KineticsModel::HERCOURT_ESSEN):
+        {
+          const HercourtEssenRate<CoeffType>& he = static_cast<const HercourtEssenRate<CoeffType>&>(rate);
+          group.Cf.push_back( he.Cf() );
+          group.eta.push_back( he.eta() );
+        }
+        break;
+
+      case(KineticsModel::BERTHELOT):
+        {
+          const BerthelotRate<CoeffType>& berth = static_cast<const BerthelotRate<CoeffType>&>(rate);
+          group.Cf.push_back( berth.Cf() );
+          group.D.push_back( berth.D() );
+        }
+        break;
+
+      case(KineticsModel::ARRHENIUS):
+        {
+          const ArrheniusRate<CoeffType>& arr = static_cast<const ArrheniusRate<CoeffType>&>(rate);
+          group.Cf.push_back( arr.Cf() );
+          group.Ea.push_back( arr.Ea_K() );
+        }
+        break;
+
+      case(KineticsModel::BHE):
+        {
+          const BerthelotHercourtEssenRate<CoeffType>& bhe = static_cast<const BerthelotHercourtEssenRate<CoeffType>&>(rate);
+          group.Cf.push_back( bhe.Cf() );
+          group.eta.push_back( bhe.eta() );
+          group.D.push_back( bhe.D() );
+        }
+        break;
+
+      case(KineticsModel::KOOIJ):
+        {
+          const KooijRate<CoeffType>& kooij = static_cast<const KooijRate<CoeffType>&>(rate);
+          group.Cf.push_back( kooij.Cf() );
+          group.eta.push_back( kooij.eta() );
+          group.Ea.push_back( kooij.Ea_K() );
+        }
+        break;
+
+      case(KineticsModel::VANTHOFF):
+        {
+          const VantHoffRate<CoeffType>& vh = static_cast<const VantHoffRate<CoeffType>&>(rate);
+          group.Cf.push_back( vh.Cf() );
+          group.eta.push_back( vh.eta() );
+          group.Ea.push_back( vh.Ea_K() );
+          group.D.push_back( vh.D() );
+        }
+        break;
+
+      default:
+        {
+          antioch_error();
+        }
+      } // switch( rate.type() )
+
+    if( reaction.type() == ReactionType::THREE_BODY )
+      {
+        for( unsigned int k = 0; k < reaction.n_efficiency_corrections(); k++ )
+          {
+            group.efficiency_species.push_back( reaction.efficiency_correction_species(k) );
+            group.efficiency_values.push_back( reaction.efficiency_correction(k) );
+          }
+        group.efficiency_offsets.push_back( group.efficiency_species.size() );
+      }
+
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  void CompiledReactionSet<CoeffType>::add_to_falloff_group( unsigned int rxn )
+  {
+    const Reaction<CoeffType>& reaction = _reaction_set.reaction(rxn);
+    const bool troe = ( reaction.type() == ReactionType::TROE_FALLOFF ||
+                        reaction.type() == ReactionType::TROE_FALLOFF_THREE_BODY );
+
+    unsigned int g = 0;
+    for( ; g < _falloff_groups.size(); g++ )
+      {
+        if( _falloff_groups[g].troe == troe )
+          break;
+      }
+
+    if( g == _falloff_groups.size() )
+      {
+        _falloff_groups.push_back( FalloffGroup() );
+        _falloff_groups.back().troe = troe;
+        _falloff_groups.back().efficiency_offsets.assign(1,0);
+      }
+
+    FalloffGroup& group = _falloff_groups[g];
+    group.reactions.push_back(rxn);
+    _falloff_reactions.push_back(rxn);
+
+    CoeffType Cf, eta, Ea, D;
+    vanthoff_parameters_of_rate( reaction.forward_rate(0), Cf, eta, Ea, D );
+    group.Cf_0.push_back(Cf);
+    group.eta_0.push_back(eta);
+    group.Ea_0.push_back(Ea);
+    group.D_0.push_back(D);
+
+    vanthoff_parameters_of_rate( reaction.forward_rate(1), Cf, eta, Ea, D );
+    group.Cf_inf.push_back(Cf);
+    group.eta_inf.push_back(eta);
+    group.Ea_inf.push_back(Ea);
+    group.D_inf.push_back(D);
+
+    if( troe )
+      {
+        const TroeFalloff<CoeffType>& F = ( reaction.type() == ReactionType::TROE_FALLOFF ) ?
+          static_cast<const FalloffReaction<CoeffType,TroeFalloff<CoeffType> >&>(reaction).F() :
+          static_cast<const FalloffThreeBodyReaction<CoeffType,TroeFalloff<CoeffType> >&>(reaction).F();
+
+        // TroeFalloff skips exp(-T**/T) when T** is not given
+        const bool has_T2 = ( F.get_T2() != std::numeric_limits<CoeffType>::max() );
+
+        group.alpha.push_back( F.get_alpha() );
+        group.T1.push_back( F.get_T1() );
+        group.T2.push_back( has_T2 ? F.get_T2() : 0 );
+        group.T3.push_back( F.get_T3() );
+        group.T2_weight.push_back( has_T2 ? 1 : 0 );
+      }
+
+    if( reaction.type() == ReactionType::LINDEMANN_FALLOFF_THREE_BODY ||
+        reaction.type() == ReactionType::TROE_FALLOFF_THREE_BODY )
+      {
+        for( unsigned int k = 0; k < reaction.n_efficiency_corrections(); k++ )
+          {
+            group.efficiency_species.push_back( reaction.efficiency_correction_species(k) );
+            group.efficiency_values.push_back( reaction.efficiency_correction(k) );
+          }
+      }
+    group.efficiency_offsets.push_back( group.efficiency_species.size() );
+
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  void CompiledReactionSet<CoeffType>::compile()
+  {
+    _groups.clear();
+    _falloff_groups.clear();
+    _falloff_reactions.clear();
+    _generic_reactions.clear();
+    _irreversible_reactions.clear();
+    _reversible_reactions.clear();
+
+    _reactant_offsets.assign(1,0);
+    _reactant_ids.clear();
+    _reactant_stoichiometry.clear();
+    _reactant_partial_orders.clear();
+    _reactant_integer_orders.clear();
+
+    _product_offsets.assign(1,0);
+    _product_ids.clear();
+    _product_stoichiometry.clear();
+    _product_partial_orders.clear();
+    _product_integer_orders.clear();
+
+    _gamma.clear();
+    _max_rate.clear();
+    _min_gamma = 0;
+    _max_gamma = 0;
+
+    for( unsigned int rxn = 0; rxn < _reaction_set.n_reactions(); rxn++ )
+      {
+        const Reaction<CoeffType>& reaction = _reaction_set.reaction(rxn);
+        antioch_assert( reaction.initialized() );
+
+        if( this->is_compilable(reaction) )
+          this->add_to_group(rxn);
+        else if( this->is_falloff_compilable(reaction) )
+          this->add_to_falloff_group(rxn);
+        else
+          _generic_reactions.push_back(rxn);
+
+        ( reaction.reversible() ) ? _reversible_reactions.push_back(rxn) :
+                                    _irreversible_reactions.push_back(rxn);
+
+        for( unsigned int r = 0; r < reaction.n_reactants(); r++ )
+          {
+            _reactant_ids.push_back( reaction.reactant_id(r) );
+            _reactant_stoichiometry.push_back( static_cast<CoeffType>(reaction.reactant_stoichiometric_coefficient(r)) );
+            _reactant_partial_orders.push_back( reaction.reactant_partial_order(r) );
+            _reactant_integer_orders.push_back( reaction.reactant_integer_partial_order(r) );
+          }
+        _reactant_offsets.push_back( _reactant_ids.size() );
+
+        for( unsigned int p = 0; p < reaction.n_products(); p++ )
+          {
+            _product_ids.push_back( reaction.product_id(p) );
+            _product_stoichiometry.push_back( static_cast<CoeffType>(reaction.product_stoichiometric_coefficient(p)) );
+            _product_partial_orders.push_back( reaction.product_partial_order(p) );
+            _product_integer_orders.push_back( reaction.product_integer_partial_order(p) );
+          }
+        _product_offsets.push_back( _product_ids.size() );
+
+        _gamma.push_back( reaction.gamma() );
+        _max_rate.push_back( reaction.maximum_rate() );
+
+        _min_gamma = std::min( _min_gamma, _gamma.back() );
+        _max_gamma = std::max( _max_gamma, _gamma.back() );
+      }
+
+    return;
+  }
+
+  template<typename CoeffType>
+  template <typename StateType, typename VectorStateType, typename VectorReactionsType>
+  inline
+  void CompiledReactionSet<CoeffType>::compute_forward_rate_coefficients( const RateGroup& group,
+                                                                          const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                                          const VectorStateType& molar_densities,
+                                                                          const StateType& total_concentration,
+                                                                          VectorReactionsType& kfwd ) const
+  {
+    const StateType& T   = conditions.T();
+    const StateType& lnT = conditions.temp_cache().lnT;
+    const unsigned int n = group.reactions.size();
+
+    // One switch per group, the loops themselves are branch-free.
+    // The expressions are those of the KineticsType derived classes.
+    switch( group.model )
+      {
+      case(KineticsModel::CONSTANT):
+        {
+          for( unsigned int i = 0; i < n; i++ )
+            kfwd[group.reactions[i]] = constant_clone(T,group.Cf[i]);
+        }
+        break;
+
+      case(KineticsModel::HERCOURT_ESSEN):
+        {
+          for( unsigned int i = 0; i < n; i++ )
+            kfwd[group.reactions[i]] = group.Cf[i] * ant_exp(group.eta[i] * lnT);
+        }
+        break;
+
+      case(KineticsModel::BERTHELOT):
+        {
+          for( unsigned int i = 0; i < n; i++ )
+            kfwd[group.reactions[i]] = group.Cf[i] * ant_exp(group.D[i] * T);
+        }
+        break;
+
+      case(KineticsModel::ARRHENIUS):
+        {
+          for( unsigned int i = 0; i < n; i++ )
+            kfwd[group.reactions[i]] = group.Cf[i] * ant_exp(- group.Ea[i]/T);
+        }
+        break;
+
+      case(KineticsModel::BHE):
+        {
+          for( unsigned int i = 0; i < n; i++ )
+            kfwd[group.reactions[i]] = group.Cf[i] * ant_exp(group.eta[i] * lnT + group.D[i]*T);
+        }
+        break;
+
+      case(KineticsModel::KOOIJ):
+        {
+          for( unsigned int i = 0; i < n; i++ )
+            kfwd[group.reactions[i]] = group.Cf[i] * ant_exp(group.eta[i] * lnT - group.Ea[i]/T);
+        }
+        break;
+
+      case(KineticsModel::VANTHOFF):
+        {
+          for( unsigned int i = 0; i < n; i++ )
+            kfwd[group.reactions[i]] = group.Cf[i] * ant_exp(group.eta[i] * lnT - group.Ea[i]/T + group.D[i]*T);
+        }
+        break;
+
+      default:
+        {
+          antioch_error();
+        }
+      } // switch( group.model )
+
+    // k(T,[M]) = (sum eff_i * C_i) * alpha(T), as Reaction::third_body_concentration
+    if( group.type == ReactionType::THREE_BODY )
+      {
+        for( unsigned int i = 0; i < n; i++ )
+          {
+            StateType M = total_concentration;
+            for( unsigned int k = group.efficiency_offsets[i]; k < group.efficiency_offsets[i+1]; k++ )
+              M += ( group.efficiency_values[k] - 1 ) * molar_densities[group.efficiency_species[k]];
+
+            M *= kfwd[group.reactions[i]];
+            kfwd[group.reactions[i]] = M;
+          }
+      }
+
+    return;
+  }
+
+  template<typename CoeffType>
+  template <typename StateType, typename VectorStateType, typename VectorReactionsType>
+  inline
+  void CompiledReactionSet<CoeffType>::compute_falloff_rate_coefficients( const FalloffGroup& group,
+                                                                          const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                                          const VectorStateType& molar_densities,
+                                                                          const StateType& total_concentration,
+                                                                          VectorReactionsType& kfwd ) const
+  {
+    const StateType& T   = conditions.T();
+    const StateType& lnT = conditions.temp_cache().lnT;
+
+    // as in TroeFalloff
+    const CoeffType c_coeff = CoeffType(0.67L) * Constants::log10_to_log<CoeffType>();
+    const CoeffType n_coeff = CoeffType(1.27L) * Constants::log10_to_log<CoeffType>();
+    const CoeffType d = CoeffType(0.14L);
+
+    // The expressions are those of FalloffReaction, FalloffThreeBodyReaction,
+    // TroeFalloff and of the KineticsType derived classes
+    for( unsigned int i = 0; i < group.reactions.size(); i++ )
+      {
+        const StateType k0   = group.Cf_0[i] * ant_exp(group.eta_0[i] * lnT - group.Ea_0[i]/T + group.D_0[i]*T);
+        const StateType kinf = group.Cf_inf[i] * ant_exp(group.eta_inf[i] * lnT - group.Ea_inf[i]/T + group.D_inf[i]*T);
+
+        StateType M = total_concentration;
+        for( unsigned int k = group.efficiency_offsets[i]; k < group.efficiency_offsets[i+1]; k++ )
+          M += ( group.efficiency_values[k] - 1 ) * molar_densities[group.efficiency_species[k]];
+
+        StateType k = k0 / (ant_pow(M,-1) + k0 / kinf);
+
+        if( group.troe )
+          {
+            StateType Fcent = (1 - group.alpha[i]) * ant_exp(-T/group.T3[i]) + group.alpha[i] * ant_exp(-T/group.T1[i]);
+            if( group.T2_weight[i] != 0 )
+              Fcent += ant_exp(-group.T2[i]/T);
+            antioch_assert(!has_nan(Fcent));
+
+            const StateType logFcent = ant_log(Fcent);
+            const StateType Pr = M * k0/kinf;
+            const StateType c = - CoeffType(0.4L) - c_coeff * logFcent;
+            const StateType n = CoeffType(0.75L) - n_coeff * logFcent;
+            const StateType log10Pr = Constants::log10_to_log<CoeffType>() * ant_log(Pr);
+            const StateType logF = logFcent/(1 + ant_pow(((log10Pr + c)/(n - d*(log10Pr + c) )),2) );
+
+            typename Antioch::rebind<StateType, bool>::type Fcent_is_nonzero = (Fcent != Antioch::zero_clone(T));
+            k *= Antioch::if_else(Fcent_is_nonzero, StateType(ant_exp(logF)), Antioch::zero_clone(T));
+          }
+
+        antioch_assert(!has_nan(k));
+        kfwd[group.reactions[i]] = k;
+      }
+
+    return;
+  }
+
+  template<typename CoeffType>
+  template <typename StateType, typename VectorStateType, typename VectorReactionsType>
+  inline
+  void CompiledReactionSet<CoeffType>::compute_reaction_rates( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                               const VectorStateType& molar_densities,
+                                                               const VectorStateType& h_RT_minus_s_R,
+                                                               VectorReactionsType& net_reaction_rates ) const
+  {
+    EquilibriumFactors<CoeffType,StateType> equilibrium_factors( _reaction_set, conditions.T() );
+
+    this->compute_reaction_rates( conditions, equilibrium_factors, molar_densities, h_RT_minus_s_R,
+                                  net_reaction_rates );
+  }
+
+  template<typename CoeffType>
+  template <typename StateType, typename VectorStateType, typename VectorReactionsType>
+  inline
+  void CompiledReactionSet<CoeffType>::compute_reaction_rates( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                               EquilibriumFactors<CoeffType,StateType>& equilibrium_factors,
+                                                               const VectorStateType& molar_densities,
+                                                               const VectorStateType& h_RT_minus_s_R,
+                                                               VectorReactionsType& net_reaction_rates ) const
+  {
+    antioch_assert_equal_to( net_reaction_rates.size(), this->n_reactions() );
+    antioch_assert_equal_to( molar_densities.size(), this->n_species() );
+    antioch_assert_equal_to( h_RT_minus_s_R.size(), this->n_species() );
+
+    // [M] before the efficiency corrections, as in ReactionSet
+    const StateType total_concentration = Antioch::total_concentration<StateType>( molar_densities );
+
+    // forward rate coefficients, stored in place
+    for( unsigned int g = 0; g < _groups.size(); g++ )
+      this->compute_forward_rate_coefficients( _groups[g], conditions, molar_densities, total_concentration,
+                                               net_reaction_rates );
+
+    for( unsigned int g = 0; g < _falloff_groups.size(); g++ )
+      this->compute_falloff_rate_coefficients( _falloff_groups[g], conditions, molar_densities, total_concentration,
+                                               net_reaction_rates );
+
+    for( unsigned int i = 0; i < _generic_reactions.size(); i++ )
+      {
+        const unsigned int rxn = _generic_reactions[i];
+        net_reaction_rates[rxn] =
+          _reaction_set.reaction(rxn).compute_forward_rate_coefficient(molar_densities,conditions,total_concentration);
+      }
+
+    // Rfwd only
+    for( unsigned int i = 0; i < _irreversible_reactions.size(); i++ )
+      {
+        const unsigned int rxn = _irreversible_reactions[i];
+        antioch_assert(!has_nan(net_reaction_rates[rxn]));
+
+        for( unsigned int r = _reactant_offsets[rxn]; r < _reactant_offsets[rxn+1]; r++ )
+          this->multiply_partial_order_power( net_reaction_rates[rxn], molar_densities[_reactant_ids[r]],
+                                              _reactant_partial_orders[r], _reactant_integer_orders[r] );
+      }
+
+    // species exponentials and powers of P0/(RT), as in ReactionSet
+    equilibrium_factors.update( conditions.T(), h_RT_minus_s_R );
+
+    // Rfwd - Rbkwd
+    for( unsigned int i = 0; i < _reversible_reactions.size(); i++ )
+      {
+        const unsigned int rxn = _reversible_reactions[i];
+        const StateType kfwd = net_reaction_rates[rxn];
+        antioch_assert(!has_nan(kfwd));
+
+        StateType kfwd_times_reactants = kfwd;
+        for( unsigned int r = _reactant_offsets[rxn]; r < _reactant_offsets[rxn+1]; r++ )
+          this->multiply_partial_order_power( kfwd_times_reactants, molar_densities[_reactant_ids[r]],
+                                              _reactant_partial_orders[r], _reactant_integer_orders[r] );
+
+        // Keq = (P0/(RT))^gamma exp(reactants - products), same operations as Reaction
+        StateType Keq = equilibrium_factors.P0_RT_power(_gamma[rxn]);
+        CoeffType numerator_exponent = 0;
+        for( unsigned int r = _reactant_offsets[rxn]; r < _reactant_offsets[rxn+1]; r++ )
+          {
+            const StateType& factor = equilibrium_factors.exp_h_RT_minus_s_R(_reactant_ids[r]);
+            for( unsigned int n = 0; n < static_cast<unsigned int>(_reactant_stoichiometry[r]); n++ )
+              Keq *= factor;
+            numerator_exponent += ( _reactant_stoichiometry[r] * equilibrium_factors.abs_h_RT_minus_s_R(_reactant_ids[r]) );
+          }
+
+        StateType denominator = Antioch::constant_clone(Keq,1);
+        CoeffType denominator_exponent = 0;
+        for( unsigned int p = _product_offsets[rxn]; p < _product_offsets[rxn+1]; p++ )
+          {
+            const StateType& factor = equilibrium_factors.exp_h_RT_minus_s_R(_product_ids[p]);
+            for( unsigned int n = 0; n < static_cast<unsigned int>(_product_stoichiometry[p]); n++ )
+              denominator *= factor;
+            denominator_exponent += ( _product_stoichiometry[p] * equilibrium_factors.abs_h_RT_minus_s_R(_product_ids[p]) );
+          }
+
+        if( numerator_exponent < equilibrium_factors.max_exponent() &&
+            denominator_exponent < equilibrium_factors.max_exponent() )
+          Keq /= denominator;
+        else
+          {
+            const unsigned int r0 = _reactant_offsets[rxn];
+            StateType exppower = ( _reactant_stoichiometry[r0] * h_RT_minus_s_R[_reactant_ids[r0]] );
+            for( unsigned int r = r0 + 1; r < _reactant_offsets[rxn+1]; r++ )
+              exppower += ( _reactant_stoichiometry[r] * h_RT_minus_s_R[_reactant_ids[r]] );
+            for( unsigned int p = _product_offsets[rxn]; p < _product_offsets[rxn+1]; p++ )
+              exppower -= ( _product_stoichiometry[p] * h_RT_minus_s_R[_product_ids[p]] );
+
+            Keq = equilibrium_factors.P0_RT_power(_gamma[rxn]) * ant_exp(exppower);
+          }
+        antioch_assert(!has_nan(Keq));
+
+        StateType kbkwd_times_products = kfwd/Keq;
+        for( unsigned int p = _product_offsets[rxn]; p < _product_offsets[rxn+1]; p++ )
+          this->multiply_partial_order_power( kbkwd_times_products, molar_densities[_product_ids[p]],
+                                              _product_partial_orders[p], _product_integer_orders[p] );
+
+        // Same treatment of a zero equilibrium constant as in Reaction
+        typename Antioch::rebind<StateType,bool>::type is_nonzero = (Keq != Antioch::zero_clone(Keq));
+        kbkwd_times_products =
+          Antioch::if_else(is_nonzero, kbkwd_times_products,
+                           Antioch::constant_clone(Keq, _max_rate[rxn]));
+
+        net_reaction_rates[rxn] = kfwd_times_reactants - kbkwd_times_products;
+      }
+
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  void CompiledReactionSet<CoeffType>::compute_batch_forward_rate_coefficients( const RateGroup& group,
+                                                                                const unsigned int n_cells,
+                                                                                const CoeffType* T,
+                                                                                const CoeffType* lnT,
+                                                                                const CoeffType* molar_densities,
+                                                                                const CoeffType* total_concentration,
+                                                                                CoeffType* M,
+                                                                                CoeffType* kfwd ) const
+  {
+    const unsigned int n = group.reactions.size();
+
+    // Same expressions as compute_forward_rate_coefficients, cell loop innermost,
+    // the exponent is stored in k and exponentiated over all the cells at once
+    for( unsigned int i = 0; i < n; i++ )
+      {
+        CoeffType* k = kfwd + group.reactions[i]*n_cells;
+        const CoeffType Cf = group.Cf[i];
+
+        switch( group.model )
+          {
+          case(KineticsModel::CONSTANT):
+            {
+              for( unsigned int c = 0; c < n_cells; c++ )
+                k[c] = Cf;
+            }
+            break;
+
+          case(KineticsModel::HERCOURT_ESSEN):
+            {
+              const CoeffType eta = group.eta[i];
+              for( unsigned int c = 0; c < n_cells; c++ )
+                k[c] = eta * lnT[c];
+              vector_exp( k, k, n_cells, _math_accuracy );
+              for( unsigned int c = 0; c < n_cells; c++ )
+                k[c] = Cf * k[c];
+            }
+            break;
+
+          case(KineticsModel::BERTHELOT):
+            {
+              const CoeffType D = group.D[i];
+              for( unsigned int c = 0; c < n_cells; c++ )
+                k[c] = D * T[c];
+              vector_exp( k, k, n_cells, _math_accuracy );
+              for( unsigned int c = 0; c < n_cells; c++ )
+                k[c] = Cf * k[c];
+            }
+            break;
+
+          case(KineticsModel::ARRHENIUS):
+            {
+              const CoeffType Ea = group.Ea[i];
+              for( unsigned int c = 0; c < n_cells; c++ )
+                k[c] = - Ea/T[c];
+              vector_exp( k, k, n_cells, _math_accuracy );
+              for( unsigned int c = 0; c < n_cells; c++ )
+                k[c] = Cf * k[c];
+            }
+            break;
+
+          case(KineticsModel::BHE):
+            {
+              const CoeffType eta = group.eta[i];
+              const CoeffType D = group.D[i];
+              for( unsigned int c = 0; c < n_cells; c++ )
+                k[c] = eta * lnT[c] + D*T[c];
+              vector_exp( k, k, n_cells, _math_accuracy );
+              for( unsigned int c = 0; c < n_cells; c++ )
+                k[c] = Cf * k[c];
+            }
+            break;
+
+          case(KineticsModel::KOOIJ):
+            {
+              const CoeffType eta = group.eta[i];
+              const CoeffType Ea = group.Ea[i];
+              for( unsigned int c = 0; c < n_cells; c++ )
+                k[c] = eta * lnT[c] - Ea/T[c];
+              vector_exp( k, k, n_cells, _math_accuracy );
+              for( unsigned int c = 0; c < n_cells; c++ )
+                k[c] = Cf * k[c];
+            }
+            break;
+
+          case(KineticsModel::VANTHOFF):
+            {
+              const CoeffType eta = group.eta[i];
+              const CoeffType Ea = group.Ea[i];
+              const CoeffType D = group.D[i];
+              for( unsigned int c = 0; c < n_cells; c++ )
+                k[c] = eta * lnT[c] - Ea/T[c] + D*T[c];
+              vector_exp( k, k, n_cells, _math_accuracy );
+              for( unsigned int c = 0; c < n_cells; c++ )
+                k[c] = Cf * k[c];
+            }
+            break;
+
+          default:
+            {
+              antioch_error();
+            }
+          } // switch( group.model )
+
+        // k(T,[M]) = (sum eff_i * C_i) * alpha(T)
+        if( group.type == ReactionType::THREE_BODY )
+          {
+            for( unsigned int c = 0; c < n_cells; c++ )
+              M[c] = total_concentration[c];
+
+            for( unsigned int k = group.efficiency_offsets[i]; k < group.efficiency_offsets[i+1]; k++ )
+              {
+                const CoeffType* X = molar_densities + group.efficiency_species[k]*n_cells;
+                const CoeffType correction = group.efficiency_values[k] - 1;
+                for( unsigned int c = 0; c < n_cells; c++ )
+                  M[c] += correction * X[c];
+              }
+
+            for( unsigned int c = 0; c < n_cells; c++ )
+              k[c] = M[c] * k[c];
+          }
+      }
+
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  void CompiledReactionSet<CoeffType>::compute_batch_falloff_rate_coefficients( const FalloffGroup& group,
+                                                                                const unsigned int n_cells,
+                                                                                BatchWork& batch_work,
+                                                                                const CoeffType* T,
+                                                                                const CoeffType* lnT,
+                                                                                const CoeffType* molar_densities,
+                                                                                const CoeffType* total_concentration,
+                                                                                CoeffType* kfwd,
+                                                                                CoeffType* dkfwd_dT,
+                                                                                CoeffType* dkfwd_dM ) const
+  {
+    const unsigned int n = group.reactions.size();
+    const unsigned int size = n*n_cells;
+    const bool derivatives = ( dkfwd_dT != NULL );
+
+    antioch_assert( derivatives == ( dkfwd_dM != NULL ) );
+
+    if( size == 0 )
+      return;
+
+    // Same expressions as compute_falloff_rate_coefficients, the whole group
+    // packed into [i*n_cells + c] arrays so that each exponential or logarithm
+    // is a single vector_exp or vector_log call over all reactions and cells
+    std::vector<CoeffType>& k0 = batch_work.k0;
+    std::vector<CoeffType>& kinf = batch_work.kinf;
+    std::vector<CoeffType>& M = batch_work.M;
+    k0.resize(size);
+    kinf.resize(size);
+    M.resize(size);
+
+    for( unsigned int i = 0; i < n; i++ )
+      {
+        const CoeffType eta_0 = group.eta_0[i], Ea_0 = group.Ea_0[i], D_0 = group.D_0[i];
+        const CoeffType eta_inf = group.eta_inf[i], Ea_inf = group.Ea_inf[i], D_inf = group.D_inf[i];
+        CoeffType* k0_i = &k0[i*n_cells];
+        CoeffType* kinf_i = &kinf[i*n_cells];
+        CoeffType* M_i = &M[i*n_cells];
+
+        for( unsigned int c = 0; c < n_cells; c++ )
+          {
+            k0_i[c] = eta_0 * lnT[c] - Ea_0/T[c] + D_0*T[c];
+            kinf_i[c] = eta_inf * lnT[c] - Ea_inf/T[c] + D_inf*T[c];
+            M_i[c] = total_concentration[c];
+          }
+
+        for( unsigned int k = group.efficiency_offsets[i]; k < group.efficiency_offsets[i+1]; k++ )
+          {
+            const CoeffType* X = molar_densities + group.efficiency_species[k]*n_cells;
+            const CoeffType correction = group.efficiency_values[k] - 1;
+            for( unsigned int c = 0; c < n_cells; c++ )
+              M_i[c] += correction * X[c];
+          }
+      }
+
+    vector_exp( &k0[0], &k0[0], size, _math_accuracy );
+    vector_exp( &kinf[0], &kinf[0], size, _math_accuracy );
+
+    for( unsigned int i = 0; i < n; i++ )
+      {
+        const CoeffType Cf_0 = group.Cf_0[i], Cf_inf = group.Cf_inf[i];
+        CoeffType* k0_i = &k0[i*n_cells];
+        CoeffType* kinf_i = &kinf[i*n_cells];
+        for( unsigned int c = 0; c < n_cells; c++ )
+          {
+            k0_i[c] = Cf_0 * k0_i[c];
+            kinf_i[c] = Cf_inf * kinf_i[c];
+          }
+      }
+
+    // F and its derivatives with respect to T and [M], 1 and 0 for Lindemann
+    std::vector<CoeffType>& F = batch_work.F;
+    std::vector<CoeffType>& dF_dT = batch_work.dF_dT;
+    std::vector<CoeffType>& dF_dM = batch_work.dF_dM;
+
+    if( group.troe )
+      {
+        const CoeffType l10 = Constants::log10_to_log<CoeffType>();
+        const CoeffType c_coeff = CoeffType(0.67L) * l10;
+        const CoeffType n_coeff = CoeffType(1.27L) * l10;
+        const CoeffType d = CoeffType(0.14L);
+
+        // exp(-T/T***), exp(-T/T*) and exp(-T**/T) of all reactions and cells at once
+        std::vector<CoeffType>& E = batch_work.E;
+        E.resize(3*size);
+        CoeffType* E3 = &E[0];
+        CoeffType* E1 = &E[size];
+        CoeffType* E2 = &E[2*size];
+        for( unsigned int i = 0; i < n; i++ )
+          {
+            const CoeffType T1 = group.T1[i], T2 = group.T2[i], T3 = group.T3[i];
+            for( unsigned int c = 0; c < n_cells; c++ )
+              {
+                E3[i*n_cells + c] = -T[c]/T3;
+                E1[i*n_cells + c] = -T[c]/T1;
+                E2[i*n_cells + c] = -T2/T[c];
+              }
+          }
+        vector_exp( &E[0], &E[0], 3*size, _math_accuracy );
+
+        // Fcent, then log(Fcent) and log(Pr) in a single call
+        std::vector<CoeffType>& Fcent = batch_work.Fcent;
+        std::vector<CoeffType>& logs = batch_work.logs;
+        Fcent.resize(size);
+        logs.resize(2*size);
+        CoeffType* logFcent = &logs[0];
+        CoeffType* logPr = &logs[size];
+        for( unsigned int i = 0; i < n; i++ )
+          {
+            const CoeffType alpha = group.alpha[i], T2_weight = group.T2_weight[i];
+            const unsigned int offset = i*n_cells;
+            for( unsigned int c = 0; c < n_cells; c++ )
+              {
+                Fcent[offset + c] = (1 - alpha) * E3[offset + c] + alpha * E1[offset + c]
+                                  + T2_weight * E2[offset + c];
+                logFcent[offset + c] = Fcent[offset + c];
+                logPr[offset + c] = M[offset + c] * k0[offset + c]/kinf[offset + c];
+              }
+          }
+        vector_log( &logs[0], &logs[0], 2*size, _math_accuracy );
+
+        F.resize(size);
+        std::vector<CoeffType>& logF = batch_work.logF;
+        logF.resize(size);
+        for( unsigned int j = 0; j < size; j++ )
+          {
+            const CoeffType c = - CoeffType(0.4L) - c_coeff * logFcent[j];
+            const CoeffType n_j = CoeffType(0.75L) - n_coeff * logFcent[j];
+            const CoeffType y = l10 * logPr[j] + c;
+            const CoeffType x = y/(n_j - d*y);
+            logF[j] = logFcent[j]/(1 + x*x);
+          }
+        vector_exp( &logF[0], &F[0], size, _math_accuracy );
+
+        for( unsigned int j = 0; j < size; j++ )
+          F[j] = ( Fcent[j] != 0 ) ? F[j] : CoeffType(0);
+
+        if( derivatives )
+          {
+            dF_dT.resize(size);
+            dF_dM.resize(size);
+            for( unsigned int i = 0; i < n; i++ )
+              {
+                const CoeffType alpha = group.alpha[i], T2_weight = group.T2_weight[i];
+                const CoeffType T1 = group.T1[i], T2 = group.T2[i], T3 = group.T3[i];
+                const CoeffType eta_0 = group.eta_0[i], Ea_0 = group.Ea_0[i], D_0 = group.D_0[i];
+                const CoeffType eta_inf = group.eta_inf[i], Ea_inf = group.Ea_inf[i], D_inf = group.D_inf[i];
+                const unsigned int offset = i*n_cells;
+                for( unsigned int c = 0; c < n_cells; c++ )
+                  {
+                    const unsigned int j = offset + c;
+                    const CoeffType dFcent_dT = (alpha - 1)/T3 * E3[j] - alpha/T1 * E1[j]
+                                              + T2_weight * T2/(T[c]*T[c]) * E2[j];
+
+                    // dPr_dT/Pr = dk0_dT/k0 - dkinf_dT/kinf
+                    const CoeffType dlog10Pr_dT = l10 * ( D_0 + eta_0/T[c] + Ea_0/(T[c]*T[c])
+                                                        - D_inf - eta_inf/T[c] - Ea_inf/(T[c]*T[c]) );
+                    const CoeffType dlog10Pr_dM = l10/M[j];
+
+                    const CoeffType c_j = - CoeffType(0.4L) - c_coeff * logFcent[j];
+                    const CoeffType n_j = CoeffType(0.75L) - n_coeff * logFcent[j];
+                    const CoeffType dc_dT = - c_coeff * dFcent_dT/Fcent[j];
+                    const CoeffType dn_dT = - n_coeff * dFcent_dT/Fcent[j];
+
+                    const CoeffType y = l10 * logPr[j] + c_j;
+                    const CoeffType D = n_j - d * y;
+                    const CoeffType x = y/D;
+                    const CoeffType one_plus_x2 = 1 + x*x;
+
+                    const CoeffType dy_dT = dlog10Pr_dT + dc_dT;
+                    const CoeffType dD_dT = dn_dT - d * dy_dT;
+                    const CoeffType dlogF_dT = (dFcent_dT/Fcent[j] - 2 * logF[j] * x * (dy_dT * D - y * dD_dT)/(D*D))/one_plus_x2;
+                    const CoeffType dlogF_dM = - 2 * logF[j] * x * n_j/(D*D) * dlog10Pr_dM/one_plus_x2;
+
+                    dF_dT[j] = F[j] * dlogF_dT;
+                    dF_dM[j] = F[j] * dlogF_dM;
+                  }
+              }
+          }
+      }
+
+    // k(T,[M]) = k0 * ([M]^-1 + k0 * kinf^-1)^-1 * F, as in FalloffReaction
+    for( unsigned int i = 0; i < n; i++ )
+      {
+        const unsigned int offset = i*n_cells;
+        const unsigned int rxn_offset = group.reactions[i]*n_cells;
+
+        if( derivatives )
+          {
+            const CoeffType eta_0 = group.eta_0[i], Ea_0 = group.Ea_0[i], D_0 = group.D_0[i];
+            const CoeffType eta_inf = group.eta_inf[i], Ea_inf = group.Ea_inf[i], D_inf = group.D_inf[i];
+            for( unsigned int c = 0; c < n_cells; c++ )
+              {
+                const unsigned int j = offset + c;
+                const CoeffType f = group.troe ? F[j] : CoeffType(1);
+                const CoeffType df_dT = group.troe ? dF_dT[j] : CoeffType(0);
+                const CoeffType df_dM = group.troe ? dF_dM[j] : CoeffType(0);
+
+                // dk_dT = k * (D + eta/T + Ea/T^2) for the Van't Hoff form
+                const CoeffType dk0_dT = k0[j] * ( D_0 + eta_0/T[c] + Ea_0/(T[c]*T[c]) );
+                const CoeffType dkinf_dT = kinf[j] * ( D_inf + eta_inf/T[c] + Ea_inf/(T[c]*T[c]) );
+
+                const CoeffType k = k0[j] / (1/M[j] + k0[j]/kinf[j]);
+                const CoeffType temp = kinf[j]/M[j] + k0[j];
+
+                dkfwd_dT[rxn_offset + c] = f * k * (dk0_dT/k0[j] - dk0_dT/temp + dkinf_dT * k0[j]/(kinf[j] * temp))
+                                         + df_dT * k;
+                dkfwd_dM[rxn_offset + c] = f * k / (M[j] + M[j]*M[j] * k0[j]/kinf[j]) + df_dM * k;
+                kfwd[rxn_offset + c] = k * f;
+              }
+          }
+        else if( group.troe )
+          {
+            for( unsigned int c = 0; c < n_cells; c++ )
+              {
+                const unsigned int j = offset + c;
+                kfwd[rxn_offset + c] = k0[j] / (1/M[j] + k0[j]/kinf[j]) * F[j];
+              }
+          }
+        else
+          {
+            for( unsigned int c = 0; c < n_cells; c++ )
+              {
+                const unsigned int j = offset + c;
+                kfwd[rxn_offset + c] = k0[j] / (1/M[j] + k0[j]/kinf[j]);
+              }
+          }
+      }
+
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  void CompiledReactionSet<CoeffType>::compute_batch_reaction_rates( const unsigned int n_cells,
+                                                                     const std::vector<CoeffType>& T,
+                                                                     const std::vector<CoeffType>& molar_densities,
+                                                                     const std::vector<CoeffType>& h_RT_minus_s_R,
+                                                                     std::vector<CoeffType>& net_reaction_rates ) const
+  {
+    BatchWork batch_work;
+    this->compute_batch_reaction_rates( n_cells, batch_work, T, molar_densities, h_RT_minus_s_R, net_reaction_rates );
+
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  void CompiledReactionSet<CoeffType>::compute_batch_reaction_rates( const unsigned int n_cells,
+                                                                     BatchWork& batch_work,
+                                                                     const std::vector<CoeffType>& T,
+                                                                     const std::vector<CoeffType>& molar_densities,
+                                                                     const std::vector<CoeffType>& h_RT_minus_s_R,
+                                                                     std::vector<CoeffType>& net_reaction_rates ) const
+  {
+    const unsigned int n_species = this->n_species();
+
+    antioch_assert_greater_equal( T.size(), n_cells );
+    antioch_assert_greater_equal( molar_densities.size(), n_species*n_cells );
+    antioch_assert_greater_equal( h_RT_minus_s_R.size(), n_species*n_cells );
+    antioch_assert_greater_equal( net_reaction_rates.size(), this->n_reactions()*n_cells );
+
+    if( n_cells == 0 )
+      return;
+
+    const CoeffType* X = &molar_densities[0];
+    const CoeffType* h = &h_RT_minus_s_R[0];
+    CoeffType* rates = &net_reaction_rates[0];
+
+    // per cell work arrays
+    std::vector<CoeffType>& lnT = batch_work.lnT;
+    std::vector<CoeffType>& P0_RT = batch_work.P0_RT;
+    std::vector<CoeffType>& work = batch_work.work;
+    std::vector<CoeffType>& work2 = batch_work.work2;
+    std::vector<CoeffType>& work3 = batch_work.work3;
+    std::vector<CoeffType>& work4 = batch_work.work4;
+    std::vector<CoeffType>& powers = batch_work.powers;
+    lnT.resize(n_cells);
+    P0_RT.resize(n_cells);
+    work.resize(n_cells);
+    work2.resize(n_cells);
+    work3.resize(n_cells);
+    work4.resize(n_cells);
+    powers.resize(n_cells);
+
+    vector_log( &T[0], &lnT[0], n_cells, _math_accuracy );
+    for( unsigned int c = 0; c < n_cells; c++ )
+      P0_RT[c] = _P0_R/T[c];
+
+    // species exponentials and powers of P0/(RT), as in EquilibriumFactors
+    const int min_gamma = _min_gamma;
+    std::vector<CoeffType>& P0_RT_powers = batch_work.P0_RT_powers;
+    P0_RT_powers.resize( (_max_gamma - min_gamma + 1)*n_cells );
+    for( int g = min_gamma; g <= _max_gamma; g++ )
+      {
+        vector_pow( &P0_RT[0], static_cast<CoeffType>(g), &P0_RT_powers[(g - min_gamma)*n_cells],
+                    n_cells, _math_accuracy );
+      }
+
+    std::vector<CoeffType>& exp_h = batch_work.exp_h;
+    std::vector<CoeffType>& abs_h = batch_work.abs_h;
+    exp_h.resize( n_species*n_cells );
+    abs_h.resize( n_species*n_cells );
+    for( unsigned int s = 0; s < n_species; s++ )
+      {
+        const CoeffType* hs = h + s*n_cells;
+        CoeffType* es = &exp_h[s*n_cells];
+        CoeffType* as = &abs_h[s*n_cells];
+        vector_exp( hs, es, n_cells, _math_accuracy );
+        for( unsigned int c = 0; c < n_cells; c++ )
+          as[c] = std::max(hs[c], -hs[c]);
+      }
+
+    const CoeffType max_exponent = EquilibriumFactors<CoeffType>::max_exponent();
+    std::vector<CoeffType>& numerator_exponent = batch_work.numerator_exponent;
+    std::vector<CoeffType>& denominator_exponent = batch_work.denominator_exponent;
+    numerator_exponent.resize(n_cells);
+    denominator_exponent.resize(n_cells);
+
+    // [M] before the efficiency corrections, same sum as total_concentration()
+    std::vector<CoeffType>& total_concentration = batch_work.total_concentration;
+    total_concentration.assign(X, X + n_cells);
+    for( unsigned int s = 1; s < n_species; s++ )
+      {
+        const CoeffType* Xs = X + s*n_cells;
+        for( unsigned int c = 0; c < n_cells; c++ )
+          total_concentration[c] += Xs[c];
+      }
+
+    // forward rate coefficients, stored in place
+    for( unsigned int g = 0; g < _groups.size(); g++ )
+      this->compute_batch_forward_rate_coefficients( _groups[g], n_cells, &T[0], &lnT[0], X,
+                                                     &total_concentration[0], &work[0], rates );
+
+    for( unsigned int g = 0; g < _falloff_groups.size(); g++ )
+      this->compute_batch_falloff_rate_coefficients( _falloff_groups[g], n_cells, batch_work, &T[0], &lnT[0], X,
+                                                     &total_concentration[0], rates, NULL, NULL );
+
+    if( !_generic_reactions.empty() )
+      {
+        std::vector<CoeffType>& cell_molar_densities = batch_work.cell_molar_densities;
+        cell_molar_densities.resize(n_species);
+        for( unsigned int c = 0; c < n_cells; c++ )
+          {
+            for( unsigned int s = 0; s < n_species; s++ )
+              cell_molar_densities[s] = X[s*n_cells + c];
+
+            const KineticsConditions<CoeffType> conditions(T[c]);
+
+            for( unsigned int i = 0; i < _generic_reactions.size(); i++ )
+              {
+                const unsigned int rxn = _generic_reactions[i];
+                rates[rxn*n_cells + c] =
+                  _reaction_set.reaction(rxn).compute_forward_rate_coefficient(cell_molar_densities,conditions,
+                                                                               total_concentration[c]);
+              }
+          }
+      }
+
+    // Rfwd only
+    for( unsigned int i = 0; i < _irreversible_reactions.size(); i++ )
+      {
+        const unsigned int rxn = _irreversible_reactions[i];
+        CoeffType* q = rates + rxn*n_cells;
+
+        for( unsigned int r = _reactant_offsets[rxn]; r < _reactant_offsets[rxn+1]; r++ )
+          {
+            const CoeffType* Xr = X + _reactant_ids[r]*n_cells;
+            const CoeffType order = _reactant_partial_orders[r];
+            const unsigned int integer_order = _reactant_integer_orders[r];
+            if( integer_order )
+              for( unsigned int n = 0; n < integer_order; n++ )
+                for( unsigned int c = 0; c < n_cells; c++ )
+                  q[c] *= Xr[c];
+            else
+              {
+                vector_pow( Xr, order, &powers[0], n_cells, _math_accuracy );
+                for( unsigned int c = 0; c < n_cells; c++ )
+                  q[c] *= powers[c];
+              }
+          }
+      }
+
+    // Rfwd - Rbkwd
+    CoeffType* kfwd_times_reactants = &work[0];
+    CoeffType* kbkwd_times_products = &work2[0];
+    CoeffType* Keq = &work3[0];
+    CoeffType* denominator = &work4[0];
+    for( unsigned int i = 0; i < _reversible_reactions.size(); i++ )
+      {
+        const unsigned int rxn = _reversible_reactions[i];
+        CoeffType* q = rates + rxn*n_cells;
+
+        for( unsigned int c = 0; c < n_cells; c++ )
+          kfwd_times_reactants[c] = q[c];
+
+        for( unsigned int r = _reactant_offsets[rxn]; r < _reactant_offsets[rxn+1]; r++ )
+          {
+            const CoeffType* Xr = X + _reactant_ids[r]*n_cells;
+            const CoeffType order = _reactant_partial_orders[r];
+            const unsigned int integer_order = _reactant_integer_orders[r];
+            if( integer_order )
+              for( unsigned int n = 0; n < integer_order; n++ )
+                for( unsigned int c = 0; c < n_cells; c++ )
+                  kfwd_times_reactants[c] *= Xr[c];
+            else
+              {
+                vector_pow( Xr, order, &powers[0], n_cells, _math_accuracy );
+                for( unsigned int c = 0; c < n_cells; c++ )
+                  kfwd_times_reactants[c] *= powers[c];
+              }
+          }
+
+        // Keq = (P0/(RT))^gamma prod_r exp(h_r)^nu_r / prod_p exp(h_p)^nu_p, same operations as Reaction
+        const CoeffType* power = &P0_RT_powers[(_gamma[rxn] - min_gamma)*n_cells];
+        for( unsigned int c = 0; c < n_cells; c++ )
+          {
+            Keq[c] = power[c];
+            denominator[c] = 1;
+            numerator_exponent[c] = 0;
+            denominator_exponent[c] = 0;
+          }
+        for( unsigned int r = _reactant_offsets[rxn]; r < _reactant_offsets[rxn+1]; r++ )
+          {
+            const CoeffType* er = &exp_h[_reactant_ids[r]*n_cells];
+            const CoeffType* ar = &abs_h[_reactant_ids[r]*n_cells];
+            const CoeffType nu = _reactant_stoichiometry[r];
+            for( unsigned int n = 0; n < static_cast<unsigned int>(nu); n++ )
+              for( unsigned int c = 0; c < n_cells; c++ )
+                Keq[c] *= er[c];
+            for( unsigned int c = 0; c < n_cells; c++ )
+              numerator_exponent[c] += ( nu * ar[c] );
+          }
+        for( unsigned int p = _product_offsets[rxn]; p < _product_offsets[rxn+1]; p++ )
+          {
+            const CoeffType* ep = &exp_h[_product_ids[p]*n_cells];
+            const CoeffType* ap = &abs_h[_product_ids[p]*n_cells];
+            const CoeffType nu = _product_stoichiometry[p];
+            for( unsigned int n = 0; n < static_cast<unsigned int>(nu); n++ )
+              for( unsigned int c = 0; c < n_cells; c++ )
+                denominator[c] *= ep[c];
+            for( unsigned int c = 0; c < n_cells; c++ )
+              denominator_exponent[c] += ( nu * ap[c] );
+          }
+
+        // where the products could overflow, exp(reactants - products)
+        const unsigned int r0 = _reactant_offsets[rxn];
+        for( unsigned int c = 0; c < n_cells; c++ )
+          {
+            if( numerator_exponent[c] < max_exponent &&
+                denominator_exponent[c] < max_exponent )
+              {
+                Keq[c] /= denominator[c];
+                continue;
+              }
+
+            CoeffType exppower = ( _reactant_stoichiometry[r0] * h[_reactant_ids[r0]*n_cells + c] );
+            for( unsigned int r = r0 + 1; r < _reactant_offsets[rxn+1]; r++ )
+              exppower += ( _reactant_stoichiometry[r] * h[_reactant_ids[r]*n_cells + c] );
+            for( unsigned int p = _product_offsets[rxn]; p < _product_offsets[rxn+1]; p++ )
+              exppower -= ( _product_stoichiometry[p] * h[_product_ids[p]*n_cells + c] );
+
+            Keq[c] = power[c] * ant_exp(exppower);
+          }
+
+        for( unsigned int c = 0; c < n_cells; c++ )
+          kbkwd_times_products[c] = q[c]/Keq[c];
+
+        for( unsigned int p = _product_offsets[rxn]; p < _product_offsets[rxn+1]; p++ )
+          {
+            const CoeffType* Xp = X + _product_ids[p]*n_cells;
+            const CoeffType order = _product_partial_orders[p];
+            const unsigned int integer_order = _product_integer_orders[p];
+            if( integer_order )
+              for( unsigned int n = 0; n < integer_order; n++ )
+                for( unsigned int c = 0; c < n_cells; c++ )
+                  kbkwd_times_products[c] *= Xp[c];
+            else
+              {
+                vector_pow( Xp, order, &powers[0], n_cells, _math_accuracy );
+                for( unsigned int c = 0; c < n_cells; c++ )
+                  kbkwd_times_products[c] *= powers[c];
+              }
+          }
+
+        // Same treatment of a zero equilibrium constant as in Reaction
+        const CoeffType max_rate = _max_rate[rxn];
+        for( unsigned int c = 0; c < n_cells; c++ )
+          {
+            antioch_assert(!has_nan(Keq[c]));
+            q[c] = kfwd_times_reactants[c] - ( (Keq[c] != 0) ? kbkwd_times_products[c] : max_rate );
+          }
+      }
+
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  void CompiledReactionSet<CoeffType>::compute_batch_falloff_rate_coefficients_and_derivatives( const unsigned int n_cells,
+                                                                                                const std::vector<CoeffType>& T,
+                                                                                                const std::vector<CoeffType>& molar_densities,
+                                                                                                std::vector<CoeffType>& kfwd,
+                                                                                                std::vector<CoeffType>& dkfwd_dT,
+                                                                                                std::vector<CoeffType>& dkfwd_dM ) const
+  {
+    const unsigned int n_species = this->n_species();
+
+    antioch_assert_greater_equal( T.size(), n_cells );
+    antioch_assert_greater_equal( molar_densities.size(), n_species*n_cells );
+    antioch_assert_greater_equal( kfwd.size(), this->n_reactions()*n_cells );
+    antioch_assert_greater_equal( dkfwd_dT.size(), this->n_reactions()*n_cells );
+    antioch_assert_greater_equal( dkfwd_dM.size(), this->n_reactions()*n_cells );
+
+    if( n_cells == 0 || _falloff_groups.empty() )
+      return;
+
+    const CoeffType* X = &molar_densities[0];
+
+    BatchWork batch_work;
+    std::vector<CoeffType>& lnT = batch_work.lnT;
+    lnT.resize(n_cells);
+    vector_log( &T[0], &lnT[0], n_cells, _math_accuracy );
+
+    std::vector<CoeffType>& total_concentration = batch_work.total_concentration;
+    total_concentration.assign(X, X + n_cells);
+    for( unsigned int s = 1; s < n_species; s++ )
+      {
+        const CoeffType* Xs = X + s*n_cells;
+        for( unsigned int c = 0; c < n_cells; c++ )
+          total_concentration[c] += Xs[c];
+      }
+
+    for( unsigned int g = 0; g < _falloff_groups.size(); g++ )
+      this->compute_batch_falloff_rate_coefficients( _falloff_groups[g], n_cells, batch_work, &T[0], &lnT[0], X,
+                                                     &total_concentration[0], &kfwd[0],
+                                                     &dkfwd_dT[0], &dkfwd_dM[0] );
+
+    return;
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_COMPILED_REACTION_SET_H
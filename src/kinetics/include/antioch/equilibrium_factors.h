@@ -0,0 +1,209 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+
+
+
+#ifndef ANTIOCH_EQUILIBRIUM_FACTORS_H
+#define ANTIOCH_EQUILIBRIUM_FACTORS_H
+
+// Antioch
+#include "antioch/antioch_asserts.h"
+#include "antioch/cmath_shims.h"
+#include "antioch/metaprogramming.h"
+#include "antioch/physical_constants.h"
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace Antioch
+{
+  template<typename CoeffType>
+  class ReactionSet;
+
+  //! Species level factors of the equilibrium constants of a ReactionSet
+  /*!
+   * The equilibrium constant of a reaction is
+   * \f[
+   *    K_{eq} = \left(\frac{P_0}{RT}\right)^\gamma
+   *             \frac{\prod_r \exp(h_r)^{\nu_r}}{\prod_p \exp(h_p)^{\nu_p}}
+   * \f]
+   * with \f$h_s = \frac{h_s}{RT} - \frac{s_s}{R}\f$. update() evaluates the
+   * exponentials once per species and \f$(P_0/RT)^\gamma\f$ once per distinct
+   * \f$\gamma\f$ of the reaction set, Reaction::equilibrium_constant then only
+   * multiplies them. When \f$\sum_r \nu_r |h_r|\f$ or \f$\sum_p \nu_p |h_p|\f$
+   * exceeds max_exponent(), the products could overflow and the reaction falls
+   * back to the exponential of the summed exponents.
+   *
+   * The \f$\gamma\f$ range is taken from the reaction set at construction,
+   * the factors are meant to be kept and updated for each evaluation.
+   */
+  template<typename CoeffType=double, typename StateType=CoeffType>
+  class EquilibriumFactors
+  {
+  public:
+
+    //! \p example gives the size of vector-valued StateTypes
+    EquilibriumFactors( const ReactionSet<CoeffType>& reaction_set,
+                        const StateType& example );
+
+    ~EquilibriumFactors();
+
+    //! Evaluate the factors at temperature \p T
+    template <typename VectorStateType>
+    void update( const StateType& T, const VectorStateType& h_RT_minus_s_R );
+
+    //! \f$P_0/(RT)\f$
+    const StateType& P0_RT() const;
+
+    //! \f$(P_0/(RT))^\gamma\f$
+    const StateType& P0_RT_power( int gamma ) const;
+
+    //! \f$\exp(h_s/(RT) - s_s/R)\f$
+    const StateType& exp_h_RT_minus_s_R( unsigned int s ) const;
+
+    //! Bound of \f$|h_s/(RT) - s_s/R|\f$ over the components of StateType
+    CoeffType abs_h_RT_minus_s_R( unsigned int s ) const;
+
+    //! Largest exponent of the products of species exponentials
+    static CoeffType max_exponent();
+
+  private:
+
+    EquilibriumFactors();
+
+    //! Scaling for equilibrium constant, as in ReactionSet
+    const CoeffType _P0_R;
+
+    int _min_gamma;
+
+    StateType _P0_RT;
+
+    std::vector<StateType> _P0_RT_powers;
+
+    std::vector<StateType> _exp_h_RT_minus_s_R;
+
+    std::vector<CoeffType> _abs_h_RT_minus_s_R;
+  };
+
+  /* ------------------------- Inline Functions -------------------------*/
+
+  template<typename CoeffType, typename StateType>
+  inline
+  EquilibriumFactors<CoeffType,StateType>::EquilibriumFactors( const ReactionSet<CoeffType>& reaction_set,
+                                                               const StateType& example )
+    : _P0_R(1.0e5/Constants::R_universal<CoeffType>()), //SI, as in ReactionSet
+      _min_gamma(reaction_set.min_gamma()),
+      _P0_RT(example),
+      _P0_RT_powers(reaction_set.max_gamma() - reaction_set.min_gamma() + 1, example),
+      _exp_h_RT_minus_s_R(reaction_set.n_species(), example),
+      _abs_h_RT_minus_s_R(reaction_set.n_species(), std::numeric_limits<CoeffType>::infinity())
+  {
+    return;
+  }
+
+  template<typename CoeffType, typename StateType>
+  inline
+  EquilibriumFactors<CoeffType,StateType>::~EquilibriumFactors()
+  {
+    return;
+  }
+
+  template<typename CoeffType, typename StateType>
+  template <typename VectorStateType>
+  inline
+  void EquilibriumFactors<CoeffType,StateType>::update( const StateType& T,
+                                                        const VectorStateType& h_RT_minus_s_R )
+  {
+    antioch_assert_equal_to( h_RT_minus_s_R.size(), _exp_h_RT_minus_s_R.size() );
+
+    _P0_RT = _P0_R/T;
+
+    for( unsigned int g = 0; g < _P0_RT_powers.size(); g++ )
+      _P0_RT_powers[g] = ant_pow( _P0_RT, static_cast<CoeffType>(_min_gamma + static_cast<int>(g)) );
+
+    for( unsigned int s = 0; s < _exp_h_RT_minus_s_R.size(); s++ )
+      {
+        _exp_h_RT_minus_s_R[s] = ant_exp(h_RT_minus_s_R[s]);
+
+        const CoeffType hmax = Antioch::max(h_RT_minus_s_R[s]);
+        const CoeffType hmin = Antioch::min(h_RT_minus_s_R[s]);
+        _abs_h_RT_minus_s_R[s] = std::max(hmax, -hmin);
+      }
+
+    return;
+  }
+
+  template<typename CoeffType, typename StateType>
+  inline
+  const StateType& EquilibriumFactors<CoeffType,StateType>::P0_RT() const
+  {
+    return _P0_RT;
+  }
+
+  template<typename CoeffType, typename StateType>
+  inline
+  const StateType& EquilibriumFactors<CoeffType,StateType>::P0_RT_power( int gamma ) const
+  {
+    antioch_assert_greater_equal( gamma, _min_gamma );
+    antioch_assert_less( gamma - _min_gamma, static_cast<int>(_P0_RT_powers.size()) );
+
+    return _P0_RT_powers[gamma - _min_gamma];
+  }
+
+  template<typename CoeffType, typename StateType>
+  inline
+  const StateType& EquilibriumFactors<CoeffType,StateType>::exp_h_RT_minus_s_R( unsigned int s ) const
+  {
+    antioch_assert_less( s, _exp_h_RT_minus_s_R.size() );
+
+    return _exp_h_RT_minus_s_R[s];
+  }
+
+  template<typename CoeffType, typename StateType>
+  inline
+  CoeffType EquilibriumFactors<CoeffType,StateType>::abs_h_RT_minus_s_R( unsigned int s ) const
+  {
+    antioch_assert_less( s, _abs_h_RT_minus_s_R.size() );
+
+    return _abs_h_RT_minus_s_R[s];
+  }
+
+  template<typename CoeffType, typename StateType>
+  inline
+  CoeffType EquilibriumFactors<CoeffType,StateType>::max_exponent()
+  {
+    // leaves room for (P0/(RT))^gamma and keeps the products away from denormals
+    static const CoeffType exponent = 0.9*std::log(std::numeric_limits<CoeffType>::max());
+    return exponent;
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_EQUILIBRIUM_FACTORS_H
@@ -121,6 +121,21 @@ namespace Antioch
                                                            StateType& dkfwd_dT, 
                                                            VectorStateType& dkfkwd_dX) const;
 
+    //! \p total_concentration is sum_s c_s, which is [M] for this reaction
+    template <typename StateType, typename VectorStateType>
+    StateType compute_forward_rate_coefficient( const VectorStateType& molar_densities,
+                                                const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                const StateType& total_concentration ) const;
+
+    //!
+    template <typename StateType, typename VectorStateType>
+    void compute_forward_rate_coefficient_and_derivatives( const VectorStateType& molar_densities,
+                                                           const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                           const StateType& total_concentration,
+                                                           StateType& kfwd,
+                                                           StateType& dkfwd_dT,
+                                                           VectorStateType& dkfkwd_dX) const;
+
 
     //! Return const reference to the falloff object
     const FalloffType &F() const;
@@ -174,12 +189,19 @@ namespace Antioch
   StateType FalloffReaction<CoeffType,FalloffType>::compute_forward_rate_coefficient( const VectorStateType& molar_densities,
                                                                                       const KineticsConditions<StateType,VectorStateType>& conditions  ) const
   {
+    return this->compute_forward_rate_coefficient( molar_densities, conditions,
+                                                   total_concentration<StateType>(molar_densities) );
+  }
+
+  template<typename CoeffType, typename FalloffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  StateType FalloffReaction<CoeffType,FalloffType>::compute_forward_rate_coefficient( const VectorStateType& /*molar_densities*/,
+                                                                                      const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                                                      const StateType& total_concentration ) const
+  {
 //falloff is k(T,[M]) = k0*[M]/(1 + [M]*k0/kinf) * F = k0 * ([M]^-1 + k0 * kinf^-1)^-1 * F    
-    StateType M = Antioch::zero_clone(conditions.T());
-    for(unsigned int i = 0; i < molar_densities.size(); i++)
-    {
-        M += molar_densities[i];
-    }
+    const StateType& M = total_concentration;
 
     const StateType k0   = (*this->_forward_rate[0])(conditions);
     const StateType kinf = (*this->_forward_rate[1])(conditions);
@@ -199,6 +221,21 @@ namespace Antioch
                                                                                                  StateType& kfwd, 
                                                                                                  StateType& dkfwd_dT,
                                                                                                  VectorStateType& dkfwd_dX) const 
+  {
+    this->compute_forward_rate_coefficient_and_derivatives( molar_densities, conditions,
+                                                            total_concentration<StateType>(molar_densities),
+                                                            kfwd, dkfwd_dT, dkfwd_dX );
+  }
+
+  template<typename CoeffType, typename FalloffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void FalloffReaction<CoeffType,FalloffType>::compute_forward_rate_coefficient_and_derivatives( const VectorStateType &molar_densities,
+                                                                                                 const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                                                                 const StateType& total_concentration,
+                                                                                                 StateType& kfwd,
+                                                                                                 StateType& dkfwd_dT,
+                                                                                                 VectorStateType& dkfwd_dX) const
   {
     //variables, k0,kinf and derivatives
     StateType k0 = Antioch::zero_clone(conditions.T());
@@ -209,11 +246,7 @@ namespace Antioch
     this->_forward_rate[0]->compute_rate_and_derivative(conditions,k0,dk0_dT);
     this->_forward_rate[1]->compute_rate_and_derivative(conditions,kinf,dkinf_dT);
 
-    StateType M = Antioch::zero_clone(conditions.T());
-    for(unsigned int i = 0; i < molar_densities.size(); i++)
-    {
-        M += molar_densities[i];
-    }
+    const StateType& M = total_concentration;
 
     //F
     StateType f = Antioch::zero_clone(M);
@@ -125,6 +125,21 @@ namespace Antioch
                                                            StateType& dkfwd_dT, 
                                                            VectorStateType& dkfkwd_dX) const;
 
+    //! \p total_concentration is sum_s c_s, only the non-unity efficiencies are applied to it
+    template <typename StateType, typename VectorStateType>
+    StateType compute_forward_rate_coefficient( const VectorStateType& molar_densities,
+                                                const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                const StateType& total_concentration ) const;
+
+    //!
+    template <typename StateType, typename VectorStateType>
+    void compute_forward_rate_coefficient_and_derivatives( const VectorStateType& molar_densities,
+                                                           const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                           const StateType& total_concentration,
+                                                           StateType& kfwd,
+                                                           StateType& dkfwd_dT,
+                                                           VectorStateType& dkfkwd_dX) const;
+
 
     //! Return const reference to the falloff object
     const FalloffType &F() const;
@@ -150,8 +165,6 @@ namespace Antioch
      _F(n_species)
      
   {
-    Reaction<CoeffType>::_efficiencies.resize(n_species); 
-    std::fill (Reaction<CoeffType>::_efficiencies.begin(), Reaction<CoeffType>::_efficiencies.end(), 1.);
   }
 
 
@@ -182,12 +195,19 @@ namespace Antioch
   StateType FalloffThreeBodyReaction<CoeffType,FalloffType>::compute_forward_rate_coefficient( const VectorStateType& molar_densities,
                                                                                       const KineticsConditions<StateType,VectorStateType>& conditions  ) const
   {
+    return this->compute_forward_rate_coefficient( molar_densities, conditions,
+                                                   total_concentration<StateType>(molar_densities) );
+  }
+
+  template<typename CoeffType, typename FalloffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  StateType FalloffThreeBodyReaction<CoeffType,FalloffType>::compute_forward_rate_coefficient( const VectorStateType& molar_densities,
+                                                                                      const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                                                      const StateType& total_concentration ) const
+  {
 //falloff is k(T,[M]) = k0*[M]/(1 + [M]*k0/kinf) * F = k0 * ([M]^-1 + k0 * kinf^-1)^-1 * F    
-    StateType M = Antioch::zero_clone(conditions.T());
-    for(unsigned int s = 0; s < molar_densities.size(); s++)
-    {
-        M += this->efficiency(s) * molar_densities[s];
-    }
+    const StateType M = this->third_body_concentration( molar_densities, total_concentration );
 
     const StateType k0   = (*this->_forward_rate[0])(conditions);
     const StateType kinf = (*this->_forward_rate[1])(conditions);
@@ -207,6 +227,21 @@ namespace Antioch
                                                                                                  StateType& kfwd, 
                                                                                                  StateType& dkfwd_dT,
                                                                                                  VectorStateType& dkfwd_dX) const 
+  {
+    this->compute_forward_rate_coefficient_and_derivatives( molar_densities, conditions,
+                                                            total_concentration<StateType>(molar_densities),
+                                                            kfwd, dkfwd_dT, dkfwd_dX );
+  }
+
+  template<typename CoeffType, typename FalloffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void FalloffThreeBodyReaction<CoeffType,FalloffType>::compute_forward_rate_coefficient_and_derivatives( const VectorStateType &molar_densities,
+                                                                                                 const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                                                                 const StateType& total_concentration,
+                                                                                                 StateType& kfwd,
+                                                                                                 StateType& dkfwd_dT,
+                                                                                                 VectorStateType& dkfwd_dX) const
   {
     //variables, k0,kinf and derivatives
     StateType k0 = Antioch::zero_clone(conditions.T());
@@ -217,11 +252,7 @@ namespace Antioch
     this->_forward_rate[0]->compute_rate_and_derivative(conditions,k0,dk0_dT);
     this->_forward_rate[1]->compute_rate_and_derivative(conditions,kinf,dkinf_dT);
 
-    StateType M = Antioch::zero_clone(conditions.T());
-    for(unsigned int s = 0; s < molar_densities.size(); s++)
-    {
-        M += this->efficiency(s) * molar_densities[s];
-    }
+    const StateType M = this->third_body_concentration( molar_densities, total_concentration );
 
     //F
     StateType f = Antioch::zero_clone(conditions.T());
@@ -246,7 +277,13 @@ namespace Antioch
 //         = F * epsilon_i * kfwd / ([M] +  [M]^2 k0/kinf) + kfwd * dF_dX
     for(unsigned int ic = 0; ic < this->n_species(); ic++)
       {
-        dkfwd_dX[ic] = this->efficiency(ic) * ( tmp + df_dX[ic] * kfwd );
+        dkfwd_dX[ic] = tmp + df_dX[ic] * kfwd;
+      }
+
+    // epsilon_i = 1 except for the stored corrections
+    for(unsigned int k = 0; k < this->n_efficiency_corrections(); k++)
+      {
+        dkfwd_dX[this->efficiency_correction_species(k)] *= this->efficiency_correction(k);
       }
 
     kfwd *= f; //finalize
@@ -0,0 +1,506 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+
+
+
+#ifndef ANTIOCH_HOMOGENEOUS_REACTOR_H
+#define ANTIOCH_HOMOGENEOUS_REACTOR_H
+
+// Antioch
+#include "antioch/antioch_asserts.h"
+#include "antioch/chemical_mixture.h"
+#include "antioch/reaction_set.h"
+#include "antioch/kinetics_evaluator.h"
+#include "antioch/kinetics_conditions.h"
+#include "antioch/temp_cache.h"
+#include "antioch/bdf_integrator.h"
+
+// C++
+#include <vector>
+
+namespace Antioch
+{
+  namespace ReactorType
+  {
+    enum ReactorType { CONSTANT_PRESSURE = 0, //!< fixed pressure, the density follows T and composition
+                       CONSTANT_VOLUME };     //!< fixed density
+  }
+
+  namespace ReactorEnergy
+  {
+    enum ReactorEnergy { ADIABATIC = 0, //!< enthalpy (const P) or internal energy (const V) conserved
+                         ISOTHERMAL };  //!< fixed temperature
+  }
+
+  //! Closed, homogeneous (0-D) reactor
+  /*!
+   * The state is \f$ y = (Y_0, \dots, Y_{n-1}, T) \f$, mass fractions
+   * then temperature, and evolves by
+   * \f[
+   *   \frac{dY_s}{dt} = \frac{\dot{\omega}_s}{\rho}, \qquad
+   *   \frac{dT}{dt} = -\frac{\sum_s e_s \dot{\omega}_s}{\rho c}
+   * \f]
+   * with \f$ e_s = h_s, c = c_p \f$ at constant pressure and
+   * \f$ e_s = u_s, c = c_v \f$ at constant volume (mass units).
+   *
+   * rhs() and jacobian() follow the BDFIntegrator system interface. The
+   * Jacobian is analytical: the species part comes from
+   * KineticsEvaluator::compute_mass_sources_and_derivs, chained through
+   * the density at constant pressure, the temperature row from the
+   * species enthalpies and heat capacities of \p ThermoEvaluator (which
+   * must provide h, cp, dcp_dT, h_RT_minus_s_R and dh_RT_minus_s_R_dT,
+   * as NASAEvaluator does).
+   *
+   * The reactor holds a KineticsEvaluator and work arrays, and so must
+   * be created within each thread.
+   */
+  template<typename CoeffType, typename ThermoEvaluator>
+  class HomogeneousReactor
+  {
+  public:
+
+    HomogeneousReactor( const ReactionSet<CoeffType>& reaction_set,
+                        const ThermoEvaluator& thermo,
+                        ReactorType::ReactorType type = ReactorType::CONSTANT_PRESSURE,
+                        ReactorEnergy::ReactorEnergy energy = ReactorEnergy::ADIABATIC );
+
+    ~HomogeneousReactor();
+
+    ReactorType::ReactorType type() const;
+
+    ReactorEnergy::ReactorEnergy energy() const;
+
+    //! Pressure of a constant pressure reactor
+    void set_pressure( const CoeffType P );
+
+    CoeffType pressure() const;
+
+    //! Density of a constant volume reactor
+    void set_density( const CoeffType rho );
+
+    CoeffType density() const;
+
+    //! Time integrator, for its tolerances and statistics
+    BDFIntegrator<CoeffType>& integrator();
+
+    const BDFIntegrator<CoeffType>& integrator() const;
+
+    unsigned int n_species() const;
+
+    //! n_species()+1
+    unsigned int n_equations() const;
+
+    //! Time derivative of the state \p y
+    void rhs( const CoeffType t, const std::vector<CoeffType>& y, std::vector<CoeffType>& dy_dt );
+
+    //! Jacobian of rhs(), row major (n_equations() x n_equations())
+    void jacobian( const CoeffType t, const std::vector<CoeffType>& y, std::vector<CoeffType>& J );
+
+    //! Integrate the state \p y over \p dt
+    void advance( std::vector<CoeffType>& y, const CoeffType dt );
+
+    //! Integrate mass fractions and temperature over \p dt
+    void advance( std::vector<CoeffType>& mass_fractions, CoeffType& T, const CoeffType dt );
+
+  private:
+
+    HomogeneousReactor();
+
+    //! Density, molar densities, thermodynamics and mass sources at \p y
+    void evaluate( const std::vector<CoeffType>& y, bool derivatives );
+
+    const ChemicalMixture<CoeffType>& _chem_mixture;
+
+    const ThermoEvaluator& _thermo;
+
+    KineticsEvaluator<CoeffType> _kinetics;
+
+    ReactorType::ReactorType _type;
+
+    ReactorEnergy::ReactorEnergy _energy;
+
+    CoeffType _pressure;
+
+    CoeffType _density;
+
+    BDFIntegrator<CoeffType> _integrator;
+
+    //! last evaluation
+    CoeffType _rho;
+    CoeffType _T;
+    std::vector<CoeffType> _molar_densities;
+    std::vector<CoeffType> _h_RT_minus_s_R;
+    std::vector<CoeffType> _dh_RT_minus_s_R_dT;
+    std::vector<CoeffType> _omega_dot;
+    std::vector<CoeffType> _domega_dot_dT;
+    std::vector<std::vector<CoeffType> > _domega_dot_drho_s;
+
+    //! species energies (h or u) and heat capacities (cp or cv), mass units
+    std::vector<CoeffType> _e_s;
+    std::vector<CoeffType> _c_s;
+    std::vector<CoeffType> _dc_s_dT;
+
+    //! d(omega_dot_s)/dY_k at fixed T and d(omega_dot_s)/dT at fixed Y
+    std::vector<CoeffType> _domega_dot_dY;
+    std::vector<CoeffType> _domega_dot_dT_Y;
+  };
+
+  /* ------------------------- Inline Functions -------------------------*/
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  HomogeneousReactor<CoeffType,ThermoEvaluator>::HomogeneousReactor( const ReactionSet<CoeffType>& reaction_set,
+                                                                     const ThermoEvaluator& thermo,
+                                                                     ReactorType::ReactorType type,
+                                                                     ReactorEnergy::ReactorEnergy energy )
+    : _chem_mixture( reaction_set.chemical_mixture() ),
+      _thermo( thermo ),
+      _kinetics( reaction_set, 0 ),
+      _type( type ),
+      _energy( energy ),
+      _pressure( 0 ),
+      _density( 0 ),
+      _rho( 0 ),
+      _T( 0 ),
+      _molar_densities( reaction_set.n_species(), 0 ),
+      _h_RT_minus_s_R( reaction_set.n_species(), 0 ),
+      _dh_RT_minus_s_R_dT( reaction_set.n_species(), 0 ),
+      _omega_dot( reaction_set.n_species(), 0 ),
+      _domega_dot_dT( reaction_set.n_species(), 0 ),
+      _domega_dot_drho_s( reaction_set.n_species(), std::vector<CoeffType>(reaction_set.n_species(), 0) ),
+      _e_s( reaction_set.n_species(), 0 ),
+      _c_s( reaction_set.n_species(), 0 ),
+      _dc_s_dT( reaction_set.n_species(), 0 ),
+      _domega_dot_dY( reaction_set.n_species()*reaction_set.n_species(), 0 ),
+      _domega_dot_dT_Y( reaction_set.n_species(), 0 )
+  {
+    return;
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  HomogeneousReactor<CoeffType,ThermoEvaluator>::~HomogeneousReactor()
+  {
+    return;
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  ReactorType::ReactorType HomogeneousReactor<CoeffType,ThermoEvaluator>::type() const
+  {
+    return _type;
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  ReactorEnergy::ReactorEnergy HomogeneousReactor<CoeffType,ThermoEvaluator>::energy() const
+  {
+    return _energy;
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  void HomogeneousReactor<CoeffType,ThermoEvaluator>::set_pressure( const CoeffType P )
+  {
+    antioch_assert_greater( P, CoeffType(0) );
+    _pressure = P;
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  CoeffType HomogeneousReactor<CoeffType,ThermoEvaluator>::pressure() const
+  {
+    return _pressure;
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  void HomogeneousReactor<CoeffType,ThermoEvaluator>::set_density( const CoeffType rho )
+  {
+    antioch_assert_greater( rho, CoeffType(0) );
+    _density = rho;
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  CoeffType HomogeneousReactor<CoeffType,ThermoEvaluator>::density() const
+  {
+    return _density;
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  BDFIntegrator<CoeffType>& HomogeneousReactor<CoeffType,ThermoEvaluator>::integrator()
+  {
+    return _integrator;
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  const BDFIntegrator<CoeffType>& HomogeneousReactor<CoeffType,ThermoEvaluator>::integrator() const
+  {
+    return _integrator;
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  unsigned int HomogeneousReactor<CoeffType,ThermoEvaluator>::n_species() const
+  {
+    return _chem_mixture.n_species();
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  unsigned int HomogeneousReactor<CoeffType,ThermoEvaluator>::n_equations() const
+  {
+    return this->n_species() + 1;
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  void HomogeneousReactor<CoeffType,ThermoEvaluator>::evaluate( const std::vector<CoeffType>& y, bool derivatives )
+  {
+    const unsigned int n_species = this->n_species();
+
+    antioch_assert_equal_to( y.size(), this->n_equations() );
+
+    _T = y[n_species];
+
+    // mass fractions are the first n_species entries of y
+    CoeffType R_mix = y[0]*_chem_mixture.R(0);
+    for( unsigned int s = 1; s < n_species; s++ )
+      R_mix += y[s]*_chem_mixture.R(s);
+
+    if( _type == ReactorType::CONSTANT_PRESSURE )
+      {
+        antioch_assert_greater( _pressure, CoeffType(0) );
+        _rho = _pressure/(R_mix*_T);
+      }
+    else
+      {
+        antioch_assert_greater( _density, CoeffType(0) );
+        _rho = _density;
+      }
+
+    for( unsigned int s = 0; s < n_species; s++ )
+      _molar_densities[s] = _rho*y[s]/_chem_mixture.M(s);
+
+    const TempCache<CoeffType> cache(_T);
+    const KineticsConditions<CoeffType> conditions(_T);
+
+    _thermo.h_RT_minus_s_R( cache, _h_RT_minus_s_R );
+
+    if( derivatives )
+      {
+        _thermo.dh_RT_minus_s_R_dT( cache, _dh_RT_minus_s_R_dT );
+        _kinetics.compute_mass_sources_and_derivs( conditions, _molar_densities, _h_RT_minus_s_R,
+                                                   _dh_RT_minus_s_R_dT, _omega_dot, _domega_dot_dT,
+                                                   _domega_dot_drho_s );
+      }
+    else
+      _kinetics.compute_mass_sources( conditions, _molar_densities, _h_RT_minus_s_R, _omega_dot );
+
+    if( _energy == ReactorEnergy::ISOTHERMAL )
+      return;
+
+    for( unsigned int s = 0; s < n_species; s++ )
+      {
+        _e_s[s] = _thermo.h( cache, s );
+        _c_s[s] = _thermo.cp( cache, s );
+
+        if( _type == ReactorType::CONSTANT_VOLUME )
+          {
+            _e_s[s] -= _chem_mixture.R(s)*_T;
+            _c_s[s] -= _chem_mixture.R(s);
+          }
+
+        if( derivatives )
+          _dc_s_dT[s] = _thermo.dcp_dT( cache, s );
+      }
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  void HomogeneousReactor<CoeffType,ThermoEvaluator>::rhs( const CoeffType /*t*/,
+                                                           const std::vector<CoeffType>& y,
+                                                           std::vector<CoeffType>& dy_dt )
+  {
+    const unsigned int n_species = this->n_species();
+
+    antioch_assert_equal_to( dy_dt.size(), this->n_equations() );
+
+    this->evaluate( y, false );
+
+    for( unsigned int s = 0; s < n_species; s++ )
+      dy_dt[s] = _omega_dot[s]/_rho;
+
+    dy_dt[n_species] = 0;
+
+    if( _energy == ReactorEnergy::ADIABATIC )
+      {
+        CoeffType heat_release = 0;
+        CoeffType c = 0;
+        for( unsigned int s = 0; s < n_species; s++ )
+          {
+            heat_release += _e_s[s]*_omega_dot[s];
+            c += y[s]*_c_s[s];
+          }
+
+        dy_dt[n_species] = -heat_release/(_rho*c);
+      }
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  void HomogeneousReactor<CoeffType,ThermoEvaluator>::jacobian( const CoeffType /*t*/,
+                                                                const std::vector<CoeffType>& y,
+                                                                std::vector<CoeffType>& J )
+  {
+    const unsigned int n_species = this->n_species();
+    const unsigned int n = this->n_equations();
+
+    antioch_assert_equal_to( J.size(), n*n );
+
+    this->evaluate( y, true );
+
+    const bool constant_pressure = ( _type == ReactorType::CONSTANT_PRESSURE );
+
+    // density derivatives, rho = P/(R_mix T) at constant pressure
+    CoeffType R_mix = y[0]*_chem_mixture.R(0);
+    for( unsigned int s = 1; s < n_species; s++ )
+      R_mix += y[s]*_chem_mixture.R(s);
+
+    const CoeffType drho_dT = constant_pressure ? -_rho/_T : CoeffType(0);
+
+    // dw_s/dY_k = rho dw_s/drho_k + drho/dY_k sum_t Y_t dw_s/drho_t, and
+    // dw_s/dT at fixed Y = dw_s/dT + drho/dT sum_t Y_t dw_s/drho_t
+    std::vector<CoeffType>& dw_dY = _domega_dot_dY;
+    std::vector<CoeffType>& dw_dT = _domega_dot_dT_Y;
+    dw_dT = _domega_dot_dT;
+
+    for( unsigned int s = 0; s < n_species; s++ )
+      {
+        const std::vector<CoeffType>& dw_drho = _domega_dot_drho_s[s];
+
+        CoeffType weighted = 0;
+        if( constant_pressure )
+          for( unsigned int t = 0; t < n_species; t++ )
+            weighted += y[t]*dw_drho[t];
+
+        for( unsigned int k = 0; k < n_species; k++ )
+          {
+            dw_dY[s*n_species+k] = _rho*dw_drho[k];
+            if( constant_pressure )
+              dw_dY[s*n_species+k] -= _rho*_chem_mixture.R(k)/R_mix*weighted;
+          }
+
+        dw_dT[s] += drho_dT*weighted;
+      }
+
+    // species rows, d(w_s/rho)
+    const CoeffType inv_rho = 1/_rho;
+    for( unsigned int s = 0; s < n_species; s++ )
+      {
+        const CoeffType f_s = _omega_dot[s]*inv_rho;
+
+        for( unsigned int k = 0; k < n_species; k++ )
+          {
+            J[s*n+k] = dw_dY[s*n_species+k]*inv_rho;
+            if( constant_pressure )
+              J[s*n+k] += f_s*_chem_mixture.R(k)/R_mix;
+          }
+
+        J[s*n+n_species] = dw_dT[s]*inv_rho - f_s*drho_dT*inv_rho;
+      }
+
+    // temperature row
+    for( unsigned int k = 0; k < n; k++ )
+      J[n_species*n+k] = 0;
+
+    if( _energy == ReactorEnergy::ISOTHERMAL )
+      return;
+
+    CoeffType heat_release = 0;
+    CoeffType c = 0;
+    CoeffType dc_dT = 0;
+    CoeffType dheat_release_dT = 0;
+    for( unsigned int s = 0; s < n_species; s++ )
+      {
+        heat_release += _e_s[s]*_omega_dot[s];
+        c += y[s]*_c_s[s];
+        dc_dT += y[s]*_dc_s_dT[s];
+        dheat_release_dT += _c_s[s]*_omega_dot[s] + _e_s[s]*dw_dT[s];
+      }
+
+    const CoeffType rho_c = _rho*c;
+    const CoeffType f_T = -heat_release/rho_c;
+
+    // f_T = -Q/(rho c): df_T = -(dQ + f_T d(rho c))/(rho c)
+    for( unsigned int k = 0; k < n_species; k++ )
+      {
+        CoeffType dheat_release_dY = 0;
+        for( unsigned int s = 0; s < n_species; s++ )
+          dheat_release_dY += _e_s[s]*dw_dY[s*n_species+k];
+
+        CoeffType drho_c_dY = _rho*_c_s[k];
+        if( constant_pressure )
+          drho_c_dY -= _rho*_chem_mixture.R(k)/R_mix*c;
+
+        J[n_species*n+k] = -(dheat_release_dY + f_T*drho_c_dY)/rho_c;
+      }
+
+    const CoeffType drho_c_dT = drho_dT*c + _rho*dc_dT;
+    J[n_species*n+n_species] = -(dheat_release_dT + f_T*drho_c_dT)/rho_c;
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  void HomogeneousReactor<CoeffType,ThermoEvaluator>::advance( std::vector<CoeffType>& y, const CoeffType dt )
+  {
+    _integrator.integrate( *this, 0, dt, y );
+  }
+
+  template<typename CoeffType, typename ThermoEvaluator>
+  inline
+  void HomogeneousReactor<CoeffType,ThermoEvaluator>::advance( std::vector<CoeffType>& mass_fractions,
+                                                               CoeffType& T,
+                                                               const CoeffType dt )
+  {
+    antioch_assert_equal_to( mass_fractions.size(), this->n_species() );
+
+    std::vector<CoeffType> y( mass_fractions );
+    y.push_back(T);
+
+    this->advance( y, dt );
+
+    for( unsigned int s = 0; s < this->n_species(); s++ )
+      mass_fractions[s] = y[s];
+    T = y.back();
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_HOMOGENEOUS_REACTOR_H
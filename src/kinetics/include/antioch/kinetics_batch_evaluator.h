@@ -0,0 +1,316 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+
+
+#ifndef ANTIOCH_KINETICS_BATCH_EVALUATOR_H
+#define ANTIOCH_KINETICS_BATCH_EVALUATOR_H
+
+// Antioch
+#include "antioch/antioch_asserts.h"
+#include "antioch/chemical_mixture.h"
+#include "antioch/compiled_reaction_set.h"
+#include "antioch/stoichiometry_matrix.h"
+
+// C++
+#include <vector>
+#include <algorithm>
+
+namespace Antioch
+{
+  namespace BatchLayout
+  {
+    enum BatchLayout { CELL_MAJOR = 0, //!< data[c*n_species + s], one species vector per cell
+                       SPECIES_MAJOR };//!< data[s*n_cells + c], one cell vector per species
+  }
+
+  //! Class to compute the source terms of many cells at once.
+  /*!
+   * The cells are processed by blocks of block_size() cells. Each block
+   * is copied into species-major work arrays, so that the rates of
+   * progress (CompiledReactionSet::compute_batch_reaction_rates) and the
+   * stoichiometry product are computed with the loop over the cells innermost.
+   * Each cell gets the same operations as KineticsEvaluator built on the
+   * same CompiledReactionSet.
+   *
+   * As KineticsEvaluator, this class preallocates work arrays and so *must*
+   * be created within a spawned thread, if running in a threaded environment.
+   * The compiled set must outlive the evaluator.
+   */
+  template<typename CoeffType=double>
+  class KineticsBatchEvaluator
+  {
+  public:
+
+    KineticsBatchEvaluator( const CompiledReactionSet<CoeffType>& compiled_set,
+                            const unsigned int block_size = 64 );
+
+    ~KineticsBatchEvaluator();
+
+    unsigned int n_species() const;
+
+    unsigned int n_reactions() const;
+
+    //! Number of cells processed together.
+    unsigned int block_size() const;
+
+    //! Compute species molar production/destruction rates per unit volume of n_cells cells
+    /*! \f$ \left(mole/sec/m^3\right)\f$
+     *  T is of size n_cells, the other arrays of size n_cells*n_species
+     *  in the given \p layout.
+     */
+    void compute_mole_sources( const unsigned int n_cells,
+                               const std::vector<CoeffType>& T,
+                               const std::vector<CoeffType>& molar_densities,
+                               const std::vector<CoeffType>& h_RT_minus_s_R,
+                               std::vector<CoeffType>& mole_sources,
+                               BatchLayout::BatchLayout layout = BatchLayout::CELL_MAJOR );
+
+    //! Compute species production/destruction rates per unit volume of n_cells cells
+    /*! \f$ \left(kg/sec/m^3\right)\f$, see compute_mole_sources. */
+    void compute_mass_sources( const unsigned int n_cells,
+                               const std::vector<CoeffType>& T,
+                               const std::vector<CoeffType>& molar_densities,
+                               const std::vector<CoeffType>& h_RT_minus_s_R,
+                               std::vector<CoeffType>& mass_sources,
+                               BatchLayout::BatchLayout layout = BatchLayout::CELL_MAJOR );
+
+  private:
+
+    KineticsBatchEvaluator();
+
+    //! copy cells [first,first+n_block) of data into the species-major block
+    void gather( const std::vector<CoeffType>& data, const unsigned int n_cells,
+                 const unsigned int first, const unsigned int n_block,
+                 BatchLayout::BatchLayout layout, std::vector<CoeffType>& block ) const;
+
+    //! copy the species-major block into cells [first,first+n_block) of data
+    void scatter( const std::vector<CoeffType>& block, const unsigned int n_cells,
+                  const unsigned int first, const unsigned int n_block,
+                  BatchLayout::BatchLayout layout, std::vector<CoeffType>& data ) const;
+
+    const CompiledReactionSet<CoeffType>& _compiled_set;
+
+    const ChemicalMixture<CoeffType>& _chem_mixture;
+
+    const StoichiometryMatrix<CoeffType> _stoichiometry;
+
+    const unsigned int _block_size;
+
+    // species-major (reaction-major for the rates) work arrays of one block
+    std::vector<CoeffType> _T;
+    std::vector<CoeffType> _molar_densities;
+    std::vector<CoeffType> _h_RT_minus_s_R;
+    std::vector<CoeffType> _net_reaction_rates;
+    std::vector<CoeffType> _mole_sources;
+
+    //! work arrays of CompiledReactionSet::compute_batch_reaction_rates
+    typename CompiledReactionSet<CoeffType>::BatchWork _batch_work;
+  };
+
+  /* ------------------------- Inline Functions -------------------------*/
+  template<typename CoeffType>
+  inline
+  KineticsBatchEvaluator<CoeffType>::KineticsBatchEvaluator( const CompiledReactionSet<CoeffType>& compiled_set,
+                                                             const unsigned int block_size )
+    : _compiled_set( compiled_set ),
+      _chem_mixture( compiled_set.reaction_set().chemical_mixture() ),
+      _stoichiometry( compiled_set.reaction_set() ),
+      _block_size( block_size ),
+      _T( block_size ),
+      _molar_densities( block_size*compiled_set.n_species() ),
+      _h_RT_minus_s_R( block_size*compiled_set.n_species() ),
+      _net_reaction_rates( block_size*compiled_set.n_reactions() ),
+      _mole_sources( block_size*compiled_set.n_species() )
+  {
+    antioch_assert_greater( block_size, 0 );
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  KineticsBatchEvaluator<CoeffType>::~KineticsBatchEvaluator()
+  {
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int KineticsBatchEvaluator<CoeffType>::n_species() const
+  {
+    return _compiled_set.n_species();
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int KineticsBatchEvaluator<CoeffType>::n_reactions() const
+  {
+    return _compiled_set.n_reactions();
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int KineticsBatchEvaluator<CoeffType>::block_size() const
+  {
+    return _block_size;
+  }
+
+  template<typename CoeffType>
+  inline
+  void KineticsBatchEvaluator<CoeffType>::gather( const std::vector<CoeffType>& data, const unsigned int n_cells,
+                                                  const unsigned int first, const unsigned int n_block,
+                                                  BatchLayout::BatchLayout layout, std::vector<CoeffType>& block ) const
+  {
+    const unsigned int n_species = this->n_species();
+
+    if( layout == BatchLayout::CELL_MAJOR )
+      {
+        for( unsigned int c = 0; c < n_block; c++ )
+          for( unsigned int s = 0; s < n_species; s++ )
+            block[s*n_block + c] = data[(first + c)*n_species + s];
+      }
+    else
+      {
+        for( unsigned int s = 0; s < n_species; s++ )
+          std::copy( data.begin() + s*n_cells + first,
+                     data.begin() + s*n_cells + first + n_block,
+                     block.begin() + s*n_block );
+      }
+  }
+
+  template<typename CoeffType>
+  inline
+  void KineticsBatchEvaluator<CoeffType>::scatter( const std::vector<CoeffType>& block, const unsigned int n_cells,
+                                                   const unsigned int first, const unsigned int n_block,
+                                                   BatchLayout::BatchLayout layout, std::vector<CoeffType>& data ) const
+  {
+    const unsigned int n_species = this->n_species();
+
+    if( layout == BatchLayout::CELL_MAJOR )
+      {
+        for( unsigned int c = 0; c < n_block; c++ )
+          for( unsigned int s = 0; s < n_species; s++ )
+            data[(first + c)*n_species + s] = block[s*n_block + c];
+      }
+    else
+      {
+        for( unsigned int s = 0; s < n_species; s++ )
+          std::copy( block.begin() + s*n_block,
+                     block.begin() + (s+1)*n_block,
+                     data.begin() + s*n_cells + first );
+      }
+  }
+
+  template<typename CoeffType>
+  inline
+  void KineticsBatchEvaluator<CoeffType>::compute_mole_sources( const unsigned int n_cells,
+                                                                const std::vector<CoeffType>& T,
+                                                                const std::vector<CoeffType>& molar_densities,
+                                                                const std::vector<CoeffType>& h_RT_minus_s_R,
+                                                                std::vector<CoeffType>& mole_sources,
+                                                                BatchLayout::BatchLayout layout )
+  {
+    const unsigned int n_species = this->n_species();
+
+    antioch_assert_equal_to( T.size(), n_cells );
+    antioch_assert_equal_to( molar_densities.size(), n_cells*n_species );
+    antioch_assert_equal_to( h_RT_minus_s_R.size(), n_cells*n_species );
+    antioch_assert_equal_to( mole_sources.size(), n_cells*n_species );
+
+    const std::vector<unsigned int>& row_offsets = _stoichiometry.row_offsets();
+    const std::vector<unsigned int>& reaction_ids = _stoichiometry.reaction_ids();
+    const std::vector<CoeffType>& nu = _stoichiometry.values();
+
+    for( unsigned int first = 0; first < n_cells; first += _block_size )
+      {
+        const unsigned int n_block = std::min( _block_size, n_cells - first );
+
+        std::copy( T.begin() + first, T.begin() + first + n_block, _T.begin() );
+        this->gather( molar_densities, n_cells, first, n_block, layout, _molar_densities );
+        this->gather( h_RT_minus_s_R, n_cells, first, n_block, layout, _h_RT_minus_s_R );
+
+        _compiled_set.compute_batch_reaction_rates( n_block, _batch_work, _T, _molar_densities,
+                                                    _h_RT_minus_s_R, _net_reaction_rates );
+
+        // compute the actual mole sources in kmol/sec/m^3, as StoichiometryMatrix::multiply
+        for( unsigned int s = 0; s < n_species; s++ )
+          {
+            CoeffType* omega = &_mole_sources[s*n_block];
+
+            for( unsigned int c = 0; c < n_block; c++ )
+              omega[c] = 0;
+
+            for( unsigned int i = row_offsets[s]; i < row_offsets[s+1]; i++ )
+              {
+                const CoeffType* q = &_net_reaction_rates[reaction_ids[i]*n_block];
+                const CoeffType nu_i = nu[i];
+                for( unsigned int c = 0; c < n_block; c++ )
+                  omega[c] += nu_i * q[c];
+              }
+          }
+
+        this->scatter( _mole_sources, n_cells, first, n_block, layout, mole_sources );
+      }
+
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  void KineticsBatchEvaluator<CoeffType>::compute_mass_sources( const unsigned int n_cells,
+                                                                const std::vector<CoeffType>& T,
+                                                                const std::vector<CoeffType>& molar_densities,
+                                                                const std::vector<CoeffType>& h_RT_minus_s_R,
+                                                                std::vector<CoeffType>& mass_sources,
+                                                                BatchLayout::BatchLayout layout )
+  {
+    // Quantities asserted in compute_mole_sources call
+    this->compute_mole_sources( n_cells, T, molar_densities, h_RT_minus_s_R, mass_sources, layout );
+
+    // finally scale by molar mass
+    const unsigned int n_species = this->n_species();
+    if( layout == BatchLayout::CELL_MAJOR )
+      {
+        for( unsigned int c = 0; c < n_cells; c++ )
+          for( unsigned int s = 0; s < n_species; s++ )
+            mass_sources[c*n_species + s] *= _chem_mixture.M(s);
+      }
+    else
+      {
+        for( unsigned int s = 0; s < n_species; s++ )
+          {
+            const CoeffType M = _chem_mixture.M(s);
+            for( unsigned int c = 0; c < n_cells; c++ )
+              mass_sources[s*n_cells + c] *= M;
+          }
+      }
+
+    return;
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_KINETICS_BATCH_EVALUATOR_H
@@ -30,6 +30,9 @@
 // Antioch
 #include "antioch/metaprogramming.h"
 #include "antioch/reaction_set.h"
+#include "antioch/compiled_reaction_set.h"
+#include "antioch/stoichiometry_matrix.h"
+#include "antioch/kinetics_jacobian_pattern.h"
 #include "antioch/kinetics_conditions.h"
 
 // C++
@@ -41,6 +44,9 @@ namespace Antioch
   template<typename CoeffType>
   class ReactionSet;
 
+  template<typename CoeffType>
+  class CompiledReactionSet;
+
   template<typename CoeffType>
   class ChemicalMixture;
   
@@ -62,10 +68,22 @@ namespace Antioch
     KineticsEvaluator( const ReactionSet<CoeffType>& reaction_set,
                        const StateType& example );
 
+    //! Constructor from a compiled reaction set
+    /*! The rates of progress of compute_mole_sources and compute_mass_sources
+     *  are then evaluated by the CompiledReactionSet, the derivatives still
+     *  go through the underlying ReactionSet. The compiled set must outlive
+     *  the evaluator.
+     */
+    KineticsEvaluator( const CompiledReactionSet<CoeffType>& compiled_set,
+                       const StateType& example );
+
     ~KineticsEvaluator();
 
     const ReactionSet<CoeffType>& reaction_set() const;
 
+    //! Net stoichiometry matrix used to assemble the species source terms
+    const StoichiometryMatrix<CoeffType>& stoichiometry_matrix() const;
+
     //! Compute species production/destruction rates per unit volume
     /*! \f$ \left(kg/sec/m^3\right)\f$ */
     template <typename VectorStateType, typename KC>
@@ -106,21 +124,181 @@ namespace Antioch
                                           VectorStateType& dmole_dT,
                                           std::vector<VectorStateType>& dmole_dX_s );
 
+    //! Compute species molar production/destruction rates and their sparse Jacobian
+    /*! Same as compute_mole_sources_and_derivs, but \p dmole_dX_s holds only
+     *  the entries of \p pattern, in its storage order (size pattern.n_nonzeros()).
+     *  The pattern must have been built on stoichiometry_matrix() or on an
+     *  identical matrix.
+     */
+    template <typename VectorStateType, typename KC>
+    void compute_mole_sources_and_sparse_derivs( const KC& conditions,
+                                                 const VectorStateType& molar_densities,
+                                                 const VectorStateType& h_RT_minus_s_R,
+                                                 const VectorStateType& dh_RT_minus_s_R_dT,
+                                                 const KineticsJacobianPattern<CoeffType>& pattern,
+                                                 VectorStateType& mole_sources,
+                                                 VectorStateType& dmole_dT,
+                                                 VectorStateType& dmole_dX_s );
+
+    //! Compute species production/destruction rates and their sparse Jacobian
+    /*! In mass units, see compute_mole_sources_and_sparse_derivs. */
+    template <typename VectorStateType, typename KC>
+    void compute_mass_sources_and_sparse_derivs( const KC& conditions,
+                                                 const VectorStateType& molar_densities,
+                                                 const VectorStateType& h_RT_minus_s_R,
+                                                 const VectorStateType& dh_RT_minus_s_R_dT,
+                                                 const KineticsJacobianPattern<CoeffType>& pattern,
+                                                 VectorStateType& mass_sources,
+                                                 VectorStateType& dmass_dT,
+                                                 VectorStateType& dmass_drho_s );
+
+    //! Compute species molar production/destruction rates of the active reactions
+    /*! The reactions outside \p subset contribute nothing. The rates are
+     *  computed by the ReactionSet, also for an evaluator built on a
+     *  CompiledReactionSet. */
+    template <typename VectorStateType, typename KC>
+    void compute_mole_sources( const KC& conditions,
+                               const VectorStateType& molar_densities,
+                               const VectorStateType& h_RT_minus_s_R,
+                               const ActiveReactionSubset<CoeffType>& subset,
+                               VectorStateType& mole_sources );
+
+    //! Compute species production/destruction rates of the active reactions
+    /*! In mass units, see the subset compute_mole_sources. */
+    template <typename VectorStateType, typename KC>
+    void compute_mass_sources( const KC& conditions,
+                               const VectorStateType& molar_densities,
+                               const VectorStateType& h_RT_minus_s_R,
+                               const ActiveReactionSubset<CoeffType>& subset,
+                               VectorStateType& mass_sources );
+
+    //! Compute species molar production/destruction rates and derivatives of the active reactions
+    /*! The reactions outside \p subset contribute nothing to the sources
+     *  nor to the derivatives. */
+    template <typename VectorStateType, typename KC>
+    void compute_mole_sources_and_derivs( const KC& conditions,
+                                          const VectorStateType& molar_densities,
+                                          const VectorStateType& h_RT_minus_s_R,
+                                          const VectorStateType& dh_RT_minus_s_R_dT,
+                                          const ActiveReactionSubset<CoeffType>& subset,
+                                          VectorStateType& mole_sources,
+                                          VectorStateType& dmole_dT,
+                                          std::vector<VectorStateType>& dmole_dX_s );
+
+    //! Compute species production/destruction rates and derivatives of the active reactions
+    /*! In mass units, see the subset compute_mole_sources_and_derivs. */
+    template <typename VectorStateType, typename KC>
+    void compute_mass_sources_and_derivs( const KC& conditions,
+                                          const VectorStateType& molar_densities,
+                                          const VectorStateType& h_RT_minus_s_R,
+                                          const VectorStateType& dh_RT_minus_s_R_dT,
+                                          const ActiveReactionSubset<CoeffType>& subset,
+                                          VectorStateType& mass_sources,
+                                          VectorStateType& dmass_dT,
+                                          std::vector<VectorStateType>& dmass_drho_s );
+
+    //! Compute species molar production/destruction rates and their sensitivities to the rate parameters
+    /*! Derivatives of the mole sources with respect to \f$\ln A_r\f$,
+     *  \f$\beta_r\f$ and \f$E_{a,r}\f$ (in K, as stored) of every reaction r,
+     *  see Reaction::compute_forward_rate_coefficient_log_parameter_derivatives.
+     *  A parameter of reaction r only changes the sources of the species of r,
+     *  so \p dmole_dlnA, \p dmole_dbeta and \p dmole_dEa hold the entries of
+     *  stoichiometry_matrix(), in its storage order (size n_nonzeros()):
+     *  entry i is the derivative of the source of the species of its row with
+     *  respect to the parameter of reaction stoichiometry_matrix().reaction_ids()[i].
+     *  The rates of progress are evaluated once, no finite differences.
+     *
+     *  There is one triplet of parameters per reaction, not per rate: the
+     *  parameter of a reaction with several rates is the common shift of
+     *  all of them, i.e. both k_0 and k_inf of a falloff, every rate of a
+     *  duplicate, every pressure level of a PLOG. A Chebyshev reaction
+     *  only has the ln A entry, a uniform scaling of its rate (its beta
+     *  and E_a entries are 0).
+     */
+    template <typename VectorStateType, typename KC>
+    void compute_mole_sources_and_parameter_sensitivities( const KC& conditions,
+                                                           const VectorStateType& molar_densities,
+                                                           const VectorStateType& h_RT_minus_s_R,
+                                                           VectorStateType& mole_sources,
+                                                           VectorStateType& dmole_dlnA,
+                                                           VectorStateType& dmole_dbeta,
+                                                           VectorStateType& dmole_dEa );
+
+    //! Compute species production/destruction rates and their sensitivities to the rate parameters
+    /*! In mass units, see compute_mole_sources_and_parameter_sensitivities. */
+    template <typename VectorStateType, typename KC>
+    void compute_mass_sources_and_parameter_sensitivities( const KC& conditions,
+                                                           const VectorStateType& molar_densities,
+                                                           const VectorStateType& h_RT_minus_s_R,
+                                                           VectorStateType& mass_sources,
+                                                           VectorStateType& dmass_dlnA,
+                                                           VectorStateType& dmass_dbeta,
+                                                           VectorStateType& dmass_dEa );
+
+    //! Rates of progress of the last evaluation
+    /*! Not a measure of importance for ActiveReactionSubset::update(): a reaction
+        in partial equilibrium has a small net rate. */
+    const std::vector<StateType>& net_reaction_rates() const;
+
     unsigned int n_species() const;
 
     unsigned int n_reactions() const;
 
   protected:
 
+    //! Zero the sources and derivatives before a reaction by reaction assembly
+    template <typename VectorStateType>
+    void zero_sources_and_derivs( VectorStateType& mole_sources,
+                                  VectorStateType& dmole_dT,
+                                  std::vector<VectorStateType>& dmole_dX_s );
+
+    //! Add the contributions of reaction \p rxn to the sources and derivatives
+    template <typename VectorStateType>
+    void add_reaction_sources_and_derivs( const unsigned int rxn,
+                                          const KineticsConditions<StateType,VectorStateType>& conditions,
+                                          const StateType& total_concentration,
+                                          const VectorStateType& molar_densities,
+                                          const VectorStateType& h_RT_minus_s_R,
+                                          const VectorStateType& dh_RT_minus_s_R_dT,
+                                          VectorStateType& mole_sources,
+                                          VectorStateType& dmole_dT,
+                                          std::vector<VectorStateType>& dmole_dX_s );
+
+    //! Add \p factor times the derivatives of the rate of \p reaction, in _drate_dX_s, to \p dsource_dX_s
+    /*! Only the species the rate depends on are visited, the other entries of _drate_dX_s are stale. */
+    template <typename VectorStateType>
+    void add_rate_derivatives( const Reaction<CoeffType>& reaction,
+                               const CoeffType factor,
+                               VectorStateType& dsource_dX_s ) const;
+
+    //! Convert sources and derivatives from mole to mass units
+    template <typename VectorStateType>
+    void mole_to_mass_sources_and_derivs( VectorStateType& sources,
+                                          VectorStateType& dsources_dT,
+                                          std::vector<VectorStateType>& dsources_dX_s ) const;
+
     const ReactionSet<CoeffType>& _reaction_set;
 
+    //! NULL if the rates are computed by the ReactionSet
+    const CompiledReactionSet<CoeffType>* _compiled_set;
+
     const ChemicalMixture<CoeffType>& _chem_mixture;
 
+    const StoichiometryMatrix<CoeffType> _stoichiometry;
+
     std::vector<StateType> _net_reaction_rates;
 
     std::vector<StateType> _dnet_rate_dT;
 
-    std::vector<std::vector<StateType> > _dnet_rate_dX_s;
+    //! derivatives of one reaction, the Jacobian is assembled reaction by reaction
+    /*! Only the entries of the species the current reaction depends on are up to date. */
+    std::vector<StateType> _drate_dX_s;
+
+    //! derivatives of the rates of progress w.r.t. ln(A), beta and Ea, three per reaction
+    std::vector<StateType> _drate_dparameters;
+
+    //! species factors of the equilibrium constants, kept across evaluations
+    EquilibriumFactors<CoeffType,StateType> _equilibrium_factors;
   };
 
   /* ------------------------- Inline Functions -------------------------*/
@@ -131,6 +309,20 @@ namespace Antioch
     return _reaction_set;
   }
 
+  template<typename CoeffType, typename StateType>
+  inline
+  const StoichiometryMatrix<CoeffType>& KineticsEvaluator<CoeffType,StateType>::stoichiometry_matrix() const
+  {
+    return _stoichiometry;
+  }
+
+  template<typename CoeffType, typename StateType>
+  inline
+  const std::vector<StateType>& KineticsEvaluator<CoeffType,StateType>::net_reaction_rates() const
+  {
+    return _net_reaction_rates;
+  }
+
   template<typename CoeffType, typename StateType>
   inline
   unsigned int KineticsEvaluator<CoeffType,StateType>::n_species() const
@@ -152,16 +344,35 @@ namespace Antioch
   ( const ReactionSet<CoeffType>& reaction_set,
     const StateType& example )
     : _reaction_set( reaction_set ),
+      _compiled_set( NULL ),
       _chem_mixture( reaction_set.chemical_mixture() ),
+      _stoichiometry( reaction_set ),
       _net_reaction_rates( reaction_set.n_reactions(), example ),
       _dnet_rate_dT( reaction_set.n_reactions(), example ),
-      _dnet_rate_dX_s( reaction_set.n_reactions() )
+      _drate_dX_s( reaction_set.n_species(), example ),
+      _drate_dparameters( 3*reaction_set.n_reactions(), example ),
+      _equilibrium_factors( reaction_set, example )
   {
+    return;
+  }
 
-    for( unsigned int r = 0; r < this->n_reactions(); r++ )
-      {
-        _dnet_rate_dX_s[r].resize( reaction_set.n_species(), example );
-      }
+
+  template<typename CoeffType, typename StateType>
+  inline
+  KineticsEvaluator<CoeffType,StateType>::KineticsEvaluator
+  ( const CompiledReactionSet<CoeffType>& compiled_set,
+    const StateType& example )
+    : _reaction_set( compiled_set.reaction_set() ),
+      _compiled_set( &compiled_set ),
+      _chem_mixture( compiled_set.reaction_set().chemical_mixture() ),
+      _stoichiometry( compiled_set.reaction_set() ),
+      _net_reaction_rates( compiled_set.n_reactions(), example ),
+      _dnet_rate_dT( compiled_set.n_reactions(), example ),
+      _drate_dX_s( compiled_set.n_species(), example ),
+      _drate_dparameters( 3*compiled_set.n_reactions(), example ),
+      _equilibrium_factors( compiled_set.reaction_set(), example )
+  {
+    antioch_assert_equal_to( compiled_set.n_reactions(), compiled_set.reaction_set().n_reactions() );
 
     return;
   }
@@ -191,45 +402,24 @@ namespace Antioch
     /*! \todo Do we need to really initialize this? */
     Antioch::set_zero(_net_reaction_rates);
 
-    Antioch::set_zero(mole_sources);
-
     typename constructor_or_reference<const KineticsConditions<StateType,VectorStateType>, const KC>::type  //either (KineticsConditions<> &) or (KineticsConditions<>)
                 kinetics_conditions(conditions);
     // compute the requisite reaction rates
-    this->_reaction_set.compute_reaction_rates( kinetics_conditions, molar_densities,
-                                                h_RT_minus_s_R, _net_reaction_rates );
+    if( _compiled_set )
+      _compiled_set->compute_reaction_rates( kinetics_conditions, _equilibrium_factors, molar_densities,
+                                             h_RT_minus_s_R, _net_reaction_rates );
+    else
+      this->_reaction_set.compute_reaction_rates( kinetics_conditions, _equilibrium_factors, molar_densities,
+                                                  h_RT_minus_s_R, _net_reaction_rates );
+
+    // We'd *like* to assert that our rates aren't NaN, but if we
+    // have two infinitely-stiff reactions contributing in
+    // opposite directions to the same rate, then NaN is the
+    // correct output, and hopefully our user code has some way to
+    // recover from that.
 
     // compute the actual mole sources in kmol/sec/m^3
-    for (unsigned int rxn = 0; rxn < this->n_reactions(); rxn++)
-      {
-        const Reaction<CoeffType>& reaction = this->_reaction_set.reaction(rxn);
-        const StateType rate = _net_reaction_rates[rxn];
-
-        // We'd *like* to assert that our rates aren't NaN, but if we
-        // have two infinitely-stiff reactions contributing in
-        // opposite directions to the same rate, then NaN is the
-        // correct output, and hopefully our user code has some way to
-        // recover from that.
-//        antioch_assert(!has_nan(rate));
-        
-        // reactant contributions
-        for (unsigned int r = 0; r < reaction.n_reactants(); r++)
-          {
-            const unsigned int r_id = reaction.reactant_id(r);
-            const unsigned int r_stoich = reaction.reactant_stoichiometric_coefficient(r);
-            
-            mole_sources[r_id] -= (static_cast<CoeffType>(r_stoich)*rate);
-          }
-        
-        // product contributions
-        for (unsigned int p=0; p < reaction.n_products(); p++)
-          {
-            const unsigned int p_id = reaction.product_id(p);
-            const unsigned int p_stoich = reaction.product_stoichiometric_coefficient(p);
-            
-            mole_sources[p_id] += (static_cast<CoeffType>(p_stoich)*rate);
-          }
-      }
+    _stoichiometry.multiply( _net_reaction_rates, mole_sources );
 
     return;
   }
@@ -282,6 +472,154 @@ namespace Antioch
       }
 #endif
     
+    this->zero_sources_and_derivs( mole_sources, dmole_dT, dmole_dX_s );
+
+    typename constructor_or_reference<const KineticsConditions<StateType,VectorStateType>, const KC>::type  //either (KineticsConditions<> &) or (KineticsConditions<>)
+                                        kinetics_conditions(conditions);
+
+    _equilibrium_factors.update( kinetics_conditions.T(), h_RT_minus_s_R );
+    const StateType total_concentration = Antioch::total_concentration<StateType>( molar_densities );
+
+    // compute the actual mole sources in kmol/sec/m^3, reaction by reaction
+    for (unsigned int rxn = 0; rxn < this->n_reactions(); rxn++)
+      this->add_reaction_sources_and_derivs( rxn, kinetics_conditions, total_concentration,
+                                             molar_densities, h_RT_minus_s_R, dh_RT_minus_s_R_dT,
+                                             mole_sources, dmole_dT, dmole_dX_s );
+
+    return;
+  }
+
+
+  template<typename CoeffType, typename StateType>
+  template <typename VectorStateType, typename KC>
+  inline
+  void KineticsEvaluator<CoeffType,StateType>::compute_mass_sources_and_derivs( const KC& conditions,
+                                                                                const VectorStateType& molar_densities,
+                                                                                const VectorStateType& h_RT_minus_s_R,
+                                                                                const VectorStateType& dh_RT_minus_s_R_dT,
+                                                                                VectorStateType& mass_sources,
+                                                                                VectorStateType& dmass_dT,
+                                                                                std::vector<VectorStateType>& dmass_drho_s )
+  {
+    // Asserts are in compute_mole_sources
+    this->compute_mole_sources_and_derivs( conditions, molar_densities, h_RT_minus_s_R, dh_RT_minus_s_R_dT,
+                                           mass_sources, dmass_dT, dmass_drho_s );
+    
+    // Convert from mole units to mass units
+    this->mole_to_mass_sources_and_derivs( mass_sources, dmass_dT, dmass_drho_s );
+
+    return;
+  }
+
+  template<typename CoeffType, typename StateType>
+  template<typename VectorStateType, typename KC>
+  inline
+  void KineticsEvaluator<CoeffType,StateType>::compute_mole_sources( const KC& conditions,
+                                                                     const VectorStateType& molar_densities,
+                                                                     const VectorStateType& h_RT_minus_s_R,
+                                                                     const ActiveReactionSubset<CoeffType>& subset,
+                                                                     VectorStateType& mole_sources )
+  {
+    antioch_assert_equal_to( molar_densities.size(), this->n_species() );
+    antioch_assert_equal_to( h_RT_minus_s_R.size(), this->n_species() );
+    antioch_assert_equal_to( mole_sources.size(), this->n_species() );
+    antioch_assert_equal_to( subset.n_reactions(), this->n_reactions() );
+
+    typename constructor_or_reference<const KineticsConditions<StateType,VectorStateType>, const KC>::type  //either (KineticsConditions<> &) or (KineticsConditions<>)
+                kinetics_conditions(conditions);
+
+    // inactive reactions get a zero rate
+    this->_reaction_set.compute_reaction_rates( kinetics_conditions, _equilibrium_factors, molar_densities,
+                                                h_RT_minus_s_R, subset, _net_reaction_rates );
+
+    _stoichiometry.multiply( _net_reaction_rates, mole_sources );
+
+    return;
+  }
+
+  template<typename CoeffType, typename StateType>
+  template<typename VectorStateType, typename KC>
+  inline
+  void KineticsEvaluator<CoeffType,StateType>::compute_mass_sources( const KC& conditions,
+                                                                     const VectorStateType& molar_densities,
+                                                                     const VectorStateType& h_RT_minus_s_R,
+                                                                     const ActiveReactionSubset<CoeffType>& subset,
+                                                                     VectorStateType& mass_sources )
+  {
+    this->compute_mole_sources( conditions, molar_densities, h_RT_minus_s_R, subset, mass_sources );
+
+    for (unsigned int s=0; s < this->n_species(); s++)
+      {
+        mass_sources[s] *= _chem_mixture.M(s);
+      }
+
+    return;
+  }
+
+  template<typename CoeffType, typename StateType>
+  template<typename VectorStateType, typename KC>
+  inline
+  void KineticsEvaluator<CoeffType,StateType>::compute_mole_sources_and_derivs( const KC& conditions,
+                                                                                const VectorStateType& molar_densities,
+                                                                                const VectorStateType& h_RT_minus_s_R,
+                                                                                const VectorStateType& dh_RT_minus_s_R_dT,
+                                                                                const ActiveReactionSubset<CoeffType>& subset,
+                                                                                VectorStateType& mole_sources,
+                                                                                VectorStateType& dmole_dT,
+                                                                                std::vector<VectorStateType>& dmole_dX_s )
+  {
+    antioch_assert_equal_to( molar_densities.size(), this->n_species() );
+    antioch_assert_equal_to( h_RT_minus_s_R.size(), this->n_species() );
+    antioch_assert_equal_to( dh_RT_minus_s_R_dT.size(), this->n_species() );
+    antioch_assert_equal_to( mole_sources.size(), this->n_species() );
+    antioch_assert_equal_to( dmole_dT.size(), this->n_species() );
+    antioch_assert_equal_to( dmole_dX_s.size(), this->n_species() );
+    antioch_assert_equal_to( subset.n_reactions(), this->n_reactions() );
+
+    this->zero_sources_and_derivs( mole_sources, dmole_dT, dmole_dX_s );
+
+    typename constructor_or_reference<const KineticsConditions<StateType,VectorStateType>, const KC>::type  //either (KineticsConditions<> &) or (KineticsConditions<>)
+                                        kinetics_conditions(conditions);
+
+    _equilibrium_factors.update( kinetics_conditions.T(), h_RT_minus_s_R );
+    const StateType total_concentration = Antioch::total_concentration<StateType>( molar_densities );
+
+    const std::vector<unsigned int>& active_reactions = subset.active_reactions();
+    for (unsigned int i = 0; i < active_reactions.size(); i++)
+      this->add_reaction_sources_and_derivs( active_reactions[i], kinetics_conditions, total_concentration,
+                                             molar_densities, h_RT_minus_s_R, dh_RT_minus_s_R_dT,
+                                             mole_sources, dmole_dT, dmole_dX_s );
+
+    return;
+  }
+
+  template<typename CoeffType, typename StateType>
+  template <typename VectorStateType, typename KC>
+  inline
+  void KineticsEvaluator<CoeffType,StateType>::compute_mass_sources_and_derivs( const KC& conditions,
+                                                                                const VectorStateType& molar_densities,
+                                                                                const VectorStateType& h_RT_minus_s_R,
+                                                                                const VectorStateType& dh_RT_minus_s_R_dT,
+                                                                                const ActiveReactionSubset<CoeffType>& subset,
+                                                                                VectorStateType& mass_sources,
+                                                                                VectorStateType& dmass_dT,
+                                                                                std::vector<VectorStateType>& dmass_drho_s )
+  {
+    this->compute_mole_sources_and_derivs( conditions, molar_densities, h_RT_minus_s_R, dh_RT_minus_s_R_dT,
+                                           subset, mass_sources, dmass_dT, dmass_drho_s );
+
+    this->mole_to_mass_sources_and_derivs( mass_sources, dmass_dT, dmass_drho_s );
+
+    return;
+  }
+
+  template<typename CoeffType, typename StateType>
+  template <typename VectorStateType>
+  inline
+  void KineticsEvaluator<CoeffType,StateType>::zero_sources_and_derivs( VectorStateType& mole_sources,
+                                                                        VectorStateType& dmole_dT,
+                                                                        std::vector<VectorStateType>& dmole_dX_s )
+  {
     /*! \todo Do we need to really initialize these? */
     Antioch::set_zero(_net_reaction_rates);
     Antioch::set_zero(_dnet_rate_dT);
@@ -292,69 +630,175 @@ namespace Antioch
       {
         Antioch::set_zero(dmole_dX_s[s]);
       }
+  }
+
+  template<typename CoeffType, typename StateType>
+  template <typename VectorStateType>
+  inline
+  void KineticsEvaluator<CoeffType,StateType>::add_reaction_sources_and_derivs( const unsigned int rxn,
+                                                                                const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                                                const StateType& total_concentration,
+                                                                                const VectorStateType& molar_densities,
+                                                                                const VectorStateType& h_RT_minus_s_R,
+                                                                                const VectorStateType& dh_RT_minus_s_R_dT,
+                                                                                VectorStateType& mole_sources,
+                                                                                VectorStateType& dmole_dT,
+                                                                                std::vector<VectorStateType>& dmole_dX_s )
+  {
+    this->_reaction_set.compute_reaction_rate_and_derivs( rxn, conditions, _equilibrium_factors,
+                                                          total_concentration, molar_densities,
+                                                          h_RT_minus_s_R, dh_RT_minus_s_R_dT,
+                                                          _net_reaction_rates[rxn],
+                                                          _dnet_rate_dT[rxn],
+                                                          _drate_dX_s );
+
+    const Reaction<CoeffType>& reaction = this->_reaction_set.reaction(rxn);
 
-    for (unsigned int rxn=0; rxn < this->n_reactions(); rxn++)
+    const StateType& rate = _net_reaction_rates[rxn];
+    const StateType& drate_dT = _dnet_rate_dT[rxn];
+
+    // reactant contributions
+    for (unsigned int r = 0; r < reaction.n_reactants(); r++)
       {
-        /*! \todo Do we need to really initialize this? */
-        Antioch::set_zero(_dnet_rate_dX_s[rxn]);
+        const unsigned int r_id = reaction.reactant_id(r);
+        const unsigned int r_stoich = reaction.reactant_stoichiometric_coefficient(r);
+        
+        mole_sources[r_id] -= (static_cast<CoeffType>(r_stoich)*rate);
+
+        // d/dT rate contributions
+        dmole_dT[r_id] -= (static_cast<CoeffType>(r_stoich)*drate_dT);
+
+        // d(.m)/dX_s rate contributions
+        this->add_rate_derivatives( reaction, -static_cast<CoeffType>(r_stoich), dmole_dX_s[r_id] );
       }
+    
+    // product contributions
+    for (unsigned int p=0; p < reaction.n_products(); p++)
+      {
+        const unsigned int p_id = reaction.product_id(p);
+        const unsigned int p_stoich = reaction.product_stoichiometric_coefficient(p);
+        
+        mole_sources[p_id] += (static_cast<CoeffType>(p_stoich)*rate);
 
-    typename constructor_or_reference<const KineticsConditions<StateType,VectorStateType>, const KC>::type  //either (KineticsConditions<> &) or (KineticsConditions<>)
-                                        kinetics_conditions(conditions);
-    // compute the requisite reaction rates
-    this->_reaction_set.compute_reaction_rates_and_derivs( kinetics_conditions, molar_densities, 
-                                                           h_RT_minus_s_R, dh_RT_minus_s_R_dT,
-                                                           _net_reaction_rates,
-                                                           _dnet_rate_dT, 
-                                                           _dnet_rate_dX_s );
-    // compute the actual mole sources in kmol/sec/m^3
-    for (unsigned int rxn = 0; rxn < this->n_reactions(); rxn++)
+        // d/dT rate contributions
+        dmole_dT[p_id] += (static_cast<CoeffType>(p_stoich)*drate_dT);
+
+        // d/dX_s rate contributions
+        this->add_rate_derivatives( reaction, static_cast<CoeffType>(p_stoich), dmole_dX_s[p_id] );
+      }
+  }
+
+  template<typename CoeffType, typename StateType>
+  template <typename VectorStateType>
+  inline
+  void KineticsEvaluator<CoeffType,StateType>::add_rate_derivatives( const Reaction<CoeffType>& reaction,
+                                                                     const CoeffType factor,
+                                                                     VectorStateType& dsource_dX_s ) const
+  {
+    if( reaction.rate_coefficient_depends_on_concentrations() )
       {
+        for (unsigned int s=0; s < this->n_species(); s++)
+          dsource_dX_s[s] += factor*_drate_dX_s[s];
 
-        const Reaction<CoeffType>& reaction = this->_reaction_set.reaction(rxn);
+        return;
+      }
 
-        /*! \todo Are these going to get optimized out? Should we remove them? */
-        const StateType rate = _net_reaction_rates[rxn];
-        const StateType drate_dT = _dnet_rate_dT[rxn];
-        const VectorStateType drate_dX_s = _dnet_rate_dX_s[rxn];
+    for (unsigned int r = 0; r < reaction.n_reactants(); r++)
+      {
+        const unsigned int s = reaction.reactant_id(r);
+        dsource_dX_s[s] += factor*_drate_dX_s[s];
+      }
 
-        // reactant contributions
-        for (unsigned int r = 0; r < reaction.n_reactants(); r++)
-          {
-            const unsigned int r_id = reaction.reactant_id(r);
-            const unsigned int r_stoich = reaction.reactant_stoichiometric_coefficient(r);
-            
-            mole_sources[r_id] -= (static_cast<CoeffType>(r_stoich)*rate);
+    if( !reaction.reversible() )
+      return;
 
-            // d/dT rate contributions
-            dmole_dT[r_id] -= (static_cast<CoeffType>(r_stoich)*drate_dT);
+    // the species on both sides are already done
+    for (unsigned int p = 0; p < reaction.n_products(); p++)
+      {
+        const unsigned int s = reaction.product_id(p);
+        if( reaction.species_reactant_stoichiometric_coefficient(s) == 0 )
+          dsource_dX_s[s] += factor*_drate_dX_s[s];
+      }
+  }
 
-            // d(.m)/dX_s rate contributions
-            for (unsigned int s=0; s < this->n_species(); s++)
-              {
-                dmole_dX_s[r_id][s] -= (static_cast<CoeffType>(r_stoich)*drate_dX_s[s]);
-              }
-          }
-        
-        // product contributions
-        for (unsigned int p=0; p < reaction.n_products(); p++)
+  template<typename CoeffType, typename StateType>
+  template <typename VectorStateType>
+  inline
+  void KineticsEvaluator<CoeffType,StateType>::mole_to_mass_sources_and_derivs( VectorStateType& sources,
+                                                                                VectorStateType& dsources_dT,
+                                                                                std::vector<VectorStateType>& dsources_dX_s ) const
+  {
+    for (unsigned int s=0; s < this->n_species(); s++)
+      {
+        sources[s] *= _chem_mixture.M(s);
+        dsources_dT[s] *= _chem_mixture.M(s);
+
+        for (unsigned int t=0; t < this->n_species(); t++)
           {
-            const unsigned int p_id = reaction.product_id(p);
-            const unsigned int p_stoich = reaction.product_stoichiometric_coefficient(p);
-            
-            mole_sources[p_id] += (static_cast<CoeffType>(p_stoich)*rate);
+            dsources_dX_s[s][t] *= _chem_mixture.M(s)/_chem_mixture.M(t);
+          }
+      }
+  }
 
-            // d/dT rate contributions
-            dmole_dT[p_id] += (static_cast<CoeffType>(p_stoich)*drate_dT);
+  template<typename CoeffType, typename StateType>
+  template<typename VectorStateType, typename KC>
+  inline
+  void KineticsEvaluator<CoeffType,StateType>::compute_mole_sources_and_sparse_derivs( const KC& conditions,
+                                                                                       const VectorStateType& molar_densities,
+                                                                                       const VectorStateType& h_RT_minus_s_R,
+                                                                                       const VectorStateType& dh_RT_minus_s_R_dT,
+                                                                                       const KineticsJacobianPattern<CoeffType>& pattern,
+                                                                                       VectorStateType& mole_sources,
+                                                                                       VectorStateType& dmole_dT,
+                                                                                       VectorStateType& dmole_dX_s )
+  {
+    antioch_assert_equal_to( molar_densities.size(), this->n_species() );
+    antioch_assert_equal_to( h_RT_minus_s_R.size(), this->n_species() );
+    antioch_assert_equal_to( dh_RT_minus_s_R_dT.size(), this->n_species() );
+    antioch_assert_equal_to( mole_sources.size(), this->n_species() );
+    antioch_assert_equal_to( dmole_dT.size(), this->n_species() );
+    antioch_assert_equal_to( pattern.n_species(), this->n_species() );
+    antioch_assert_equal_to( pattern.n_reactions(), this->n_reactions() );
+    antioch_assert_equal_to( dmole_dX_s.size(), pattern.n_nonzeros() );
+
+    Antioch::set_zero(dmole_dX_s);
+
+    typename constructor_or_reference<const KineticsConditions<StateType,VectorStateType>, const KC>::type  //either (KineticsConditions<> &) or (KineticsConditions<>)
+                                        kinetics_conditions(conditions);
+
+    const std::vector<unsigned int>& reaction_offsets = pattern.reaction_offsets();
+    const std::vector<CoeffType>& stoichiometry = pattern.reaction_stoichiometry();
+    const std::vector<unsigned int>& dependency_offsets = pattern.dependency_offsets();
+    const std::vector<unsigned int>& dependency_ids = pattern.dependency_ids();
+    const std::vector<unsigned int>& scatter = pattern.scatter();
 
-            // d/dX_s rate contributions
-            for (unsigned int s=0; s < this->n_species(); s++)
+    _equilibrium_factors.update( kinetics_conditions.T(), h_RT_minus_s_R );
+    const StateType total_concentration = Antioch::total_concentration<StateType>( molar_densities );
+
+    unsigned int k = 0;
+    for (unsigned int rxn = 0; rxn < this->n_reactions(); rxn++)
+      {
+        this->_reaction_set.compute_reaction_rate_and_derivs( rxn, kinetics_conditions, _equilibrium_factors,
+                                                              total_concentration, molar_densities,
+                                                              h_RT_minus_s_R, dh_RT_minus_s_R_dT,
+                                                              _net_reaction_rates[rxn],
+                                                              _dnet_rate_dT[rxn],
+                                                              _drate_dX_s );
+
+        // only the species the reaction depends on are read
+        for (unsigned int i = reaction_offsets[rxn]; i < reaction_offsets[rxn+1]; i++)
+          {
+            for (unsigned int j = dependency_offsets[rxn]; j < dependency_offsets[rxn+1]; j++)
               {
-                dmole_dX_s[p_id][s] += (static_cast<CoeffType>(p_stoich)*drate_dX_s[s]);
+                dmole_dX_s[scatter[k++]] += stoichiometry[i] * _drate_dX_s[dependency_ids[j]];
               }
           }
       }
 
+    // compute the actual mole sources in kmol/sec/m^3
+    _stoichiometry.multiply( _net_reaction_rates, mole_sources );
+    _stoichiometry.multiply( _dnet_rate_dT, dmole_dT );
+
     return;
   }
 
@@ -362,29 +806,123 @@ namespace Antioch
   template<typename CoeffType, typename StateType>
   template <typename VectorStateType, typename KC>
   inline
-  void KineticsEvaluator<CoeffType,StateType>::compute_mass_sources_and_derivs( const KC& conditions,
-                                                                                const VectorStateType& molar_densities,
-                                                                                const VectorStateType& h_RT_minus_s_R,
-                                                                                const VectorStateType& dh_RT_minus_s_R_dT,
-                                                                                VectorStateType& mass_sources,
-                                                                                VectorStateType& dmass_dT,
-                                                                                std::vector<VectorStateType>& dmass_drho_s )
+  void KineticsEvaluator<CoeffType,StateType>::compute_mass_sources_and_sparse_derivs( const KC& conditions,
+                                                                                       const VectorStateType& molar_densities,
+                                                                                       const VectorStateType& h_RT_minus_s_R,
+                                                                                       const VectorStateType& dh_RT_minus_s_R_dT,
+                                                                                       const KineticsJacobianPattern<CoeffType>& pattern,
+                                                                                       VectorStateType& mass_sources,
+                                                                                       VectorStateType& dmass_dT,
+                                                                                       VectorStateType& dmass_drho_s )
   {
-    // Asserts are in compute_mole_sources
-    this->compute_mole_sources_and_derivs( conditions, molar_densities, h_RT_minus_s_R, dh_RT_minus_s_R_dT,
-                                           mass_sources, dmass_dT, dmass_drho_s );
-    
+    // Asserts are in compute_mole_sources_and_sparse_derivs
+    this->compute_mole_sources_and_sparse_derivs( conditions, molar_densities, h_RT_minus_s_R, dh_RT_minus_s_R_dT,
+                                                  pattern, mass_sources, dmass_dT, dmass_drho_s );
+
     // Convert from mole units to mass units
     for (unsigned int s=0; s < this->n_species(); s++)
       {
         mass_sources[s] *= _chem_mixture.M(s);
         dmass_dT[s] *= _chem_mixture.M(s);
+      }
 
-        for (unsigned int t=0; t < this->n_species(); t++)
+    const bool csr = (pattern.layout() == SparseMatrixLayout::CSR);
+    const std::vector<unsigned int>& offsets = pattern.offsets();
+    const std::vector<unsigned int>& indices = pattern.indices();
+
+    for (unsigned int l=0; l < this->n_species(); l++)
+      {
+        for (unsigned int k = offsets[l]; k < offsets[l+1]; k++)
           {
-            dmass_drho_s[s][t] *= _chem_mixture.M(s)/_chem_mixture.M(t);
+            const unsigned int s = csr?l:indices[k];
+            const unsigned int t = csr?indices[k]:l;
+
+            dmass_drho_s[k] *= _chem_mixture.M(s)/_chem_mixture.M(t);
           }
+      }
+
+    return;
+  }
+
+  template<typename CoeffType, typename StateType>
+  template<typename VectorStateType, typename KC>
+  inline
+  void KineticsEvaluator<CoeffType,StateType>::compute_mole_sources_and_parameter_sensitivities( const KC& conditions,
+                                                                                                 const VectorStateType& molar_densities,
+                                                                                                 const VectorStateType& h_RT_minus_s_R,
+                                                                                                 VectorStateType& mole_sources,
+                                                                                                 VectorStateType& dmole_dlnA,
+                                                                                                 VectorStateType& dmole_dbeta,
+                                                                                                 VectorStateType& dmole_dEa )
+  {
+    antioch_assert_equal_to( dmole_dlnA.size(), _stoichiometry.n_nonzeros() );
+    antioch_assert_equal_to( dmole_dbeta.size(), _stoichiometry.n_nonzeros() );
+    antioch_assert_equal_to( dmole_dEa.size(), _stoichiometry.n_nonzeros() );
+
+    // Quantities asserted in compute_mole_sources call
+    this->compute_mole_sources( conditions, molar_densities, h_RT_minus_s_R, mole_sources );
+
+    typename constructor_or_reference<const KineticsConditions<StateType,VectorStateType>, const KC>::type  //either (KineticsConditions<> &) or (KineticsConditions<>)
+                kinetics_conditions(conditions);
+
+    // the rate of progress is proportional to the forward rate coefficient,
+    // dq_r/dp_r = q_r dlnkfwd_r/dp_r
+    StateType dlnk_dlnA = Antioch::zero_clone(kinetics_conditions.T());
+    StateType dlnk_dbeta = Antioch::zero_clone(kinetics_conditions.T());
+    StateType dlnk_dEa = Antioch::zero_clone(kinetics_conditions.T());
+
+    for (unsigned int rxn = 0; rxn < this->n_reactions(); rxn++)
+      {
+        _reaction_set.reaction(rxn).compute_forward_rate_coefficient_log_parameter_derivatives
+          ( molar_densities, kinetics_conditions, dlnk_dlnA, dlnk_dbeta, dlnk_dEa );
+
+        _drate_dparameters[3*rxn]     = _net_reaction_rates[rxn] * dlnk_dlnA;
+        _drate_dparameters[3*rxn + 1] = _net_reaction_rates[rxn] * dlnk_dbeta;
+        _drate_dparameters[3*rxn + 2] = _net_reaction_rates[rxn] * dlnk_dEa;
+      }
 
+    // domega_s/dp_r = nu_{s,r} dq_r/dp_r
+    const std::vector<unsigned int>& reaction_ids = _stoichiometry.reaction_ids();
+    const std::vector<CoeffType>& nu = _stoichiometry.values();
+
+    for (unsigned int i = 0; i < _stoichiometry.n_nonzeros(); i++)
+      {
+        const unsigned int rxn = reaction_ids[i];
+        dmole_dlnA[i]  = nu[i] * _drate_dparameters[3*rxn];
+        dmole_dbeta[i] = nu[i] * _drate_dparameters[3*rxn + 1];
+        dmole_dEa[i]   = nu[i] * _drate_dparameters[3*rxn + 2];
+      }
+
+    return;
+  }
+
+  template<typename CoeffType, typename StateType>
+  template<typename VectorStateType, typename KC>
+  inline
+  void KineticsEvaluator<CoeffType,StateType>::compute_mass_sources_and_parameter_sensitivities( const KC& conditions,
+                                                                                                 const VectorStateType& molar_densities,
+                                                                                                 const VectorStateType& h_RT_minus_s_R,
+                                                                                                 VectorStateType& mass_sources,
+                                                                                                 VectorStateType& dmass_dlnA,
+                                                                                                 VectorStateType& dmass_dbeta,
+                                                                                                 VectorStateType& dmass_dEa )
+  {
+    this->compute_mole_sources_and_parameter_sensitivities( conditions, molar_densities, h_RT_minus_s_R,
+                                                            mass_sources, dmass_dlnA, dmass_dbeta, dmass_dEa );
+
+    // Convert from mole units to mass units
+    const std::vector<unsigned int>& row_offsets = _stoichiometry.row_offsets();
+
+    for (unsigned int s=0; s < this->n_species(); s++)
+      {
+        mass_sources[s] *= _chem_mixture.M(s);
+
+        for (unsigned int i = row_offsets[s]; i < row_offsets[s+1]; i++)
+          {
+            dmass_dlnA[i]  *= _chem_mixture.M(s);
+            dmass_dbeta[i] *= _chem_mixture.M(s);
+            dmass_dEa[i]   *= _chem_mixture.M(s);
+          }
       }
 
     return;
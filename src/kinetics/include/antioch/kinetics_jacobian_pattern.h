@@ -0,0 +1,408 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+
+
+#ifndef ANTIOCH_KINETICS_JACOBIAN_PATTERN_H
+#define ANTIOCH_KINETICS_JACOBIAN_PATTERN_H
+
+// Antioch
+#include "antioch/antioch_asserts.h"
+#include "antioch/reaction_enum.h"
+#include "antioch/reaction_set.h"
+#include "antioch/stoichiometry_matrix.h"
+
+// C++
+#include <vector>
+#include <algorithm>
+
+namespace Antioch
+{
+  namespace SparseMatrixLayout
+  {
+    enum SparseMatrixLayout { CSR = 0, //!< compressed rows
+                              CSC };   //!< compressed columns
+  }
+
+  //! Sparsity pattern of the species source terms Jacobian
+  /*!
+   * The rate of progress of a reaction depends on its reactants, on its
+   * products if it is reversible, and on the third bodies (the species
+   * with a nonzero efficiency, or all species for falloff reactions
+   * without specified efficiencies). The Jacobian
+   * \f$ \frac{\partial \dot{\omega}_s}{\partial X_t}\f$ is nonzero only
+   * if a reaction produces or consumes s and depends on t. The diagonal
+   * is always stored, so that \f$ I - \gamma J \f$ shares the pattern.
+   *
+   * The pattern is built once from the StoichiometryMatrix, together with
+   * the position of every (reaction, species, dependency) contribution in the
+   * values array, so that KineticsEvaluator::compute_mole_sources_and_sparse_derivs
+   * fills the values without any search.
+   *
+   * This is a snapshot: if the ReactionSet is modified, build() must be
+   * called again after StoichiometryMatrix::build().
+   */
+  template<typename CoeffType=double>
+  class KineticsJacobianPattern
+  {
+  public:
+
+    KineticsJacobianPattern( const StoichiometryMatrix<CoeffType>& stoichiometry,
+                             SparseMatrixLayout::SparseMatrixLayout layout = SparseMatrixLayout::CSR );
+
+    ~KineticsJacobianPattern();
+
+    //! (Re)build the pattern.
+    void build();
+
+    SparseMatrixLayout::SparseMatrixLayout layout() const;
+
+    //! \returns the number of species, the Jacobian is n_species x n_species.
+    unsigned int n_species() const;
+
+    unsigned int n_reactions() const;
+
+    //! \returns the number of stored entries.
+    unsigned int n_nonzeros() const;
+
+    //! Row (CSR) or column (CSC) i owns the entries [offsets()[i],offsets()[i+1])
+    const std::vector<unsigned int>& offsets() const;
+
+    //! Column (CSR) or row (CSC) index of each stored entry
+    const std::vector<unsigned int>& indices() const;
+
+    //! \returns the position of the entry (s,t), or n_nonzeros() if it is not stored.
+    unsigned int position( unsigned int s, unsigned int t ) const;
+
+    //! Species the rate of progress of reaction rxn depends on, [dependency_offsets()[rxn],dependency_offsets()[rxn+1])
+    const std::vector<unsigned int>& dependency_offsets() const;
+
+    const std::vector<unsigned int>& dependency_ids() const;
+
+    //! Net stoichiometry, by reaction, [reaction_offsets()[rxn],reaction_offsets()[rxn+1])
+    const std::vector<unsigned int>& reaction_offsets() const;
+
+    const std::vector<unsigned int>& reaction_species() const;
+
+    const std::vector<CoeffType>& reaction_stoichiometry() const;
+
+    //! Position in the values of each (reaction, species, dependency) contribution
+    /*!
+     * Ordered by reaction, then by stoichiometry entry, then by dependency.
+     */
+    const std::vector<unsigned int>& scatter() const;
+
+  private:
+
+    KineticsJacobianPattern();
+
+    //! species the rate of progress of reaction depends on, sorted
+    void find_dependencies( const Reaction<CoeffType>& reaction,
+                            std::vector<unsigned int>& dependencies ) const;
+
+    const StoichiometryMatrix<CoeffType>& _stoichiometry;
+
+    SparseMatrixLayout::SparseMatrixLayout _layout;
+
+    std::vector<unsigned int> _offsets;
+    std::vector<unsigned int> _indices;
+
+    std::vector<unsigned int> _dependency_offsets;
+    std::vector<unsigned int> _dependency_ids;
+
+    std::vector<unsigned int> _reaction_offsets;
+    std::vector<unsigned int> _reaction_species;
+    std::vector<CoeffType>    _reaction_stoichiometry;
+
+    std::vector<unsigned int> _scatter;
+  };
+
+  /* ------------------------- Inline Functions -------------------------*/
+  template<typename CoeffType>
+  inline
+  KineticsJacobianPattern<CoeffType>::KineticsJacobianPattern( const StoichiometryMatrix<CoeffType>& stoichiometry,
+                                                               SparseMatrixLayout::SparseMatrixLayout layout )
+    : _stoichiometry(stoichiometry),
+      _layout(layout)
+  {
+    this->build();
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  KineticsJacobianPattern<CoeffType>::~KineticsJacobianPattern()
+  {
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  SparseMatrixLayout::SparseMatrixLayout KineticsJacobianPattern<CoeffType>::layout() const
+  {
+    return _layout;
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int KineticsJacobianPattern<CoeffType>::n_species() const
+  {
+    return _offsets.size() - 1;
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int KineticsJacobianPattern<CoeffType>::n_reactions() const
+  {
+    return _dependency_offsets.size() - 1;
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int KineticsJacobianPattern<CoeffType>::n_nonzeros() const
+  {
+    return _indices.size();
+  }
+
+  template<typename CoeffType>
+  inline
+  const std::vector<unsigned int>& KineticsJacobianPattern<CoeffType>::offsets() const
+  {
+    return _offsets;
+  }
+
+  template<typename CoeffType>
+  inline
+  const std::vector<unsigned int>& KineticsJacobianPattern<CoeffType>::indices() const
+  {
+    return _indices;
+  }
+
+  template<typename CoeffType>
+  inline
+  const std::vector<unsigned int>& KineticsJacobianPattern<CoeffType>::dependency_offsets() const
+  {
+    return _dependency_offsets;
+  }
+
+  template<typename CoeffType>
+  inline
+  const std::vector<unsigned int>& KineticsJacobianPattern<CoeffType>::dependency_ids() const
+  {
+    return _dependency_ids;
+  }
+
+  template<typename CoeffType>
+  inline
+  const std::vector<unsigned int>& KineticsJacobianPattern<CoeffType>::reaction_offsets() const
+  {
+    return _reaction_offsets;
+  }
+
+  template<typename CoeffType>
+  inline
+  const std::vector<unsigned int>& KineticsJacobianPattern<CoeffType>::reaction_species() const
+  {
+    return _reaction_species;
+  }
+
+  template<typename CoeffType>
+  inline
+  const std::vector<CoeffType>& KineticsJacobianPattern<CoeffType>::reaction_stoichiometry() const
+  {
+    return _reaction_stoichiometry;
+  }
+
+  template<typename CoeffType>
+  inline
+  const std::vector<unsigned int>& KineticsJacobianPattern<CoeffType>::scatter() const
+  {
+    return _scatter;
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int KineticsJacobianPattern<CoeffType>::position( unsigned int s, unsigned int t ) const
+  {
+    antioch_assert_less( s, this->n_species() );
+    antioch_assert_less( t, this->n_species() );
+
+    const unsigned int outer = (_layout == SparseMatrixLayout::CSR)?s:t;
+    const unsigned int inner = (_layout == SparseMatrixLayout::CSR)?t:s;
+
+    std::vector<unsigned int>::const_iterator begin = _indices.begin() + _offsets[outer];
+    std::vector<unsigned int>::const_iterator end   = _indices.begin() + _offsets[outer+1];
+    std::vector<unsigned int>::const_iterator it = std::lower_bound(begin,end,inner);
+
+    return (it != end && *it == inner)?(it - _indices.begin()):this->n_nonzeros();
+  }
+
+  template<typename CoeffType>
+  inline
+  void KineticsJacobianPattern<CoeffType>::find_dependencies( const Reaction<CoeffType>& reaction,
+                                                              std::vector<unsigned int>& dependencies ) const
+  {
+    dependencies.clear();
+
+    for( unsigned int r = 0; r < reaction.n_reactants(); r++ )
+      dependencies.push_back(reaction.reactant_id(r));
+
+    if( reaction.reversible() )
+      {
+        for( unsigned int p = 0; p < reaction.n_products(); p++ )
+          dependencies.push_back(reaction.product_id(p));
+      }
+
+    switch( reaction.type() )
+      {
+      case( ReactionType::THREE_BODY ):
+      case( ReactionType::LINDEMANN_FALLOFF_THREE_BODY ):
+      case( ReactionType::TROE_FALLOFF_THREE_BODY ):
+        {
+          for( unsigned int s = 0; s < reaction.n_species(); s++ )
+            {
+              if( reaction.efficiency(s) != 0 )
+                dependencies.push_back(s);
+            }
+        }
+        break;
+
+      // [M] is the sum of all the molar densities, and so is the
+      // pressure of the PLOG and Chebyshev reactions
+      case( ReactionType::LINDEMANN_FALLOFF ):
+      case( ReactionType::TROE_FALLOFF ):
+      case( ReactionType::PLOG ):
+      case( ReactionType::CHEBYSHEV ):
+        {
+          for( unsigned int s = 0; s < reaction.n_species(); s++ )
+            dependencies.push_back(s);
+        }
+        break;
+
+      default:
+        break;
+      }
+
+    std::sort(dependencies.begin(),dependencies.end());
+    dependencies.erase(std::unique(dependencies.begin(),dependencies.end()),dependencies.end());
+  }
+
+  template<typename CoeffType>
+  inline
+  void KineticsJacobianPattern<CoeffType>::build()
+  {
+    const ReactionSet<CoeffType>& reaction_set = _stoichiometry.reaction_set();
+    const unsigned int n_species = _stoichiometry.n_species();
+    const unsigned int n_reactions = _stoichiometry.n_reactions();
+
+    // stoichiometry by reaction, transposed from the species rows
+    const std::vector<unsigned int>& nu_offsets = _stoichiometry.row_offsets();
+    const std::vector<unsigned int>& nu_reactions = _stoichiometry.reaction_ids();
+    const std::vector<CoeffType>& nu_values = _stoichiometry.values();
+
+    _reaction_offsets.assign(n_reactions+1,0);
+    for( unsigned int i = 0; i < nu_reactions.size(); i++ )
+      _reaction_offsets[nu_reactions[i]+1]++;
+    for( unsigned int rxn = 0; rxn < n_reactions; rxn++ )
+      _reaction_offsets[rxn+1] += _reaction_offsets[rxn];
+
+    _reaction_species.resize(nu_reactions.size());
+    _reaction_stoichiometry.resize(nu_reactions.size());
+    {
+      std::vector<unsigned int> next(_reaction_offsets.begin(),_reaction_offsets.end() - 1);
+      for( unsigned int s = 0; s < n_species; s++ )
+        {
+          for( unsigned int i = nu_offsets[s]; i < nu_offsets[s+1]; i++ )
+            {
+              const unsigned int pos = next[nu_reactions[i]]++;
+              _reaction_species[pos] = s;
+              _reaction_stoichiometry[pos] = nu_values[i];
+            }
+        }
+    }
+
+    // dependencies of each reaction
+    _dependency_offsets.assign(n_reactions+1,0);
+    _dependency_ids.clear();
+    std::vector<unsigned int> dependencies;
+    for( unsigned int rxn = 0; rxn < n_reactions; rxn++ )
+      {
+        this->find_dependencies(reaction_set.reaction(rxn),dependencies);
+        _dependency_ids.insert(_dependency_ids.end(),dependencies.begin(),dependencies.end());
+        _dependency_offsets[rxn+1] = _dependency_ids.size();
+      }
+
+    // the pattern, diagonal included
+    std::vector<std::vector<unsigned int> > lines(n_species);
+    for( unsigned int s = 0; s < n_species; s++ )
+      lines[s].push_back(s);
+
+    for( unsigned int rxn = 0; rxn < n_reactions; rxn++ )
+      {
+        for( unsigned int i = _reaction_offsets[rxn]; i < _reaction_offsets[rxn+1]; i++ )
+          {
+            const unsigned int s = _reaction_species[i];
+            for( unsigned int j = _dependency_offsets[rxn]; j < _dependency_offsets[rxn+1]; j++ )
+              {
+                const unsigned int t = _dependency_ids[j];
+                if( _layout == SparseMatrixLayout::CSR )
+                  lines[s].push_back(t);
+                else
+                  lines[t].push_back(s);
+              }
+          }
+      }
+
+    _offsets.assign(n_species+1,0);
+    _indices.clear();
+    for( unsigned int l = 0; l < n_species; l++ )
+      {
+        std::sort(lines[l].begin(),lines[l].end());
+        lines[l].erase(std::unique(lines[l].begin(),lines[l].end()),lines[l].end());
+        _indices.insert(_indices.end(),lines[l].begin(),lines[l].end());
+        _offsets[l+1] = _indices.size();
+      }
+
+    // where each contribution goes
+    _scatter.clear();
+    for( unsigned int rxn = 0; rxn < n_reactions; rxn++ )
+      {
+        for( unsigned int i = _reaction_offsets[rxn]; i < _reaction_offsets[rxn+1]; i++ )
+          {
+            for( unsigned int j = _dependency_offsets[rxn]; j < _dependency_offsets[rxn+1]; j++ )
+              {
+                _scatter.push_back(this->position(_reaction_species[i],_dependency_ids[j]));
+                antioch_assert_less( _scatter.back(), this->n_nonzeros() );
+              }
+          }
+      }
+
+    return;
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_KINETICS_JACOBIAN_PATTERN_H
@@ -75,6 +75,31 @@ namespace Antioch
                                KineticsModel::Parameters parameter,
                                const CoeffType new_value, int l, const std::string & unit = "SI");
 
+  //! reset a parameter already in the internal units (SI, activation energy in K)
+  /*! No string handling, this is what reset_parameter_of_rate() ends up
+   *  calling once the unit has been taken care of.
+   */
+  template <typename CoeffType, typename VectorCoeffType>
+  void reset_internal_parameter_of_rate(KineticsType<CoeffType,VectorCoeffType> & rate,
+                                        KineticsModel::Parameters parameter,
+                                        const CoeffType new_coef);
+
+  // vectorized parameter
+  template <typename CoeffType, typename VectorCoeffType>
+  void reset_internal_parameter_of_rate(KineticsType<CoeffType,VectorCoeffType> & rate,
+                                        KineticsModel::Parameters parameter,
+                                        const CoeffType new_coef, int l);
+
+  //! Van't Hoff form of an analytical kinetics model
+  /*!
+   * Any model but the photochemical one is
+   * \f$C_f \exp\left(\eta \ln T - \frac{E_a}{T} + D T\right)\f$,
+   * \f$E_a\f$ in K, with the reference temperature absorbed in \f$C_f\f$.
+   */
+  template <typename CoeffType, typename VectorCoeffType>
+  void vanthoff_parameters_of_rate(const KineticsType<CoeffType,VectorCoeffType> & rate,
+                                   CoeffType & Cf, CoeffType & eta, CoeffType & Ea, CoeffType & D);
+
 
 //----------------------------------------
 
@@ -256,6 +281,14 @@ namespace Antioch
    }
    
 
+    reset_internal_parameter_of_rate(rate, parameter, new_coef);
+  }
+
+  template <typename CoeffType, typename VectorCoeffType>
+  void reset_internal_parameter_of_rate(KineticsType<CoeffType,VectorCoeffType> & rate,
+                                        KineticsModel::Parameters parameter,
+                                        const CoeffType new_coef)
+  {
     switch(rate.type())
       {
       case(KineticsModel::CONSTANT):
@@ -321,6 +354,14 @@ namespace Antioch
     CoeffType new_coef = (unit == "SI")?new_value:
                                         new_value * Units<typename value_type<CoeffType>::type>(unit).get_SI_factor();
 
+    reset_internal_parameter_of_rate(rate, parameter, new_coef, l);
+  }
+
+  template <typename CoeffType, typename VectorCoeffType>
+  void reset_internal_parameter_of_rate(KineticsType<CoeffType,VectorCoeffType> & rate,
+                                        KineticsModel::Parameters parameter,
+                                        const CoeffType new_coef, int l)
+  {
     switch(rate.type())
     {
       case(KineticsModel::PHOTOCHEM):
@@ -338,6 +379,82 @@ namespace Antioch
   }
 
 
+  template <typename CoeffType, typename VectorCoeffType>
+  void vanthoff_parameters_of_rate(const KineticsType<CoeffType,VectorCoeffType> & rate,
+                                   CoeffType & Cf, CoeffType & eta, CoeffType & Ea, CoeffType & D)
+  {
+    eta = 0;
+    Ea = 0;
+    D = 0;
+
+    switch( rate.type() )
+      {
+      case(KineticsModel::CONSTANT):
+        {
+          Cf = static_cast<const ConstantRate<CoeffType>&>(rate).Cf();
+        }
+        break;
+
+      case(KineticsModel::HERCOURT_ESSEN):
+        {
+          const HercourtEssenRate<CoeffType>& he = static_cast<const HercourtEssenRate<CoeffType>&>(rate);
+          Cf = he.Cf();
+          eta = he.eta();
+        }
+        break;
+
+      case(KineticsModel::BERTHELOT):
+        {
+          const BerthelotRate<CoeffType>& berth = static_cast<const BerthelotRate<CoeffType>&>(rate);
+          Cf = berth.Cf();
+          D = berth.D();
+        }
+        break;
+
+      case(KineticsModel::ARRHENIUS):
+        {
+          const ArrheniusRate<CoeffType>& arr = static_cast<const ArrheniusRate<CoeffType>&>(rate);
+          Cf = arr.Cf();
+          Ea = arr.Ea_K();
+        }
+        break;
+
+      case(KineticsModel::BHE):
+        {
+          const BerthelotHercourtEssenRate<CoeffType>& bhe = static_cast<const BerthelotHercourtEssenRate<CoeffType>&>(rate);
+          Cf = bhe.Cf();
+          eta = bhe.eta();
+          D = bhe.D();
+        }
+        break;
+
+      case(KineticsModel::KOOIJ):
+        {
+          const KooijRate<CoeffType>& kooij = static_cast<const KooijRate<CoeffType>&>(rate);
+          Cf = kooij.Cf();
+          eta = kooij.eta();
+          Ea = kooij.Ea_K();
+        }
+        break;
+
+      case(KineticsModel::VANTHOFF):
+        {
+          const VantHoffRate<CoeffType>& vh = static_cast<const VantHoffRate<CoeffType>&>(rate);
+          Cf = vh.Cf();
+          eta = vh.eta();
+          Ea = vh.Ea_K();
+          D = vh.D();
+        }
+        break;
+
+      default:
+        {
+          antioch_error();
+        }
+      } // switch( rate.type() )
+
+    return;
+  }
 
 } // end namespace Antioch
 
@@ -34,6 +34,7 @@
 #include "antioch/metaprogramming.h"
 
 //C++
+#include <cmath>
 #include <string>
 #include <vector>
 #include <iostream>
@@ -118,6 +119,20 @@ namespace Antioch{
                                      StateType & rate,
                                      StateType& drate_dT) const;
 
+    //! Logarithmic derivatives of the rate constant with respect to its parameters
+    /*!
+     * \f$\frac{\partial\ln k}{\partial\ln A}\f$, \f$\frac{\partial\ln k}{\partial\beta}\f$
+     * and \f$\frac{\partial\ln k}{\partial E_a}\f$, with \f$E_a\f$ in K as stored.
+     * \f$\beta\f$ is varied at fixed \f$A\f$ and \f$\mathrm{T_{ref}}\f$. The derivatives
+     * with respect to the parameters the model does not have are zero, all
+     * three are zero for the photochemical model.
+     */
+    template <typename StateType, typename VectorStateType>
+    void compute_log_parameter_derivatives(const KineticsConditions<StateType, VectorStateType>& conditions,
+                                           StateType& dlnk_dlnA,
+                                           StateType& dlnk_dbeta,
+                                           StateType& dlnk_dEa) const;
+
     //!
     void set_index(unsigned int nr);
 
@@ -396,6 +411,56 @@ namespace Antioch{
     return;
   }
 
+  template <typename CoeffType, typename VectorCoeffType>
+  template <typename StateType, typename VectorStateType>
+  inline
+  void KineticsType<CoeffType,VectorCoeffType>::compute_log_parameter_derivatives(const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                                                 StateType& dlnk_dlnA,
+                                                                                 StateType& dlnk_dbeta,
+                                                                                 StateType& dlnk_dEa) const
+  {
+    using std::log;
+
+    dlnk_dlnA  = constant_clone(conditions.T(),1);
+    dlnk_dbeta = zero_clone(conditions.T());
+    dlnk_dEa   = zero_clone(conditions.T());
+
+    // k = A (T/Tref)^beta exp(-Ea/T) (...)
+    switch(my_type)
+      {
+      case(KineticsModel::HERCOURT_ESSEN):
+      case(KineticsModel::BHE):
+        {
+          dlnk_dbeta = conditions.temp_cache().lnT - log(this->get_parameter(KineticsModel::Parameters::T_REF));
+        }
+        break;
+
+      case(KineticsModel::ARRHENIUS):
+        {
+          dlnk_dEa = - constant_clone(conditions.T(),1) / conditions.T();
+        }
+        break;
+
+      case(KineticsModel::KOOIJ):
+      case(KineticsModel::VANTHOFF):
+        {
+          dlnk_dbeta = conditions.temp_cache().lnT - log(this->get_parameter(KineticsModel::Parameters::T_REF));
+          dlnk_dEa = - constant_clone(conditions.T(),1) / conditions.T();
+        }
+        break;
+
+      case(KineticsModel::PHOTOCHEM):
+        {
+          dlnk_dlnA = zero_clone(conditions.T());
+        }
+        break;
+
+      default: // constant, Berthelot: A only
+        break;
+
+      } // switch(my_type)
+  }
+
   template <typename CoeffType, typename VectorCoeffType>
   CoeffType KineticsType<CoeffType,VectorCoeffType>::get_parameter(KineticsModel::Parameters parameter) const
   {
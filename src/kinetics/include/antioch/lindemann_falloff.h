@@ -77,6 +77,11 @@ namespace Antioch{
                            StateType &dF_dT,
                            VectorStateType &dF_dX) const;
 
+    //! \f$\partial \ln F/\partial \ln P_r\f$, 0
+    template <typename StateType>
+    StateType dlnF_dlnPr(const StateType &T,
+                         const StateType &Pr) const;
+
   private:
     unsigned int n_spec;
 
@@ -130,6 +135,16 @@ namespace Antioch{
     return;
   }
 
+  template<typename CoeffType>
+  template <typename StateType>
+  inline
+  StateType LindemannFalloff<CoeffType>::dlnF_dlnPr
+    (const StateType& /* T */,
+     const StateType& Pr) const
+  {
+    return Antioch::zero_clone(Pr);
+  }
+
   template<typename CoeffType>
   inline
   LindemannFalloff<CoeffType>::LindemannFalloff(const unsigned int nspec):n_spec(nspec)
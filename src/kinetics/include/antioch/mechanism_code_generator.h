@@ -0,0 +1,922 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+
+
+
+#ifndef ANTIOCH_MECHANISM_CODE_GENERATOR_H
+#define ANTIOCH_MECHANISM_CODE_GENERATOR_H
+
+// Antioch
+#include "antioch/antioch_asserts.h"
+#include "antioch/physical_constants.h"
+#include "antioch/reaction_set.h"
+
+// C++
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Antioch
+{
+
+  //! Writes specialized C++ source for the kinetics of a ReactionSet
+  /*!
+   * The generated header is self-contained: it only includes Antioch's
+   * cmath shims and metaprogramming utilities, and defines, in the
+   * requested namespace, the free functions
+   *   - compute_reaction_rates(T, molar_densities, h_RT_minus_s_R, net_reaction_rates)
+   *   - compute_mole_sources(T, molar_densities, h_RT_minus_s_R, mole_sources)
+   *   - compute_mole_sources_and_derivs(T, molar_densities, h_RT_minus_s_R,
+   *     dh_RT_minus_s_R_dT, mole_sources, dmole_dT, dmole_dX_s)
+   * with the same arguments and conventions as KineticsEvaluator, templated
+   * on StateType so that the scalar and vector backends can be used.
+   *
+   * Each reaction is written out as straight-line code: the rate parameters,
+   * efficiencies, stoichiometric coefficients and Troe parameters are
+   * folded as constants, terms of the kinetics models that vanish are not
+   * written, integer partial orders are expanded into products and the
+   * sparsity of the stoichiometry is used when summing the sources and
+   * filling the Jacobian. ln(T), 1/T, the total concentration and the
+   * powers of P0/(RT) are computed once and shared by all reactions.
+   *
+   * The partial derivatives follow the conventions of
+   * Reaction::compute_rate_of_progress_and_derivatives. The maximum rate
+   * used by the library when an equilibrium constant underflows to zero
+   * is not reproduced. Photochemical reactions, whose rate depends on a
+   * run-time cross-section, and the PLOG and Chebyshev reactions are not
+   * supported.
+   */
+  template<typename CoeffType=double>
+  class MechanismCodeGenerator
+  {
+  public:
+
+    MechanismCodeGenerator( const ReactionSet<CoeffType>& reaction_set );
+
+    ~MechanismCodeGenerator();
+
+    //! Write the header, its functions being put in namespace \p name_space
+    void write( std::ostream& output, const std::string& name_space ) const;
+
+  private:
+
+    MechanismCodeGenerator();
+
+    //! Literal of a constant, as a Scalar
+    std::string constant( const CoeffType value ) const;
+
+    //! Code of a sum of terms, each written as " + term" or " - term"
+    std::string sum_of( const std::string& terms ) const;
+
+    //! Code of value*expression, unity factors being dropped
+    std::string scaled( const CoeffType value, const std::string& expression ) const;
+
+    //! Multiplicative prefix for a stoichiometric coefficient, empty for unity
+    std::string coefficient( unsigned int nu ) const;
+
+    //! Code of x^order, integer orders being expanded into products
+    std::string species_power( unsigned int s, CoeffType order, unsigned int integer_order ) const;
+
+    //! Writes the declaration of \p k, and of \p dk_dT if not empty
+    void write_rate_constant( std::ostream& output,
+                              const KineticsType<CoeffType>& rate,
+                              const std::string& k,
+                              const std::string& dk_dT ) const;
+
+    //! Writes the forward rate coefficient kf<rxn>
+    /*!
+     * With \p derivatives, dkf<rxn>_dT is also written and, for reactions
+     * depending on the third-body concentration, dkf<rxn>_dM.
+     */
+    void write_forward_rate_coefficient( std::ostream& output, unsigned int rxn, bool derivatives ) const;
+
+    //! Writes the rate of progress R<rxn>
+    /*!
+     * With \p derivatives, dR<rxn>_dT, dR<rxn>_dM and the nonzero
+     * dR<rxn>_dX<s> are also written, the species of the latter being
+     * returned in \p dX_species.
+     */
+    void write_rate_of_progress( std::ostream& output, unsigned int rxn, bool derivatives,
+                                 std::vector<unsigned int>& dX_species ) const;
+
+    //! Writes the shared quantities and all the rates of progress
+    void write_reactions( std::ostream& output, bool derivatives,
+                          std::vector<std::vector<unsigned int> >& dX_species ) const;
+
+    //! \returns true if the rate constant of the reaction depends on the third-body concentration
+    bool depends_on_M( unsigned int rxn ) const;
+
+    const ReactionSet<CoeffType>& _reaction_set;
+
+    //! Net stoichiometric coefficients, products minus reactants, [rxn][species]
+    std::vector<std::map<unsigned int,int> > _net_stoichiometry;
+
+    //! Distinct values of gamma, for which P0_RT powers are precomputed
+    std::map<int,std::string> _P0_RT_powers;
+  };
+
+  template<typename CoeffType>
+  inline
+  MechanismCodeGenerator<CoeffType>::MechanismCodeGenerator( const ReactionSet<CoeffType>& reaction_set )
+    : _reaction_set(reaction_set),
+      _net_stoichiometry(reaction_set.n_reactions())
+  {
+    for( unsigned int rxn = 0; rxn < _reaction_set.n_reactions(); rxn++ )
+      {
+        const Reaction<CoeffType>& reaction = _reaction_set.reaction(rxn);
+
+        if( reaction.type() == ReactionType::PLOG ||
+            reaction.type() == ReactionType::CHEBYSHEV )
+          antioch_error_msg("MechanismCodeGenerator does not support pressure-dependent PLOG and Chebyshev reactions: " + reaction.equation());
+
+        for( unsigned int k = 0; k < reaction.n_rate_constants(); k++ )
+          {
+            if( reaction.forward_rate(k).type() == KineticsModel::PHOTOCHEM )
+              antioch_error_msg("MechanismCodeGenerator does not support photochemical reactions: " + reaction.equation());
+          }
+
+        for( unsigned int r = 0; r < reaction.n_reactants(); r++ )
+          _net_stoichiometry[rxn][reaction.reactant_id(r)] -= static_cast<int>(reaction.reactant_stoichiometric_coefficient(r));
+
+        for( unsigned int p = 0; p < reaction.n_products(); p++ )
+          _net_stoichiometry[rxn][reaction.product_id(p)] += static_cast<int>(reaction.product_stoichiometric_coefficient(p));
+
+        if( reaction.reversible() && reaction.gamma() != 0 )
+          {
+            std::ostringstream name;
+            name << "P0_RT";
+            if( reaction.gamma() != 1 )
+              name << "_" << ( reaction.gamma() < 0 ? "m" : "" ) << std::abs(reaction.gamma());
+            _P0_RT_powers[reaction.gamma()] = name.str();
+          }
+      }
+  }
+
+  template<typename CoeffType>
+  inline
+  MechanismCodeGenerator<CoeffType>::~MechanismCodeGenerator()
+  {
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  std::string MechanismCodeGenerator<CoeffType>::constant( const CoeffType value ) const
+  {
+    std::ostringstream literal;
+    literal << std::setprecision(std::numeric_limits<CoeffType>::digits10 + 2) << value;
+    return "Scalar(" + literal.str() + ")";
+  }
+
+  template<typename CoeffType>
+  inline
+  std::string MechanismCodeGenerator<CoeffType>::sum_of( const std::string& terms ) const
+  {
+    antioch_assert_greater( terms.size(), 3 );
+    return ( terms[1] == '-' ? "-" : "" ) + terms.substr(3);
+  }
+
+  template<typename CoeffType>
+  inline
+  std::string MechanismCodeGenerator<CoeffType>::scaled( const CoeffType value, const std::string& expression ) const
+  {
+    if( value == 1 )
+      return expression;
+    if( value == -1 )
+      return "-" + expression;
+    return this->constant(value) + "*" + expression;
+  }
+
+  template<typename CoeffType>
+  inline
+  std::string MechanismCodeGenerator<CoeffType>::coefficient( unsigned int nu ) const
+  {
+    if( nu == 1 )
+      return "";
+
+    std::ostringstream prefix;
+    prefix << "Scalar(" << nu << ")*";
+    return prefix.str();
+  }
+
+  template<typename CoeffType>
+  inline
+  std::string MechanismCodeGenerator<CoeffType>::species_power( unsigned int s, CoeffType order, unsigned int integer_order ) const
+  {
+    std::ostringstream x;
+    x << "X[" << s << "]";
+
+    if( !integer_order )
+      return "Antioch::ant_pow(" + x.str() + ", " + this->constant(order) + ")";
+
+    std::string power = x.str();
+    for( unsigned int k = 1; k < integer_order; k++ )
+      power += "*" + x.str();
+
+    return power;
+  }
+
+  template<typename CoeffType>
+  inline
+  bool MechanismCodeGenerator<CoeffType>::depends_on_M( unsigned int rxn ) const
+  {
+    const ReactionType::ReactionType type = _reaction_set.reaction(rxn).type();
+    return ( type != ReactionType::ELEMENTARY && type != ReactionType::DUPLICATE );
+  }
+
+  template<typename CoeffType>
+  inline
+  void MechanismCodeGenerator<CoeffType>::write_rate_constant( std::ostream& output,
+                                                               const KineticsType<CoeffType>& rate,
+                                                               const std::string& k,
+                                                               const std::string& dk_dT ) const
+  {
+    // All the analytical models are Cf*exp(eta*ln(T) - Ea/T + D*T)
+    CoeffType Cf = 0, eta = 0, Ea = 0, D = 0;
+
+    switch( rate.type() )
+      {
+      case(KineticsModel::CONSTANT):
+        Cf = static_cast<const ConstantRate<CoeffType>&>(rate).Cf();
+        break;
+
+      case(KineticsModel::HERCOURT_ESSEN):
+        {
+          const HercourtEssenRate<CoeffType>& he = static_cast<const HercourtEssenRate<CoeffType>&>(rate);
+          Cf  = he.Cf();
+          eta = he.eta();
+        }
+        break;
+
+      case(KineticsModel::BERTHELOT):
+        {
+          const BerthelotRate<CoeffType>& berth = static_cast<const BerthelotRate<CoeffType>&>(rate);
+          Cf = berth.Cf();
+          D  = berth.D();
+        }
+        break;
+
+      case(KineticsModel::ARRHENIUS):
+        {
+          const ArrheniusRate<CoeffType>& arr = static_cast<const ArrheniusRate<CoeffType>&>(rate);
+          Cf = arr.Cf();
+          Ea = arr.Ea_K();
+        }
+        break;
+
+      case(KineticsModel::BHE):
+        {
+          const BerthelotHercourtEssenRate<CoeffType>& bhe = static_cast<const BerthelotHercourtEssenRate<CoeffType>&>(rate);
+          Cf  = bhe.Cf();
+          eta = bhe.eta();
+          D   = bhe.D();
+        }
+        break;
+
+      case(KineticsModel::KOOIJ):
+        {
+          const KooijRate<CoeffType>& kooij = static_cast<const KooijRate<CoeffType>&>(rate);
+          Cf  = kooij.Cf();
+          eta = kooij.eta();
+          Ea  = kooij.Ea_K();
+        }
+        break;
+
+      case(KineticsModel::VANTHOFF):
+        {
+          const VantHoffRate<CoeffType>& vh = static_cast<const VantHoffRate<CoeffType>&>(rate);
+          Cf  = vh.Cf();
+          eta = vh.eta();
+          Ea  = vh.Ea_K();
+          D   = vh.D();
+        }
+        break;
+
+      default:
+        {
+          antioch_error();
+        }
+      } // switch( rate.type() )
+
+    std::string exponent, dlnk_dT;
+    if( eta != 0 )
+      {
+        exponent += " + " + this->scaled(eta, "lnT");
+        dlnk_dT  += " + " + this->scaled(eta, "invT");
+      }
+    if( Ea != 0 )
+      {
+        exponent += " - " + this->constant(Ea) + "*invT";
+        dlnk_dT  += " + " + this->constant(Ea) + "*invT*invT";
+      }
+    if( D != 0 )
+      {
+        exponent += " + " + this->constant(D) + "*T";
+        dlnk_dT  += " + " + this->constant(D);
+      }
+
+    if( exponent.empty() )
+      output << "    const StateType " << k << " = Antioch::constant_clone(T, " << this->constant(Cf) << ");\n";
+    else
+      output << "    const StateType " << k << " = "
+             << this->scaled(Cf, "Antioch::ant_exp(StateType(" + this->sum_of(exponent) + "))") << ";\n";
+
+    if( dk_dT.empty() )
+      return;
+
+    if( dlnk_dT.empty() )
+      output << "    const StateType " << dk_dT << " = Antioch::zero_clone(T);\n";
+    else
+      output << "    const StateType " << dk_dT << " = " << k << "*(" << this->sum_of(dlnk_dT) << ");\n";
+  }
+
+  template<typename CoeffType>
+  inline
+  void MechanismCodeGenerator<CoeffType>::write_forward_rate_coefficient( std::ostream& output,
+                                                                          unsigned int rxn,
+                                                                          bool derivatives ) const
+  {
+    const Reaction<CoeffType>& reaction = _reaction_set.reaction(rxn);
+
+    std::ostringstream suffix_stream;
+    suffix_stream << rxn;
+    const std::string n = suffix_stream.str();
+    const std::string kf = "kf" + n, dkf_dT = derivatives ? "dkf" + n + "_dT" : "";
+
+    // Third-body concentration, the efficiencies being folded in
+    std::string M = "Mtot";
+    if( reaction.n_efficiency_corrections() )
+      {
+        M = "M" + n;
+        output << "    const StateType " << M << " = Mtot";
+        for( unsigned int k = 0; k < reaction.n_efficiency_corrections(); k++ )
+          {
+            const CoeffType correction = reaction.efficiency_correction(k) - 1;
+            if( correction == 0 )
+              continue;
+            std::ostringstream x;
+            x << "X[" << reaction.efficiency_correction_species(k) << "]";
+            output << ( correction < 0 ? " - " : " + " ) << this->scaled(std::abs(correction), x.str());
+          }
+        output << ";\n";
+      }
+
+    switch( reaction.type() )
+      {
+      case(ReactionType::ELEMENTARY):
+        this->write_rate_constant( output, reaction.forward_rate(), kf, dkf_dT );
+        break;
+
+      case(ReactionType::DUPLICATE):
+        {
+          std::string sum, dsum;
+          for( unsigned int k = 0; k < reaction.n_rate_constants(); k++ )
+            {
+              std::ostringstream kk;
+              kk << "_" << k;
+              this->write_rate_constant( output, reaction.forward_rate(k), kf + kk.str(),
+                                         derivatives ? dkf_dT + kk.str() : "" );
+              sum  += " + " + kf + kk.str();
+              dsum += " + " + dkf_dT + kk.str();
+            }
+          output << "    const StateType " << kf << " = " << this->sum_of(sum) << ";\n";
+          if( derivatives )
+            output << "    const StateType " << dkf_dT << " = " << this->sum_of(dsum) << ";\n";
+        }
+        break;
+
+      case(ReactionType::THREE_BODY):
+        {
+          this->write_rate_constant( output, reaction.forward_rate(), "alpha" + n,
+                                     derivatives ? "dalpha" + n + "_dT" : "" );
+          output << "    const StateType " << kf << " = alpha" << n << "*" << M << ";\n";
+          if( derivatives )
+            {
+              output << "    const StateType " << dkf_dT << " = dalpha" << n << "_dT*" << M << ";\n";
+              output << "    const StateType& dkf" << n << "_dM = alpha" << n << ";\n";
+            }
+        }
+        break;
+
+      case(ReactionType::LINDEMANN_FALLOFF):
+      case(ReactionType::TROE_FALLOFF):
+      case(ReactionType::LINDEMANN_FALLOFF_THREE_BODY):
+      case(ReactionType::TROE_FALLOFF_THREE_BODY):
+        {
+          const std::string k0 = "k0_" + n, kinf = "kinf" + n, kl = "kl" + n;
+          this->write_rate_constant( output, reaction.forward_rate(0), k0,
+                                     derivatives ? "dk0_" + n + "_dT" : "" );
+          this->write_rate_constant( output, reaction.forward_rate(1), kinf,
+                                     derivatives ? "dkinf" + n + "_dT" : "" );
+
+          // Lindemann form, k0/(1/[M] + k0/kinf)
+          output << "    const StateType " << kl << " = " << k0 << "/(Scalar(1)/" << M << " + " << k0 << "/" << kinf << ");\n";
+          if( derivatives )
+            {
+              output << "    const StateType d" << kl << "_dT = " << kl << "*(dk0_" << n << "_dT/" << k0
+                     << " - dk0_" << n << "_dT/(" << kinf << "/" << M << " + " << k0 << ")"
+                     << " + dkinf" << n << "_dT*" << k0 << "/(" << kinf << "*(" << kinf << "/" << M << " + " << k0 << ")));\n";
+              output << "    const StateType d" << kl << "_dM = " << kl << "/(" << M << " + " << M << "*" << M << "*" << k0 << "/" << kinf << ");\n";
+            }
+
+          const bool troe = ( reaction.type() == ReactionType::TROE_FALLOFF ||
+                              reaction.type() == ReactionType::TROE_FALLOFF_THREE_BODY );
+          if( !troe )
+            {
+              output << "    const StateType& " << kf << " = " << kl << ";\n";
+              if( derivatives )
+                {
+                  output << "    const StateType& " << dkf_dT << " = d" << kl << "_dT;\n";
+                  output << "    const StateType& dkf" << n << "_dM = d" << kl << "_dM;\n";
+                }
+              break;
+            }
+
+          const CoeffType alpha = reaction.get_parameter_of_chemical_process(ReactionType::TROE_ALPHA);
+          const CoeffType T1    = reaction.get_parameter_of_chemical_process(ReactionType::TROE_T1);
+          const CoeffType T2    = reaction.get_parameter_of_chemical_process(ReactionType::TROE_T2);
+          const CoeffType T3    = reaction.get_parameter_of_chemical_process(ReactionType::TROE_T3);
+          const CoeffType ln10  = std::log(CoeffType(10));
+
+          // Fcent = (1-alpha) exp(-T/T3) + alpha exp(-T/T1) + exp(-T2/T)
+          std::string Fcent, dFcent_dT;
+          if( T3 != 0 && alpha != 1 )
+            {
+              const std::string term = "Antioch::ant_exp(StateType(" + this->constant(-1/T3) + "*T))";
+              Fcent     += " + " + this->constant(1 - alpha) + "*" + term;
+              dFcent_dT += " + " + this->constant((alpha - 1)/T3) + "*" + term;
+            }
+          if( T1 != 0 && alpha != 0 )
+            {
+              const std::string term = "Antioch::ant_exp(StateType(" + this->constant(-1/T1) + "*T))";
+              Fcent     += " + " + this->constant(alpha) + "*" + term;
+              dFcent_dT += " + " + this->constant(-alpha/T1) + "*" + term;
+            }
+          if( T2 != std::numeric_limits<CoeffType>::max() )
+            {
+              const std::string term = "Antioch::ant_exp(StateType(" + this->constant(-T2) + "*invT))";
+              Fcent     += " + " + term;
+              dFcent_dT += " + " + this->constant(T2) + "*invT*invT*" + term;
+            }
+          antioch_assert( !Fcent.empty() );
+
+          output << "    const StateType Fcent" << n << " = " << this->sum_of(Fcent) << ";\n"
+                 << "    const StateType lnFcent" << n << " = Antioch::ant_log(Fcent" << n << ");\n"
+                 << "    const StateType log10Pr" << n << " = " << this->constant(1/ln10)
+                 << "*Antioch::ant_log(StateType(" << M << "*" << k0 << "/" << kinf << "));\n"
+                 << "    const StateType c" << n << " = " << this->constant(-0.4L) << " - "
+                 << this->constant(0.67L/ln10) << "*lnFcent" << n << ";\n"
+                 << "    const StateType nt" << n << " = " << this->constant(0.75L) << " - "
+                 << this->constant(1.27L/ln10) << "*lnFcent" << n << ";\n"
+                 << "    const StateType y" << n << " = log10Pr" << n << " + c" << n << ";\n"
+                 << "    const StateType d" << n << " = nt" << n << " - " << this->constant(0.14L) << "*y" << n << ";\n"
+                 << "    const StateType x" << n << " = y" << n << "/d" << n << ";\n"
+                 << "    const StateType lnF" << n << " = lnFcent" << n << "/(Scalar(1) + x" << n << "*x" << n << ");\n"
+                 << "    const StateType F" << n << " = Antioch::ant_exp(lnF" << n << ");\n"
+                 << "    const StateType " << kf << " = " << kl << "*F" << n << ";\n";
+
+          if( derivatives )
+            {
+              output << "    const StateType dlnFcent" << n << "_dT = (" << this->sum_of(dFcent_dT) << ")/Fcent" << n << ";\n"
+                     << "    const StateType dlog10Pr" << n << "_dT = " << this->constant(1/ln10)
+                     << "*(dk0_" << n << "_dT/" << k0 << " - dkinf" << n << "_dT/" << kinf << ");\n"
+                     << "    const StateType dy" << n << "_dT = dlog10Pr" << n << "_dT - "
+                     << this->constant(0.67L/ln10) << "*dlnFcent" << n << "_dT;\n"
+                     << "    const StateType dd" << n << "_dT = " << this->constant(-1.27L/ln10) << "*dlnFcent" << n << "_dT - "
+                     << this->constant(0.14L) << "*dy" << n << "_dT;\n"
+                     << "    const StateType dlnF" << n << "_dT = (dlnFcent" << n << "_dT - Scalar(2)*lnF" << n << "*x" << n
+                     << "*(dy" << n << "_dT*d" << n << " - y" << n << "*dd" << n << "_dT)/(d" << n << "*d" << n << "))"
+                     << "/(Scalar(1) + x" << n << "*x" << n << ");\n"
+                     << "    const StateType dlnF" << n << "_dM = " << this->constant(-2/ln10) << "*lnF" << n << "*x" << n
+                     << "*nt" << n << "/(d" << n << "*d" << n << "*" << M << "*(Scalar(1) + x" << n << "*x" << n << "));\n"
+                     << "    const StateType " << dkf_dT << " = F" << n << "*d" << kl << "_dT + " << kf << "*dlnF" << n << "_dT;\n"
+                     << "    const StateType dkf" << n << "_dM = F" << n << "*d" << kl << "_dM + " << kf << "*dlnF" << n << "_dM;\n";
+            }
+        }
+        break;
+
+      default:
+        {
+          antioch_error();
+        }
+      } // switch( reaction.type() )
+  }
+
+  template<typename CoeffType>
+  inline
+  void MechanismCodeGenerator<CoeffType>::write_rate_of_progress( std::ostream& output,
+                                                                  unsigned int rxn,
+                                                                  bool derivatives,
+                                                                  std::vector<unsigned int>& dX_species ) const
+  {
+    const Reaction<CoeffType>& reaction = _reaction_set.reaction(rxn);
+
+    std::ostringstream suffix_stream;
+    suffix_stream << rxn;
+    const std::string n = suffix_stream.str();
+
+    output << "    // " << reaction.equation() << "\n";
+
+    this->write_forward_rate_coefficient( output, rxn, derivatives );
+
+    // Concentration products, and the derivatives with respect to each
+    // participating species, partial_order_power convention
+    std::vector<std::string> reactant_powers(reaction.n_reactants());
+    for( unsigned int r = 0; r < reaction.n_reactants(); r++ )
+      reactant_powers[r] = this->species_power( reaction.reactant_id(r),
+                                                reaction.reactant_partial_order(r),
+                                                reaction.reactant_integer_partial_order(r) );
+
+    std::vector<std::string> product_powers(reaction.n_products());
+    for( unsigned int p = 0; p < reaction.n_products(); p++ )
+      product_powers[p] = this->species_power( reaction.product_id(p),
+                                               reaction.product_partial_order(p),
+                                               reaction.product_integer_partial_order(p) );
+
+    std::string fwd;
+    for( unsigned int r = 0; r < reaction.n_reactants(); r++ )
+      fwd += "*" + reactant_powers[r];
+
+    output << "    const StateType Rf" << n << " = kf" << n << fwd << ";\n";
+
+    std::string bwd;
+    if( reaction.reversible() )
+      {
+        for( unsigned int p = 0; p < reaction.n_products(); p++ )
+          bwd += "*" + product_powers[p];
+
+        // Keq = (P0/RT)^gamma exp( sum_r nu_r h_r - sum_p nu_p h_p )
+        std::string exppower, dexppower;
+        for( unsigned int r = 0; r < reaction.n_reactants(); r++ )
+          {
+            std::ostringstream id;
+            id << reaction.reactant_id(r) << "]";
+            const std::string nu = this->coefficient(reaction.reactant_stoichiometric_coefficient(r));
+            exppower  += " + " + nu + "h[" + id.str();
+            dexppower += " + " + nu + "dh[" + id.str();
+          }
+        for( unsigned int p = 0; p < reaction.n_products(); p++ )
+          {
+            std::ostringstream id;
+            id << reaction.product_id(p) << "]";
+            const std::string nu = this->coefficient(reaction.product_stoichiometric_coefficient(p));
+            exppower  += " - " + nu + "h[" + id.str();
+            dexppower += " - " + nu + "dh[" + id.str();
+          }
+
+        output << "    const StateType keq" << n << " = ";
+        if( reaction.gamma() != 0 )
+          output << _P0_RT_powers.find(reaction.gamma())->second << "*";
+        output << "Antioch::ant_exp(StateType(" << this->sum_of(exppower) << "));\n";
+        output << "    const StateType kb" << n << " = kf" << n << "/keq" << n << ";\n";
+        output << "    const StateType Rb" << n << " = kb" << n << bwd << ";\n";
+        output << "    const StateType R" << n << " = Rf" << n << " - Rb" << n << ";\n";
+
+        if( derivatives )
+          {
+            output << "    const StateType dlnkeq" << n << "_dT = ";
+            if( reaction.gamma() != 0 )
+              output << this->scaled(-reaction.gamma(), "invT") << " + ";
+            output << this->sum_of(dexppower) << ";\n";
+            output << "    const StateType dR" << n << "_dT = dkf" << n << "_dT*(" << fwd.substr(1)
+                   << " - Scalar(1)/keq" << n << bwd << ") + Rb" << n << "*dlnkeq" << n << "_dT;\n";
+          }
+      }
+    else
+      {
+        output << "    const StateType& R" << n << " = Rf" << n << ";\n";
+        if( derivatives )
+          output << "    const StateType dR" << n << "_dT = dkf" << n << "_dT" << fwd << ";\n";
+      }
+
+    if( !derivatives )
+      return;
+
+    if( this->depends_on_M(rxn) )
+      {
+        if( reaction.reversible() )
+          output << "    const StateType dR" << n << "_dM = dkf" << n << "_dM*(" << fwd.substr(1)
+                 << " - Scalar(1)/keq" << n << bwd << ");\n";
+        else
+          output << "    const StateType dR" << n << "_dM = dkf" << n << "_dM" << fwd << ";\n";
+      }
+
+    // d(prod_r x_r^o_r)/dx_s
+    std::map<unsigned int,std::string> dR_dX;
+    for( unsigned int r = 0; r < reaction.n_reactants(); r++ )
+      {
+        std::ostringstream dpower;
+        dpower << "kf" << n;
+        const unsigned int o = reaction.reactant_integer_partial_order(r);
+        // d(x^o)/dx = o x^(o-1)
+        if( o > 1 )
+          dpower << "*Scalar(" << o << ")*" << this->species_power( reaction.reactant_id(r), o - 1, o - 1 );
+        else if( !o )
+          dpower << "*" << this->constant(reaction.reactant_partial_order(r))
+                 << "*" << this->species_power( reaction.reactant_id(r), reaction.reactant_partial_order(r) - 1, 0 );
+        for( unsigned int rr = 0; rr < reaction.n_reactants(); rr++ )
+          if( rr != r )
+            dpower << "*" << reactant_powers[rr];
+
+        std::string& entry = dR_dX[reaction.reactant_id(r)];
+        entry += ( entry.empty() ? "" : " + " ) + dpower.str();
+      }
+
+    if( reaction.reversible() )
+      {
+        for( unsigned int p = 0; p < reaction.n_products(); p++ )
+          {
+            std::ostringstream dpower;
+            dpower << "kb" << n;
+            const unsigned int o = reaction.product_integer_partial_order(p);
+            // d(x^o)/dx = o x^(o-1)
+            if( o > 1 )
+              dpower << "*Scalar(" << o << ")*" << this->species_power( reaction.product_id(p), o - 1, o - 1 );
+            else if( !o )
+              dpower << "*" << this->constant(reaction.product_partial_order(p))
+                     << "*" << this->species_power( reaction.product_id(p), reaction.product_partial_order(p) - 1, 0 );
+            for( unsigned int pp = 0; pp < reaction.n_products(); pp++ )
+              if( pp != p )
+                dpower << "*" << product_powers[pp];
+
+            std::string& entry = dR_dX[reaction.product_id(p)];
+            entry = ( entry.empty() ? "-" : entry + " - " ) + dpower.str();
+          }
+      }
+
+    // Non-unity efficiencies add to the dR_dM contribution
+    if( reaction.n_efficiency_corrections() )
+      {
+        for( unsigned int k = 0; k < reaction.n_efficiency_corrections(); k++ )
+          {
+            const CoeffType correction = reaction.efficiency_correction(k) - 1;
+            if( correction == 0 )
+              continue;
+            std::string& entry = dR_dX[reaction.efficiency_correction_species(k)];
+            entry = ( entry.empty() ? "" : entry + " + " ) + this->scaled(correction, "dR" + n + "_dM");
+          }
+      }
+
+    dX_species.clear();
+    for( typename std::map<unsigned int,std::string>::const_iterator it = dR_dX.begin();
+         it != dR_dX.end(); ++it )
+      {
+        output << "    const StateType dR" << n << "_dX" << it->first << " = " << it->second << ";\n";
+        dX_species.push_back(it->first);
+      }
+  }
+
+  template<typename CoeffType>
+  inline
+  void MechanismCodeGenerator<CoeffType>::write_reactions( std::ostream& output, bool derivatives,
+                                                           std::vector<std::vector<unsigned int> >& dX_species ) const
+  {
+    const unsigned int n_species = _reaction_set.n_species();
+
+    output << "    typedef typename Antioch::raw_value_type<StateType>::type Scalar;\n"
+           << "    const VectorStateType& X = molar_densities;\n"
+           << "    const VectorStateType& h = h_RT_minus_s_R;\n";
+    if( derivatives )
+      output << "    const VectorStateType& dh = dh_RT_minus_s_R_dT;\n";
+
+    output << "    const StateType lnT = Antioch::ant_log(T);\n"
+           << "    const StateType invT = Scalar(1)/T;\n";
+
+    bool uses_M = false;
+    for( unsigned int rxn = 0; rxn < _reaction_set.n_reactions(); rxn++ )
+      uses_M = uses_M || this->depends_on_M(rxn);
+
+    if( uses_M )
+      {
+        output << "    const StateType Mtot = X[0]";
+        for( unsigned int s = 1; s < n_species; s++ )
+          output << " + X[" << s << "]";
+        output << ";\n";
+      }
+
+    if( !_P0_RT_powers.empty() )
+      {
+        output << "    const StateType P0_RT = " << this->constant(1e5/Constants::R_universal<CoeffType>()) << "*invT;\n";
+        for( typename std::map<int,std::string>::const_iterator it = _P0_RT_powers.begin();
+             it != _P0_RT_powers.end(); ++it )
+          {
+            if( it->first == 1 )
+              continue;
+            output << "    const StateType " << it->second << " = ";
+            const unsigned int power = std::abs(it->first);
+            std::string product = "P0_RT";
+            for( unsigned int k = 1; k < power; k++ )
+              product += "*P0_RT";
+            if( it->first < 0 )
+              output << "Scalar(1)/" << ( power > 1 ? "(" + product + ")" : product ) << ";\n";
+            else
+              output << product << ";\n";
+          }
+      }
+
+    dX_species.resize(_reaction_set.n_reactions());
+    for( unsigned int rxn = 0; rxn < _reaction_set.n_reactions(); rxn++ )
+      {
+        output << "\n";
+        this->write_rate_of_progress( output, rxn, derivatives, dX_species[rxn] );
+      }
+  }
+
+  template<typename CoeffType>
+  inline
+  void MechanismCodeGenerator<CoeffType>::write( std::ostream& output, const std::string& name_space ) const
+  {
+    const unsigned int n_species   = _reaction_set.n_species();
+    const unsigned int n_reactions = _reaction_set.n_reactions();
+
+    std::string guard = "ANTIOCH_MECHANISM_";
+    for( unsigned int c = 0; c < name_space.size(); c++ )
+      guard += std::isalnum(name_space[c]) ? static_cast<char>(std::toupper(name_space[c])) : '_';
+    guard += "_H";
+
+    output << "// Generated by Antioch's MechanismCodeGenerator, do not edit.\n"
+           << "// " << n_species << " species, " << n_reactions << " reactions.\n\n"
+           << "#ifndef " << guard << "\n"
+           << "#define " << guard << "\n\n"
+           << "#include \"antioch/cmath_shims.h\"\n"
+           << "#include \"antioch/metaprogramming.h\"\n\n"
+           << "namespace " << name_space << "\n{\n\n"
+           << "  const unsigned int n_species = " << n_species << ";\n"
+           << "  const unsigned int n_reactions = " << n_reactions << ";\n\n";
+
+    // Species names, in the order of the chemical mixture
+    const std::map<Species,std::string>& names = _reaction_set.chemical_mixture().species_inverse_name_map();
+    const std::vector<Species>& species = _reaction_set.chemical_mixture().species_list();
+    output << "  inline const char* species_name( const unsigned int s )\n  {\n"
+           << "    static const char* const names[n_species] = {";
+    for( unsigned int s = 0; s < n_species; s++ )
+      output << ( s ? ", " : " " ) << "\"" << names.find(species[s])->second << "\"";
+    output << " };\n    return names[s];\n  }\n\n";
+
+    std::vector<std::vector<unsigned int> > dX_species;
+
+    // Rates of progress
+    output << "  template <typename StateType, typename VectorStateType, typename VectorReactionsType>\n"
+           << "  inline\n"
+           << "  void compute_reaction_rates( const StateType& T,\n"
+           << "                               const VectorStateType& molar_densities,\n"
+           << "                               const VectorStateType& h_RT_minus_s_R,\n"
+           << "                               VectorReactionsType& net_reaction_rates )\n  {\n";
+    this->write_reactions( output, false, dX_species );
+    output << "\n";
+    for( unsigned int rxn = 0; rxn < n_reactions; rxn++ )
+      output << "    net_reaction_rates[" << rxn << "] = R" << rxn << ";\n";
+    output << "  }\n\n";
+
+    // Species sources, from the transposed stoichiometry
+    std::vector<std::map<unsigned int,int> > species_stoichiometry(n_species);
+    for( unsigned int rxn = 0; rxn < n_reactions; rxn++ )
+      for( std::map<unsigned int,int>::const_iterator it = _net_stoichiometry[rxn].begin();
+           it != _net_stoichiometry[rxn].end(); ++it )
+        if( it->second != 0 )
+          species_stoichiometry[it->first][rxn] = it->second;
+
+    for( unsigned int derivs = 0; derivs < 2; derivs++ )
+      {
+        output << "  template <typename StateType, typename VectorStateType>\n"
+               << "  inline\n";
+        if( derivs )
+          output << "  void compute_mole_sources_and_derivs( const StateType& T,\n"
+                 << "                                        const VectorStateType& molar_densities,\n"
+                 << "                                        const VectorStateType& h_RT_minus_s_R,\n"
+                 << "                                        const VectorStateType& dh_RT_minus_s_R_dT,\n"
+                 << "                                        VectorStateType& mole_sources,\n"
+                 << "                                        VectorStateType& dmole_dT,\n"
+                 << "                                        std::vector<VectorStateType>& dmole_dX_s )\n  {\n";
+        else
+          output << "  void compute_mole_sources( const StateType& T,\n"
+                 << "                             const VectorStateType& molar_densities,\n"
+                 << "                             const VectorStateType& h_RT_minus_s_R,\n"
+                 << "                             VectorStateType& mole_sources )\n  {\n";
+
+        this->write_reactions( output, derivs, dX_species );
+        output << "\n";
+
+        for( unsigned int s = 0; s < n_species; s++ )
+          {
+            std::string sum, dsum;
+            for( std::map<unsigned int,int>::const_iterator it = species_stoichiometry[s].begin();
+                 it != species_stoichiometry[s].end(); ++it )
+              {
+                std::ostringstream term;
+                if( it->second == 1 )
+                  term << " + ";
+                else if( it->second == -1 )
+                  term << " - ";
+                else
+                  term << ( it->second < 0 ? " - " : " + " ) << "Scalar(" << std::abs(it->second) << ")*";
+                sum  += term.str() + "R" ;
+                dsum += term.str() + "dR";
+                std::ostringstream id;
+                id << it->first;
+                sum  += id.str();
+                dsum += id.str() + "_dT";
+              }
+
+            output << "    mole_sources[" << s << "] = ";
+            if( sum.empty() )
+              output << "Antioch::zero_clone(T);\n";
+            else
+              output << this->sum_of(sum) << ";\n";
+
+            if( derivs )
+              {
+                output << "    dmole_dT[" << s << "] = ";
+                if( dsum.empty() )
+                  output << "Antioch::zero_clone(T);\n";
+                else
+                  output << this->sum_of(dsum) << ";\n";
+              }
+          }
+
+        if( !derivs )
+          {
+            output << "  }\n\n";
+            continue;
+          }
+
+        // Jacobian, the third-body contributions being spread over all species first
+        output << "\n"
+               << "    for( unsigned int s = 0; s < n_species; s++ )\n"
+               << "      for( unsigned int k = 0; k < n_species; k++ )\n"
+               << "        dmole_dX_s[s][k] = Antioch::zero_clone(T);\n";
+
+        for( unsigned int rxn = 0; rxn < n_reactions; rxn++ )
+          {
+            if( !this->depends_on_M(rxn) )
+              continue;
+
+            for( std::map<unsigned int,int>::const_iterator it = _net_stoichiometry[rxn].begin();
+                 it != _net_stoichiometry[rxn].end(); ++it )
+              {
+                if( it->second == 0 )
+                  continue;
+                output << "    for( unsigned int k = 0; k < n_species; k++ )\n"
+                       << "      dmole_dX_s[" << it->first << "][k] += ";
+                if( it->second != 1 )
+                  output << "Scalar(" << it->second << ")*";
+                output << "dR" << rxn << "_dM;\n";
+              }
+          }
+
+        for( unsigned int rxn = 0; rxn < n_reactions; rxn++ )
+          for( std::map<unsigned int,int>::const_iterator it = _net_stoichiometry[rxn].begin();
+               it != _net_stoichiometry[rxn].end(); ++it )
+            {
+              if( it->second == 0 )
+                continue;
+              for( unsigned int k = 0; k < dX_species[rxn].size(); k++ )
+                {
+                  output << "    dmole_dX_s[" << it->first << "][" << dX_species[rxn][k] << "] += ";
+                  if( it->second != 1 )
+                    output << "Scalar(" << it->second << ")*";
+                  output << "dR" << rxn << "_dX" << dX_species[rxn][k] << ";\n";
+                }
+            }
+
+        output << "  }\n\n";
+      }
+
+    output << "} // end namespace " << name_space << "\n\n"
+           << "#endif // " << guard << "\n";
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_MECHANISM_CODE_GENERATOR_H
@@ -0,0 +1,581 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+
+
+#ifndef ANTIOCH_PARALLEL_KINETICS_DRIVER_H
+#define ANTIOCH_PARALLEL_KINETICS_DRIVER_H
+
+// Antioch
+#include "antioch/antioch_asserts.h"
+#include "antioch/reaction_set.h"
+#include "antioch/kinetics_evaluator.h"
+#include "antioch/kinetics_conditions.h"
+#include "antioch/stoichiometry_matrix.h"
+#include "antioch/kinetics_jacobian_pattern.h"
+#include "antioch/nasa7_curve_fit.h"
+#include "antioch/nasa_mixture.h"
+#include "antioch/nasa_evaluator.h"
+#include "antioch/temp_cache.h"
+
+// C++
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+
+namespace Antioch
+{
+  //! Class to compute the source terms of a range of cells on a pool of threads.
+  /*!
+   * Each worker thread owns its own KineticsEvaluator and NASAEvaluator,
+   * both created within the worker thread. The cells of a call are cut
+   * into chunks of chunk_size() cells, distributed evenly over the workers
+   * queues. A worker whose queue is empty steals chunks from the back of
+   * the other queues, so that expensive (hot, stiff) regions of the mesh
+   * do not leave the other workers idle.
+   *
+   * Each cell is computed by a single worker with exactly the same
+   * operations, there is no reduction across cells: the results do not
+   * depend on the number of workers nor on the scheduling.
+   *
+   * Arrays are cell-major, i.e. molar_densities[c*n_species + s], and
+   * indexed by the global cell index: only cells [first_cell,end_cell)
+   * are read and written. The reaction set and the thermo mixture must
+   * outlive the driver. The calls themselves are not thread-safe.
+   *
+   * Built on std::thread: code including this header must be compiled
+   * and linked with the thread flags of the platform (-pthread for gcc
+   * and clang), which antioch.pc exports in its Cflags and Libs.
+   */
+  template<typename CoeffType=double, typename NASAFit=NASA7CurveFit<CoeffType> >
+  class ParallelKineticsDriver
+  {
+  public:
+
+    //! n_workers = 0 uses std::thread::hardware_concurrency() workers
+    ParallelKineticsDriver( const ReactionSet<CoeffType>& reaction_set,
+                            const NASAThermoMixture<CoeffType,NASAFit>& thermo_mixture,
+                            const unsigned int n_workers = 0,
+                            const unsigned int chunk_size = 16 );
+
+    //! Stops and joins the workers
+    ~ParallelKineticsDriver();
+
+    unsigned int n_workers() const;
+
+    unsigned int chunk_size() const;
+
+    unsigned int n_species() const;
+
+    //! Sparsity pattern (CSR) of the per cell Jacobians of compute_mass_sources_and_derivs
+    const KineticsJacobianPattern<CoeffType>& jacobian_pattern() const;
+
+    //! Compute species production/destruction rates per unit volume of cells [first_cell,end_cell)
+    /*! \f$ \left(kg/sec/m^3\right)\f$ */
+    void compute_mass_sources( const unsigned int first_cell,
+                               const unsigned int end_cell,
+                               const std::vector<CoeffType>& T,
+                               const std::vector<CoeffType>& molar_densities,
+                               std::vector<CoeffType>& mass_sources );
+
+    //! Compute species production/destruction rates and derivatives of cells [first_cell,end_cell)
+    /*! \p dmass_dT is cell-major as \p mass_sources, \p dmass_drho_s holds
+     *  the jacobian_pattern().n_nonzeros() values of each cell:
+     *  dmass_drho_s[c*n_nonzeros + k].
+     */
+    void compute_mass_sources_and_derivs( const unsigned int first_cell,
+                                          const unsigned int end_cell,
+                                          const std::vector<CoeffType>& T,
+                                          const std::vector<CoeffType>& molar_densities,
+                                          std::vector<CoeffType>& mass_sources,
+                                          std::vector<CoeffType>& dmass_dT,
+                                          std::vector<CoeffType>& dmass_drho_s );
+
+    //! Number of chunks taken from another worker during the last call
+    unsigned int n_steals() const;
+
+  private:
+
+    ParallelKineticsDriver();
+    ParallelKineticsDriver( const ParallelKineticsDriver& );
+    ParallelKineticsDriver& operator=( const ParallelKineticsDriver& );
+
+    //! Evaluators and work arrays of one worker
+    struct Workspace
+    {
+      Workspace( const ReactionSet<CoeffType>& reaction_set,
+                 const NASAThermoMixture<CoeffType,NASAFit>& thermo_mixture,
+                 const unsigned int n_nonzeros );
+
+      KineticsEvaluator<CoeffType> kinetics;
+      NASAEvaluator<CoeffType,NASAFit> thermo;
+
+      std::vector<CoeffType> molar_densities;
+      std::vector<CoeffType> h_RT_minus_s_R;
+      std::vector<CoeffType> dh_RT_minus_s_R_dT;
+      std::vector<CoeffType> mass_sources;
+      std::vector<CoeffType> dmass_dT;
+      std::vector<CoeffType> dmass_drho_s;
+    };
+
+    //! Chunks [begin,end) left to one worker
+    struct ChunkQueue
+    {
+      std::mutex mutex;
+      unsigned int begin;
+      unsigned int end;
+    };
+
+    //! Body of the worker threads
+    void worker_loop( const unsigned int worker );
+
+    //! Hand the current job to the workers and wait for completion
+    void run( const unsigned int first_cell, const unsigned int end_cell );
+
+    //! Pop a chunk from the worker queue, or steal one, false when none is left
+    bool next_chunk( const unsigned int worker, unsigned int& chunk );
+
+    void compute_chunk( Workspace& workspace, const unsigned int chunk );
+
+    //! Stop and join the workers, free the workspaces
+    void stop();
+
+    const ReactionSet<CoeffType>& _reaction_set;
+
+    const NASAThermoMixture<CoeffType,NASAFit>& _thermo_mixture;
+
+    const StoichiometryMatrix<CoeffType> _stoichiometry;
+
+    const KineticsJacobianPattern<CoeffType> _pattern;
+
+    const unsigned int _n_workers;
+
+    const unsigned int _chunk_size;
+
+    std::vector<std::thread> _threads;
+
+    std::vector<Workspace*> _workspaces;
+
+    std::vector<ChunkQueue*> _queues;
+
+    //! First exception thrown by each worker during the current call
+    std::vector<std::exception_ptr> _errors;
+
+    // current job, set by run() before waking up the workers
+    unsigned int _first_cell;
+    unsigned int _end_cell;
+    const std::vector<CoeffType>* _T;
+    const std::vector<CoeffType>* _molar_densities;
+    std::vector<CoeffType>* _mass_sources;
+    std::vector<CoeffType>* _dmass_dT;
+    std::vector<CoeffType>* _dmass_drho_s;
+
+    // synchronization of the job hand-off
+    std::mutex _mutex;
+    std::condition_variable _start;
+    std::condition_variable _done;
+    unsigned long _generation;
+    unsigned int _n_busy;
+    bool _shutdown;
+
+    std::atomic<unsigned int> _n_steals;
+  };
+
+  /* ------------------------- Inline Functions -------------------------*/
+  template<typename CoeffType, typename NASAFit>
+  inline
+  ParallelKineticsDriver<CoeffType,NASAFit>::Workspace::Workspace( const ReactionSet<CoeffType>& reaction_set,
+                                                                   const NASAThermoMixture<CoeffType,NASAFit>& thermo_mixture,
+                                                                   const unsigned int n_nonzeros )
+    : kinetics( reaction_set, 0 ),
+      thermo( thermo_mixture ),
+      molar_densities( reaction_set.n_species() ),
+      h_RT_minus_s_R( reaction_set.n_species() ),
+      dh_RT_minus_s_R_dT( reaction_set.n_species() ),
+      mass_sources( reaction_set.n_species() ),
+      dmass_dT( reaction_set.n_species() ),
+      dmass_drho_s( n_nonzeros )
+  {
+    return;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  ParallelKineticsDriver<CoeffType,NASAFit>::ParallelKineticsDriver( const ReactionSet<CoeffType>& reaction_set,
+                                                                     const NASAThermoMixture<CoeffType,NASAFit>& thermo_mixture,
+                                                                     const unsigned int n_workers,
+                                                                     const unsigned int chunk_size )
+    : _reaction_set( reaction_set ),
+      _thermo_mixture( thermo_mixture ),
+      _stoichiometry( reaction_set ),
+      _pattern( _stoichiometry, SparseMatrixLayout::CSR ),
+      _n_workers( n_workers ? n_workers : std::max( std::thread::hardware_concurrency(), 1u ) ),
+      _chunk_size( chunk_size ),
+      _workspaces( _n_workers, NULL ),
+      _queues( _n_workers, NULL ),
+      _errors( _n_workers ),
+      _first_cell( 0 ),
+      _end_cell( 0 ),
+      _T( NULL ),
+      _molar_densities( NULL ),
+      _mass_sources( NULL ),
+      _dmass_dT( NULL ),
+      _dmass_drho_s( NULL ),
+      _generation( 0 ),
+      _n_busy( _n_workers ),
+      _shutdown( false ),
+      _n_steals( 0 )
+  {
+    antioch_assert_greater( chunk_size, 0 );
+
+    for( unsigned int w = 0; w < _n_workers; w++ )
+      _queues[w] = new ChunkQueue;
+
+    // the workers build their workspace, then signal
+    for( unsigned int w = 0; w < _n_workers; w++ )
+      _threads.push_back( std::thread( &ParallelKineticsDriver::worker_loop, this, w ) );
+
+    {
+      std::unique_lock<std::mutex> lock( _mutex );
+      while( _n_busy > 0 )
+        _done.wait( lock );
+    }
+
+    for( unsigned int w = 0; w < _n_workers; w++ )
+      if( _errors[w] )
+        {
+          std::exception_ptr error = _errors[w];
+          this->stop();
+          std::rethrow_exception( error );
+        }
+
+    return;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  ParallelKineticsDriver<CoeffType,NASAFit>::~ParallelKineticsDriver()
+  {
+    this->stop();
+    return;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  void ParallelKineticsDriver<CoeffType,NASAFit>::stop()
+  {
+    {
+      std::lock_guard<std::mutex> lock( _mutex );
+      _shutdown = true;
+    }
+    _start.notify_all();
+
+    for( unsigned int w = 0; w < _threads.size(); w++ )
+      _threads[w].join();
+    _threads.clear();
+
+    for( unsigned int w = 0; w < _n_workers; w++ )
+      {
+        delete _workspaces[w];
+        _workspaces[w] = NULL;
+        delete _queues[w];
+        _queues[w] = NULL;
+      }
+
+    return;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  unsigned int ParallelKineticsDriver<CoeffType,NASAFit>::n_workers() const
+  {
+    return _n_workers;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  unsigned int ParallelKineticsDriver<CoeffType,NASAFit>::chunk_size() const
+  {
+    return _chunk_size;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  unsigned int ParallelKineticsDriver<CoeffType,NASAFit>::n_species() const
+  {
+    return _reaction_set.n_species();
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  const KineticsJacobianPattern<CoeffType>& ParallelKineticsDriver<CoeffType,NASAFit>::jacobian_pattern() const
+  {
+    return _pattern;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  unsigned int ParallelKineticsDriver<CoeffType,NASAFit>::n_steals() const
+  {
+    return _n_steals;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  void ParallelKineticsDriver<CoeffType,NASAFit>::worker_loop( const unsigned int worker )
+  {
+    try
+      {
+        _workspaces[worker] = new Workspace( _reaction_set, _thermo_mixture, _pattern.n_nonzeros() );
+      }
+    catch(...)
+      {
+        _errors[worker] = std::current_exception();
+      }
+
+    {
+      std::lock_guard<std::mutex> lock( _mutex );
+      if( --_n_busy == 0 )
+        _done.notify_one();
+    }
+
+    unsigned long generation = 0;
+
+    while( true )
+      {
+        {
+          std::unique_lock<std::mutex> lock( _mutex );
+          while( !_shutdown && _generation == generation )
+            _start.wait( lock );
+
+          if( _shutdown )
+            return;
+
+          generation = _generation;
+        }
+
+        try
+          {
+            unsigned int chunk;
+            while( this->next_chunk( worker, chunk ) )
+              this->compute_chunk( *_workspaces[worker], chunk );
+          }
+        catch(...)
+          {
+            _errors[worker] = std::current_exception();
+          }
+
+        std::lock_guard<std::mutex> lock( _mutex );
+        if( --_n_busy == 0 )
+          _done.notify_one();
+      }
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  bool ParallelKineticsDriver<CoeffType,NASAFit>::next_chunk( const unsigned int worker, unsigned int& chunk )
+  {
+    {
+      ChunkQueue& queue = *_queues[worker];
+      std::lock_guard<std::mutex> lock( queue.mutex );
+      if( queue.begin < queue.end )
+        {
+          chunk = queue.begin++;
+          return true;
+        }
+    }
+
+    // own queue is empty, steal from the back of the others
+    for( unsigned int i = 1; i < _n_workers; i++ )
+      {
+        ChunkQueue& victim = *_queues[(worker + i) % _n_workers];
+        std::lock_guard<std::mutex> lock( victim.mutex );
+        if( victim.begin < victim.end )
+          {
+            chunk = --victim.end;
+            ++_n_steals;
+            return true;
+          }
+      }
+
+    return false;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  void ParallelKineticsDriver<CoeffType,NASAFit>::compute_chunk( Workspace& workspace, const unsigned int chunk )
+  {
+    const unsigned int n_species = this->n_species();
+    const unsigned int n_nonzeros = _pattern.n_nonzeros();
+
+    const unsigned int first = _first_cell + chunk*_chunk_size;
+    const unsigned int end = std::min( first + _chunk_size, _end_cell );
+
+    for( unsigned int c = first; c < end; c++ )
+      {
+        const CoeffType T = (*_T)[c];
+
+        std::copy( _molar_densities->begin() + c*n_species,
+                   _molar_densities->begin() + (c+1)*n_species,
+                   workspace.molar_densities.begin() );
+
+        const TempCache<CoeffType> temp_cache( T );
+        const KineticsConditions<CoeffType> conditions( T );
+
+        workspace.thermo.h_RT_minus_s_R( temp_cache, workspace.h_RT_minus_s_R );
+
+        if( _dmass_drho_s )
+          {
+            workspace.thermo.dh_RT_minus_s_R_dT( temp_cache, workspace.dh_RT_minus_s_R_dT );
+
+            workspace.kinetics.compute_mass_sources_and_sparse_derivs( conditions,
+                                                                       workspace.molar_densities,
+                                                                       workspace.h_RT_minus_s_R,
+                                                                       workspace.dh_RT_minus_s_R_dT,
+                                                                       _pattern,
+                                                                       workspace.mass_sources,
+                                                                       workspace.dmass_dT,
+                                                                       workspace.dmass_drho_s );
+
+            std::copy( workspace.dmass_dT.begin(), workspace.dmass_dT.end(),
+                       _dmass_dT->begin() + c*n_species );
+            std::copy( workspace.dmass_drho_s.begin(), workspace.dmass_drho_s.end(),
+                       _dmass_drho_s->begin() + c*n_nonzeros );
+          }
+        else
+          workspace.kinetics.compute_mass_sources( conditions,
+                                                   workspace.molar_densities,
+                                                   workspace.h_RT_minus_s_R,
+                                                   workspace.mass_sources );
+
+        std::copy( workspace.mass_sources.begin(), workspace.mass_sources.end(),
+                   _mass_sources->begin() + c*n_species );
+      }
+
+    return;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  void ParallelKineticsDriver<CoeffType,NASAFit>::run( const unsigned int first_cell, const unsigned int end_cell )
+  {
+    antioch_assert_less_equal( first_cell, end_cell );
+
+    const unsigned int n_chunks = (end_cell - first_cell + _chunk_size - 1) / _chunk_size;
+
+    // contiguous initial distribution, stealing does the balancing
+    for( unsigned int w = 0; w < _n_workers; w++ )
+      {
+        _queues[w]->begin = (w * n_chunks) / _n_workers;
+        _queues[w]->end = ((w + 1) * n_chunks) / _n_workers;
+        _errors[w] = std::exception_ptr();
+      }
+
+    _first_cell = first_cell;
+    _end_cell = end_cell;
+    _n_steals = 0;
+
+    {
+      std::lock_guard<std::mutex> lock( _mutex );
+      _n_busy = _n_workers;
+      ++_generation;
+    }
+    _start.notify_all();
+
+    {
+      std::unique_lock<std::mutex> lock( _mutex );
+      while( _n_busy > 0 )
+        _done.wait( lock );
+    }
+
+    for( unsigned int w = 0; w < _n_workers; w++ )
+      if( _errors[w] )
+        std::rethrow_exception( _errors[w] );
+
+    return;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  void ParallelKineticsDriver<CoeffType,NASAFit>::compute_mass_sources( const unsigned int first_cell,
+                                                                        const unsigned int end_cell,
+                                                                        const std::vector<CoeffType>& T,
+                                                                        const std::vector<CoeffType>& molar_densities,
+                                                                        std::vector<CoeffType>& mass_sources )
+  {
+    const unsigned int n_species = this->n_species();
+
+    antioch_assert_greater_equal( T.size(), end_cell );
+    antioch_assert_greater_equal( molar_densities.size(), end_cell*n_species );
+    antioch_assert_greater_equal( mass_sources.size(), end_cell*n_species );
+
+    _T = &T;
+    _molar_densities = &molar_densities;
+    _mass_sources = &mass_sources;
+    _dmass_dT = NULL;
+    _dmass_drho_s = NULL;
+
+    this->run( first_cell, end_cell );
+
+    return;
+  }
+
+  template<typename CoeffType, typename NASAFit>
+  inline
+  void ParallelKineticsDriver<CoeffType,NASAFit>::compute_mass_sources_and_derivs( const unsigned int first_cell,
+                                                                                   const unsigned int end_cell,
+                                                                                   const std::vector<CoeffType>& T,
+                                                                                   const std::vector<CoeffType>& molar_densities,
+                                                                                   std::vector<CoeffType>& mass_sources,
+                                                                                   std::vector<CoeffType>& dmass_dT,
+                                                                                   std::vector<CoeffType>& dmass_drho_s )
+  {
+    const unsigned int n_species = this->n_species();
+
+    antioch_assert_greater_equal( T.size(), end_cell );
+    antioch_assert_greater_equal( molar_densities.size(), end_cell*n_species );
+    antioch_assert_greater_equal( mass_sources.size(), end_cell*n_species );
+    antioch_assert_greater_equal( dmass_dT.size(), end_cell*n_species );
+    antioch_assert_greater_equal( dmass_drho_s.size(), end_cell*_pattern.n_nonzeros() );
+
+    _T = &T;
+    _molar_densities = &molar_densities;
+    _mass_sources = &mass_sources;
+    _dmass_dT = &dmass_dT;
+    _dmass_drho_s = &dmass_drho_s;
+
+    this->run( first_cell, end_cell );
+
+    return;
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_PARALLEL_KINETICS_DRIVER_H
@@ -0,0 +1,625 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+#ifndef ANTIOCH_PLOG_REACTION_H
+#define ANTIOCH_PLOG_REACTION_H
+
+// Antioch
+#include "antioch/antioch_asserts.h"
+#include "antioch/cmath_shims.h"
+#include "antioch/metaprogramming_decl.h"
+#include "antioch/physical_constants.h"
+#include "antioch/reaction.h"
+#include "antioch/kinetics_conditions.h"
+#include "antioch/kinetics_parsing.h"
+
+//C++
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <iostream>
+
+namespace Antioch
+{
+  //!A single reaction mechanism.
+  /*!\class PlogReaction
+ *
+    This class encapsulates a pressure-dependent reaction given by rate
+    constants \f$k_i(T)\f$ at pressures \f$P_i\f$ (PLOG). The rate constants
+    given at the same pressure are summed. Between two pressures, the rate
+    constant is interpolated linearly in \f$\ln P\f$:
+    \f[
+        \ln k(T,P) = \ln k_i(T) + \frac{\ln P - \ln P_i}{\ln P_{i+1} - \ln P_i}
+                     \left(\ln k_{i+1}(T) - \ln k_i(T)\right)
+    \f]
+    and it is the rate constant of the closest pressure outside of
+    \f$[P_0,P_n]\f$. The pressure is given by the KineticsConditions or,
+    if not, by the ideal gas law \f$P = [M] \mathrm{R} T\f$, \f$[M]\f$
+    the mixture concentration. We have then:
+    \f[
+        \begin{split}
+           \frac{\partial k(T,P)}{\partial T}   & = k(T,P)\left(\frac{\partial \ln k}{\partial T}
+                                                   + \frac{1}{T}\frac{\partial \ln k}{\partial \ln P}\right) \\[10pt]
+           \frac{\partial k(T,P)}{\partial c_i} & = \frac{k(T,P)}{[M]}\frac{\partial \ln k}{\partial \ln P}
+        \end{split}
+    \f]
+    and no \f$c_i\f$ dependence if the pressure is given.
+
+    The pressures are sorted into levels by update_rate_tables(),
+    called by Reaction::initialize(), which also stores the Van't Hoff form
+    (see vanthoff_parameters_of_rate()) of the levels with a single
+    analytical rate constant: their \f$\ln k_i(T)\f$ takes no exponential,
+    so that an evaluation takes one exponential as an elementary reaction.
+    For scalar states the bracket \f$[P_i,P_{i+1}]\f$ is found in a table
+    of uniform bins in \f$\ln P\f$, the interpolation is otherwise written
+    as a sum of clamped ramps over all the levels.
+  */
+  template<typename CoeffType=double>
+  class PlogReaction: public Reaction<CoeffType>
+  {
+  public:
+
+    //! Construct a single reaction mechanism.
+    PlogReaction( const unsigned int n_species,
+                  const std::string &equation,
+                  const bool &reversible = true,
+                  const KineticsModel::KineticsModel kin = KineticsModel::KOOIJ);
+
+    ~PlogReaction();
+
+    //! Pressure (Pa) of the first forward rate without one
+    void add_pressure( const CoeffType P );
+
+    //! Pressure (Pa) of the \p ir th forward rate
+    CoeffType pressure( unsigned int ir ) const;
+
+    //! Number of distinct pressures
+    unsigned int n_pressure_levels() const;
+
+    //! Sorts the pressures and stores the Van't Hoff forms of the rates
+    /*! See Reaction::update_rate_tables(). */
+    virtual void update_rate_tables();
+
+    //!
+    template <typename StateType, typename VectorStateType>
+    StateType compute_forward_rate_coefficient( const VectorStateType& molar_densities,
+                                                const KineticsConditions<StateType,VectorStateType>& conditions ) const;
+
+    //!
+    template <typename StateType, typename VectorStateType>
+    void compute_forward_rate_coefficient_and_derivatives( const VectorStateType& molar_densities,
+                                                           const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                           StateType& kfwd,
+                                                           StateType& dkfwd_dT,
+                                                           VectorStateType& dkfwd_dX) const;
+
+    //! \p total_concentration is sum_s c_s, for the ideal gas pressure; unused if \p conditions carry the pressure
+    template <typename StateType, typename VectorStateType>
+    StateType compute_forward_rate_coefficient( const VectorStateType& molar_densities,
+                                                const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                const StateType& total_concentration ) const;
+
+    //! \p total_concentration is sum_s c_s, for the ideal gas pressure; unused if \p conditions carry the pressure
+    template <typename StateType, typename VectorStateType>
+    void compute_forward_rate_coefficient_and_derivatives( const VectorStateType& molar_densities,
+                                                           const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                           const StateType& total_concentration,
+                                                           StateType& kfwd,
+                                                           StateType& dkfwd_dT,
+                                                           VectorStateType& dkfwd_dX) const;
+
+    //! see Reaction::compute_forward_rate_coefficient_log_parameter_derivatives()
+    /*! \f$\ln k\f$ being linear in the \f$\ln k_i\f$, its derivatives are
+        the interpolation of those of the levels. */
+    template <typename StateType, typename VectorStateType>
+    void compute_log_parameter_derivatives( const VectorStateType& molar_densities,
+                                            const KineticsConditions<StateType,VectorStateType>& conditions,
+                                            StateType& dlnk_dlnA,
+                                            StateType& dlnk_dbeta,
+                                            StateType& dlnk_dEa ) const;
+
+  private:
+
+    //! ln(P), from the conditions or the ideal gas law
+    template <typename StateType, typename VectorStateType>
+    StateType log_pressure( const KineticsConditions<StateType,VectorStateType>& conditions,
+                            const StateType& total_concentration ) const;
+
+    //! ln(k_l) and its derivative with respect to T
+    template <typename StateType, typename VectorStateType>
+    void level_log_rate( unsigned int l,
+                         const KineticsConditions<StateType,VectorStateType>& conditions,
+                         StateType& lnk, StateType* dlnk_dT ) const;
+
+    //! ln(k) and its derivatives with respect to T and ln(P), one bracket
+    template <typename StateType, typename VectorStateType>
+    typename enable_if_c<!has_size<StateType>::value, void>::type
+    log_rate( const KineticsConditions<StateType,VectorStateType>& conditions,
+              const StateType& lnP,
+              StateType& lnk, StateType* dlnk_dT, StateType* dlnk_dlnP ) const;
+
+    //! ln(k) and its derivatives with respect to T and ln(P), all the ramps
+    template <typename StateType, typename VectorStateType>
+    typename enable_if_c<has_size<StateType>::value, void>::type
+    log_rate( const KineticsConditions<StateType,VectorStateType>& conditions,
+              const StateType& lnP,
+              StateType& lnk, StateType* dlnk_dT, StateType* dlnk_dlnP ) const;
+
+    //! pressure of each forward rate
+    std::vector<CoeffType> _pressures;
+
+    //! sorted distinct ln(P_i)
+    std::vector<CoeffType> _level_lnP;
+
+    //! 1/(ln(P_{i+1}) - ln(P_i))
+    std::vector<CoeffType> _level_inv_width;
+
+    //! forward rates of level l are _level_rates[_level_begin[l]] to _level_rates[_level_begin[l+1]-1]
+    std::vector<unsigned int> _level_begin;
+    std::vector<unsigned int> _level_rates;
+
+    //! Van't Hoff form of the levels with a single analytical rate
+    std::vector<bool> _level_is_vanthoff;
+    std::vector<CoeffType> _level_lnCf;
+    std::vector<CoeffType> _level_eta;
+    std::vector<CoeffType> _level_Ea;
+    std::vector<CoeffType> _level_D;
+
+    //! lowest level of each bin of width 1/_inv_bin_width from _level_lnP[0]
+    std::vector<unsigned int> _bin_level;
+    CoeffType _inv_bin_width;
+
+    //! bound on the size of _bin_level
+    static const unsigned int max_bins = 1024;
+  };
+
+  /* ------------------------- Inline Functions -------------------------*/
+  template<typename CoeffType>
+  inline
+  PlogReaction<CoeffType>::PlogReaction( const unsigned int n_species,
+                                         const std::string &equation,
+                                         const bool &reversible,
+                                         const KineticsModel::KineticsModel kin)
+    :Reaction<CoeffType>(n_species,equation,reversible,ReactionType::PLOG,kin),
+     _inv_bin_width(0)
+  {
+    return;
+  }
+
+
+  template<typename CoeffType>
+  inline
+  PlogReaction<CoeffType>::~PlogReaction()
+  {
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  void PlogReaction<CoeffType>::add_pressure( const CoeffType P )
+  {
+    antioch_assert_greater(P,0);
+    antioch_assert_less(_pressures.size(),this->n_rate_constants());
+
+    _pressures.push_back(P);
+  }
+
+  template<typename CoeffType>
+  inline
+  CoeffType PlogReaction<CoeffType>::pressure( unsigned int ir ) const
+  {
+    antioch_assert_less(ir,_pressures.size());
+    return _pressures[ir];
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int PlogReaction<CoeffType>::n_pressure_levels() const
+  {
+    return _level_lnP.size();
+  }
+
+  template<typename CoeffType>
+  inline
+  void PlogReaction<CoeffType>::update_rate_tables()
+  {
+    using std::log;
+    using std::ceil;
+
+    antioch_assert_equal_to(_pressures.size(),this->n_rate_constants());
+    antioch_assert(!_pressures.empty());
+
+    // rates sorted by pressure, stable so the sums keep the input order
+    std::vector<std::pair<CoeffType,unsigned int> > sorted;
+    for( unsigned int ir = 0; ir < _pressures.size(); ir++ )
+      sorted.push_back(std::make_pair(_pressures[ir],ir));
+    std::stable_sort(sorted.begin(),sorted.end());
+
+    _level_lnP.clear();
+    _level_begin.clear();
+    _level_rates.clear();
+    for( unsigned int i = 0; i < sorted.size(); i++ )
+      {
+        if( i == 0 || sorted[i].first != sorted[i-1].first )
+          {
+            _level_lnP.push_back(log(sorted[i].first));
+            _level_begin.push_back(_level_rates.size());
+          }
+        _level_rates.push_back(sorted[i].second);
+      }
+    _level_begin.push_back(_level_rates.size());
+
+    const unsigned int n_levels = _level_lnP.size();
+
+    _level_inv_width.assign(n_levels,0);
+    for( unsigned int l = 0; l + 1 < n_levels; l++ )
+      _level_inv_width[l] = 1/(_level_lnP[l+1] - _level_lnP[l]);
+
+    _level_is_vanthoff.assign(n_levels,false);
+    _level_lnCf.assign(n_levels,0);
+    _level_eta.assign(n_levels,0);
+    _level_Ea.assign(n_levels,0);
+    _level_D.assign(n_levels,0);
+    for( unsigned int l = 0; l < n_levels; l++ )
+      {
+        if( _level_begin[l+1] - _level_begin[l] != 1 )
+          continue;
+
+        const KineticsType<CoeffType>& rate = *this->_forward_rate[_level_rates[_level_begin[l]]];
+        if( rate.type() == KineticsModel::PHOTOCHEM )
+          continue;
+
+        CoeffType Cf;
+        vanthoff_parameters_of_rate(rate,Cf,_level_eta[l],_level_Ea[l],_level_D[l]);
+        if( !(Cf > 0) )
+          continue;
+
+        _level_lnCf[l] = log(Cf);
+        _level_is_vanthoff[l] = true;
+      }
+
+    // bins no wider than the narrowest level, so that a bin spans
+    // a couple of levels at most
+    _bin_level.clear();
+    _inv_bin_width = 0;
+    if( n_levels > 1 )
+      {
+        const CoeffType range = _level_lnP.back() - _level_lnP.front();
+        const CoeffType max_inv_width = *std::max_element(_level_inv_width.begin(),_level_inv_width.end() - 1);
+        unsigned int n_bins = static_cast<unsigned int>(ceil(range * max_inv_width));
+        n_bins = std::max(1u,std::min(n_bins,static_cast<unsigned int>(max_bins)));
+
+        _inv_bin_width = n_bins/range;
+        _bin_level.resize(n_bins);
+        unsigned int l = 0;
+        for( unsigned int b = 0; b < n_bins; b++ )
+          {
+            const CoeffType lnP_b = _level_lnP.front() + b/_inv_bin_width;
+            while( l + 2 < n_levels && _level_lnP[l+1] <= lnP_b )
+              l++;
+            _bin_level[b] = l;
+          }
+      }
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  StateType PlogReaction<CoeffType>::log_pressure( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                   const StateType& total_concentration ) const
+  {
+    if( conditions.has_pressure() )
+      return conditions.lnP();
+
+    return ant_log( total_concentration * Constants::R_universal<CoeffType>() * conditions.T() );
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void PlogReaction<CoeffType>::level_log_rate( unsigned int l,
+                                                const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                StateType& lnk, StateType* dlnk_dT ) const
+  {
+    const StateType& T = conditions.T();
+
+    if( _level_is_vanthoff[l] )
+      {
+        lnk = _level_lnCf[l] + _level_eta[l] * conditions.temp_cache().lnT - _level_Ea[l]/T + _level_D[l] * T;
+        if( dlnk_dT )
+          *dlnk_dT = (_level_eta[l] + _level_Ea[l]/T)/T + _level_D[l];
+        return;
+      }
+
+    // same sum as DuplicateReaction
+    StateType k = zero_clone(T);
+    StateType dk_dT = zero_clone(T);
+    StateType ki = zero_clone(T);
+    StateType dki_dT = zero_clone(T);
+    for( unsigned int i = _level_begin[l]; i < _level_begin[l+1]; i++ )
+      {
+        this->_forward_rate[_level_rates[i]]->compute_rate_and_derivative(conditions,ki,dki_dT);
+        k += ki;
+        dk_dT += dki_dT;
+      }
+
+    lnk = ant_log(k);
+    if( dlnk_dT )
+      *dlnk_dT = dk_dT/k;
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  typename enable_if_c<!has_size<StateType>::value, void>::type
+  PlogReaction<CoeffType>::log_rate( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                     const StateType& lnP,
+                                     StateType& lnk, StateType* dlnk_dT, StateType* dlnk_dlnP ) const
+  {
+    const unsigned int n_levels = _level_lnP.size();
+
+    if( dlnk_dlnP )
+      *dlnk_dlnP = 0;
+
+    // clamped outside of the pressure range
+    if( n_levels == 1 || !(lnP > _level_lnP.front()) )
+      {
+        this->level_log_rate(0,conditions,lnk,dlnk_dT);
+        return;
+      }
+    if( !(lnP < _level_lnP.back()) )
+      {
+        this->level_log_rate(n_levels - 1,conditions,lnk,dlnk_dT);
+        return;
+      }
+
+    // bracket from the bins, then at most a couple of steps
+    unsigned int b = static_cast<unsigned int>((lnP - _level_lnP.front()) * _inv_bin_width);
+    if( b >= _bin_level.size() )
+      b = _bin_level.size() - 1;
+    unsigned int l = _bin_level[b];
+    while( l + 2 < n_levels && !(lnP < _level_lnP[l+1]) )
+      l++;
+    while( l > 0 && lnP < _level_lnP[l] )
+      l--;
+
+    StateType lnk_hi = zero_clone(lnP);
+    StateType dlnk_hi_dT = zero_clone(lnP);
+    this->level_log_rate(l,conditions,lnk,dlnk_dT);
+    this->level_log_rate(l+1,conditions,lnk_hi,dlnk_dT ? &dlnk_hi_dT : NULL);
+
+    const StateType w = (lnP - _level_lnP[l]) * _level_inv_width[l];
+    if( dlnk_dlnP )
+      *dlnk_dlnP = (lnk_hi - lnk) * _level_inv_width[l];
+    if( dlnk_dT )
+      *dlnk_dT += w * (dlnk_hi_dT - *dlnk_dT);
+    lnk += w * (lnk_hi - lnk);
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  typename enable_if_c<has_size<StateType>::value, void>::type
+  PlogReaction<CoeffType>::log_rate( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                     const StateType& lnP,
+                                     StateType& lnk, StateType* dlnk_dT, StateType* dlnk_dlnP ) const
+  {
+    // the bracket may differ from one element of the state to another:
+    // ln(k) = ln(k_0) + sum_l r_l (ln(k_l+1) - ln(k_l)), r_l clamped in [0,1]
+    const StateType zero = zero_clone(lnP);
+    const StateType one = constant_clone(lnP,1);
+
+    this->level_log_rate(0,conditions,lnk,dlnk_dT);
+    if( dlnk_dlnP )
+      *dlnk_dlnP = zero;
+
+    StateType lnk_lo = lnk;
+    StateType dlnk_lo_dT = dlnk_dT ? *dlnk_dT : zero;
+    StateType lnk_hi = zero;
+    StateType dlnk_hi_dT = zero;
+    for( unsigned int l = 0; l + 1 < _level_lnP.size(); l++ )
+      {
+        this->level_log_rate(l+1,conditions,lnk_hi,dlnk_dT ? &dlnk_hi_dT : NULL);
+
+        const StateType x = (lnP - _level_lnP[l]) * _level_inv_width[l];
+        const StateType r = if_else(x < zero, zero, StateType(if_else(x > one, one, x)));
+
+        lnk += r * (lnk_hi - lnk_lo);
+        if( dlnk_dT )
+          *dlnk_dT += r * (dlnk_hi_dT - dlnk_lo_dT);
+        if( dlnk_dlnP )
+          {
+            const StateType slope = (lnk_hi - lnk_lo) * _level_inv_width[l];
+            *dlnk_dlnP += if_else(x < zero, zero, StateType(if_else(x > one, zero, slope)));
+          }
+
+        lnk_lo = lnk_hi;
+        dlnk_lo_dT = dlnk_hi_dT;
+      }
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  StateType PlogReaction<CoeffType>::compute_forward_rate_coefficient
+    ( const VectorStateType& molar_densities,
+      const KineticsConditions<StateType,VectorStateType>& conditions) const
+  {
+    // log_pressure() ignores the total concentration if the pressure
+    // is given, it is not summed for nothing then
+    const StateType conc = conditions.has_pressure() ?
+      zero_clone(conditions.T()) : total_concentration<StateType>(molar_densities);
+
+    return this->compute_forward_rate_coefficient( molar_densities, conditions, conc );
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  StateType PlogReaction<CoeffType>::compute_forward_rate_coefficient
+    ( const VectorStateType& /* molar_densities */,
+      const KineticsConditions<StateType,VectorStateType>& conditions,
+      const StateType& total_concentration ) const
+  {
+    antioch_assert(this->initialized());
+
+    const StateType lnP = this->log_pressure(conditions,total_concentration);
+
+    StateType lnk = zero_clone(lnP);
+    this->log_rate(conditions,lnP,lnk,static_cast<StateType*>(NULL),static_cast<StateType*>(NULL));
+
+    StateType kfwd = ant_exp(lnk);
+
+    antioch_assert(!has_nan(kfwd));
+
+    return kfwd;
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void PlogReaction<CoeffType>::compute_forward_rate_coefficient_and_derivatives
+    ( const VectorStateType& molar_densities,
+      const KineticsConditions<StateType,VectorStateType>& conditions,
+      StateType& kfwd,
+      StateType& dkfwd_dT,
+      VectorStateType& dkfwd_dX) const
+  {
+    // as above, the total concentration is not needed if the pressure is given
+    const StateType conc = conditions.has_pressure() ?
+      zero_clone(conditions.T()) : total_concentration<StateType>(molar_densities);
+
+    this->compute_forward_rate_coefficient_and_derivatives( molar_densities, conditions, conc,
+                                                            kfwd, dkfwd_dT, dkfwd_dX );
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void PlogReaction<CoeffType>::compute_forward_rate_coefficient_and_derivatives
+    ( const VectorStateType& /* molar_densities */,
+      const KineticsConditions<StateType,VectorStateType>& conditions,
+      const StateType& total_concentration,
+      StateType& kfwd,
+      StateType& dkfwd_dT,
+      VectorStateType& dkfwd_dX) const
+  {
+    antioch_assert(this->initialized());
+    antioch_assert_equal_to(dkfwd_dX.size(),this->n_species());
+
+    const StateType lnP = this->log_pressure(conditions,total_concentration);
+
+    StateType lnk = zero_clone(lnP);
+    StateType dlnk_dT = zero_clone(lnP);
+    StateType dlnk_dlnP = zero_clone(lnP);
+    this->log_rate(conditions,lnP,lnk,&dlnk_dT,&dlnk_dlnP);
+
+    kfwd = ant_exp(lnk);
+
+    antioch_assert(!has_nan(kfwd));
+
+    // the given pressure is independent of T and of the concentrations
+    if( conditions.has_pressure() )
+      {
+        dkfwd_dT = kfwd * dlnk_dT;
+        Antioch::set_zero(dkfwd_dX);
+        return;
+      }
+
+    // P = [M] R T: dlnP/dT = 1/T, dlnP/dc_i = 1/[M]
+    dkfwd_dT = kfwd * (dlnk_dT + dlnk_dlnP/conditions.T());
+
+    const StateType dkfwd_dc = kfwd * dlnk_dlnP/total_concentration;
+    for( unsigned int s = 0; s < this->n_species(); s++ )
+      dkfwd_dX[s] = dkfwd_dc;
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void PlogReaction<CoeffType>::compute_log_parameter_derivatives
+    ( const VectorStateType& molar_densities,
+      const KineticsConditions<StateType,VectorStateType>& conditions,
+      StateType& dlnk_dlnA,
+      StateType& dlnk_dbeta,
+      StateType& dlnk_dEa ) const
+  {
+    antioch_assert(this->initialized());
+
+    const StateType lnP = conditions.has_pressure() ? conditions.lnP() :
+      this->log_pressure(conditions,total_concentration<StateType>(molar_densities));
+
+    const StateType zero = zero_clone(lnP);
+    const StateType one = constant_clone(lnP,1);
+
+    dlnk_dlnA = zero;
+    dlnk_dbeta = zero;
+    dlnk_dEa = zero;
+
+    // weight of level l is r_l-1 - r_l, with r_-1 = 1 and r_n-1 = 0
+    StateType r_previous = one;
+    StateType k = zero;
+    StateType ki = zero;
+    StateType dlnki_dlnA = zero;
+    StateType dlnki_dbeta = zero;
+    StateType dlnki_dEa = zero;
+    for( unsigned int l = 0; l < _level_lnP.size(); l++ )
+      {
+        StateType r = zero;
+        if( l + 1 < _level_lnP.size() )
+          {
+            const StateType x = (lnP - _level_lnP[l]) * _level_inv_width[l];
+            r = if_else(x < zero, zero, StateType(if_else(x > one, one, x)));
+          }
+        const StateType weight = r_previous - r;
+        r_previous = r;
+
+        // same weighting as DuplicateReaction within a level
+        StateType level_dlnA = zero;
+        StateType level_dbeta = zero;
+        StateType level_dEa = zero;
+        k = zero;
+        for( unsigned int i = _level_begin[l]; i < _level_begin[l+1]; i++ )
+          {
+            const KineticsType<CoeffType>& rate = *this->_forward_rate[_level_rates[i]];
+            ki = rate(conditions);
+            rate.compute_log_parameter_derivatives(conditions,dlnki_dlnA,dlnki_dbeta,dlnki_dEa);
+            level_dlnA  += ki * dlnki_dlnA;
+            level_dbeta += ki * dlnki_dbeta;
+            level_dEa   += ki * dlnki_dEa;
+            k += ki;
+          }
+
+        dlnk_dlnA  += weight * level_dlnA / k;
+        dlnk_dbeta += weight * level_dbeta / k;
+        dlnk_dEa   += weight * level_dEa / k;
+      }
+  }
+
+} // namespace Antioch
+
+#endif // ANTIOCH_PLOG_REACTION_H
@@ -0,0 +1,669 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+
+
+#ifndef ANTIOCH_RATE_COEFFICIENT_TABLE_H
+#define ANTIOCH_RATE_COEFFICIENT_TABLE_H
+
+// Antioch
+#include "antioch/antioch_asserts.h"
+#include "antioch/cmath_shims.h"
+#include "antioch/kinetics_enum.h"
+#include "antioch/reaction_enum.h"
+#include "antioch/reaction.h"
+#include "antioch/constant_rate.h"
+#include "antioch/hercourtessen_rate.h"
+#include "antioch/berthelot_rate.h"
+#include "antioch/arrhenius_rate.h"
+#include "antioch/berthelothercourtessen_rate.h"
+#include "antioch/kooij_rate.h"
+#include "antioch/vanthoff_rate.h"
+
+// C++
+#include <vector>
+#include <limits>
+#include <iostream>
+
+namespace Antioch
+{
+  template<typename CoeffType>
+  class ReactionSet;
+
+  namespace RateTableVariable
+  {
+    enum RateTableVariable { INVERSE_TEMPERATURE = 0, //!< uniform grid in 1/T
+                             LN_TEMPERATURE };        //!< uniform grid in ln(T)
+  }
+
+  //! Table of the temperature dependent part of the forward rate coefficients
+  /*!
+   * For each reaction whose forward rate coefficient is
+   * \f$k(T)\f$ (elementary, duplicate) or \f$[M] k(T)\f$ (three body),
+   * \f$\ln k\f$ is tabulated on a uniform grid in \f$1/T\f$ or \f$\ln T\f$
+   * over \f$[T_{min},T_{max}]\f$ and interpolated by cubic Hermite polynomials,
+   * using the exact values and derivatives at the nodes. The derivative
+   * with respect to the temperature is the derivative of the interpolant.
+   *
+   * The grid is refined until the error on \f$\ln k\f$, i.e. the relative
+   * error on \f$k\f$, is below the tolerance at the checked points (quarter,
+   * middle and three quarter of each interval). In \f$1/T\f$, Arrhenius
+   * rates are interpolated exactly.
+   *
+   * Falloff and photochemical reactions, and reactions whose rate coefficient
+   * is not positive over the range, are not tabulated.
+   *
+   * The table is used by ReactionSet (see ReactionSet::enable_rate_table),
+   * not by CompiledReactionSet; it must be rebuilt (tabulate()) whenever
+   * the reactions are modified.
+   * Only scalar temperatures are involved, the header does not need the
+   * vector overloads of vector_utils.h.
+   */
+  template<typename CoeffType=double>
+  class RateCoefficientTable
+  {
+  public:
+
+    //! Interval and Hermite weights of a temperature
+    /*! Zeroed on construction, the callers that cannot use the table
+     *  (vector temperatures) never fill it but still pass it around. */
+    struct Location
+    {
+      Location()
+        : interval(0)
+      {
+        for( unsigned int i = 0; i < 4; i++ )
+          {
+            w[i] = 0;
+            dw[i] = 0;
+          }
+      }
+
+      unsigned int interval;
+      //! weights of ln k
+      CoeffType w[4];
+      //! weights of d ln k / dT
+      CoeffType dw[4];
+    };
+
+    //! Constructor, tabulates the reaction set.
+    RateCoefficientTable( const ReactionSet<CoeffType>& reaction_set,
+                          const CoeffType T_min,
+                          const CoeffType T_max,
+                          const CoeffType tolerance,
+                          RateTableVariable::RateTableVariable variable = RateTableVariable::INVERSE_TEMPERATURE,
+                          const unsigned int max_intervals = 65536 );
+
+    ~RateCoefficientTable();
+
+    //! (Re)build the table from the reaction set.
+    void tabulate();
+
+    //! Update the entry of reaction \p rxn after a change of its rates
+    /*! The reaction is tabulated again on the current grid. The whole table
+        is rebuilt if the tolerance is not met on it any more, or if the
+        reaction was left out for not being positive. */
+    void tabulate( const unsigned int rxn );
+
+    //! \returns true if reaction \p rxn is tabulated.
+    bool tabulated( const unsigned int rxn ) const;
+
+    //! \returns the number of tabulated reactions.
+    unsigned int n_tabulated() const;
+
+    //! \returns the number of intervals of the grid.
+    unsigned int n_intervals() const;
+
+    CoeffType T_min() const;
+
+    CoeffType T_max() const;
+
+    CoeffType tolerance() const;
+
+    //! \returns the largest error on ln k measured while building the table.
+    CoeffType max_error() const;
+
+    RateTableVariable::RateTableVariable variable() const;
+
+    //! Find the interval and the weights of \p T, false if \p T is out of range.
+    bool locate( const CoeffType T, Location& location ) const;
+
+    //! Interpolated \f$k(T)\f$ of tabulated reaction \p rxn
+    CoeffType rate_coefficient( const unsigned int rxn, const Location& location ) const;
+
+    //! Interpolated \f$k(T)\f$ and \f$\frac{\partial k}{\partial T}\f$ of tabulated reaction \p rxn
+    void rate_coefficient_and_derivative( const unsigned int rxn, const Location& location,
+                                          CoeffType& k, CoeffType& dk_dT ) const;
+
+  private:
+
+    RateCoefficientTable();
+
+    //! true if the forward rate coefficient of the reaction is \f$k(T)\f$ or \f$[M]k(T)\f$
+    bool is_tabulable( const Reaction<CoeffType>& reaction ) const;
+
+    //! exact \f$k(T)\f$ and its derivative of a rate that is not photochemical
+    void exact_rate_coefficient( const KineticsType<CoeffType>& rate, const CoeffType T,
+                                 CoeffType& k, CoeffType& dk_dT ) const;
+
+    //! exact \f$\ln k\f$ and its derivative with respect to the grid variable \p x,
+    //! false if \f$k\f$ is not positive
+    bool exact_ln_rate_coefficient( const Reaction<CoeffType>& reaction, const CoeffType x,
+                                    CoeffType& lnk, CoeffType& dlnk_dx ) const;
+
+    //! grid variable of a temperature
+    CoeffType coordinate( const CoeffType T ) const;
+
+    //! temperature of a grid variable
+    CoeffType temperature( const CoeffType x ) const;
+
+    //! Hermite interpolation of slot j on interval i at t in [0,1]
+    CoeffType interpolate( const std::vector<CoeffType>& values, const unsigned int n_slots,
+                           const unsigned int i, const unsigned int j, const CoeffType t ) const;
+
+    const ReactionSet<CoeffType>& _reaction_set;
+
+    const CoeffType _T_min;
+
+    const CoeffType _T_max;
+
+    const CoeffType _tolerance;
+
+    const RateTableVariable::RateTableVariable _variable;
+
+    const unsigned int _max_intervals;
+
+    //! slot of each reaction in the table, n_reactions if not tabulated
+    std::vector<unsigned int> _slots;
+
+    //! tabulated reactions
+    std::vector<unsigned int> _reactions;
+
+    CoeffType _x_min;
+
+    CoeffType _dx;
+
+    unsigned int _n_intervals;
+
+    CoeffType _max_error;
+
+    //! node-major: node i, slot j, _values[2*(i*n_tabulated + j)] = ln k,
+    //! _values[2*(i*n_tabulated + j) + 1] = dx * d ln k/dx
+    std::vector<CoeffType> _values;
+  };
+
+  /* ------------------------- Inline Functions -------------------------*/
+  template<typename CoeffType>
+  inline
+  RateCoefficientTable<CoeffType>::RateCoefficientTable( const ReactionSet<CoeffType>& reaction_set,
+                                                         const CoeffType T_min,
+                                                         const CoeffType T_max,
+                                                         const CoeffType tolerance,
+                                                         RateTableVariable::RateTableVariable variable,
+                                                         const unsigned int max_intervals )
+    : _reaction_set( reaction_set ),
+      _T_min( T_min ),
+      _T_max( T_max ),
+      _tolerance( tolerance ),
+      _variable( variable ),
+      _max_intervals( max_intervals ),
+      _x_min( 0 ),
+      _dx( 0 ),
+      _n_intervals( 0 ),
+      _max_error( 0 )
+  {
+    antioch_assert_greater( T_min, CoeffType(0) );
+    antioch_assert_greater( T_max, T_min );
+    antioch_assert_greater( tolerance, CoeffType(0) );
+
+    this->tabulate();
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  RateCoefficientTable<CoeffType>::~RateCoefficientTable()
+  {
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  bool RateCoefficientTable<CoeffType>::tabulated( const unsigned int rxn ) const
+  {
+    antioch_assert_less( rxn, _slots.size() );
+    return _slots[rxn] < _slots.size();
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int RateCoefficientTable<CoeffType>::n_tabulated() const
+  {
+    return _reactions.size();
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int RateCoefficientTable<CoeffType>::n_intervals() const
+  {
+    return _n_intervals;
+  }
+
+  template<typename CoeffType>
+  inline
+  CoeffType RateCoefficientTable<CoeffType>::T_min() const
+  {
+    return _T_min;
+  }
+
+  template<typename CoeffType>
+  inline
+  CoeffType RateCoefficientTable<CoeffType>::T_max() const
+  {
+    return _T_max;
+  }
+
+  template<typename CoeffType>
+  inline
+  CoeffType RateCoefficientTable<CoeffType>::tolerance() const
+  {
+    return _tolerance;
+  }
+
+  template<typename CoeffType>
+  inline
+  CoeffType RateCoefficientTable<CoeffType>::max_error() const
+  {
+    return _max_error;
+  }
+
+  template<typename CoeffType>
+  inline
+  RateTableVariable::RateTableVariable RateCoefficientTable<CoeffType>::variable() const
+  {
+    return _variable;
+  }
+
+  template<typename CoeffType>
+  inline
+  CoeffType RateCoefficientTable<CoeffType>::coordinate( const CoeffType T ) const
+  {
+    using std::log;
+
+    return (_variable == RateTableVariable::INVERSE_TEMPERATURE)?1/T:log(T);
+  }
+
+  template<typename CoeffType>
+  inline
+  CoeffType RateCoefficientTable<CoeffType>::temperature( const CoeffType x ) const
+  {
+    using std::exp;
+
+    return (_variable == RateTableVariable::INVERSE_TEMPERATURE)?1/x:exp(x);
+  }
+
+  template<typename CoeffType>
+  inline
+  bool RateCoefficientTable<CoeffType>::is_tabulable( const Reaction<CoeffType>& reaction ) const
+  {
+    if( reaction.type() != ReactionType::ELEMENTARY &&
+        reaction.type() != ReactionType::DUPLICATE  &&
+        reaction.type() != ReactionType::THREE_BODY )
+      return false;
+
+    for( unsigned int ir = 0; ir < reaction.n_rate_constants(); ir++ )
+      if( reaction.forward_rate(ir).type() == KineticsModel::PHOTOCHEM )
+        return false;
+
+    return true;
+  }
+
+  template<typename CoeffType>
+  inline
+  void RateCoefficientTable<CoeffType>::exact_rate_coefficient( const KineticsType<CoeffType>& rate, const CoeffType T,
+                                                                CoeffType& k, CoeffType& dk_dT ) const
+  {
+    // KineticsType::compute_rate_and_derivative would also instantiate
+    // the photochemical rate, which needs the particle flux
+    switch( rate.type() )
+      {
+      case(KineticsModel::CONSTANT):
+        static_cast<const ConstantRate<CoeffType>&>(rate).rate_and_derivative( T, k, dk_dT );
+        break;
+
+      case(KineticsModel::HERCOURT_ESSEN):
+        static_cast<const HercourtEssenRate<CoeffType>&>(rate).rate_and_derivative( T, k, dk_dT );
+        break;
+
+      case(KineticsModel::BERTHELOT):
+        static_cast<const BerthelotRate<CoeffType>&>(rate).rate_and_derivative( T, k, dk_dT );
+        break;
+
+      case(KineticsModel::ARRHENIUS):
+        static_cast<const ArrheniusRate<CoeffType>&>(rate).rate_and_derivative( T, k, dk_dT );
+        break;
+
+      case(KineticsModel::BHE):
+        static_cast<const BerthelotHercourtEssenRate<CoeffType>&>(rate).rate_and_derivative( T, k, dk_dT );
+        break;
+
+      case(KineticsModel::KOOIJ):
+        static_cast<const KooijRate<CoeffType>&>(rate).rate_and_derivative( T, k, dk_dT );
+        break;
+
+      case(KineticsModel::VANTHOFF):
+        static_cast<const VantHoffRate<CoeffType>&>(rate).rate_and_derivative( T, k, dk_dT );
+        break;
+
+      default:
+        {
+          // excluded by is_tabulable()
+          antioch_error();
+        }
+
+      } // switch(rate.type())
+  }
+
+  template<typename CoeffType>
+  inline
+  bool RateCoefficientTable<CoeffType>::exact_ln_rate_coefficient( const Reaction<CoeffType>& reaction, const CoeffType x,
+                                                                   CoeffType& lnk, CoeffType& dlnk_dx ) const
+  {
+    using std::log;
+
+    const CoeffType T = this->temperature(x);
+
+    // same sum as DuplicateReaction
+    CoeffType k, dk_dT;
+    this->exact_rate_coefficient( reaction.forward_rate(0), T, k, dk_dT );
+    for( unsigned int ir = 1; ir < reaction.n_rate_constants(); ir++ )
+      {
+        CoeffType k_ir, dk_ir_dT;
+        this->exact_rate_coefficient( reaction.forward_rate(ir), T, k_ir, dk_ir_dT );
+        k += k_ir;
+        dk_dT += dk_ir_dT;
+      }
+
+    if( !(k > 0) || !(k < std::numeric_limits<CoeffType>::infinity()) )
+      return false;
+
+    lnk = log(k);
+
+    // dT/dx is -T^2 for x = 1/T, T for x = ln(T)
+    const CoeffType dT_dx = (_variable == RateTableVariable::INVERSE_TEMPERATURE)?-T*T:T;
+    dlnk_dx = dk_dT / k * dT_dx;
+
+    return true;
+  }
+
+  template<typename CoeffType>
+  inline
+  CoeffType RateCoefficientTable<CoeffType>::interpolate( const std::vector<CoeffType>& values, const unsigned int n_slots,
+                                                          const unsigned int i, const unsigned int j, const CoeffType t ) const
+  {
+    const CoeffType* v0 = &values[2*(i*n_slots + j)];
+    const CoeffType* v1 = &values[2*((i+1)*n_slots + j)];
+
+    return (1 + 2*t)*(1 - t)*(1 - t) * v0[0] + t*(1 - t)*(1 - t) * v0[1] +
+           t*t*(3 - 2*t)             * v1[0] + t*t*(t - 1)       * v1[1];
+  }
+
+  template<typename CoeffType>
+  inline
+  void RateCoefficientTable<CoeffType>::tabulate()
+  {
+    using std::abs;
+
+    const unsigned int n_reactions = _reaction_set.n_reactions();
+
+    // candidates, some of them may be dropped if not positive
+    std::vector<unsigned int> candidates;
+    for( unsigned int rxn = 0; rxn < n_reactions; rxn++ )
+      if( this->is_tabulable( _reaction_set.reaction(rxn) ) )
+        candidates.push_back(rxn);
+
+    const CoeffType x_a = this->coordinate(_T_min);
+    const CoeffType x_b = this->coordinate(_T_max);
+    _x_min = std::min(x_a,x_b);
+    const CoeffType length = abs(x_b - x_a);
+
+    std::vector<bool> positive( candidates.size(), true );
+    std::vector<CoeffType> values;
+
+    unsigned int n_intervals = 16;
+
+    while( true )
+      {
+        const unsigned int n_slots = candidates.size();
+        const CoeffType dx = length / n_intervals;
+
+        values.resize( 2*(n_intervals + 1)*n_slots );
+
+        for( unsigned int i = 0; i <= n_intervals; i++ )
+          {
+            const CoeffType x = (i == n_intervals)?_x_min + length:_x_min + i*dx;
+            for( unsigned int j = 0; j < n_slots; j++ )
+              {
+                CoeffType& lnk = values[2*(i*n_slots + j)];
+                CoeffType& dlnk = values[2*(i*n_slots + j) + 1];
+                positive[j] = this->exact_ln_rate_coefficient( _reaction_set.reaction(candidates[j]), x, lnk, dlnk )
+                              && positive[j];
+                dlnk *= dx;
+              }
+          }
+
+        // check the error inside of the intervals
+        CoeffType max_error = 0;
+        for( unsigned int i = 0; i < n_intervals; i++ )
+          for( unsigned int q = 1; q < 4; q++ )
+            {
+              const CoeffType t = static_cast<CoeffType>(q)/4;
+              for( unsigned int j = 0; j < n_slots; j++ )
+                {
+                  CoeffType lnk, dlnk;
+                  if( !positive[j] ||
+                      !this->exact_ln_rate_coefficient( _reaction_set.reaction(candidates[j]), _x_min + (i + t)*dx, lnk, dlnk ) )
+                    {
+                      positive[j] = false;
+                      continue;
+                    }
+                  max_error = std::max( max_error, abs( this->interpolate(values,n_slots,i,j,t) - lnk ) );
+                }
+            }
+
+        // drop the non positive reactions, the values are recomputed
+        bool dropped = false;
+        for( unsigned int j = n_slots; j > 0; j-- )
+          if( !positive[j-1] )
+            {
+              candidates.erase( candidates.begin() + (j-1) );
+              positive.erase( positive.begin() + (j-1) );
+              dropped = true;
+            }
+        if( dropped )
+          continue;
+
+        if( max_error <= _tolerance )
+          {
+            _max_error = max_error;
+            _n_intervals = n_intervals;
+            _dx = dx;
+            break;
+          }
+
+        if( 2*n_intervals > _max_intervals )
+          {
+            std::cerr << "Error: rate coefficient table tolerance " << _tolerance
+                      << " not reached with " << n_intervals << " intervals"
+                      << " (error " << max_error << ")" << std::endl;
+            antioch_error();
+          }
+
+        n_intervals *= 2;
+      }
+
+    _values.swap(values);
+    _reactions = candidates;
+    _slots.assign( n_reactions, n_reactions );
+    for( unsigned int j = 0; j < _reactions.size(); j++ )
+      _slots[_reactions[j]] = j;
+
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  void RateCoefficientTable<CoeffType>::tabulate( const unsigned int rxn )
+  {
+    using std::abs;
+
+    antioch_assert_less( rxn, _slots.size() );
+
+    const Reaction<CoeffType>& reaction = _reaction_set.reaction(rxn);
+
+    if( !this->tabulated(rxn) )
+      {
+        if( this->is_tabulable(reaction) )
+          this->tabulate();
+        return;
+      }
+
+    const unsigned int n_slots = _reactions.size();
+    const unsigned int j = _slots[rxn];
+    const CoeffType length = abs(this->coordinate(_T_max) - this->coordinate(_T_min));
+
+    // same nodes and checked points as tabulate()
+    for( unsigned int i = 0; i <= _n_intervals; i++ )
+      {
+        const CoeffType x = (i == _n_intervals)?_x_min + length:_x_min + i*_dx;
+        CoeffType& lnk = _values[2*(i*n_slots + j)];
+        CoeffType& dlnk = _values[2*(i*n_slots + j) + 1];
+        if( !this->exact_ln_rate_coefficient( reaction, x, lnk, dlnk ) )
+          {
+            this->tabulate();
+            return;
+          }
+        dlnk *= _dx;
+      }
+
+    CoeffType max_error = 0;
+    for( unsigned int i = 0; i < _n_intervals; i++ )
+      for( unsigned int q = 1; q < 4; q++ )
+        {
+          const CoeffType t = static_cast<CoeffType>(q)/4;
+          CoeffType lnk, dlnk;
+          if( !this->exact_ln_rate_coefficient( reaction, _x_min + (i + t)*_dx, lnk, dlnk ) )
+            {
+              this->tabulate();
+              return;
+            }
+          max_error = std::max( max_error, abs( this->interpolate(_values,n_slots,i,j,t) - lnk ) );
+        }
+
+    if( max_error > _tolerance )
+      {
+        this->tabulate();
+        return;
+      }
+
+    _max_error = std::max( _max_error, max_error );
+
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  bool RateCoefficientTable<CoeffType>::locate( const CoeffType T, Location& location ) const
+  {
+    if( !(T >= _T_min && T <= _T_max) )
+      return false;
+
+    const CoeffType u = (this->coordinate(T) - _x_min) / _dx;
+    unsigned int i = (u > 0)?static_cast<unsigned int>(u):0;
+    if( i >= _n_intervals )
+      i = _n_intervals - 1;
+    const CoeffType t = u - i;
+
+    location.interval = i;
+
+    // cubic Hermite basis and its derivative
+    location.w[0] = (1 + 2*t)*(1 - t)*(1 - t);
+    location.w[1] = t*(1 - t)*(1 - t);
+    location.w[2] = t*t*(3 - 2*t);
+    location.w[3] = t*t*(t - 1);
+
+    // d/dT = d/dt * (1/dx) * dx/dT
+    const CoeffType dx_dT = (_variable == RateTableVariable::INVERSE_TEMPERATURE)?-1/(T*T):1/T;
+    const CoeffType scale = dx_dT / _dx;
+    location.dw[0] = (6*t*t - 6*t) * scale;
+    location.dw[1] = (3*t*t - 4*t + 1) * scale;
+    location.dw[2] = (6*t - 6*t*t) * scale;
+    location.dw[3] = (3*t*t - 2*t) * scale;
+
+    return true;
+  }
+
+  template<typename CoeffType>
+  inline
+  CoeffType RateCoefficientTable<CoeffType>::rate_coefficient( const unsigned int rxn, const Location& location ) const
+  {
+    using std::exp;
+
+    antioch_assert( this->tabulated(rxn) );
+
+    const unsigned int n_slots = _reactions.size();
+    const CoeffType* v0 = &_values[2*(location.interval*n_slots + _slots[rxn])];
+    const CoeffType* v1 = v0 + 2*n_slots;
+
+    return exp( location.w[0]*v0[0] + location.w[1]*v0[1] +
+                location.w[2]*v1[0] + location.w[3]*v1[1] );
+  }
+
+  template<typename CoeffType>
+  inline
+  void RateCoefficientTable<CoeffType>::rate_coefficient_and_derivative( const unsigned int rxn, const Location& location,
+                                                                          CoeffType& k, CoeffType& dk_dT ) const
+  {
+    using std::exp;
+
+    antioch_assert( this->tabulated(rxn) );
+
+    const unsigned int n_slots = _reactions.size();
+    const CoeffType* v0 = &_values[2*(location.interval*n_slots + _slots[rxn])];
+    const CoeffType* v1 = v0 + 2*n_slots;
+
+    k = exp( location.w[0]*v0[0] + location.w[1]*v0[1] +
+             location.w[2]*v1[0] + location.w[3]*v1[1] );
+
+    dk_dT = k * ( location.dw[0]*v0[0] + location.dw[1]*v0[1] +
+                  location.dw[2]*v1[0] + location.dw[3]*v1[1] );
+
+    return;
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_RATE_COEFFICIENT_TABLE_H
@@ -70,12 +70,40 @@ namespace Antioch
   template <typename CoeffType,typename FalloffType>
   class FalloffThreeBodyReaction;
 
+  template <typename CoeffType>
+  class PlogReaction;
+
+  template <typename CoeffType>
+  class ChebyshevReaction;
+
+  template <typename CoeffType>
+  class ReactionArena;
+
   template <typename CoeffType>
   class LindemannFalloff;
 
   template <typename CoeffType>
   class TroeFalloff;
 
+  template <typename CoeffType, typename StateType>
+  class EquilibriumFactors;
+
+  //! Total concentration sum_s c_s
+  /*! Computed once per state and shared by the third-body and falloff
+      reactions, see Reaction::third_body_concentration(). */
+  template <typename StateType, typename VectorStateType>
+  inline
+  StateType total_concentration( const VectorStateType& molar_densities )
+  {
+    antioch_assert_greater(molar_densities.size(), 0);
+
+    StateType M = molar_densities[0];
+    for( unsigned int s = 1; s < molar_densities.size(); s++ )
+      M += molar_densities[s];
+
+    return M;
+  }
+
   //!A single reaction mechanism.
   /*!\class Reaction
    *
@@ -93,6 +121,7 @@ namespace Antioch
    - falloff processes (FalloffReaction) and falloff three-body processes (FalloffThreeBodyReaction) with:
       - Lindemann falloff (LindemannFalloff),
       - Troe falloff (TroeFalloff).
+   - pressure-dependent processes, PLOG (PlogReaction) and Chebyshev (ChebyshevReaction).
 
    This class encapsulates a kinetics model.  The choosable kinetics models are
    - Constant (ConstantRate),
@@ -127,6 +156,7 @@ namespace Antioch
     const std::string & id() const;
 
     //! set the reaction id.
+    /*! Once the reaction is in a ReactionSet, use ReactionSet::set_reaction_id(). */
     void set_id(const std::string & id);
 
     /*! Type of reaction.
@@ -147,6 +177,10 @@ namespace Antioch
      */
     void set_maximum_rate( const CoeffType max_rate);
 
+    /*! \return the maximum reaction rate.
+     */
+    CoeffType maximum_rate() const;
+
     //! Model of kinetics.
     KineticsModel::KineticsModel kinetics_model() const;
 
@@ -178,6 +212,10 @@ namespace Antioch
      */
     bool reversible() const;
 
+    //! \returns true if the forward rate coefficient depends on the concentrations
+    /*! Through [M] or the pressure: every type but elementary and duplicate reactions. */
+    bool rate_coefficient_depends_on_concentrations() const;
+
     //! \returns the number of reactants.
     unsigned int n_reactants() const;
 
@@ -185,11 +223,21 @@ namespace Antioch
     unsigned int n_products() const;
 
     //! \returns the name of the \p r th reactant.
+    /*! Looked up in the chemical mixture, see set_chemical_mixture().
+        The reaction does not store the names: it is an error to ask
+        for one before the mixture is set, which ReactionSet::add_reaction()
+        does, a standalone reaction having to call set_chemical_mixture(). */
     const std::string& reactant_name(const unsigned int r) const;
 
     //! \returns the name of the \p p th product.
+    /*! As reactant_name(). */
     const std::string& product_name(const unsigned int p) const;
 
+    //! Chemical mixture the species names are looked up in
+    /*! Set by ReactionSet::add_reaction(), the reaction only stores
+        the ids of its species. */
+    void set_chemical_mixture(const ChemicalMixture<CoeffType>& chem_mixture);
+
     //!
     unsigned int reactant_id(const unsigned int r) const;
 
@@ -208,17 +256,48 @@ namespace Antioch
     //!
     CoeffType product_partial_order(const unsigned int p) const;
 
-    //!
+    //! Reactant partial order as a positive integer, 0 if it is not one
+    /*! Integer orders are raised by repeated multiplication rather than
+        ant_pow.  Only valid once initialize() has been called. */
+    unsigned int reactant_integer_partial_order(const unsigned int r) const;
+
+    //! Product partial order as a positive integer, 0 if it is not one
+    unsigned int product_integer_partial_order(const unsigned int p) const;
+
+    //! Reactant stoichiometric coefficient of species \p s, 0 if \p s is not a reactant
+    unsigned int species_reactant_stoichiometric_coefficient(const unsigned int s) const;
+
+    //! Product stoichiometric coefficient of species \p s, 0 if \p s is not a product
+    unsigned int species_product_stoichiometric_coefficient(const unsigned int s) const;
+
+    //! Net stoichiometric coefficient of species \p s, products minus reactants
+    int species_delta_stoichiometry(const unsigned int s) const;
+
+    //! Adds species \p r_id to the reactants
+    /*! The default partial order is the stoichiometric coefficient. */
+    void add_reactant( const unsigned int r_id,
+                       const unsigned int stoichiometric_coeff,
+                       const CoeffType partial_order = std::numeric_limits<CoeffType>::infinity());// what test could be reliable?
+
+    //! Adds species \p p_id to the products
+    void add_product( const unsigned int p_id,
+                      const unsigned int stoichiometric_coeff,
+                      const CoeffType partial_order = std::numeric_limits<CoeffType>::infinity()); // what test could be reliable?
+
+    //! Deprecated, the names come from the chemical mixture
+    /*! \p name is not stored; it is checked against \p r_id if the
+        chemical mixture is already set. */
     void add_reactant( const std::string &name,
                        const unsigned int r_id,
                        const unsigned int stoichiometric_coeff,
-                       const CoeffType partial_order = std::numeric_limits<CoeffType>::infinity());// what test could be reliable?
+                       const CoeffType partial_order = std::numeric_limits<CoeffType>::infinity());
 
-    //!
+    //! Deprecated, the names come from the chemical mixture
+    /*! As add_reactant(). */
     void add_product( const std::string &name,
                       const unsigned int p_id,
                       const unsigned int stoichiometric_coeff,
-                      const CoeffType partial_order = std::numeric_limits<CoeffType>::infinity()); // what test could be reliable?
+                      const CoeffType partial_order = std::numeric_limits<CoeffType>::infinity());
 
     //!
     void clear_reactant();
@@ -237,9 +316,31 @@ namespace Antioch
     //!
     CoeffType efficiency( const unsigned int s) const;
 
+    //! Number of species whose efficiency is not unity
+    unsigned int n_efficiency_corrections() const;
+
+    //! Species of the \p k-th non-unity efficiency
+    unsigned int efficiency_correction_species( const unsigned int k ) const;
+
+    //! Value of the \p k-th non-unity efficiency
+    CoeffType efficiency_correction( const unsigned int k ) const;
+
+    //! Third-body concentration [M] = sum_s eff_s c_s
+    /*! Built from the total concentration sum_s c_s and the non-unity
+        efficiencies only, (eff_s - 1) c_s. */
+    template <typename StateType, typename VectorStateType>
+    StateType third_body_concentration( const VectorStateType& molar_densities,
+                                        const StateType& total_concentration ) const;
+
     //! Computes derived quantities.
     void initialize(unsigned int index = 0);
 
+    //! Rebuilds what the chemical process precomputes from the forward rates
+    /*! Called by initialize() and set_parameter_of_rate(), to be called
+        again after changing a rate through forward_rate(). Nothing to do
+        but for the PLOG reactions, see PlogReaction::update_rate_tables(). */
+    virtual void update_rate_tables();
+
     //!
     int gamma() const;
 
@@ -257,11 +358,31 @@ namespace Antioch
                                               StateType& keq,
                                               StateType& dkeq_dT) const;
 
+    //! Equilibrium constant from the species factors of the reaction set
+    template <typename StateType, typename VectorStateType>
+    StateType equilibrium_constant( const EquilibriumFactors<CoeffType,StateType>& factors,
+                                    const VectorStateType& h_RT_minus_s_R ) const;
+
+    //! Equilibrium constant and derivative from the species factors of the reaction set
+    template <typename StateType, typename VectorStateType>
+    void equilibrium_constant_and_derivative( const StateType& T,
+                                              const EquilibriumFactors<CoeffType,StateType>& factors,
+                                              const VectorStateType& h_RT_minus_s_R,
+                                              const VectorStateType& ddT_h_RT_minus_s_R,
+                                              StateType& keq,
+                                              StateType& dkeq_dT) const;
+
     //!
     template <typename StateType, typename VectorStateType>
     StateType compute_forward_rate_coefficient( const VectorStateType& molar_densities,
                                                 const KineticsConditions<StateType,VectorStateType>& conditions) const;
 
+    //! Forward rate coefficient, given the total concentration of the state
+    template <typename StateType, typename VectorStateType>
+    StateType compute_forward_rate_coefficient( const VectorStateType& molar_densities,
+                                                const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                const StateType& total_concentration ) const;
+
     // Deprecated API for backwards compatibility
     template <typename StateType, typename VectorStateType>
     StateType compute_forward_rate_coefficient( const VectorStateType& molar_densities,
@@ -277,6 +398,23 @@ namespace Antioch
                                                            StateType& dkfwd_dT,
                                                            VectorStateType& dkfwd_dX) const;
 
+    //! Forward rate coefficient and derivatives, given the total concentration of the state
+    template <typename StateType, typename VectorStateType>
+    void compute_forward_rate_coefficient_and_derivatives( const VectorStateType& molar_densities,
+                                                           const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                           const StateType& total_concentration,
+                                                           StateType& kfwd,
+                                                           StateType& dkfwd_dT,
+                                                           VectorStateType& dkfwd_dX) const;
+
+    //! Forward rate coefficient and temperature derivative
+    /*! Only for reactions whose rate coefficient does not depend on the
+        concentrations, see rate_coefficient_depends_on_concentrations(). */
+    template <typename StateType, typename VectorStateType>
+    void compute_forward_rate_coefficient_and_derivative( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                          StateType& kfwd,
+                                                          StateType& dkfwd_dT ) const;
+
     // Deprecated API for backwards compatibility
     template <typename StateType, typename VectorStateType>
     void compute_forward_rate_coefficient_and_derivatives( const VectorStateType& molar_densities,
@@ -286,6 +424,23 @@ namespace Antioch
                                                            StateType& dkfwd_dT,
                                                            VectorStateType& dkfwd_dX) const;
 
+    //! Logarithmic derivatives of the forward rate coefficient with respect to the rate parameters
+    /*!
+     * \f$\ln A\f$, \f$\beta\f$ and \f$E_a\f$ (in K) are perturbed together for all the
+     * forward rates of the reaction (both limits of a falloff, all the rates
+     * of a duplicate, all the pressure levels of a PLOG), see
+     * KineticsType::compute_log_parameter_derivatives. A Chebyshev reaction has
+     * no such parameters: its coefficient is scaled as a whole, dlnk_dlnA = 1,
+     * and dlnk_dbeta = dlnk_dEa = 0. The rate of progress being proportional
+     * to the forward rate coefficient, these are also its logarithmic derivatives.
+     */
+    template <typename StateType, typename VectorStateType>
+    void compute_forward_rate_coefficient_log_parameter_derivatives( const VectorStateType& molar_densities,
+                                                                     const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                                     StateType& dlnk_dlnA,
+                                                                     StateType& dlnk_dbeta,
+                                                                     StateType& dlnk_dEa ) const;
+
     ////
     template <typename StateType, typename VectorStateType>
     StateType compute_rate_of_progress( const VectorStateType& molar_densities,
@@ -300,6 +455,22 @@ namespace Antioch
                                         const StateType& P0_RT,
                                         const VectorStateType& h_RT_minus_s_R) const;
 
+    //! Rate of progress for a given forward rate coefficient \p kfwd
+    //! and equilibrium constant \p keq, not used if irreversible
+    template <typename StateType, typename VectorStateType>
+    StateType compute_rate_of_progress_from_kfwd( const VectorStateType& molar_densities,
+                                                  const StateType& kfwd,
+                                                  const StateType& keq ) const;
+
+    //! Forward and backward rates of progress, their difference being
+    //! compute_rate_of_progress_from_kfwd(); \p kbkwd_times_products is zero if irreversible
+    template <typename StateType, typename VectorStateType>
+    void compute_forward_and_backward_rates_from_kfwd( const VectorStateType& molar_densities,
+                                                       const StateType& kfwd,
+                                                       const StateType& keq,
+                                                       StateType& kfwd_times_reactants,
+                                                       StateType& kbkwd_times_products ) const;
+
     template <typename StateType, typename VectorStateType>
     void compute_rate_of_progress_and_derivatives( const VectorStateType &molar_densities,
                                                    const ChemicalMixture<CoeffType>& /*chem_mixture*/, // fully useless, why is it here?
@@ -323,6 +494,27 @@ namespace Antioch
                                                    StateType& dnet_rate_dT,
                                                    VectorStateType& dnet_rate_dX_s ) const;
 
+    //! Rate of progress and derivatives for a given forward rate coefficient,
+    //! equilibrium constant and their derivatives, \p keq not used if irreversible
+    /*!
+     * Only the species the rate depends on are written in \p dnet_rate_dX_s:
+     * the reactants, the products if reversible, and all species if
+     * rate_coefficient_depends_on_concentrations(); the other entries are
+     * left untouched. \p dkfwd_dX_s is only read in the latter case, and
+     * may then be \p dnet_rate_dX_s itself.
+     */
+    template <typename StateType, typename VectorStateType>
+    void compute_rate_of_progress_and_derivatives_from_kfwd( const VectorStateType &molar_densities,
+                                                             const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                             const StateType &keq,
+                                                             const StateType &dkeq_dT,
+                                                             const StateType &kfwd,
+                                                             const StateType &dkfwd_dT,
+                                                             const VectorStateType &dkfwd_dX_s,
+                                                             StateType& net_reaction_rate,
+                                                             StateType& dnet_rate_dT,
+                                                             VectorStateType& dnet_rate_dX_s ) const;
+
     //! Return const reference to the forward rate object
     const KineticsType<CoeffType,VectorCoeffType>& forward_rate(unsigned int ir = 0) const;
 
@@ -360,17 +552,19 @@ namespace Antioch
     unsigned int _n_species;
     std::string _id;
     std::string _equation;
-    std::vector<std::string> _reactant_names;
-    std::vector<std::string> _product_names;
+
+    //! species names, not owned
+    const ChemicalMixture<CoeffType>* _chem_mixture;
+
+    //! only the participating species are stored, by order of appearance
     std::vector<unsigned int> _reactant_ids;
     std::vector<unsigned int> _product_ids;
     std::vector<unsigned int> _reactant_stoichiometry;
     std::vector<unsigned int> _product_stoichiometry;
-    std::vector<unsigned int> _species_reactant_stoichiometry;
-    std::vector<unsigned int> _species_product_stoichiometry;
-    std::vector<CoeffType>    _species_reactant_partial_order;
-    std::vector<CoeffType>    _species_product_partial_order;
-    std::vector<int>          _species_delta_stoichiometry;
+    std::vector<CoeffType>    _reactant_partial_order;
+    std::vector<CoeffType>    _product_partial_order;
+    std::vector<unsigned int> _reactant_integer_partial_order;
+    std::vector<unsigned int> _product_integer_partial_order;
     int _gamma;
     bool _initialized;
     bool _reversible;
@@ -381,12 +575,52 @@ namespace Antioch
     //! The forward reaction rate modified Arrhenius form.
     std::vector<KineticsType<CoeffType,VectorCoeffType>* > _forward_rate;
 
-    //! efficiencies for three body reactions
-    std::vector<CoeffType> _efficiencies;
+    //! false when the rates are laid out in a ReactionArena, which destroys them
+    bool _owns_forward_rates;
+
+    //! efficiencies for three body reactions, only the non-unity ones are stored
+    std::vector<unsigned int> _efficiency_species;
+    std::vector<CoeffType>    _efficiency_values;
 
   private:
     Reaction();
 
+    //! relocates the reaction and its rates
+    template <typename T>
+    friend class ReactionArena;
+
+    //! true for the reactions with a third body efficiency
+    bool has_efficiencies() const;
+
+    //! exponent of the equilibrium constant, reactants - products
+    template <typename StateType, typename VectorStateType>
+    StateType equilibrium_exponent( const VectorStateType& h_RT_minus_s_R ) const;
+
+    //! derivative of the exponent of the equilibrium constant
+    template <typename StateType, typename VectorStateType>
+    StateType equilibrium_exponent_derivative( const VectorStateType& ddT_h_RT_minus_s_R ) const;
+
+    //! error out if the chemical mixture is set and \p name is not the name of species \p s
+    void check_species_name(const std::string & name, const unsigned int s) const;
+
+    //! order as a positive integer not above max_integer_partial_order, 0 otherwise
+    static unsigned int integer_partial_order( const CoeffType order );
+
+    //! largest partial order handled by repeated multiplication
+    static const unsigned int max_integer_partial_order = 8;
+
+    //! reactants and products whose powers are kept on the stack by
+    //! compute_rate_of_progress_and_derivatives_from_kfwd()
+    static const unsigned int max_cached_participants = 8;
+
+    //! x^order and order x^(order-1), sharing one power computation
+    template <typename StateType>
+    void partial_order_power( const StateType& x,
+                              const CoeffType order,
+                              const unsigned int integer_order,
+                              StateType& val,
+                              StateType& dval ) const;
+
   };
 
   /* ------------------------- Inline Functions -------------------------*/
@@ -448,6 +682,13 @@ namespace Antioch
     _max_rate = max_rate;
   }
 
+  template<typename CoeffType, typename VectorCoeffType>
+  inline
+  CoeffType Reaction<CoeffType,VectorCoeffType>::maximum_rate() const
+  {
+    return _max_rate;
+  }
+
   template<typename CoeffType,typename VectorCoeffType>
   inline
   KineticsModel::KineticsModel Reaction<CoeffType,VectorCoeffType>::kinetics_model() const
@@ -477,6 +718,14 @@ namespace Antioch
     return _reversible;
   }
 
+  template<typename CoeffType, typename VectorCoeffType>
+  inline
+  bool Reaction<CoeffType,VectorCoeffType>::rate_coefficient_depends_on_concentrations() const
+  {
+    return ( _type != ReactionType::ELEMENTARY &&
+             _type != ReactionType::DUPLICATE );
+  }
+
   template<typename CoeffType, typename VectorCoeffType>
   inline
   void Reaction<CoeffType,VectorCoeffType>::add_forward_rate(KineticsType<CoeffType,VectorCoeffType> *rate)
@@ -512,7 +761,7 @@ namespace Antioch
   {
     antioch_assert_less(_reactant_ids.size(), this->n_species());
     antioch_assert_equal_to(_reactant_ids.size(), _reactant_stoichiometry.size());
-    antioch_assert_equal_to(_reactant_ids.size(), _reactant_names.size());
+    antioch_assert_equal_to(_reactant_ids.size(), _reactant_partial_order.size());
     return _reactant_ids.size();
   }
 
@@ -522,7 +771,7 @@ namespace Antioch
   {
     antioch_assert_less(_product_ids.size(), this->n_species());
     antioch_assert_equal_to(_product_ids.size(), _product_stoichiometry.size());
-    antioch_assert_equal_to(_product_ids.size(),  _product_names.size());
+    antioch_assert_equal_to(_product_ids.size(), _product_partial_order.size());
     return _product_ids.size();
   }
 
@@ -530,16 +779,52 @@ namespace Antioch
   inline
   const std::string& Reaction<CoeffType,VectorCoeffType>::reactant_name(const unsigned int r) const
   {
-    antioch_assert_less(r, _reactant_names.size());
-    return _reactant_names[r];
+    if( !_chem_mixture )
+      {
+        std::cerr << "Error: the reactant names are only known once the chemical mixture is set,\n"
+                  << "by ReactionSet::add_reaction() or set_chemical_mixture()" << std::endl;
+        antioch_error();
+      }
+
+    return _chem_mixture->species_inverse_name_map().find(this->reactant_id(r))->second;
   }
 
   template<typename CoeffType, typename VectorCoeffType>
   inline
   const std::string& Reaction<CoeffType,VectorCoeffType>::product_name(const unsigned int p) const
   {
-    antioch_assert_less(p, _product_names.size());
-    return _product_names[p];
+    if( !_chem_mixture )
+      {
+        std::cerr << "Error: the product names are only known once the chemical mixture is set,\n"
+                  << "by ReactionSet::add_reaction() or set_chemical_mixture()" << std::endl;
+        antioch_error();
+      }
+
+    return _chem_mixture->species_inverse_name_map().find(this->product_id(p))->second;
+  }
+
+  template<typename CoeffType, typename VectorCoeffType>
+  inline
+  void Reaction<CoeffType,VectorCoeffType>::check_species_name(const std::string & name, const unsigned int s) const
+  {
+    if( !_chem_mixture )
+      return;
+
+    Species species = this->n_species();
+    if( !_chem_mixture->species_index(name,species) || species != s )
+      {
+        std::cerr << "Error: species " << name << " is not species " << s
+                  << " of the chemical mixture of reaction " << this->id() << std::endl;
+        antioch_error();
+      }
+  }
+
+  template<typename CoeffType, typename VectorCoeffType>
+  inline
+  void Reaction<CoeffType,VectorCoeffType>::set_chemical_mixture(const ChemicalMixture<CoeffType>& chem_mixture)
+  {
+    antioch_assert_equal_to(chem_mixture.n_species(), this->n_species());
+    _chem_mixture = &chem_mixture;
   }
 
   template<typename CoeffType, typename VectorCoeffType>
@@ -582,51 +867,124 @@ namespace Antioch
   inline
   CoeffType Reaction<CoeffType,VectorCoeffType>::reactant_partial_order(const unsigned int r) const
   {
-    antioch_assert_less(r, _species_reactant_partial_order.size());
+    antioch_assert_less(r, _reactant_partial_order.size());
     antioch_assert_less(_reactant_ids[r], this->n_species());
-    return _species_reactant_partial_order[r];
+    return _reactant_partial_order[r];
   }
 
   template<typename CoeffType, typename VectorCoeffType>
   inline
   CoeffType Reaction<CoeffType,VectorCoeffType>::product_partial_order(const unsigned int p) const
   {
-    antioch_assert_less(p, _species_product_partial_order.size());
+    antioch_assert_less(p, _product_partial_order.size());
     antioch_assert_less(_product_ids[p], this->n_species());
-    return _species_product_partial_order[p];
+    return _product_partial_order[p];
+  }
+
+  template<typename CoeffType, typename VectorCoeffType>
+  inline
+  unsigned int Reaction<CoeffType,VectorCoeffType>::reactant_integer_partial_order(const unsigned int r) const
+  {
+    antioch_assert_less(r, _reactant_integer_partial_order.size());
+    return _reactant_integer_partial_order[r];
+  }
+
+  template<typename CoeffType, typename VectorCoeffType>
+  inline
+  unsigned int Reaction<CoeffType,VectorCoeffType>::product_integer_partial_order(const unsigned int p) const
+  {
+    antioch_assert_less(p, _product_integer_partial_order.size());
+    return _product_integer_partial_order[p];
+  }
+
+  template<typename CoeffType, typename VectorCoeffType>
+  inline
+  unsigned int Reaction<CoeffType,VectorCoeffType>::species_reactant_stoichiometric_coefficient(const unsigned int s) const
+  {
+    antioch_assert_less(s, this->n_species());
+
+    // a handful of reactants, a scan beats any lookup structure
+    unsigned int nu = 0;
+    for (unsigned int r=0; r < _reactant_ids.size(); r++)
+      if (_reactant_ids[r] == s)
+        nu += _reactant_stoichiometry[r];
+
+    return nu;
+  }
+
+  template<typename CoeffType, typename VectorCoeffType>
+  inline
+  unsigned int Reaction<CoeffType,VectorCoeffType>::species_product_stoichiometric_coefficient(const unsigned int s) const
+  {
+    antioch_assert_less(s, this->n_species());
+
+    unsigned int nu = 0;
+    for (unsigned int p=0; p < _product_ids.size(); p++)
+      if (_product_ids[p] == s)
+        nu += _product_stoichiometry[p];
+
+    return nu;
+  }
+
+  template<typename CoeffType, typename VectorCoeffType>
+  inline
+  int Reaction<CoeffType,VectorCoeffType>::species_delta_stoichiometry(const unsigned int s) const
+  {
+    return static_cast<int>(this->species_product_stoichiometric_coefficient(s))
+         - static_cast<int>(this->species_reactant_stoichiometric_coefficient(s));
   }
 
   template<typename CoeffType, typename VectorCoeffType>
   inline
-  void Reaction<CoeffType,VectorCoeffType>::add_reactant (const std::string &name,
+  void Reaction<CoeffType,VectorCoeffType>::add_reactant (const std::string & name,
                                           const unsigned int r_id,
                                           const unsigned int stoichiometric_coeff,
                                           const CoeffType partial_order)
+  {
+    antioch_deprecated();
+    this->check_species_name(name,r_id);
+    this->add_reactant(r_id,stoichiometric_coeff,partial_order);
+  }
+
+  template<typename CoeffType, typename VectorCoeffType>
+  inline
+  void Reaction<CoeffType,VectorCoeffType>::add_reactant (const unsigned int r_id,
+                                          const unsigned int stoichiometric_coeff,
+                                          const CoeffType partial_order)
   {
     antioch_assert_less(r_id, this->n_species());
-    _reactant_names.push_back(name);
     _reactant_ids.push_back(r_id);
     _reactant_stoichiometry.push_back(stoichiometric_coeff);
 
    CoeffType order = (partial_order == std::numeric_limits<CoeffType>::infinity() )?static_cast<CoeffType>(stoichiometric_coeff):partial_order;
-    _species_reactant_partial_order.push_back(order);
+    _reactant_partial_order.push_back(order);
     return;
   }
 
   template<typename CoeffType, typename VectorCoeffType>
   inline
-  void Reaction<CoeffType,VectorCoeffType>::add_product (const std::string &name,
+  void Reaction<CoeffType,VectorCoeffType>::add_product (const std::string & name,
                                          const unsigned int p_id,
                                          const unsigned int stoichiometric_coeff,
                                          const CoeffType partial_order)
+  {
+    antioch_deprecated();
+    this->check_species_name(name,p_id);
+    this->add_product(p_id,stoichiometric_coeff,partial_order);
+  }
+
+  template<typename CoeffType, typename VectorCoeffType>
+  inline
+  void Reaction<CoeffType,VectorCoeffType>::add_product (const unsigned int p_id,
+                                         const unsigned int stoichiometric_coeff,
+                                         const CoeffType partial_order)
   {
     antioch_assert_less(p_id, this->n_species());
-    _product_names.push_back(name);
     _product_ids.push_back(p_id);
     _product_stoichiometry.push_back(stoichiometric_coeff);
 
    CoeffType order = (partial_order == std::numeric_limits<CoeffType>::infinity() )?static_cast<CoeffType>(stoichiometric_coeff):partial_order;
-    _species_product_partial_order.push_back(order);
+    _product_partial_order.push_back(order);
     return;
   }
 
@@ -634,18 +992,18 @@ namespace Antioch
   inline
   void Reaction<CoeffType,VectorCoeffType>::clear_reactant()
   {
-    _reactant_names.clear();
     _reactant_ids.clear();
     _reactant_stoichiometry.clear();
+    _reactant_partial_order.clear();
   }
 
   template<typename CoeffType, typename VectorCoeffType>
   inline
   void Reaction<CoeffType,VectorCoeffType>::clear_product()
   {
-    _product_names.clear();
     _product_ids.clear();
     _product_stoichiometry.clear();
+    _product_partial_order.clear();
   }
 
   template<typename CoeffType, typename VectorCoeffType>
@@ -654,25 +1012,97 @@ namespace Antioch
                                             const unsigned int s,
                                             const CoeffType efficiency)
   {
-    antioch_assert_less(s, _efficiencies.size());
-    _efficiencies[s] = efficiency;
+    antioch_assert(this->has_efficiencies());
+    antioch_assert_less(s, this->n_species());
+
+    unsigned int k = 0;
+    while( k < _efficiency_species.size() && _efficiency_species[k] != s )
+      k++;
+
+    if( efficiency == 1 )
+      {
+        // unity efficiencies are implicit
+        if( k < _efficiency_species.size() )
+          {
+            _efficiency_species.erase(_efficiency_species.begin() + k);
+            _efficiency_values.erase(_efficiency_values.begin() + k);
+          }
+      }
+    else if( k < _efficiency_species.size() )
+      {
+        _efficiency_values[k] = efficiency;
+      }
+    else
+      {
+        _efficiency_species.push_back(s);
+        _efficiency_values.push_back(efficiency);
+      }
   }
 
   template<typename CoeffType, typename VectorCoeffType>
   inline
   CoeffType Reaction<CoeffType,VectorCoeffType>::get_efficiency (const unsigned int s) const
   {
-    antioch_assert_less(s, _efficiencies.size());
-    return _efficiencies[s];
+    return this->efficiency(s);
   }
 
   template<typename CoeffType, typename VectorCoeffType>
   inline
   CoeffType Reaction<CoeffType,VectorCoeffType>::efficiency( const unsigned int s ) const
   {
+    antioch_assert(this->has_efficiencies());
+    antioch_assert_less(s, this->n_species());
+
+    for( unsigned int k = 0; k < _efficiency_species.size(); k++ )
+      if( _efficiency_species[k] == s )
+        return _efficiency_values[k];
+
+    return 1;
+  }
+
+  template<typename CoeffType, typename VectorCoeffType>
+  inline
+  unsigned int Reaction<CoeffType,VectorCoeffType>::n_efficiency_corrections() const
+  {
+    return _efficiency_species.size();
+  }
+
+  template<typename CoeffType, typename VectorCoeffType>
+  inline
+  unsigned int Reaction<CoeffType,VectorCoeffType>::efficiency_correction_species( const unsigned int k ) const
+  {
+    antioch_assert_less(k, _efficiency_species.size());
+    return _efficiency_species[k];
+  }
+
+  template<typename CoeffType, typename VectorCoeffType>
+  inline
+  CoeffType Reaction<CoeffType,VectorCoeffType>::efficiency_correction( const unsigned int k ) const
+  {
+    antioch_assert_less(k, _efficiency_values.size());
+    return _efficiency_values[k];
+  }
+
+  template<typename CoeffType, typename VectorCoeffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  StateType Reaction<CoeffType,VectorCoeffType>::third_body_concentration( const VectorStateType& molar_densities,
+                                                                           const StateType& total_concentration ) const
+  {
+    StateType M = total_concentration;
+    for( unsigned int k = 0; k < _efficiency_species.size(); k++ )
+      M += ( _efficiency_values[k] - 1 ) * molar_densities[_efficiency_species[k]];
 
-    antioch_assert(s < _efficiencies.size());
-    return _efficiencies[s];
+    return M;
+  }
+
+  template<typename CoeffType, typename VectorCoeffType>
+  inline
+  bool Reaction<CoeffType,VectorCoeffType>::has_efficiencies() const
+  {
+    return ( _type == ReactionType::THREE_BODY ||
+             _type == ReactionType::LINDEMANN_FALLOFF_THREE_BODY ||
+             _type == ReactionType::TROE_FALLOFF_THREE_BODY );
   }
 
   template<typename CoeffType, typename VectorCoeffType>
@@ -708,12 +1138,14 @@ namespace Antioch
                                  const KineticsModel::KineticsModel kin)
     : _n_species(n_species),
       _equation(equation),
+      _chem_mixture(NULL),
       _gamma(0),
       _initialized(false),
       _reversible(reversible),
       _max_rate(std::numeric_limits<CoeffType>::infinity()),
       _type(type),
-      _kintype(kin)
+      _kintype(kin),
+      _owns_forward_rates(true)
   {
      return;
   }
@@ -723,6 +1155,9 @@ namespace Antioch
   inline
   Reaction<CoeffType,VectorCoeffType>::~Reaction()
   {
+    if( !_owns_forward_rates )
+      return;
+
     for(unsigned int ir = 0; ir < _forward_rate.size(); ir++)
       {
         delete _forward_rate[ir];
@@ -747,6 +1182,23 @@ namespace Antioch
         _gamma += this->product_stoichiometric_coefficient(p);
       }
 
+    // classify the partial orders: small positive integers (the
+    // stoichiometric default) get the repeated-multiplication kernel,
+    // anything else (fractional or zero ford/rord) keeps ant_pow
+    _reactant_integer_partial_order.resize(this->n_reactants());
+    for (unsigned int r=0; r< this->n_reactants(); r++)
+      {
+        _reactant_integer_partial_order[r] =
+          this->integer_partial_order(this->reactant_partial_order(r));
+      }
+
+    _product_integer_partial_order.resize(this->n_products());
+    for (unsigned int p=0; p < this->n_products(); p++)
+      {
+        _product_integer_partial_order[p] =
+          this->integer_partial_order(this->product_partial_order(p));
+      }
+
      // gives kinetics object index in reaction set
      for(typename std::vector<KineticsType<CoeffType,VectorCoeffType>* >::iterator it = _forward_rate.begin();
                 it != _forward_rate.end(); it++)
@@ -756,6 +1208,8 @@ namespace Antioch
 
     // set initialization flag
     _initialized = true;
+
+    this->update_rate_tables();
   }
 
 
@@ -774,6 +1228,62 @@ namespace Antioch
 // DrG0 = - reactants + product
 // K = (P0/(RT))^gamma exp(-DrG0)
 // exppower = -DrG0 = reactants - products
+    StateType exppower = this->template equilibrium_exponent<StateType>( h_RT_minus_s_R );
+
+    antioch_assert(!has_nan(exppower));
+
+    return ant_pow( P0_RT, static_cast<CoeffType>(this->gamma()) ) * ant_exp(exppower);
+  }
+
+  template<typename CoeffType, typename VectorCoeffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  StateType Reaction<CoeffType,VectorCoeffType>::equilibrium_constant( const EquilibriumFactors<CoeffType,StateType>& factors,
+                                                                       const VectorStateType& h_RT_minus_s_R ) const
+  {
+    antioch_assert( this->initialized() );
+    antioch_assert_equal_to( h_RT_minus_s_R.size(), this->n_species() );
+
+    // K = (P0/(RT))^gamma prod_r exp(h_r)^nu_r / prod_p exp(h_p)^nu_p
+    StateType numerator = factors.P0_RT_power(this->gamma());
+    CoeffType numerator_exponent = 0;
+    for (unsigned int s=0; s < this->n_reactants(); s++)
+      {
+        const StateType& factor = factors.exp_h_RT_minus_s_R(_reactant_ids[s]);
+        for (unsigned int n=0; n < _reactant_stoichiometry[s]; n++)
+          numerator *= factor;
+        numerator_exponent += ( static_cast<CoeffType>(_reactant_stoichiometry[s])*
+                                factors.abs_h_RT_minus_s_R(_reactant_ids[s]) );
+      }
+
+    StateType denominator = Antioch::constant_clone(numerator,1);
+    CoeffType denominator_exponent = 0;
+    for (unsigned int s=0; s < this->n_products(); s++)
+      {
+        const StateType& factor = factors.exp_h_RT_minus_s_R(_product_ids[s]);
+        for (unsigned int n=0; n < _product_stoichiometry[s]; n++)
+          denominator *= factor;
+        denominator_exponent += ( static_cast<CoeffType>(_product_stoichiometry[s])*
+                                  factors.abs_h_RT_minus_s_R(_product_ids[s]) );
+      }
+
+    if( numerator_exponent < factors.max_exponent() &&
+        denominator_exponent < factors.max_exponent() )
+      return numerator/denominator;
+
+    // the products could overflow, sum the exponents
+    StateType exppower = this->template equilibrium_exponent<StateType>( h_RT_minus_s_R );
+
+    antioch_assert(!has_nan(exppower));
+
+    return factors.P0_RT_power(this->gamma()) * ant_exp(exppower);
+  }
+
+  template<typename CoeffType, typename VectorCoeffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  StateType Reaction<CoeffType,VectorCoeffType>::equilibrium_exponent( const VectorStateType& h_RT_minus_s_R ) const
+  {
     StateType exppower = ( static_cast<CoeffType>(_reactant_stoichiometry[0])*
                             h_RT_minus_s_R[_reactant_ids[0]] );
 
@@ -789,34 +1299,62 @@ namespace Antioch
                        h_RT_minus_s_R[_product_ids[s]] );
       }
 
-    antioch_assert(!has_nan(exppower));
-
-    return ant_pow( P0_RT, static_cast<CoeffType>(this->gamma()) ) * ant_exp(exppower);
+    return exppower;
   }
 
-
   template<typename CoeffType, typename VectorCoeffType>
-  template<typename StateType, typename VectorStateType>
   inline
-  void Reaction<CoeffType,VectorCoeffType>::equilibrium_constant_and_derivative( const StateType& T,
-                                                                 const StateType& P0_RT,
-                                                                 const VectorStateType& h_RT_minus_s_R,
-                                                                 const VectorStateType& ddT_h_RT_minus_s_R,
-                                                                 StateType& keq,
-                                                                 StateType& dkeq_dT) const
+  unsigned int Reaction<CoeffType,VectorCoeffType>::integer_partial_order( const CoeffType order )
   {
-    antioch_assert(this->initialized());
+    if( order < 1 || order > static_cast<CoeffType>(max_integer_partial_order) )
+      return 0;
 
-    //!\todo Make these assertions vector-compatible
-    // antioch_assert_greater( P0_RT, 0.0 );
-    // antioch_assert_greater( T, 0.0 );
-    antioch_assert_greater( h_RT_minus_s_R.size(), 0 );
-    antioch_assert_equal_to( h_RT_minus_s_R.size(), this->n_species() );
-    antioch_assert_equal_to( ddT_h_RT_minus_s_R.size(), this->n_species() );
+    const unsigned int n = static_cast<unsigned int>(order);
 
-    // get the equilibrium constant
-    keq = this->equilibrium_constant( P0_RT, h_RT_minus_s_R );
+    return (static_cast<CoeffType>(n) == order) ? n : 0;
+  }
+
+  template<typename CoeffType, typename VectorCoeffType>
+  template<typename StateType>
+  inline
+  void Reaction<CoeffType,VectorCoeffType>::partial_order_power( const StateType& x,
+                                                                 const CoeffType order,
+                                                                 const unsigned int integer_order,
+                                                                 StateType& val,
+                                                                 StateType& dval ) const
+  {
+    if( integer_order )
+      {
+        // x^(n-1) once, x^n from it
+        StateType power = constant_clone(x,1);
+        for (unsigned int k=1; k < integer_order; k++)
+          power *= x;
+
+        val  = power * x;
+        dval = static_cast<CoeffType>(integer_order) * power;
+      }
+    else
+      {
+        val  = ant_pow( x, order );
+
+        // order x^order / x, but for x = 0 where it is the limit:
+        // 0 above order one, 1 at one, infinite below (0 at order 0)
+        const CoeffType dval_at_zero =
+          ( order > 1 || order == 0 ) ? 0 :
+          ( order == 1 ) ? 1 : std::numeric_limits<CoeffType>::infinity();
+
+        typename Antioch::rebind<StateType,bool>::type x_is_zero = (x == Antioch::zero_clone(x));
+        dval = Antioch::if_else( x_is_zero,
+                                 Antioch::constant_clone(x,dval_at_zero),
+                                 StateType(order * val / x) );
+      }
+  }
 
+  template<typename CoeffType, typename VectorCoeffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  StateType Reaction<CoeffType,VectorCoeffType>::equilibrium_exponent_derivative( const VectorStateType& ddT_h_RT_minus_s_R ) const
+  {
     StateType ddT_exppower = ( static_cast<CoeffType>(_reactant_stoichiometry[0])*
                                 ddT_h_RT_minus_s_R[_reactant_ids[0]] );
 
@@ -828,12 +1366,62 @@ namespace Antioch
       ddT_exppower -=  ( static_cast<CoeffType>(_product_stoichiometry[s])*
                          ddT_h_RT_minus_s_R[_product_ids[s]] );
 
+    return ddT_exppower;
+  }
+
+
+  template<typename CoeffType, typename VectorCoeffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void Reaction<CoeffType,VectorCoeffType>::equilibrium_constant_and_derivative( const StateType& T,
+                                                                 const StateType& P0_RT,
+                                                                 const VectorStateType& h_RT_minus_s_R,
+                                                                 const VectorStateType& ddT_h_RT_minus_s_R,
+                                                                 StateType& keq,
+                                                                 StateType& dkeq_dT) const
+  {
+    antioch_assert(this->initialized());
+
+    //!\todo Make these assertions vector-compatible
+    // antioch_assert_greater( P0_RT, 0.0 );
+    // antioch_assert_greater( T, 0.0 );
+    antioch_assert_greater( h_RT_minus_s_R.size(), 0 );
+    antioch_assert_equal_to( h_RT_minus_s_R.size(), this->n_species() );
+    antioch_assert_equal_to( ddT_h_RT_minus_s_R.size(), this->n_species() );
+
+    // get the equilibrium constant
+    keq = this->equilibrium_constant( P0_RT, h_RT_minus_s_R );
+
+    StateType ddT_exppower = this->template equilibrium_exponent_derivative<StateType>( ddT_h_RT_minus_s_R );
+
     // compute its derivative
     dkeq_dT = keq*(-static_cast<CoeffType>(this->gamma())/T + ddT_exppower);
 
     return;
   }
 
+  template<typename CoeffType, typename VectorCoeffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void Reaction<CoeffType,VectorCoeffType>::equilibrium_constant_and_derivative( const StateType& T,
+                                                                                 const EquilibriumFactors<CoeffType,StateType>& factors,
+                                                                                 const VectorStateType& h_RT_minus_s_R,
+                                                                                 const VectorStateType& ddT_h_RT_minus_s_R,
+                                                                                 StateType& keq,
+                                                                                 StateType& dkeq_dT) const
+  {
+    antioch_assert(this->initialized());
+    antioch_assert_equal_to( ddT_h_RT_minus_s_R.size(), this->n_species() );
+
+    keq = this->equilibrium_constant( factors, h_RT_minus_s_R );
+
+    StateType ddT_exppower = this->template equilibrium_exponent_derivative<StateType>( ddT_h_RT_minus_s_R );
+
+    dkeq_dT = keq*(-static_cast<CoeffType>(this->gamma())/T + ddT_exppower);
+
+    return;
+  }
+
 
   template<typename CoeffType, typename VectorCoeffType>
   inline
@@ -843,16 +1431,29 @@ namespace Antioch
     if (this->n_species())
       {
         os << "#   reactants: ";
+        // species ids until the reaction knows its mixture
         for (unsigned int r=0; r<this->n_reactants(); r++)
-          os << this->reactant_name(r) << ":"
-             << this->reactant_stoichiometric_coefficient(r) << ","
-             << this->reactant_partial_order(r) << " ";
+          {
+            if (_chem_mixture)
+              os << this->reactant_name(r);
+            else
+              os << this->reactant_id(r);
+            os << ":"
+               << this->reactant_stoichiometric_coefficient(r) << ","
+               << this->reactant_partial_order(r) << " ";
+          }
         os << "\n"
            << "#   products:  ";
         for (unsigned int p=0; p<this->n_products(); p++)
-          os << this->product_name(p) << ":"
-             << this->product_stoichiometric_coefficient(p) << ","
-             << this->product_partial_order(p) << " ";
+          {
+            if (_chem_mixture)
+              os << this->product_name(p);
+            else
+              os << this->product_id(p);
+            os << ":"
+               << this->product_stoichiometric_coefficient(p) << ","
+               << this->product_partial_order(p) << " ";
+          }
       }
     os << "\n#   Chemical process: " << _type;
     os << "\n#   Kinetics model: "   << _kintype;
@@ -864,9 +1465,7 @@ namespace Antioch
         os << "\n#   forward rate eqn: " << *_forward_rate[ir];
       }
 
-    if (_type == ReactionType::THREE_BODY ||
-        _type == ReactionType::LINDEMANN_FALLOFF_THREE_BODY ||
-        _type == ReactionType::TROE_FALLOFF_THREE_BODY)
+    if (this->has_efficiencies())
       {
         os << "\n#   efficiencies: ";
         for (unsigned int s=0; s<this->n_species(); s++)
@@ -927,6 +1526,91 @@ namespace Antioch
         }
         break;
 
+      case(ReactionType::PLOG):
+        {
+          return (static_cast<const PlogReaction<CoeffType>*>(this))->compute_forward_rate_coefficient(molar_densities,conditions);
+        }
+        break;
+
+      case(ReactionType::CHEBYSHEV):
+        {
+          return (static_cast<const ChebyshevReaction<CoeffType>*>(this))->compute_forward_rate_coefficient(molar_densities,conditions);
+        }
+        break;
+
+      default:
+        {
+          antioch_error();
+        }
+      } // switch(_type)
+
+    // Dummy
+    return zero_clone(conditions.T());
+  }
+
+  template<typename CoeffType, typename VectorCoeffType>
+  template <typename StateType, typename VectorStateType>
+  inline
+  StateType Reaction<CoeffType,VectorCoeffType>::compute_forward_rate_coefficient( const VectorStateType& molar_densities,
+                                                                   const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                                   const StateType& total_concentration) const
+  {
+    switch(_type)
+      {
+      case(ReactionType::ELEMENTARY):
+        {
+          return (static_cast<const ElementaryReaction<CoeffType>*>(this))->compute_forward_rate_coefficient(molar_densities,conditions);
+        }
+        break;
+
+      case(ReactionType::DUPLICATE):
+        {
+          return (static_cast<const DuplicateReaction<CoeffType>*>(this))->compute_forward_rate_coefficient(molar_densities,conditions);
+        }
+        break;
+
+      case(ReactionType::THREE_BODY):
+        {
+          return (static_cast<const ThreeBodyReaction<CoeffType>*>(this))->compute_forward_rate_coefficient(molar_densities,conditions,total_concentration);
+        }
+        break;
+
+      case(ReactionType::LINDEMANN_FALLOFF):
+        {
+          return (static_cast<const FalloffReaction<CoeffType,LindemannFalloff<CoeffType> >*>(this))->compute_forward_rate_coefficient(molar_densities,conditions,total_concentration);
+        }
+        break;
+
+      case(ReactionType::TROE_FALLOFF):
+        {
+          return (static_cast<const FalloffReaction<CoeffType,TroeFalloff<CoeffType> >*>(this))->compute_forward_rate_coefficient(molar_densities,conditions,total_concentration);
+        }
+        break;
+
+      case(ReactionType::LINDEMANN_FALLOFF_THREE_BODY):
+        {
+          return (static_cast<const FalloffThreeBodyReaction<CoeffType,LindemannFalloff<CoeffType> >*>(this))->compute_forward_rate_coefficient(molar_densities,conditions,total_concentration);
+        }
+        break;
+
+      case(ReactionType::TROE_FALLOFF_THREE_BODY):
+        {
+          return (static_cast<const FalloffThreeBodyReaction<CoeffType,TroeFalloff<CoeffType> >*>(this))->compute_forward_rate_coefficient(molar_densities,conditions,total_concentration);
+        }
+        break;
+
+      case(ReactionType::PLOG):
+        {
+          return (static_cast<const PlogReaction<CoeffType>*>(this))->compute_forward_rate_coefficient(molar_densities,conditions,total_concentration);
+        }
+        break;
+
+      case(ReactionType::CHEBYSHEV):
+        {
+          return (static_cast<const ChebyshevReaction<CoeffType>*>(this))->compute_forward_rate_coefficient(molar_densities,conditions,total_concentration);
+        }
+        break;
+
       default:
         {
           antioch_error();
@@ -989,6 +1673,7 @@ namespace Antioch
         {
           (static_cast<const FalloffReaction<CoeffType,TroeFalloff<CoeffType> >*>(this))->compute_forward_rate_coefficient_and_derivatives(molar_densities,conditions,kfwd,dkfwd_dT,dkfwd_dX);
         }
+        break;
 
       case(ReactionType::LINDEMANN_FALLOFF_THREE_BODY):
         {
@@ -1002,6 +1687,94 @@ namespace Antioch
         }
         break;
 
+      case(ReactionType::PLOG):
+        {
+          (static_cast<const PlogReaction<CoeffType>*>(this))->compute_forward_rate_coefficient_and_derivatives(molar_densities,conditions,kfwd,dkfwd_dT,dkfwd_dX);
+        }
+        break;
+
+      case(ReactionType::CHEBYSHEV):
+        {
+          (static_cast<const ChebyshevReaction<CoeffType>*>(this))->compute_forward_rate_coefficient_and_derivatives(molar_densities,conditions,kfwd,dkfwd_dT,dkfwd_dX);
+        }
+        break;
+
+      default:
+        {
+          antioch_error();
+        }
+
+      } // switch(type)
+
+    return;
+  }
+
+  template<typename CoeffType, typename VectorCoeffType>
+  template <typename StateType, typename VectorStateType>
+  inline
+  void Reaction<CoeffType,VectorCoeffType>::compute_forward_rate_coefficient_and_derivatives( const VectorStateType& molar_densities,
+                                                                              const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                                              const StateType& total_concentration,
+                                                                              StateType& kfwd,
+                                                                              StateType& dkfwd_dT,
+                                                                              VectorStateType& dkfwd_dX) const
+  {
+    switch(_type)
+      {
+      case(ReactionType::ELEMENTARY):
+        {
+          (static_cast<const ElementaryReaction<CoeffType>*>(this))->compute_forward_rate_coefficient_and_derivatives(molar_densities,conditions,kfwd,dkfwd_dT,dkfwd_dX);
+        }
+        break;
+
+      case(ReactionType::DUPLICATE):
+        {
+          (static_cast<const DuplicateReaction<CoeffType>*>(this))->compute_forward_rate_coefficient_and_derivatives(molar_densities,conditions,kfwd,dkfwd_dT,dkfwd_dX);
+        }
+        break;
+
+      case(ReactionType::THREE_BODY):
+        {
+          (static_cast<const ThreeBodyReaction<CoeffType>*>(this))->compute_forward_rate_coefficient_and_derivatives(molar_densities,conditions,total_concentration,kfwd,dkfwd_dT,dkfwd_dX);
+        }
+        break;
+
+      case(ReactionType::LINDEMANN_FALLOFF):
+        {
+          (static_cast<const FalloffReaction<CoeffType,LindemannFalloff<CoeffType> >*>(this))->compute_forward_rate_coefficient_and_derivatives(molar_densities,conditions,total_concentration,kfwd,dkfwd_dT,dkfwd_dX);
+        }
+        break;
+
+      case(ReactionType::TROE_FALLOFF):
+        {
+          (static_cast<const FalloffReaction<CoeffType,TroeFalloff<CoeffType> >*>(this))->compute_forward_rate_coefficient_and_derivatives(molar_densities,conditions,total_concentration,kfwd,dkfwd_dT,dkfwd_dX);
+        }
+        break;
+
+      case(ReactionType::LINDEMANN_FALLOFF_THREE_BODY):
+        {
+          (static_cast<const FalloffThreeBodyReaction<CoeffType,LindemannFalloff<CoeffType> >*>(this))->compute_forward_rate_coefficient_and_derivatives(molar_densities,conditions,total_concentration,kfwd,dkfwd_dT,dkfwd_dX);
+        }
+        break;
+
+      case(ReactionType::TROE_FALLOFF_THREE_BODY):
+        {
+          (static_cast<const FalloffThreeBodyReaction<CoeffType,TroeFalloff<CoeffType> >*>(this))->compute_forward_rate_coefficient_and_derivatives(molar_densities,conditions,total_concentration,kfwd,dkfwd_dT,dkfwd_dX);
+        }
+        break;
+
+      case(ReactionType::PLOG):
+        {
+          (static_cast<const PlogReaction<CoeffType>*>(this))->compute_forward_rate_coefficient_and_derivatives(molar_densities,conditions,total_concentration,kfwd,dkfwd_dT,dkfwd_dX);
+        }
+        break;
+
+      case(ReactionType::CHEBYSHEV):
+        {
+          (static_cast<const ChebyshevReaction<CoeffType>*>(this))->compute_forward_rate_coefficient_and_derivatives(molar_densities,conditions,total_concentration,kfwd,dkfwd_dT,dkfwd_dX);
+        }
+        break;
+
       default:
         {
           antioch_error();
@@ -1012,6 +1785,33 @@ namespace Antioch
     return;
   }
 
+  template<typename CoeffType, typename VectorCoeffType>
+  template <typename StateType, typename VectorStateType>
+  inline
+  void Reaction<CoeffType,VectorCoeffType>::compute_forward_rate_coefficient_and_derivative( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                                                             StateType& kfwd,
+                                                                                             StateType& dkfwd_dT ) const
+  {
+    antioch_assert(!this->rate_coefficient_depends_on_concentrations());
+
+    // sum of the rates, one unless duplicate
+    _forward_rate[0]->compute_rate_and_derivative(conditions,kfwd,dkfwd_dT);
+
+    if( _forward_rate.size() > 1 )
+      {
+        StateType ki = Antioch::zero_clone(kfwd);
+        StateType dki_dT = Antioch::zero_clone(kfwd);
+        for(unsigned int ir = 1; ir < _forward_rate.size(); ir++)
+          {
+            _forward_rate[ir]->compute_rate_and_derivative(conditions,ki,dki_dT);
+            kfwd += ki;
+            dkfwd_dT += dki_dT;
+          }
+      }
+
+    antioch_assert(!has_nan(kfwd));
+  }
+
   template<typename CoeffType, typename VectorCoeffType>
   template <typename StateType, typename VectorStateType>
   inline
@@ -1030,6 +1830,107 @@ namespace Antioch
        kfwd, dkfwd_dT, dkfwd_dX);
   }
 
+  template<typename CoeffType, typename VectorCoeffType>
+  template <typename StateType, typename VectorStateType>
+  inline
+  void Reaction<CoeffType,VectorCoeffType>::compute_forward_rate_coefficient_log_parameter_derivatives
+  ( const VectorStateType& molar_densities,
+    const KineticsConditions<StateType,VectorStateType>& conditions,
+    StateType& dlnk_dlnA,
+    StateType& dlnk_dbeta,
+    StateType& dlnk_dEa ) const
+  {
+    switch(_type)
+      {
+      case(ReactionType::DUPLICATE):
+        {
+          // k = sum_i k_i, dlnk = sum_i k_i/k dlnk_i
+          StateType kfwd = zero_clone(conditions.T());
+          StateType ki = zero_clone(conditions.T());
+          StateType dlnki_dlnA = zero_clone(conditions.T());
+          StateType dlnki_dbeta = zero_clone(conditions.T());
+          StateType dlnki_dEa = zero_clone(conditions.T());
+
+          dlnk_dlnA = zero_clone(conditions.T());
+          dlnk_dbeta = zero_clone(conditions.T());
+          dlnk_dEa = zero_clone(conditions.T());
+
+          for(unsigned int ir = 0; ir < _forward_rate.size(); ir++)
+            {
+              ki = (*_forward_rate[ir])(conditions);
+              _forward_rate[ir]->compute_log_parameter_derivatives(conditions,dlnki_dlnA,dlnki_dbeta,dlnki_dEa);
+              dlnk_dlnA  += ki * dlnki_dlnA;
+              dlnk_dbeta += ki * dlnki_dbeta;
+              dlnk_dEa   += ki * dlnki_dEa;
+              kfwd += ki;
+            }
+
+          dlnk_dlnA  /= kfwd;
+          dlnk_dbeta /= kfwd;
+          dlnk_dEa   /= kfwd;
+        }
+        break;
+
+      case(ReactionType::LINDEMANN_FALLOFF):
+      case(ReactionType::TROE_FALLOFF):
+      case(ReactionType::LINDEMANN_FALLOFF_THREE_BODY):
+      case(ReactionType::TROE_FALLOFF_THREE_BODY):
+        {
+          // k = kinf Pr/(1 + Pr) F(T,Pr), Pr = [M] k0/kinf: dlnk = w dlnk0 + (1 - w) dlnkinf,
+          // w = dlnk/dlnPr = 1/(1 + Pr) + dlnF/dlnPr
+          const StateType k0 = (*_forward_rate[0])(conditions);
+          const StateType kinf = (*_forward_rate[1])(conditions);
+          const StateType M = this->third_body_concentration( molar_densities,
+                                                              Antioch::total_concentration<StateType>(molar_densities) );
+          const StateType Pr = M * k0/kinf;
+
+          StateType w = 1/(1 + Pr);
+          if( _type == ReactionType::TROE_FALLOFF )
+            w += (static_cast<const FalloffReaction<CoeffType,TroeFalloff<CoeffType> >*>(this))->F().dlnF_dlnPr(conditions.T(),Pr);
+          else if( _type == ReactionType::TROE_FALLOFF_THREE_BODY )
+            w += (static_cast<const FalloffThreeBodyReaction<CoeffType,TroeFalloff<CoeffType> >*>(this))->F().dlnF_dlnPr(conditions.T(),Pr);
+
+          // low pressure limit if there is no high pressure one
+          typename Antioch::rebind<StateType, bool>::type kinf_is_nonzero = (kinf != Antioch::zero_clone(kinf));
+          w = Antioch::if_else(kinf_is_nonzero, w, constant_clone(kinf,1));
+
+          StateType dlnk0_dlnA = zero_clone(conditions.T());
+          StateType dlnk0_dbeta = zero_clone(conditions.T());
+          StateType dlnk0_dEa = zero_clone(conditions.T());
+          _forward_rate[0]->compute_log_parameter_derivatives(conditions,dlnk0_dlnA,dlnk0_dbeta,dlnk0_dEa);
+          _forward_rate[1]->compute_log_parameter_derivatives(conditions,dlnk_dlnA,dlnk_dbeta,dlnk_dEa);
+
+          dlnk_dlnA  = w * dlnk0_dlnA  + (1 - w) * dlnk_dlnA;
+          dlnk_dbeta = w * dlnk0_dbeta + (1 - w) * dlnk_dbeta;
+          dlnk_dEa   = w * dlnk0_dEa   + (1 - w) * dlnk_dEa;
+        }
+        break;
+
+      case(ReactionType::PLOG):
+        {
+          (static_cast<const PlogReaction<CoeffType>*>(this))->compute_log_parameter_derivatives(molar_densities,conditions,dlnk_dlnA,dlnk_dbeta,dlnk_dEa);
+        }
+        break;
+
+      case(ReactionType::CHEBYSHEV):
+        {
+          // no kinetics model, ln(A) can only be ln(10) a_00
+          dlnk_dlnA = constant_clone(conditions.T(),1);
+          dlnk_dbeta = zero_clone(conditions.T());
+          dlnk_dEa = zero_clone(conditions.T());
+        }
+        break;
+
+      default: // one forward rate
+        {
+          antioch_assert(!_forward_rate.empty());
+          _forward_rate[0]->compute_log_parameter_derivatives(conditions,dlnk_dlnA,dlnk_dbeta,dlnk_dEa);
+        }
+        break;
+
+      } // switch(_type)
+  }
+
   //kfwd *prod_r [R]^nu_r - kbkwd * prod_p [P]^nu_p ( = - 1/nu_r d[R]/dt)
   template<typename CoeffType, typename VectorCoeffType>
   template <typename StateType, typename VectorStateType>
@@ -1044,32 +1945,77 @@ namespace Antioch
     StateType kfwd = this->compute_forward_rate_coefficient(molar_densities,conditions);
     if (has_nan(kfwd))
       antioch_error();
+
+    StateType keq = Antioch::zero_clone(kfwd);
+    if(_reversible)
+      keq = this->equilibrium_constant( P0_RT, h_RT_minus_s_R );
+
+    return this->compute_rate_of_progress_from_kfwd(molar_densities, kfwd, keq);
+  }
+
+  template<typename CoeffType, typename VectorCoeffType>
+  template <typename StateType, typename VectorStateType>
+  inline
+  StateType Reaction<CoeffType,VectorCoeffType>::compute_rate_of_progress_from_kfwd( const VectorStateType& molar_densities,
+                                                                                     const StateType& kfwd,
+                                                                                     const StateType& Keq ) const
+  {
+    StateType kfwd_times_reactants = Antioch::zero_clone(kfwd);
+    StateType kbkwd_times_products = Antioch::zero_clone(kfwd);
+
+    this->compute_forward_and_backward_rates_from_kfwd( molar_densities, kfwd, Keq,
+                                                        kfwd_times_reactants, kbkwd_times_products );
+
+    if(_reversible)
+      return kfwd_times_reactants - kbkwd_times_products;
+
+    return kfwd_times_reactants;
+  }
+
+  template<typename CoeffType, typename VectorCoeffType>
+  template <typename StateType, typename VectorStateType>
+  inline
+  void Reaction<CoeffType,VectorCoeffType>::compute_forward_and_backward_rates_from_kfwd( const VectorStateType& molar_densities,
+                                                                                          const StateType& kfwd,
+                                                                                          const StateType& Keq,
+                                                                                          StateType& kfwd_times_reactants,
+                                                                                          StateType& kbkwd_times_products ) const
+  {
     antioch_assert(!has_nan(kfwd));
 
-    StateType kfwd_times_reactants = kfwd;
+    kfwd_times_reactants = kfwd;
 
     // Rfwd
     for (unsigned int ro=0; ro < this->n_reactants(); ro++)
       {
-        kfwd_times_reactants     *=
-          ant_pow( molar_densities[this->reactant_id(ro)],
-            this->reactant_partial_order(ro));
+        const unsigned int n = this->reactant_integer_partial_order(ro);
+        if( n )
+          for (unsigned int k=0; k < n; k++)
+            kfwd_times_reactants *= molar_densities[this->reactant_id(ro)];
+        else
+          kfwd_times_reactants     *=
+            ant_pow( molar_densities[this->reactant_id(ro)],
+              this->reactant_partial_order(ro));
       }
     antioch_assert(!has_nan(kfwd_times_reactants));
 
     if(_reversible)
     {
-      StateType Keq = this->equilibrium_constant( P0_RT, h_RT_minus_s_R );
       antioch_assert(!has_nan(Keq));
 
-      StateType kbkwd_times_products = kfwd/Keq;
+      kbkwd_times_products = kfwd/Keq;
 
       // Rbkwd
       for (unsigned int po=0; po< this->n_products(); po++)
         {
-          kbkwd_times_products     *=
-            ant_pow( molar_densities[this->product_id(po)],
-              this->product_partial_order(po));
+          const unsigned int n = this->product_integer_partial_order(po);
+          if( n )
+            for (unsigned int k=0; k < n; k++)
+              kbkwd_times_products *= molar_densities[this->product_id(po)];
+          else
+            kbkwd_times_products     *=
+              ant_pow( molar_densities[this->product_id(po)],
+                this->product_partial_order(po));
         }
 
       // If we have an equilibrium constant of zero, our reverse
@@ -1080,11 +2026,9 @@ namespace Antioch
 	Antioch::if_else(is_nonzero, kbkwd_times_products,
                          Antioch::constant_clone(Keq, this->_max_rate));
       antioch_assert(!has_nan(kbkwd_times_products));
-
-      return kfwd_times_reactants - kbkwd_times_products;
     }
-
-    return kfwd_times_reactants;
+    else
+      kbkwd_times_products = Antioch::zero_clone(kfwd);
   }
 
   template<typename CoeffType, typename VectorCoeffType>
@@ -1122,173 +2066,160 @@ namespace Antioch
     StateType kfwd = Antioch::zero_clone(conditions.T());
     StateType dkfwd_dT = Antioch::zero_clone(conditions.T());
     VectorStateType dkfwd_dX_s = Antioch::zero_clone(molar_densities);
-    VectorStateType dkbkwd_dX_s = Antioch::zero_clone(molar_densities);
 
     this->compute_forward_rate_coefficient_and_derivatives(molar_densities, conditions, kfwd, dkfwd_dT ,dkfwd_dX_s);
 
-    // If users want to use valarrays, then the output reference sizes
-    // had better already match the input value sizes...
-    StateType dRfwd_dT = Antioch::zero_clone(kfwd);
+    StateType keq = Antioch::zero_clone(conditions.T());
+    StateType dkeq_dT = Antioch::zero_clone(conditions.T());
 
-    // We need to construct using an input StateType argument if we
-    // want StateType==valarray to have the right sizes
-    // valarray compatibility makes this a bit redundant, but not much
-    // worse than the previous version
-    /*! \todo Should we make this work arrays that get passed in so we aren't allocating/deallocating here? */
-    VectorStateType dRfwd_dX_s(this->n_species(), kfwd);
+    if(_reversible)
+      equilibrium_constant_and_derivative( conditions.T(), P0_RT, h_RT_minus_s_R,
+                                           dh_RT_minus_s_R_dT,
+                                           keq, dkeq_dT );
 
-    Antioch::set_zero(dRfwd_dX_s);
+    // only the species the rate depends on are written
+    Antioch::set_zero(dnet_rate_dX_s);
 
-    // pre-fill the participating species partials with the rates
-    for (unsigned int r=0; r< this->n_reactants(); r++)
+    this->compute_rate_of_progress_and_derivatives_from_kfwd( molar_densities, conditions,
+                                                              keq, dkeq_dT,
+                                                              kfwd, dkfwd_dT, dkfwd_dX_s,
+                                                              net_reaction_rate, dnet_rate_dT, dnet_rate_dX_s );
+  }
+
+  template<typename CoeffType, typename VectorCoeffType>
+  template <typename StateType, typename VectorStateType>
+  inline
+  void Reaction<CoeffType,VectorCoeffType>::compute_rate_of_progress_and_derivatives_from_kfwd( const VectorStateType &molar_densities,
+                                                                                                const KineticsConditions<StateType,VectorStateType>& /*conditions*/,
+                                                                                                const StateType &keq,
+                                                                                                const StateType &dkeq_dT,
+                                                                                                const StateType &kfwd,
+                                                                                                const StateType &dkfwd_dT,
+                                                                                                const VectorStateType &dkfwd_dX_s,
+                                                                                                StateType& net_reaction_rate,
+                                                                                                StateType& dnet_rate_dT,
+                                                                                                VectorStateType& dnet_rate_dX_s ) const
+  {
+    antioch_assert_equal_to (molar_densities.size(), this->n_species());
+    antioch_assert_equal_to (dnet_rate_dX_s.size(), this->n_species());
+
+    // R = kfwd * (facfwd - facbkwd/keq), fac being the products of the
+    // concentrations to their partial orders. Only the participating
+    // species are visited; x^order and its derivative are computed once
+    // per participant and kept, reactants then products, on the stack
+    // for reactions of up to max_cached_participants species.
+    const unsigned int n_participants = this->n_reactants() + this->n_products();
+    StateType stack_vals[max_cached_participants];
+    StateType stack_dvals[max_cached_participants];
+    std::vector<StateType> heap_vals, heap_dvals;
+    StateType* vals = stack_vals;
+    StateType* dvals = stack_dvals;
+    if( n_participants > max_cached_participants )
       {
-        dRfwd_dX_s[this->reactant_id(r)] = kfwd;
+        heap_vals.resize(n_participants, zero_clone(kfwd));
+        heap_dvals.resize(n_participants, zero_clone(kfwd));
+        vals = &heap_vals[0];
+        dvals = &heap_dvals[0];
       }
+    StateType* product_vals = vals + this->n_reactants();
+    StateType* product_dvals = dvals + this->n_reactants();
 
-    //init
-    StateType facfwd = constant_clone(conditions.T(),1);
-    dRfwd_dT = dkfwd_dT;
-
-    // Rfwd & derivatives
+    // Rfwd
+    StateType facfwd = constant_clone(kfwd,1);
     for (unsigned int ro=0; ro < this->n_reactants(); ro++)
       {
-        const StateType val =
-          ant_pow( molar_densities[this->reactant_id(ro)],
-            this->reactant_partial_order(ro));
+        this->partial_order_power( molar_densities[this->reactant_id(ro)],
+                                   this->reactant_partial_order(ro),
+                                   this->reactant_integer_partial_order(ro),
+                                   vals[ro], dvals[ro] );
+        facfwd *= vals[ro];
+      }
 
-        const StateType dval =
-          ( static_cast<CoeffType>(this->reactant_stoichiometric_coefficient(ro))*
-            ant_pow( molar_densities[this->reactant_id(ro)],
-              this->reactant_partial_order(ro) - 1)
-            );
+    net_reaction_rate = facfwd * kfwd;
+    dnet_rate_dT = facfwd * dkfwd_dT;
+
+    // factor of dkfwd_dX_s in the derivatives
+    StateType dR_dkfwd = facfwd;
 
-        facfwd   *= val;
-        dRfwd_dT *= val;
+    // Rbkwd, kbkwd = kfwd/keq
+    StateType kbkwd = zero_clone(kfwd);
+    StateType facbkwd = constant_clone(kfwd,1);
+    typename Antioch::rebind<StateType,bool>::type is_nonzero = (keq != Antioch::zero_clone(keq));
+    if(_reversible)
+      {
+        kbkwd = kfwd/keq;
 
-        for (unsigned int ri=0; ri<this->n_reactants(); ri++)
+        for (unsigned int po=0; po < this->n_products(); po++)
           {
-            dRfwd_dX_s[this->reactant_id(ri)] *= (ri == ro) ? dval : val;
+            this->partial_order_power( molar_densities[this->product_id(po)],
+                                       this->product_partial_order(po),
+                                       this->product_integer_partial_order(po),
+                                       product_vals[po], product_dvals[po] );
+            facbkwd *= product_vals[po];
           }
+
+        // If we have an equilibrium constant of zero, our reverse
+        // reaction rate should be infinity or a user-specified
+        // _max_rate, not NaN, and its derivatives are zero.
+        const StateType kbkwd_times_products =
+          Antioch::if_else(is_nonzero, StateType(facbkwd * kbkwd),
+                           Antioch::constant_clone(keq, this->_max_rate));
+        antioch_assert(!has_nan(kbkwd_times_products));
+
+        const StateType dkbkwd_dT = (dkfwd_dT - kbkwd*dkeq_dT)/keq;
+        const StateType dRbkwd_dT =
+          Antioch::if_else(is_nonzero, StateType(facbkwd * dkbkwd_dT),
+                           Antioch::zero_clone(keq));
+        antioch_assert(!has_nan(dRbkwd_dT));
+
+        net_reaction_rate -= kbkwd_times_products;
+        dnet_rate_dT -= dRbkwd_dT;
+
+        dR_dkfwd -= Antioch::if_else(is_nonzero, StateType(facbkwd/keq),
+                                     Antioch::zero_clone(keq));
       }
 
-    for (unsigned int s = 0; s < this->n_species(); s++)
+    // kfwd contributions, to all species through [M] or the pressure,
+    // else zero for the participating species before the mass action terms
+    if( this->rate_coefficient_depends_on_concentrations() )
       {
-        dRfwd_dX_s[s] += facfwd * dkfwd_dX_s[s];
+        antioch_assert_equal_to (dkfwd_dX_s.size(), this->n_species());
+        for (unsigned int s = 0; s < this->n_species(); s++)
+          dnet_rate_dX_s[s] = dR_dkfwd * dkfwd_dX_s[s];
       }
+    else
+      {
+        for (unsigned int r=0; r < this->n_reactants(); r++)
+          dnet_rate_dX_s[this->reactant_id(r)] = zero_clone(kfwd);
 
-    net_reaction_rate = facfwd * kfwd;
-
-    dnet_rate_dT = dRfwd_dT;
+        if(_reversible)
+          for (unsigned int p=0; p < this->n_products(); p++)
+            dnet_rate_dX_s[this->product_id(p)] = zero_clone(kfwd);
+      }
 
-    for (unsigned int s = 0; s < this->n_species(); s++)
+    // mass action terms, dfac/dX_i = dval_i prod_{j != i} val_j, from the
+    // cached powers; not dval_i fac/val_i, val_i may be zero
+    for (unsigned int ro=0; ro < this->n_reactants(); ro++)
       {
-        dnet_rate_dX_s[s] = dRfwd_dX_s[s];
+        StateType dRfwd = kfwd;
+        for (unsigned int ri=0; ri < this->n_reactants(); ri++)
+          dRfwd *= (ri == ro) ? dvals[ri] : vals[ri];
+
+        dnet_rate_dX_s[this->reactant_id(ro)] += dRfwd;
       }
 
     if(_reversible)
-    {
-
-    //backward to be computed and added
-
-      StateType keq = Antioch::zero_clone(conditions.T());
-      StateType dkeq_dT = Antioch::zero_clone(conditions.T());
-
-      equilibrium_constant_and_derivative( conditions.T(), P0_RT, h_RT_minus_s_R,
-                                           dh_RT_minus_s_R_dT,
-                                           keq, dkeq_dT );
-
-      const StateType kbkwd = kfwd/keq;
-      const StateType dkbkwd_dT = (dkfwd_dT - kbkwd*dkeq_dT)/keq;
-      for(unsigned int s = 0; s < this->n_species(); s++)
-        {
-          dkbkwd_dX_s[s] = dkfwd_dX_s[s]/keq;
-        }
-
-      // If users want to use valarrays, then the output reference sizes
-      // had better already match the input value sizes...
-      StateType dRbkwd_dT = Antioch::zero_clone(dkbkwd_dT);
-
-      // We need to construct using an input StateType argument if we
-      // want StateType==valarray to have the right sizes
-      // valarray compatibility makes this a bit redundant, but not much
-      // worse than the previous version
-      /*! \todo Should we make this work arrays that get passed in so we aren't allocating/deallocating here? */
-      VectorStateType dRbkwd_dX_s(this->n_species(), kbkwd);
-
-      Antioch::set_zero(dRbkwd_dX_s);
-
-      // pre-fill the participating species partials with the rates
-      for (unsigned int p=0; p < this->n_products(); p++)
-        {
-          dRbkwd_dX_s[this->product_id(p)] = kbkwd;
-        }
-
-      //init
-      StateType facbkwd = constant_clone(conditions.T(),1);
-      dRbkwd_dT = dkbkwd_dT;
-
-      // Rbkwd & derivatives
-      for (unsigned int po=0; po< this->n_products(); po++)
-        {
-          const StateType val =
-            ant_pow( molar_densities[this->product_id(po)],
-              this->product_partial_order(po));
-
-          const StateType dval =
-            ( static_cast<CoeffType>(this->product_stoichiometric_coefficient(po))*
-              ant_pow( molar_densities[this->product_id(po)],
-              this->product_partial_order(po) - 1)
-              );
-
-          facbkwd   *= val;
-          dRbkwd_dT *= val;
-
-          for (unsigned int pi=0; pi<this->n_products(); pi++)
-            {
-              dRbkwd_dX_s[this->product_id(pi)] *= (pi == po) ? dval : val;
-            }
-
-        }
-
-      for (unsigned int s = 0; s < this->n_species(); s++)
-        {
-          dRbkwd_dX_s[s] += facbkwd * dkbkwd_dX_s[s];
-        }
-
-      StateType kbkwd_times_products = facbkwd * kbkwd;
-
-      // If we have an equilibrium constant of zero, our reverse
-      // reaction rate should be infinity or a user-specified
-      // _max_rate, not NaN.
-      typename Antioch::rebind<StateType,bool>::type is_nonzero = (keq != Antioch::zero_clone(keq));
-      kbkwd_times_products =
-	Antioch::if_else(is_nonzero, kbkwd_times_products,
-                         Antioch::constant_clone(keq, this->_max_rate));
-      antioch_assert(!has_nan(kbkwd_times_products));
-
-      // If our rate is maxed out then our derivatives are zero.
-      dRbkwd_dT =
-	Antioch::if_else(is_nonzero, dRbkwd_dT,
-                         Antioch::zero_clone(keq));
-      antioch_assert(!has_nan(dRbkwd_dT));
-
-      for (unsigned int s = 0; s < this->n_species(); s++)
-        {
-          dRbkwd_dX_s[s] =
-	    Antioch::if_else(is_nonzero, dRbkwd_dX_s[s],
-                             Antioch::zero_clone(keq));
-        }
-
-      net_reaction_rate -= kbkwd_times_products;
-
-      dnet_rate_dT -= dRbkwd_dT;
-
-      for (unsigned int s = 0; s < this->n_species(); s++)
-        {
-          dnet_rate_dX_s[s] -= dRbkwd_dX_s[s];
-        }
+      {
+        for (unsigned int po=0; po < this->n_products(); po++)
+          {
+            StateType dRbkwd = kbkwd;
+            for (unsigned int pi=0; pi < this->n_products(); pi++)
+              dRbkwd *= (pi == po) ? product_dvals[pi] : product_vals[pi];
 
-    } //end of if(_reversible) condition
+            dnet_rate_dX_s[this->product_id(po)] -=
+              Antioch::if_else(is_nonzero, dRbkwd, Antioch::zero_clone(keq));
+          }
+      }
 
     return;
   }
@@ -1362,6 +2293,8 @@ namespace Antioch
   {
       antioch_assert_less(n_kin,_forward_rate.size());
       reset_parameter_of_rate(*_forward_rate[n_kin], parameter, new_value, unit);
+      if(_initialized)
+        this->update_rate_tables();
   }
 
   template<typename CoeffType, typename VectorCoeffType>
@@ -1370,6 +2303,15 @@ namespace Antioch
   {
       antioch_assert_less(n_kin,_forward_rate.size());
       reset_parameter_of_rate(*_forward_rate[n_kin], parameter, new_value, l, unit);
+      if(_initialized)
+        this->update_rate_tables();
+  }
+
+  template<typename CoeffType, typename VectorCoeffType>
+  inline
+  void Reaction<CoeffType,VectorCoeffType>::update_rate_tables()
+  {
+    return;
   }
 
   template<typename CoeffType, typename VectorCoeffType>
@@ -0,0 +1,411 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+#ifndef ANTIOCH_REACTION_ARENA_H
+#define ANTIOCH_REACTION_ARENA_H
+
+// Antioch
+#include "antioch/antioch_asserts.h"
+#include "antioch/kinetics_enum.h"
+#include "antioch/reaction_enum.h"
+#include "antioch/reaction.h"
+#include "antioch/elementary_reaction.h"
+#include "antioch/duplicate_reaction.h"
+#include "antioch/threebody_reaction.h"
+#include "antioch/falloff_reaction.h"
+#include "antioch/falloff_threebody_reaction.h"
+#include "antioch/plog_reaction.h"
+#include "antioch/chebyshev_reaction.h"
+#include "antioch/lindemann_falloff.h"
+#include "antioch/troe_falloff.h"
+
+// C++
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <new>
+#include <typeinfo>
+#include <vector>
+
+namespace Antioch
+{
+  //! Contiguous storage of reactions and of their rate objects
+  /*!
+   * The reactions are copied, each one followed by its forward rates,
+   * in a single block, in the order they are given: the evaluation
+   * loops then walk through memory instead of jumping from one heap
+   * allocation to the next. The arena owns the copies, see destroy().
+   *
+   * Only the objects themselves are relocated, the vectors they hold
+   * (reactants, efficiencies, ...) keep their own heap storage.
+   *
+   * The copies are made with the copy constructor of the concrete type
+   * given by type(), which must be the exact dynamic type of the object:
+   * derived classes of the library reactions and rates, and photochemical
+   * rates of another vector type, are not supported, see can_place().
+   */
+  template<typename CoeffType=double>
+  class ReactionArena
+  {
+  public:
+
+    //! Copies of \p reactions, in this order
+    /*! The originals are left untouched, relocated[r] is the copy of reactions[r].
+        If a copy throws, the copies already made are destroyed before rethrowing. */
+    ReactionArena( const std::vector<Reaction<CoeffType>* >& reactions,
+                   std::vector<Reaction<CoeffType>* >& relocated );
+
+    //! true if every reaction of \p reactions and every rate can be copied
+    static bool can_place( const std::vector<Reaction<CoeffType>* >& reactions );
+
+    //! Destroys the copies that are still alive
+    ~ReactionArena();
+
+    //! true if \p reaction lives in this arena
+    bool owns( const Reaction<CoeffType>* reaction ) const;
+
+    //! Destroys \p reaction and its rates, the memory is not reused
+    void destroy( Reaction<CoeffType>* reaction );
+
+    //! Size of the block, in bytes
+    std::size_t size() const;
+
+  private:
+
+    //! Counts only, see can_place()
+    ReactionArena();
+
+    ReactionArena( const ReactionArena& );
+    ReactionArena& operator=( const ReactionArena& );
+
+    //! Copies \p reactions in the block, or only counts the bytes while there is no block
+    void place_reactions( const std::vector<Reaction<CoeffType>* >& reactions,
+                          std::vector<Reaction<CoeffType>* >& relocated );
+
+    //! Copy of \p reaction, of its concrete type, NULL while counting or if not supported
+    Reaction<CoeffType>* place_reaction( const Reaction<CoeffType>& reaction );
+
+    //! Copy of \p rate, of its concrete type, NULL while counting or if not supported
+    KineticsType<CoeffType>* place_rate( const KineticsType<CoeffType>& rate );
+
+    //! Copy constructs a \p T from \p object in the next slot
+    /*! Only if \p T is the dynamic type of \p object, _supported is reset otherwise. */
+    template <typename T, typename BaseType>
+    BaseType* place( const BaseType& object );
+
+    //! Next \p n bytes, aligned for any type, NULL while counting
+    void* allocate( std::size_t n );
+
+    //! Destroys \p reaction, which lives here, and its rates
+    void destroy_objects( Reaction<CoeffType>* reaction );
+
+    //! Destroys the copies that are still alive and frees the block
+    void release();
+
+    char* _block;
+
+    //! bytes used so far, size of the block once allocated
+    std::size_t _used;
+
+    //! the copies, NULL once destroyed
+    std::vector<Reaction<CoeffType>* > _reactions;
+
+    //! false if an object of an unsupported type was met
+    bool _supported;
+  };
+
+  /* ------------------------- Inline Functions -------------------------*/
+  template<typename CoeffType>
+  inline
+  ReactionArena<CoeffType>::ReactionArena( const std::vector<Reaction<CoeffType>* >& reactions,
+                                           std::vector<Reaction<CoeffType>* >& relocated )
+    : _block(NULL),
+      _used(0),
+      _supported(true)
+  {
+    // first pass counts, second one copies
+    this->place_reactions(reactions,relocated);
+
+    if( !_supported )
+      {
+        std::cerr << "Error: a reaction or a rate is not of a type ReactionArena can copy" << std::endl;
+        antioch_error();
+      }
+
+    _block = new char[_used];
+    _used = 0;
+    _reactions.reserve(reactions.size());
+
+    try
+      {
+        this->place_reactions(reactions,relocated);
+      }
+    catch(...)
+      {
+        this->release();
+        throw;
+      }
+  }
+
+  template<typename CoeffType>
+  inline
+  ReactionArena<CoeffType>::ReactionArena()
+    : _block(NULL),
+      _used(0),
+      _supported(true)
+  {
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  ReactionArena<CoeffType>::~ReactionArena()
+  {
+    this->release();
+  }
+
+  template<typename CoeffType>
+  inline
+  bool ReactionArena<CoeffType>::can_place( const std::vector<Reaction<CoeffType>* >& reactions )
+  {
+    ReactionArena<CoeffType> counter;
+    std::vector<Reaction<CoeffType>* > relocated;
+    counter.place_reactions(reactions,relocated);
+
+    return counter._supported;
+  }
+
+  template<typename CoeffType>
+  inline
+  void ReactionArena<CoeffType>::release()
+  {
+    for( unsigned int r = 0; r < _reactions.size(); r++ )
+      if( _reactions[r] )
+        this->destroy_objects(_reactions[r]);
+    _reactions.clear();
+
+    delete [] _block;
+    _block = NULL;
+  }
+
+  template<typename CoeffType>
+  inline
+  bool ReactionArena<CoeffType>::owns( const Reaction<CoeffType>* reaction ) const
+  {
+    const char* address = reinterpret_cast<const char*>(reaction);
+    return ( _block && address >= _block && address < _block + _used );
+  }
+
+  template<typename CoeffType>
+  inline
+  void ReactionArena<CoeffType>::destroy( Reaction<CoeffType>* reaction )
+  {
+    antioch_assert( this->owns(reaction) );
+
+    for( unsigned int r = 0; r < _reactions.size(); r++ )
+      if( _reactions[r] == reaction )
+        {
+          this->destroy_objects(reaction);
+          _reactions[r] = NULL;
+          return;
+        }
+
+    // already destroyed
+    antioch_error();
+  }
+
+  template<typename CoeffType>
+  inline
+  std::size_t ReactionArena<CoeffType>::size() const
+  {
+    return _used;
+  }
+
+  template<typename CoeffType>
+  inline
+  void ReactionArena<CoeffType>::place_reactions( const std::vector<Reaction<CoeffType>* >& reactions,
+                                                  std::vector<Reaction<CoeffType>* >& relocated )
+  {
+    relocated.resize(reactions.size());
+
+    for( unsigned int r = 0; r < reactions.size(); r++ )
+      {
+        Reaction<CoeffType>* copy = this->place_reaction(*reactions[r]);
+
+        // the copy must not point to the rates of the original, even
+        // if placing its own ones throws halfway
+        if( copy )
+          {
+            copy->_owns_forward_rates = false;
+            std::fill( copy->_forward_rate.begin(), copy->_forward_rate.end(),
+                       static_cast<KineticsType<CoeffType>*>(NULL) );
+            _reactions.push_back(copy);
+          }
+
+        for( unsigned int ir = 0; ir < reactions[r]->n_rate_constants(); ir++ )
+          {
+            KineticsType<CoeffType>* rate = this->place_rate(reactions[r]->forward_rate(ir));
+            if( copy )
+              copy->_forward_rate[ir] = rate;
+          }
+
+        relocated[r] = copy;
+      }
+  }
+
+  template<typename CoeffType>
+  inline
+  Reaction<CoeffType>* ReactionArena<CoeffType>::place_reaction( const Reaction<CoeffType>& reaction )
+  {
+    typedef Reaction<CoeffType> Base;
+
+    switch(reaction.type())
+      {
+      case(ReactionType::ELEMENTARY):
+        return this->template place<ElementaryReaction<CoeffType>,Base>(reaction);
+
+      case(ReactionType::DUPLICATE):
+        return this->template place<DuplicateReaction<CoeffType>,Base>(reaction);
+
+      case(ReactionType::THREE_BODY):
+        return this->template place<ThreeBodyReaction<CoeffType>,Base>(reaction);
+
+      case(ReactionType::LINDEMANN_FALLOFF):
+        return this->template place<FalloffReaction<CoeffType,LindemannFalloff<CoeffType> >,Base>(reaction);
+
+      case(ReactionType::TROE_FALLOFF):
+        return this->template place<FalloffReaction<CoeffType,TroeFalloff<CoeffType> >,Base>(reaction);
+
+      case(ReactionType::LINDEMANN_FALLOFF_THREE_BODY):
+        return this->template place<FalloffThreeBodyReaction<CoeffType,LindemannFalloff<CoeffType> >,Base>(reaction);
+
+      case(ReactionType::TROE_FALLOFF_THREE_BODY):
+        return this->template place<FalloffThreeBodyReaction<CoeffType,TroeFalloff<CoeffType> >,Base>(reaction);
+
+      case(ReactionType::PLOG):
+        return this->template place<PlogReaction<CoeffType>,Base>(reaction);
+
+      case(ReactionType::CHEBYSHEV):
+        return this->template place<ChebyshevReaction<CoeffType>,Base>(reaction);
+
+      default:
+        {
+          _supported = false;
+        }
+
+      } // switch(reaction.type())
+
+    return NULL;
+  }
+
+  template<typename CoeffType>
+  inline
+  KineticsType<CoeffType>* ReactionArena<CoeffType>::place_rate( const KineticsType<CoeffType>& rate )
+  {
+    typedef KineticsType<CoeffType> Base;
+
+    switch(rate.type())
+      {
+      case(KineticsModel::CONSTANT):
+        return this->template place<ConstantRate<CoeffType>,Base>(rate);
+
+      case(KineticsModel::HERCOURT_ESSEN):
+        return this->template place<HercourtEssenRate<CoeffType>,Base>(rate);
+
+      case(KineticsModel::BERTHELOT):
+        return this->template place<BerthelotRate<CoeffType>,Base>(rate);
+
+      case(KineticsModel::ARRHENIUS):
+        return this->template place<ArrheniusRate<CoeffType>,Base>(rate);
+
+      case(KineticsModel::BHE):
+        return this->template place<BerthelotHercourtEssenRate<CoeffType>,Base>(rate);
+
+      case(KineticsModel::KOOIJ):
+        return this->template place<KooijRate<CoeffType>,Base>(rate);
+
+      case(KineticsModel::VANTHOFF):
+        return this->template place<VantHoffRate<CoeffType>,Base>(rate);
+
+      case(KineticsModel::PHOTOCHEM):
+        return this->template place<PhotochemicalRate<CoeffType,std::vector<CoeffType> >,Base>(rate);
+
+      default:
+        {
+          _supported = false;
+        }
+
+      } // switch(rate.type())
+
+    return NULL;
+  }
+
+  template<typename CoeffType>
+  template <typename T, typename BaseType>
+  inline
+  BaseType* ReactionArena<CoeffType>::place( const BaseType& object )
+  {
+    // a derived class, or another instantiation, would be sliced
+    if( typeid(object) != typeid(T) )
+      {
+        _supported = false;
+        return NULL;
+      }
+
+    void* memory = this->allocate(sizeof(T));
+    if( !memory )
+      return NULL;
+
+    return new (memory) T(static_cast<const T&>(object));
+  }
+
+  template<typename CoeffType>
+  inline
+  void* ReactionArena<CoeffType>::allocate( std::size_t n )
+  {
+    // new char[] returns a block aligned for any type, keep every slot so
+    const std::size_t alignment = alignof(std::max_align_t);
+    const std::size_t begin = ( _used + alignment - 1 ) / alignment * alignment;
+    _used = begin + n;
+
+    return ( _block ) ? static_cast<void*>(_block + begin) : NULL;
+  }
+
+  template<typename CoeffType>
+  inline
+  void ReactionArena<CoeffType>::destroy_objects( Reaction<CoeffType>* reaction )
+  {
+    // NULL if placing the rates was interrupted
+    for( unsigned int ir = 0; ir < reaction->_forward_rate.size(); ir++ )
+      if( reaction->_forward_rate[ir] )
+        reaction->_forward_rate[ir]->~KineticsType();
+
+    reaction->~Reaction();
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_REACTION_ARENA_H
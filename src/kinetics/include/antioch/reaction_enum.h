@@ -39,7 +39,9 @@ namespace Antioch
                         LINDEMANN_FALLOFF,
                         TROE_FALLOFF,
                         LINDEMANN_FALLOFF_THREE_BODY,
-                        TROE_FALLOFF_THREE_BODY};
+                        TROE_FALLOFF_THREE_BODY,
+                        PLOG,
+                        CHEBYSHEV};
 
   enum Parameters{ NOT_FOUND = 0,
                    EFFICIENCIES,
@@ -0,0 +1,133 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+#ifndef ANTIOCH_REACTION_PARAMETER_HANDLE_H
+#define ANTIOCH_REACTION_PARAMETER_HANDLE_H
+
+// Antioch
+#include "antioch/kinetics_enum.h"
+#include "antioch/reaction_enum.h"
+
+// C++
+#include <limits>
+
+namespace Antioch
+{
+  template<typename CoeffType>
+  class ReactionSet;
+
+  //! A parameter of a reaction of a ReactionSet, resolved once
+  /*!
+   * Built by ReactionSet::parameter_handle() from the same reaction id and
+   * keywords as ReactionSet::set_parameter_of_reaction(). The reaction,
+   * the parameter and the unit factor are looked up there, so that
+   * ReactionSet::set_parameter() and ReactionSet::get_parameter() involve
+   * no string handling. This is meant for sampling loops perturbing the
+   * same parameters many times.
+   *
+   * A handle refers to a reaction by index: it is invalidated by adding
+   * or removing reactions from the set.
+   */
+  template<typename CoeffType=double>
+  class ReactionParameterHandle
+  {
+  public:
+
+    //! Invalid handle, to be assigned from ReactionSet::parameter_handle()
+    ReactionParameterHandle();
+
+    //! Index of the reaction in the set
+    unsigned int reaction() const;
+
+    //! Kinetics model parameter, NOT_FOUND if chemical process parameter
+    KineticsModel::Parameters kinetics_parameter() const;
+
+    //! Chemical process parameter, NOT_FOUND if kinetics model parameter
+    ReactionType::Parameters chemical_parameter() const;
+
+  private:
+
+    friend class ReactionSet<CoeffType>;
+
+    unsigned int _reaction;
+
+    KineticsModel::Parameters _kinetics_parameter;
+
+    ReactionType::Parameters _chemical_parameter;
+
+    //! Which rate of a duplicate or falloff reaction
+    unsigned int _rate;
+
+    //! Index of a vectorized parameter, negative if scalar
+    int _l;
+
+    //! Species of an efficiency
+    unsigned int _species;
+
+    //! From the unit of the handle to SI
+    CoeffType _SI_factor;
+
+    //! Activation energy not in K, to be divided by R once in SI
+    bool _reduce_energy;
+  };
+
+  template<typename CoeffType>
+  inline
+  ReactionParameterHandle<CoeffType>::ReactionParameterHandle()
+    : _reaction(std::numeric_limits<unsigned int>::max()),
+      _kinetics_parameter(KineticsModel::Parameters::NOT_FOUND),
+      _chemical_parameter(ReactionType::Parameters::NOT_FOUND),
+      _rate(0),
+      _l(-1),
+      _species(std::numeric_limits<unsigned int>::max()),
+      _SI_factor(1),
+      _reduce_energy(false)
+  {}
+
+  template<typename CoeffType>
+  inline
+  unsigned int ReactionParameterHandle<CoeffType>::reaction() const
+  {
+    return _reaction;
+  }
+
+  template<typename CoeffType>
+  inline
+  KineticsModel::Parameters ReactionParameterHandle<CoeffType>::kinetics_parameter() const
+  {
+    return _kinetics_parameter;
+  }
+
+  template<typename CoeffType>
+  inline
+  ReactionType::Parameters ReactionParameterHandle<CoeffType>::chemical_parameter() const
+  {
+    return _chemical_parameter;
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_REACTION_PARAMETER_HANDLE_H
@@ -35,6 +35,8 @@
 #include "antioch/threebody_reaction.h"
 #include "antioch/falloff_reaction.h"
 #include "antioch/falloff_threebody_reaction.h"
+#include "antioch/plog_reaction.h"
+#include "antioch/chebyshev_reaction.h"
 
 namespace Antioch
 {
@@ -82,6 +84,7 @@ namespace Antioch
         {
           reaction = new FalloffReaction<CoeffType,LindemannFalloff<CoeffType> >(n_species,equation,reversible,type,kin);
         }
+        break;
       case(ReactionType::TROE_FALLOFF):
         {
           reaction = new FalloffReaction<CoeffType,TroeFalloff<CoeffType> >(n_species,equation,reversible,type,kin);
@@ -92,12 +95,25 @@ namespace Antioch
         {
           reaction = new FalloffThreeBodyReaction<CoeffType,LindemannFalloff<CoeffType> >(n_species,equation,reversible,type,kin);
         }
+        break;
       case(ReactionType::TROE_FALLOFF_THREE_BODY):
         {
           reaction = new FalloffThreeBodyReaction<CoeffType,TroeFalloff<CoeffType> >(n_species,equation,reversible,type,kin);
         }
         break;
 
+      case(ReactionType::PLOG):
+        {
+          reaction = new PlogReaction<CoeffType>(n_species,equation,reversible,kin);
+        }
+        break;
+
+      case(ReactionType::CHEBYSHEV):
+        {
+          reaction = new ChebyshevReaction<CoeffType>(n_species,equation,reversible,kin);
+        }
+        break;
+
       default:
         {
           antioch_error();
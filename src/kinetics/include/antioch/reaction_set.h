@@ -37,8 +37,15 @@
 #include "antioch/threebody_reaction.h"
 #include "antioch/falloff_reaction.h"
 #include "antioch/falloff_threebody_reaction.h"
+#include "antioch/plog_reaction.h"
+#include "antioch/chebyshev_reaction.h"
 #include "antioch/lindemann_falloff.h"
 #include "antioch/troe_falloff.h"
+#include "antioch/rate_coefficient_table.h"
+#include "antioch/reaction_arena.h"
+#include "antioch/equilibrium_factors.h"
+#include "antioch/active_reaction_subset.h"
+#include "antioch/reaction_parameter_handle.h"
 #include "antioch/string_utils.h"
 
 // C++
@@ -47,6 +54,7 @@
 #include <iomanip>
 #include <vector>
 #include <limits>
+#include <unordered_map>
 
 namespace Antioch
 {
@@ -72,24 +80,58 @@ namespace Antioch
     //! \returns the number of reactions.
     unsigned int n_reactions() const;
 
+    //! \returns the smallest change of moles \f$\gamma\f$ of the reactions, 0 if there are none.
+    int min_gamma() const;
+
+    //! \returns the largest change of moles \f$\gamma\f$ of the reactions, 0 if there are none.
+    int max_gamma() const;
+
     //! Add a reaction to the system.
     //
     // The ownership is transfered to the ReactionSet
     // object, they are deleted in the destructor.
     void add_reaction(Reaction<CoeffType>* reaction);
 
+    //! Add a reaction built by a parser
+    /*! As add_reaction(), but the reaction may then be moved by
+        finalize(): the pointer must not be kept by the caller. */
+    void add_parsed_reaction(Reaction<CoeffType>* reaction);
+
     //! remove a reaction from the system.
     //
     // The corresponding pointer is deleted
     void remove_reaction(unsigned int nr);
 
+    //! To be called once the reactions are added, the parsers do
+    /*!
+     * The reactions given to add_parsed_reaction() since the last call
+     * are laid out contiguously, with their rates and in evaluation order,
+     * in a ReactionArena owned by the set; the reactions given to
+     * add_reaction() and those packed before stay where they are. Indices
+     * and parameter handles are not affected. The rate table, if enabled,
+     * is then rebuilt if reactions have been added or removed.
+     */
+    void finalize();
+
+    //! Whether finalize() packs the parsed reactions, true by default
+    void set_reaction_packing(bool pack);
+
     //! \returns a constant reference to reaction \p r.
     const Reaction<CoeffType>& reaction(const unsigned int r) const;
 
     //! \returns a writeable reference to reaction \p r.
     Reaction<CoeffType>& reaction(const unsigned int r);
 
+    //! change the id of reaction \p r
+    /*! Keeps the hashed lookup of reaction_by_id() up to date; ids
+        changed through reaction(r).set_id() are found by a linear scan. */
+    void set_reaction_id(const unsigned int r, const std::string & reaction_id);
+
     //! \returns the index of a reaction given its id
+    /*! Hashed lookup; if several reactions share the id, the one of
+        lowest index is returned. Falls back to a linear scan over the
+        reactions if the id is not indexed or its entry is stale, after
+        reaction(r).set_id(). Read only, safe to call concurrently. */
     unsigned int reaction_by_id(const std::string & reaction_id) const;
 
     //! change a parameter of a reaction
@@ -103,8 +145,60 @@ namespace Antioch
     // in charge of the human-to-antioch translation
     CoeffType get_parameter_of_reaction(const std::string & reaction_id, const std::vector<std::string> & keywords) const;
 
+    //! resolve a parameter of a reaction once, for repeated get/set
+    /*!
+     * Same reaction id and keywords as set_parameter_of_reaction(), all
+     * the human-to-antioch translation happens here. The handle is
+     * invalidated by adding or removing reactions.
+     */
+    ReactionParameterHandle<CoeffType> parameter_handle(const std::string & reaction_id, const std::vector<std::string> & keywords) const;
+
+    //! resolve handles[i] from reaction_ids[i] and keywords[i]
+    void parameter_handles(const std::vector<std::string> & reaction_ids,
+                           const std::vector<std::vector<std::string> > & keywords,
+                           std::vector<ReactionParameterHandle<CoeffType> > & handles) const;
+
+    //! change a resolved parameter, value in the unit of the handle keywords
+    template <typename ParamType>
+    void set_parameter(const ReactionParameterHandle<CoeffType> & handle, ParamType value);
+
+    //! change all resolved parameters, handles[i] to values[i]
+    template <typename VectorParamType>
+    void set_parameters(const std::vector<ReactionParameterHandle<CoeffType> > & handles, const VectorParamType & values);
+
+    //! \return a resolved parameter, as get_parameter_of_reaction()
+    CoeffType get_parameter(const ReactionParameterHandle<CoeffType> & handle) const;
+
     const ChemicalMixture<CoeffType>& chemical_mixture() const;
 
+    //! Tabulate the forward rate coefficients over [T_min,T_max]
+    /*!
+     * The tabulated reactions (see RateCoefficientTable) are then evaluated
+     * from the table, and their derivatives from the interpolant, for scalar
+     * temperatures within the range. The other reactions and temperatures
+     * use the exact kinetics models. Adding or removing reactions suspends
+     * the table until finalize() rebuilds it, the reactions being evaluated
+     * exactly meanwhile. The entries of the reactions modified through
+     * set_parameter_of_reaction or set_parameter(s) are updated; after
+     * modifications through reaction(), enable_rate_table must be called again.
+     *
+     * Only the evaluations of ReactionSet, and of KineticsEvaluator through
+     * it, use the table. CompiledReactionSet, hence KineticsBatchEvaluator,
+     * always evaluates the exact kinetics models: with a table enabled, the
+     * same set gives slightly different k(T), within the tolerance, depending
+     * on the evaluator.
+     */
+    void enable_rate_table( const CoeffType T_min, const CoeffType T_max,
+                            const CoeffType tolerance,
+                            RateTableVariable::RateTableVariable variable = RateTableVariable::INVERSE_TEMPERATURE );
+
+    //! Go back to the exact evaluation of all the forward rate coefficients
+    void disable_rate_table();
+
+    //! \returns the rate table, NULL if not enabled
+    /*! Out of date between add_reaction() or remove_reaction() and finalize(). */
+    const RateCoefficientTable<CoeffType>* rate_table() const;
+
     //! Compute the rates of progress for each reaction
     template <typename StateType, typename VectorStateType, typename VectorReactionsType>
     void compute_reaction_rates( const KineticsConditions<StateType,VectorStateType>& conditions,
@@ -112,9 +206,67 @@ namespace Antioch
                                  const VectorStateType& h_RT_minus_s_R,
                                  VectorReactionsType& net_reaction_rates ) const;
 
+    //! Compute the rates of progress for each reaction
+    /*!
+     * As above, \p equilibrium_factors, built on this set, being updated
+     * here. Keeping them across calls saves their allocation.
+     */
+    template <typename StateType, typename VectorStateType, typename VectorReactionsType>
+    void compute_reaction_rates( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                 EquilibriumFactors<CoeffType,StateType>& equilibrium_factors,
+                                 const VectorStateType& molar_densities,
+                                 const VectorStateType& h_RT_minus_s_R,
+                                 VectorReactionsType& net_reaction_rates ) const;
+
+    //! Compute the rates of progress of the active reactions of \p subset
+    /*! The rates of the inactive reactions are set to zero. The rates
+        of the active ones are recorded in \p subset for its next update. */
+    template <typename StateType, typename VectorStateType, typename VectorReactionsType>
+    void compute_reaction_rates( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                 const VectorStateType& molar_densities,
+                                 const VectorStateType& h_RT_minus_s_R,
+                                 const ActiveReactionSubset<CoeffType>& subset,
+                                 VectorReactionsType& net_reaction_rates ) const;
+
+    //! Compute the rates of progress of the active reactions of \p subset
+    /*! As above, with \p equilibrium_factors as work storage. */
+    template <typename StateType, typename VectorStateType, typename VectorReactionsType>
+    void compute_reaction_rates( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                 EquilibriumFactors<CoeffType,StateType>& equilibrium_factors,
+                                 const VectorStateType& molar_densities,
+                                 const VectorStateType& h_RT_minus_s_R,
+                                 const ActiveReactionSubset<CoeffType>& subset,
+                                 VectorReactionsType& net_reaction_rates ) const;
+
+    //! Compute the larger of the forward and backward rates of progress of each reaction
+    /*!
+     * \f$ \max(|k_f \prod_r [X_r]^{o_r}|, |k_b \prod_p [X_p]^{o_p}|) \f$ bounds the
+     * net rate and, unlike it, does not vanish for a fast reaction in partial
+     * equilibrium; it measures the importance of the reaction, see ActiveReactionSubset.
+     * \p equilibrium_factors is work storage, as in compute_reaction_rates.
+     */
+    template <typename StateType, typename VectorStateType, typename VectorReactionsType>
+    void compute_reaction_activities( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                      EquilibriumFactors<CoeffType,StateType>& equilibrium_factors,
+                                      const VectorStateType& molar_densities,
+                                      const VectorStateType& h_RT_minus_s_R,
+                                      VectorReactionsType& activities ) const;
+
+    //! Compute the rates of progress and derivatives for each reaction
+    template <typename StateType, typename VectorStateType, typename VectorReactionsType, typename MatrixReactionsType>
+    void compute_reaction_rates_and_derivs( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                            const VectorStateType& molar_densities,
+                                            const VectorStateType& h_RT_minus_s_R,
+                                            const VectorStateType& dh_RT_minus_s_R_dT,
+                                            VectorReactionsType& net_reaction_rates,
+                                            VectorReactionsType& dnet_rate_dT,
+                                            MatrixReactionsType& dnet_rate_dX_s ) const;
+
     //! Compute the rates of progress and derivatives for each reaction
+    /*! As above, with \p equilibrium_factors as work storage. */
     template <typename StateType, typename VectorStateType, typename VectorReactionsType, typename MatrixReactionsType>
     void compute_reaction_rates_and_derivs( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                            EquilibriumFactors<CoeffType,StateType>& equilibrium_factors,
                                             const VectorStateType& molar_densities,
                                             const VectorStateType& h_RT_minus_s_R,
                                             const VectorStateType& dh_RT_minus_s_R_dT,
@@ -122,6 +274,44 @@ namespace Antioch
                                             VectorReactionsType& dnet_rate_dT,
                                             MatrixReactionsType& dnet_rate_dX_s ) const;
 
+    //! Compute the rate of progress and derivatives of reaction \p rxn
+    /*!
+     * Allows to consume the derivatives reaction by reaction, without
+     * storing the n_reactions x n_species matrix. \p dnet_rate_dX_s
+     * is of size n_species; only the entries of the species the rate
+     * depends on are written, see
+     * Reaction::compute_rate_of_progress_and_derivatives_from_kfwd(),
+     * so that the cost follows the size of the reaction.
+     */
+    template <typename StateType, typename VectorStateType>
+    void compute_reaction_rate_and_derivs( const unsigned int rxn,
+                                           const KineticsConditions<StateType,VectorStateType>& conditions,
+                                           const VectorStateType& molar_densities,
+                                           const VectorStateType& h_RT_minus_s_R,
+                                           const VectorStateType& dh_RT_minus_s_R_dT,
+                                           StateType& net_reaction_rate,
+                                           StateType& dnet_rate_dT,
+                                           VectorStateType& dnet_rate_dX_s ) const;
+
+    //! Compute the rate of progress and derivatives of reaction \p rxn
+    /*!
+     * As above, with the equilibrium constant assembled from \p equilibrium_factors,
+     * updated at the temperature of \p conditions, and the third-body concentration
+     * from \p total_concentration, see total_concentration(). Evaluating both once
+     * avoids computing the species exponentials and sums for each reaction.
+     */
+    template <typename StateType, typename VectorStateType>
+    void compute_reaction_rate_and_derivs( const unsigned int rxn,
+                                           const KineticsConditions<StateType,VectorStateType>& conditions,
+                                           const EquilibriumFactors<CoeffType,StateType>& equilibrium_factors,
+                                           const StateType& total_concentration,
+                                           const VectorStateType& molar_densities,
+                                           const VectorStateType& h_RT_minus_s_R,
+                                           const VectorStateType& dh_RT_minus_s_R_dT,
+                                           StateType& net_reaction_rate,
+                                           StateType& dnet_rate_dT,
+                                           VectorStateType& dnet_rate_dX_s ) const;
+
     //!
     template <typename StateType, typename VectorStateType>
     void print_chemical_scheme( std::ostream& output,
@@ -178,13 +368,127 @@ namespace Antioch
     // This function is used for both getter and setter.
     void find_chemical_process_parameter(ReactionType::Parameters paramChem ,const std::vector<std::string> & keywords, unsigned int & species) const;
 
+    //! set_parameter() without the rate table update
+    void apply_parameter(const ReactionParameterHandle<CoeffType> & handle, CoeffType value);
+
+    //! tabulate again the reaction of \p handle, after apply_parameter()
+    void update_rate_table(const ReactionParameterHandle<CoeffType> & handle);
+
+    //! Location of \p T in the rate table, false if the table can not be used
+    //
+    // The table is only used for scalar temperatures.
+    template <typename StateType>
+    bool locate_in_rate_table( const StateType& T,
+                               typename RateCoefficientTable<CoeffType>::Location& location ) const;
+
+    bool locate_in_rate_table( const CoeffType& T,
+                               typename RateCoefficientTable<CoeffType>::Location& location ) const;
+
+    //! Forward rate coefficient of reaction \p rxn from the rate table, false if not tabulated
+    template <typename StateType, typename VectorStateType>
+    bool tabulated_forward_rate_coefficient( const unsigned int rxn,
+                                             const KineticsConditions<StateType,VectorStateType>& conditions,
+                                             const typename RateCoefficientTable<CoeffType>::Location& location,
+                                             const VectorStateType& molar_densities,
+                                             const StateType& total_concentration,
+                                             StateType& kfwd ) const;
+
+    template <typename VectorStateType>
+    bool tabulated_forward_rate_coefficient( const unsigned int rxn,
+                                             const KineticsConditions<CoeffType,VectorStateType>& conditions,
+                                             const typename RateCoefficientTable<CoeffType>::Location& location,
+                                             const VectorStateType& molar_densities,
+                                             const CoeffType& total_concentration,
+                                             CoeffType& kfwd ) const;
+
+    //! Forward rate coefficient and derivatives of reaction \p rxn from the rate table, false if not tabulated
+    template <typename StateType, typename VectorStateType>
+    bool tabulated_forward_rate_coefficient_and_derivatives( const unsigned int rxn,
+                                                             const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                             const typename RateCoefficientTable<CoeffType>::Location& location,
+                                                             const VectorStateType& molar_densities,
+                                                             const StateType& total_concentration,
+                                                             StateType& kfwd,
+                                                             StateType& dkfwd_dT,
+                                                             VectorStateType& dkfwd_dX_s ) const;
+
+    template <typename VectorStateType>
+    bool tabulated_forward_rate_coefficient_and_derivatives( const unsigned int rxn,
+                                                             const KineticsConditions<CoeffType,VectorStateType>& conditions,
+                                                             const typename RateCoefficientTable<CoeffType>::Location& location,
+                                                             const VectorStateType& molar_densities,
+                                                             const CoeffType& total_concentration,
+                                                             CoeffType& kfwd,
+                                                             CoeffType& dkfwd_dT,
+                                                             VectorStateType& dkfwd_dX_s ) const;
+
+    //! Forward rate coefficient of reaction \p rxn, from the rate table if \p use_table
+    template <typename StateType, typename VectorStateType>
+    StateType forward_rate_coefficient( const unsigned int rxn,
+                                        const KineticsConditions<StateType,VectorStateType>& conditions,
+                                        const bool use_table,
+                                        const typename RateCoefficientTable<CoeffType>::Location& location,
+                                        const VectorStateType& molar_densities,
+                                        const StateType& total_concentration ) const;
+
+    //! Forward rate coefficient and derivatives of reaction \p rxn, from the rate table if \p use_table
+    /*! \p dkfwd_dX_s is only written if Reaction::rate_coefficient_depends_on_concentrations(). */
+    template <typename StateType, typename VectorStateType>
+    void forward_rate_coefficient_and_derivatives( const unsigned int rxn,
+                                                   const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                   const bool use_table,
+                                                   const typename RateCoefficientTable<CoeffType>::Location& location,
+                                                   const VectorStateType& molar_densities,
+                                                   const StateType& total_concentration,
+                                                   StateType& kfwd,
+                                                   StateType& dkfwd_dT,
+                                                   VectorStateType& dkfwd_dX_s ) const;
+
     const ChemicalMixture<CoeffType>& _chem_mixture;
 
     std::vector<Reaction<CoeffType>* > _reactions;
 
+    //! delete \p reaction, or destroy it in its arena
+    void destroy_reaction(Reaction<CoeffType>* reaction);
+
+    //! Move the reactions flagged in _movable to a new arena
+    /*! Nothing is moved if one of them is not of a type the arena can
+        copy (ReactionArena::can_place()); they are not tried again. */
+    void pack_reactions();
+
+    //! Rebuild _reaction_index from the reactions ids
+    void build_reaction_index();
+
+    //! Rescan the reactions for _min_gamma and _max_gamma
+    void update_gamma_range();
+
+    //! Index of the first reaction carrying each id
+    /*! Kept up to date by add_reaction(), remove_reaction() and
+        set_reaction_id(). */
+    std::unordered_map<std::string,unsigned int> _reaction_index;
+
+    //! Range of the reactions gamma, sizes the EquilibriumFactors
+    int _min_gamma;
+    int _max_gamma;
+
     //! Scaling for equilibrium constant
     const CoeffType _P0_R;
 
+    //! Optional table of the forward rate coefficients
+    RateCoefficientTable<CoeffType>* _rate_table;
+
+    //! true if reactions were added or removed since the table was built
+    bool _rate_table_stale;
+
+    //! true for the reactions of add_parsed_reaction() not packed yet
+    std::vector<bool> _movable;
+
+    //! whether finalize() packs the parsed reactions
+    bool _pack_reactions;
+
+    //! Storage of the reactions packed by each finalize()
+    std::vector<ReactionArena<CoeffType>*> _arenas;
+
   };
 
   /* ------------------------- Inline Functions -------------------------*/
@@ -202,18 +506,56 @@ namespace Antioch
     return _reactions.size();
   }
 
+  template<typename CoeffType>
+  inline
+  int ReactionSet<CoeffType>::min_gamma() const
+  {
+    return _min_gamma;
+  }
+
+  template<typename CoeffType>
+  inline
+  int ReactionSet<CoeffType>::max_gamma() const
+  {
+    return _max_gamma;
+  }
+
   template<typename CoeffType>
   inline
   void ReactionSet<CoeffType>::add_reaction(Reaction<CoeffType>* reaction)
   {
     _reactions.push_back(reaction);
+    _movable.push_back(false);
+
+    // the names of its species are the mixture's
+    _reactions.back()->set_chemical_mixture(_chem_mixture);
 
     // and make sure it is initialized!
     _reactions.back()->initialize(_reactions.size() - 1);
 
+    // keeps the first reaction of a given id
+    _reaction_index.insert( std::make_pair( reaction->id(), _reactions.size() - 1 ) );
+
+    const int gamma = reaction->gamma();
+    if( _reactions.size() == 1 || gamma < _min_gamma )
+      _min_gamma = gamma;
+    if( _reactions.size() == 1 || gamma > _max_gamma )
+      _max_gamma = gamma;
+
+    // retabulating the whole set for each reaction would be quadratic
+    _rate_table_stale = true;
+
     return;
   }
 
+  template<typename CoeffType>
+  inline
+  void ReactionSet<CoeffType>::add_parsed_reaction(Reaction<CoeffType>* reaction)
+  {
+    this->add_reaction(reaction);
+    _movable.back() = true;
+  }
+
   template<typename CoeffType>
   inline
   void ReactionSet<CoeffType>::remove_reaction(unsigned int nr)
@@ -221,10 +563,18 @@ namespace Antioch
      antioch_assert_less(nr,_reactions.size());
 
      //first clear the memory
-     delete _reactions[nr];
+     this->destroy_reaction(_reactions[nr]);
 
      //second, release the spot
      _reactions.erase(_reactions.begin() + nr);
+     _movable.erase(_movable.begin() + nr);
+
+     // the following reactions moved
+     this->build_reaction_index();
+
+     this->update_gamma_range();
+
+     _rate_table_stale = true;
   }
 
   template<typename CoeffType>
@@ -255,7 +605,12 @@ namespace Antioch
   inline
   ReactionSet<CoeffType>::ReactionSet( const ChemicalMixture<CoeffType>& chem_mixture )
     : _chem_mixture(chem_mixture),
-      _P0_R(1.0e5/Constants::R_universal<CoeffType>()) //SI
+      _min_gamma(0),
+      _max_gamma(0),
+      _P0_R(1.0e5/Constants::R_universal<CoeffType>()), //SI
+      _rate_table(NULL),
+      _rate_table_stale(false),
+      _pack_reactions(true)
   {
     return;
   }
@@ -265,10 +620,265 @@ namespace Antioch
   inline
   ReactionSet<CoeffType>::~ReactionSet()
   {
-    for(unsigned int ir = 0; ir < _reactions.size(); ir++)delete _reactions[ir];
+    for(unsigned int ir = 0; ir < _reactions.size(); ir++)
+      this->destroy_reaction(_reactions[ir]);
+    for(unsigned int a = 0; a < _arenas.size(); a++)
+      delete _arenas[a];
+    delete _rate_table;
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  void ReactionSet<CoeffType>::destroy_reaction(Reaction<CoeffType>* reaction)
+  {
+    for(unsigned int a = 0; a < _arenas.size(); a++)
+      if( _arenas[a]->owns(reaction) )
+        {
+          _arenas[a]->destroy(reaction);
+          return;
+        }
+
+    delete reaction;
+  }
+
+  template<typename CoeffType>
+  inline
+  void ReactionSet<CoeffType>::finalize()
+  {
+    if( _pack_reactions )
+      this->pack_reactions();
+
+    if( _rate_table && _rate_table_stale )
+      _rate_table->tabulate();
+    _rate_table_stale = false;
+  }
+
+  template<typename CoeffType>
+  inline
+  void ReactionSet<CoeffType>::set_reaction_packing(bool pack)
+  {
+    _pack_reactions = pack;
+  }
+
+  template<typename CoeffType>
+  inline
+  void ReactionSet<CoeffType>::pack_reactions()
+  {
+    std::vector<unsigned int> indices;
+    std::vector<Reaction<CoeffType>* > movable;
+    for(unsigned int ir = 0; ir < _reactions.size(); ir++)
+      if( _movable[ir] )
+        {
+          indices.push_back(ir);
+          movable.push_back(_reactions[ir]);
+          _movable[ir] = false;
+        }
+
+    if( movable.empty() || !ReactionArena<CoeffType>::can_place(movable) )
+      return;
+
+    // nothing is released before all the copies are made
+    std::vector<Reaction<CoeffType>* > relocated;
+    _arenas.push_back( new ReactionArena<CoeffType>(movable,relocated) );
+
+    // never packed before, the originals are on the heap
+    for(unsigned int i = 0; i < indices.size(); i++)
+      {
+        delete _reactions[indices[i]];
+        _reactions[indices[i]] = relocated[i];
+      }
+  }
+
+  template<typename CoeffType>
+  inline
+  void ReactionSet<CoeffType>::enable_rate_table( const CoeffType T_min, const CoeffType T_max,
+                                                  const CoeffType tolerance,
+                                                  RateTableVariable::RateTableVariable variable )
+  {
+    this->disable_rate_table();
+    _rate_table = new RateCoefficientTable<CoeffType>( *this, T_min, T_max, tolerance, variable );
+    _rate_table_stale = false;
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  void ReactionSet<CoeffType>::disable_rate_table()
+  {
+    delete _rate_table;
+    _rate_table = NULL;
     return;
   }
 
+  template<typename CoeffType>
+  inline
+  const RateCoefficientTable<CoeffType>* ReactionSet<CoeffType>::rate_table() const
+  {
+    return _rate_table;
+  }
+
+  template<typename CoeffType>
+  template <typename StateType>
+  inline
+  bool ReactionSet<CoeffType>::locate_in_rate_table( const StateType& /*T*/,
+                                                     typename RateCoefficientTable<CoeffType>::Location& /*location*/ ) const
+  {
+    return false;
+  }
+
+  template<typename CoeffType>
+  inline
+  bool ReactionSet<CoeffType>::locate_in_rate_table( const CoeffType& T,
+                                                     typename RateCoefficientTable<CoeffType>::Location& location ) const
+  {
+    return _rate_table && !_rate_table_stale && _rate_table->locate(T, location);
+  }
+
+  template<typename CoeffType>
+  template <typename StateType, typename VectorStateType>
+  inline
+  bool ReactionSet<CoeffType>::tabulated_forward_rate_coefficient( const unsigned int /*rxn*/,
+                                                                   const KineticsConditions<StateType,VectorStateType>& /*conditions*/,
+                                                                   const typename RateCoefficientTable<CoeffType>::Location& /*location*/,
+                                                                   const VectorStateType& /*molar_densities*/,
+                                                                   const StateType& /*total_concentration*/,
+                                                                   StateType& /*kfwd*/ ) const
+  {
+    return false;
+  }
+
+  template<typename CoeffType>
+  template <typename VectorStateType>
+  inline
+  bool ReactionSet<CoeffType>::tabulated_forward_rate_coefficient( const unsigned int rxn,
+                                                                   const KineticsConditions<CoeffType,VectorStateType>& /*conditions*/,
+                                                                   const typename RateCoefficientTable<CoeffType>::Location& location,
+                                                                   const VectorStateType& molar_densities,
+                                                                   const CoeffType& total_concentration,
+                                                                   CoeffType& kfwd ) const
+  {
+    if( !_rate_table->tabulated(rxn) )
+      return false;
+
+    const Reaction<CoeffType>& reaction = this->reaction(rxn);
+
+    kfwd = _rate_table->rate_coefficient(rxn, location);
+
+    // k(T,[M]) = (sum eff_i * C_i) * k(T), as ThreeBodyReaction
+    if( reaction.type() == ReactionType::THREE_BODY )
+      kfwd = reaction.third_body_concentration( molar_densities, total_concentration ) * kfwd;
+
+    return true;
+  }
+
+  template<typename CoeffType>
+  template <typename StateType, typename VectorStateType>
+  inline
+  bool ReactionSet<CoeffType>::tabulated_forward_rate_coefficient_and_derivatives( const unsigned int /*rxn*/,
+                                                                                   const KineticsConditions<StateType,VectorStateType>& /*conditions*/,
+                                                                                   const typename RateCoefficientTable<CoeffType>::Location& /*location*/,
+                                                                                   const VectorStateType& /*molar_densities*/,
+                                                                                   const StateType& /*total_concentration*/,
+                                                                                   StateType& /*kfwd*/,
+                                                                                   StateType& /*dkfwd_dT*/,
+                                                                                   VectorStateType& /*dkfwd_dX_s*/ ) const
+  {
+    return false;
+  }
+
+  template<typename CoeffType>
+  template <typename VectorStateType>
+  inline
+  bool ReactionSet<CoeffType>::tabulated_forward_rate_coefficient_and_derivatives( const unsigned int rxn,
+                                                                                   const KineticsConditions<CoeffType,VectorStateType>& /*conditions*/,
+                                                                                   const typename RateCoefficientTable<CoeffType>::Location& location,
+                                                                                   const VectorStateType& molar_densities,
+                                                                                   const CoeffType& total_concentration,
+                                                                                   CoeffType& kfwd,
+                                                                                   CoeffType& dkfwd_dT,
+                                                                                   VectorStateType& dkfwd_dX_s ) const
+  {
+    if( !_rate_table->tabulated(rxn) )
+      return false;
+
+    const Reaction<CoeffType>& reaction = this->reaction(rxn);
+
+    _rate_table->rate_coefficient_and_derivative(rxn, location, kfwd, dkfwd_dT);
+
+    // dkfwd_dX_s only exists for three-body reactions, see forward_rate_coefficient_and_derivatives()
+    // dk_dT = dalpha_dT * [sum_s (eps_s * X_s)], dk_dCi = alpha(T) * eps_i, as ThreeBodyReaction
+    if( reaction.type() == ReactionType::THREE_BODY )
+      {
+        const CoeffType M = reaction.third_body_concentration( molar_densities, total_concentration );
+
+        for( unsigned int s = 0; s < this->n_species(); s++ )
+          dkfwd_dX_s[s] = kfwd;
+
+        for( unsigned int k = 0; k < reaction.n_efficiency_corrections(); k++ )
+          dkfwd_dX_s[reaction.efficiency_correction_species(k)] *= reaction.efficiency_correction(k);
+
+        kfwd *= M;
+        dkfwd_dT *= M;
+      }
+
+    return true;
+  }
+
+  template<typename CoeffType>
+  template <typename StateType, typename VectorStateType>
+  inline
+  StateType ReactionSet<CoeffType>::forward_rate_coefficient( const unsigned int rxn,
+                                                              const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                              const bool use_table,
+                                                              const typename RateCoefficientTable<CoeffType>::Location& location,
+                                                              const VectorStateType& molar_densities,
+                                                              const StateType& total_concentration ) const
+  {
+    StateType kfwd = Antioch::zero_clone(conditions.T());
+
+    if( use_table &&
+        this->tabulated_forward_rate_coefficient( rxn, conditions, location, molar_densities,
+                                                  total_concentration, kfwd ) )
+      return kfwd;
+
+    kfwd = this->reaction(rxn).compute_forward_rate_coefficient(molar_densities,conditions,total_concentration);
+    if (has_nan(kfwd))
+      antioch_error();
+
+    return kfwd;
+  }
+
+  template<typename CoeffType>
+  template <typename StateType, typename VectorStateType>
+  inline
+  void ReactionSet<CoeffType>::forward_rate_coefficient_and_derivatives( const unsigned int rxn,
+                                                                         const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                                         const bool use_table,
+                                                                         const typename RateCoefficientTable<CoeffType>::Location& location,
+                                                                         const VectorStateType& molar_densities,
+                                                                         const StateType& total_concentration,
+                                                                         StateType& kfwd,
+                                                                         StateType& dkfwd_dT,
+                                                                         VectorStateType& dkfwd_dX_s ) const
+  {
+    if( use_table &&
+        this->tabulated_forward_rate_coefficient_and_derivatives( rxn, conditions, location, molar_densities,
+                                                                  total_concentration, kfwd, dkfwd_dT, dkfwd_dX_s ) )
+      return;
+
+    const Reaction<CoeffType>& reaction = this->reaction(rxn);
+
+    if( !reaction.rate_coefficient_depends_on_concentrations() )
+      {
+        reaction.compute_forward_rate_coefficient_and_derivative( conditions, kfwd, dkfwd_dT );
+        return;
+      }
+
+    reaction.compute_forward_rate_coefficient_and_derivatives( molar_densities, conditions, total_concentration,
+                                                               kfwd, dkfwd_dT, dkfwd_dX_s );
+  }
+
   template<typename CoeffType>
   template<typename StateType, typename VectorStateType, typename VectorReactionsType>
   inline
@@ -276,6 +886,21 @@ namespace Antioch
                                                         const VectorStateType& molar_densities,
                                                         const VectorStateType& h_RT_minus_s_R,
                                                         VectorReactionsType& net_reaction_rates ) const
+  {
+    EquilibriumFactors<CoeffType,StateType> equilibrium_factors( *this, conditions.T() );
+
+    this->compute_reaction_rates( conditions, equilibrium_factors, molar_densities, h_RT_minus_s_R,
+                                  net_reaction_rates );
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType, typename VectorReactionsType>
+  inline
+  void ReactionSet<CoeffType>::compute_reaction_rates ( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                        EquilibriumFactors<CoeffType,StateType>& equilibrium_factors,
+                                                        const VectorStateType& molar_densities,
+                                                        const VectorStateType& h_RT_minus_s_R,
+                                                        VectorReactionsType& net_reaction_rates ) const
   {
     antioch_assert_equal_to( net_reaction_rates.size(), this->n_reactions() );
 
@@ -285,13 +910,147 @@ namespace Antioch
     antioch_assert_equal_to( molar_densities.size(), this->n_species() );
     antioch_assert_equal_to( h_RT_minus_s_R.size(), this->n_species() );
 
-    // useful constants
-    const StateType P0_RT = _P0_R/conditions.T(); // used to transform equilibrium constant from pressure units
+    // species exponentials and powers of P0/(RT), shared by the equilibrium constants
+    equilibrium_factors.update( conditions.T(), h_RT_minus_s_R );
+
+    // [M] before the efficiency corrections, shared by the third-body and falloff reactions
+    const StateType total_concentration = Antioch::total_concentration<StateType>( molar_densities );
+
+    typename RateCoefficientTable<CoeffType>::Location location;
+    const bool use_table = this->locate_in_rate_table(conditions.T(), location);
 
     // compute reaction forward rates & other reaction-sized arrays
     for (unsigned int rxn=0; rxn<this->n_reactions(); rxn++)
       {
-        net_reaction_rates[rxn] = this->reaction(rxn).compute_rate_of_progress(molar_densities, conditions, P0_RT, h_RT_minus_s_R);
+        const Reaction<CoeffType>& reaction = this->reaction(rxn);
+
+        const StateType kfwd = this->forward_rate_coefficient( rxn, conditions, use_table, location,
+                                                               molar_densities, total_concentration );
+
+        StateType keq = Antioch::zero_clone(kfwd);
+        if( reaction.reversible() )
+          keq = reaction.equilibrium_constant( equilibrium_factors, h_RT_minus_s_R );
+
+        net_reaction_rates[rxn] = reaction.compute_rate_of_progress_from_kfwd( molar_densities, kfwd, keq );
+      }
+
+    return;
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType, typename VectorReactionsType>
+  inline
+  void ReactionSet<CoeffType>::compute_reaction_rates ( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                        const VectorStateType& molar_densities,
+                                                        const VectorStateType& h_RT_minus_s_R,
+                                                        const ActiveReactionSubset<CoeffType>& subset,
+                                                        VectorReactionsType& net_reaction_rates ) const
+  {
+    EquilibriumFactors<CoeffType,StateType> equilibrium_factors( *this, conditions.T() );
+
+    this->compute_reaction_rates( conditions, equilibrium_factors, molar_densities, h_RT_minus_s_R,
+                                  subset, net_reaction_rates );
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType, typename VectorReactionsType>
+  inline
+  void ReactionSet<CoeffType>::compute_reaction_rates ( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                        EquilibriumFactors<CoeffType,StateType>& equilibrium_factors,
+                                                        const VectorStateType& molar_densities,
+                                                        const VectorStateType& h_RT_minus_s_R,
+                                                        const ActiveReactionSubset<CoeffType>& subset,
+                                                        VectorReactionsType& net_reaction_rates ) const
+  {
+    antioch_assert_equal_to( net_reaction_rates.size(), this->n_reactions() );
+    antioch_assert_equal_to( subset.n_reactions(), this->n_reactions() );
+    antioch_assert_equal_to( molar_densities.size(), this->n_species() );
+    antioch_assert_equal_to( h_RT_minus_s_R.size(), this->n_species() );
+
+    Antioch::set_zero(net_reaction_rates);
+
+    equilibrium_factors.update( conditions.T(), h_RT_minus_s_R );
+
+    const StateType total_concentration = Antioch::total_concentration<StateType>( molar_densities );
+
+    typename RateCoefficientTable<CoeffType>::Location location;
+    const bool use_table = this->locate_in_rate_table(conditions.T(), location);
+
+    // same as compute_reaction_rates, over the active reactions only,
+    // recording the rates for the next update of the subset
+    const std::vector<unsigned int>& active_reactions = subset.active_reactions();
+    for (unsigned int i=0; i<active_reactions.size(); i++)
+      {
+        const unsigned int rxn = active_reactions[i];
+        const Reaction<CoeffType>& reaction = this->reaction(rxn);
+
+        const StateType kfwd = this->forward_rate_coefficient( rxn, conditions, use_table, location,
+                                                               molar_densities, total_concentration );
+
+        StateType keq = Antioch::zero_clone(kfwd);
+        if( reaction.reversible() )
+          keq = reaction.equilibrium_constant( equilibrium_factors, h_RT_minus_s_R );
+
+        StateType fwd_rate = Antioch::zero_clone(kfwd);
+        StateType bkwd_rate = Antioch::zero_clone(kfwd);
+        reaction.compute_forward_and_backward_rates_from_kfwd( molar_densities, kfwd, keq, fwd_rate, bkwd_rate );
+
+        StateType kbkwd = Antioch::zero_clone(kfwd);
+        if( reaction.reversible() )
+          {
+            net_reaction_rates[rxn] = fwd_rate - bkwd_rate;
+            kbkwd = Antioch::if_else( keq != Antioch::zero_clone(keq), StateType(kfwd/keq), kbkwd );
+          }
+        else
+          net_reaction_rates[rxn] = fwd_rate;
+
+        subset.record_rates( rxn, fwd_rate, bkwd_rate, kbkwd );
+      }
+
+    return;
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType, typename VectorReactionsType>
+  inline
+  void ReactionSet<CoeffType>::compute_reaction_activities( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                            EquilibriumFactors<CoeffType,StateType>& equilibrium_factors,
+                                                            const VectorStateType& molar_densities,
+                                                            const VectorStateType& h_RT_minus_s_R,
+                                                            VectorReactionsType& activities ) const
+  {
+    using std::abs;
+
+    antioch_assert_equal_to( activities.size(), this->n_reactions() );
+    antioch_assert_equal_to( molar_densities.size(), this->n_species() );
+    antioch_assert_equal_to( h_RT_minus_s_R.size(), this->n_species() );
+
+    equilibrium_factors.update( conditions.T(), h_RT_minus_s_R );
+
+    const StateType total_concentration = Antioch::total_concentration<StateType>( molar_densities );
+
+    typename RateCoefficientTable<CoeffType>::Location location;
+    const bool use_table = this->locate_in_rate_table(conditions.T(), location);
+
+    // same rates as compute_reaction_rates, before the difference
+    for (unsigned int rxn=0; rxn<this->n_reactions(); rxn++)
+      {
+        const Reaction<CoeffType>& reaction = this->reaction(rxn);
+
+        const StateType kfwd = this->forward_rate_coefficient( rxn, conditions, use_table, location,
+                                                               molar_densities, total_concentration );
+
+        StateType keq = Antioch::zero_clone(kfwd);
+        if( reaction.reversible() )
+          keq = reaction.equilibrium_constant( equilibrium_factors, h_RT_minus_s_R );
+
+        StateType fwd_rate = Antioch::zero_clone(kfwd);
+        StateType bkwd_rate = Antioch::zero_clone(kfwd);
+        reaction.compute_forward_and_backward_rates_from_kfwd( molar_densities, kfwd, keq, fwd_rate, bkwd_rate );
+
+        fwd_rate = abs(fwd_rate);
+        bkwd_rate = abs(bkwd_rate);
+        activities[rxn] = Antioch::if_else( fwd_rate > bkwd_rate, fwd_rate, bkwd_rate );
       }
 
     return;
@@ -307,6 +1066,25 @@ namespace Antioch
                                                                   VectorReactionsType& net_reaction_rates,
                                                                   VectorReactionsType& dnet_rate_dT,
                                                                   MatrixReactionsType& dnet_rate_dX_s ) const
+  {
+    EquilibriumFactors<CoeffType,StateType> equilibrium_factors( *this, conditions.T() );
+
+    this->compute_reaction_rates_and_derivs( conditions, equilibrium_factors, molar_densities,
+                                             h_RT_minus_s_R, dh_RT_minus_s_R_dT,
+                                             net_reaction_rates, dnet_rate_dT, dnet_rate_dX_s );
+  }
+
+  template<typename CoeffType>
+  template<typename StateType, typename VectorStateType, typename VectorReactionsType, typename MatrixReactionsType>
+  inline
+  void ReactionSet<CoeffType>::compute_reaction_rates_and_derivs( const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                                  EquilibriumFactors<CoeffType,StateType>& equilibrium_factors,
+                                                                  const VectorStateType& molar_densities,
+                                                                  const VectorStateType& h_RT_minus_s_R,
+                                                                  const VectorStateType& dh_RT_minus_s_R_dT,
+                                                                  VectorReactionsType& net_reaction_rates,
+                                                                  VectorReactionsType& dnet_rate_dT,
+                                                                  MatrixReactionsType& dnet_rate_dX_s ) const
   {
     antioch_assert_equal_to( net_reaction_rates.size(), this->n_reactions() );
     antioch_assert_equal_to( dnet_rate_dT.size(), this->n_reactions() );
@@ -325,27 +1103,165 @@ namespace Antioch
     antioch_assert_equal_to( molar_densities.size(), this->n_species() );
     antioch_assert_equal_to( h_RT_minus_s_R.size(), this->n_species() );
 
-    // useful constants
-    const StateType P0_RT = _P0_R/conditions.T(); // used to transform equilibrium constant from pressure units
+    // species exponentials and powers of P0/(RT), shared by the equilibrium constants
+    equilibrium_factors.update( conditions.T(), h_RT_minus_s_R );
+
+    // [M] before the efficiency corrections, shared by the third-body and falloff reactions
+    const StateType total_concentration = Antioch::total_concentration<StateType>( molar_densities );
 
     // compute reaction forward rates & other reaction-sized arrays
     for (unsigned int rxn=0; rxn<this->n_reactions(); rxn++)
       {
-        this->reaction(rxn).compute_rate_of_progress_and_derivatives( molar_densities, _chem_mixture,
-                                                                      conditions, P0_RT, h_RT_minus_s_R, dh_RT_minus_s_R_dT,
-                                                                      net_reaction_rates[rxn],
-                                                                      dnet_rate_dT[rxn],
-                                                                      dnet_rate_dX_s[rxn] );
+        // only the species the rate depends on are written
+        Antioch::set_zero(dnet_rate_dX_s[rxn]);
+
+        this->compute_reaction_rate_and_derivs( rxn, conditions, equilibrium_factors, total_concentration,
+                                                molar_densities, h_RT_minus_s_R, dh_RT_minus_s_R_dT,
+                                                net_reaction_rates[rxn],
+                                                dnet_rate_dT[rxn],
+                                                dnet_rate_dX_s[rxn] );
       }
 
     return;
   }
 
+  template<typename CoeffType>
+  template <typename StateType, typename VectorStateType>
+  inline
+  void ReactionSet<CoeffType>::compute_reaction_rate_and_derivs( const unsigned int rxn,
+                                                                 const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                                 const VectorStateType& molar_densities,
+                                                                 const VectorStateType& h_RT_minus_s_R,
+                                                                 const VectorStateType& dh_RT_minus_s_R_dT,
+                                                                 StateType& net_reaction_rate,
+                                                                 StateType& dnet_rate_dT,
+                                                                 VectorStateType& dnet_rate_dX_s ) const
+  {
+    antioch_assert_less( rxn, this->n_reactions() );
+    antioch_assert_equal_to( dnet_rate_dX_s.size(), this->n_species() );
+    antioch_assert_equal_to( molar_densities.size(), this->n_species() );
+    antioch_assert_equal_to( h_RT_minus_s_R.size(), this->n_species() );
+
+    const StateType P0_RT = _P0_R/conditions.T(); // used to transform equilibrium constant from pressure units
+
+    const Reaction<CoeffType>& reaction = this->reaction(rxn);
+
+    typename RateCoefficientTable<CoeffType>::Location location;
+    const bool use_table = this->locate_in_rate_table(conditions.T(), location);
+
+    // dnet_rate_dX_s holds dkfwd_dX_s until it is scaled in place
+    StateType kfwd = Antioch::zero_clone(conditions.T());
+    StateType dkfwd_dT = Antioch::zero_clone(conditions.T());
+
+    this->forward_rate_coefficient_and_derivatives( rxn, conditions, use_table, location, molar_densities,
+                                                    Antioch::total_concentration<StateType>( molar_densities ),
+                                                    kfwd, dkfwd_dT, dnet_rate_dX_s );
+
+    StateType keq = Antioch::zero_clone(conditions.T());
+    StateType dkeq_dT = Antioch::zero_clone(conditions.T());
+    if( reaction.reversible() )
+      reaction.equilibrium_constant_and_derivative( conditions.T(), P0_RT, h_RT_minus_s_R, dh_RT_minus_s_R_dT,
+                                                    keq, dkeq_dT );
+
+    reaction.compute_rate_of_progress_and_derivatives_from_kfwd( molar_densities, conditions, keq, dkeq_dT,
+                                                                 kfwd, dkfwd_dT, dnet_rate_dX_s,
+                                                                 net_reaction_rate, dnet_rate_dT, dnet_rate_dX_s );
+
+    return;
+  }
+
+  template<typename CoeffType>
+  template <typename StateType, typename VectorStateType>
+  inline
+  void ReactionSet<CoeffType>::compute_reaction_rate_and_derivs( const unsigned int rxn,
+                                                                 const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                                 const EquilibriumFactors<CoeffType,StateType>& equilibrium_factors,
+                                                                 const StateType& total_concentration,
+                                                                 const VectorStateType& molar_densities,
+                                                                 const VectorStateType& h_RT_minus_s_R,
+                                                                 const VectorStateType& dh_RT_minus_s_R_dT,
+                                                                 StateType& net_reaction_rate,
+                                                                 StateType& dnet_rate_dT,
+                                                                 VectorStateType& dnet_rate_dX_s ) const
+  {
+    antioch_assert_less( rxn, this->n_reactions() );
+    antioch_assert_equal_to( dnet_rate_dX_s.size(), this->n_species() );
+    antioch_assert_equal_to( molar_densities.size(), this->n_species() );
+    antioch_assert_equal_to( h_RT_minus_s_R.size(), this->n_species() );
+
+    const Reaction<CoeffType>& reaction = this->reaction(rxn);
+
+    typename RateCoefficientTable<CoeffType>::Location location;
+    const bool use_table = this->locate_in_rate_table(conditions.T(), location);
+
+    // dnet_rate_dX_s holds dkfwd_dX_s until it is scaled in place
+    StateType kfwd = Antioch::zero_clone(conditions.T());
+    StateType dkfwd_dT = Antioch::zero_clone(conditions.T());
+
+    this->forward_rate_coefficient_and_derivatives( rxn, conditions, use_table, location, molar_densities,
+                                                    total_concentration, kfwd, dkfwd_dT, dnet_rate_dX_s );
+
+    StateType keq = Antioch::zero_clone(conditions.T());
+    StateType dkeq_dT = Antioch::zero_clone(conditions.T());
+    if( reaction.reversible() )
+      reaction.equilibrium_constant_and_derivative( conditions.T(), equilibrium_factors,
+                                                    h_RT_minus_s_R, dh_RT_minus_s_R_dT,
+                                                    keq, dkeq_dT );
+
+    reaction.compute_rate_of_progress_and_derivatives_from_kfwd( molar_densities, conditions, keq, dkeq_dT,
+                                                                 kfwd, dkfwd_dT, dnet_rate_dX_s,
+                                                                 net_reaction_rate, dnet_rate_dT, dnet_rate_dX_s );
+
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  void ReactionSet<CoeffType>::build_reaction_index()
+  {
+    _reaction_index.clear();
+    _reaction_index.reserve(this->n_reactions());
+    for(unsigned int r = 0; r < this->n_reactions(); r++)
+      _reaction_index.insert( std::make_pair( this->reaction(r).id(), r ) );
+  }
+
+  template<typename CoeffType>
+  inline
+  void ReactionSet<CoeffType>::update_gamma_range()
+  {
+    _min_gamma = 0;
+    _max_gamma = 0;
+    for(unsigned int r = 0; r < this->n_reactions(); r++)
+      {
+        const int gamma = this->reaction(r).gamma();
+        if( r == 0 || gamma < _min_gamma )
+          _min_gamma = gamma;
+        if( r == 0 || gamma > _max_gamma )
+          _max_gamma = gamma;
+      }
+  }
+
+  template<typename CoeffType>
+  inline
+  void ReactionSet<CoeffType>::set_reaction_id(const unsigned int r, const std::string & reaction_id)
+  {
+    this->reaction(r).set_id(reaction_id);
+
+    // the old id may now point to a later duplicate
+    this->build_reaction_index();
+  }
 
   template<typename CoeffType>
   inline
   unsigned int ReactionSet<CoeffType>::reaction_by_id(const std::string & reaction_id) const
   {
+      typename std::unordered_map<std::string,unsigned int>::const_iterator it = _reaction_index.find(reaction_id);
+
+      if(it != _reaction_index.end() && this->reaction(it->second).id() == reaction_id)
+        return it->second;
+
+      // a miss or a stale entry: the id may have been changed
+      // through reaction(r).set_id(), which the index does not see
       unsigned int r(0);
       for(r = 0; r < this->n_reactions(); r++)
       {
@@ -374,12 +1290,13 @@ namespace Antioch
   void ReactionSet<CoeffType>::find_kinetics_model_parameter(const unsigned int r,const std::vector<std::string> & keywords, unsigned int & nr, std::string & unit, int & l) const
   {
 // now we need to know a few things:
-//  if we are in a falloff or duplicate, next keyword is which rate we want, then unit
+//  if we are in a falloff, duplicate or PLOG, next keyword is which rate we want, then unit
 //  if we are in an elementary photochemistry, next keyword is which index of sigma or lamba we want, then unit
 //  else we may have a unit
     switch(this->reaction(r).type())
     {
        case ReactionType::DUPLICATE:
+       case ReactionType::PLOG:
        {
           nr = std::stoi(keywords[1]);           // C++11, throws an exception on error
           if(keywords.size() > 2)unit = keywords[2];
@@ -414,6 +1331,11 @@ namespace Antioch
            if(keywords.size() > 2)unit = keywords[2]; // unit baby!
        }
           break;
+       case ReactionType::CHEBYSHEV:
+       {
+          antioch_error_msg("Chebyshev reactions have no kinetics model parameter: " + this->reaction(r).equation());
+       }
+          break;
        case ReactionType::ELEMENTARY: // photochem only
        {
           if(this->reaction(r).kinetics_model() == KineticsModel::PHOTOCHEM)
@@ -421,6 +1343,7 @@ namespace Antioch
              l = std::stoi(keywords[1]);           // C++11, throws an exception on error
              if(keywords.size() > 2)unit = keywords[2];
           }
+          else if(keywords.size() > 1)unit = keywords[1];  // unit baby!
        }
           break;
        default:
@@ -448,10 +1371,8 @@ namespace Antioch
      {
        antioch_assert_greater(keywords.size(),1); // we need a name
 
-       if(!this->chemical_mixture().species_name_map().count(keywords[1]))
+       if(!this->chemical_mixture().species_index(keywords[1],species))
                 antioch_error(); //who's this?
-
-       species = this->chemical_mixture().species_name_map().at(keywords[1]);
      }
 
      return;
@@ -460,94 +1381,145 @@ namespace Antioch
   template<typename CoeffType>
   inline
   CoeffType ReactionSet<CoeffType>::get_parameter_of_reaction(const std::string & reaction_id, const std::vector<std::string> & keywords) const
+  {
+     return this->get_parameter(this->parameter_handle(reaction_id,keywords));
+  }
+
+  template<typename CoeffType>
+  template <typename ParamType>
+  inline
+  void ReactionSet<CoeffType>::set_parameter_of_reaction(const std::string & reaction_id, const std::vector<std::string> & keywords, ParamType value)
+  {
+     this->set_parameter(this->parameter_handle(reaction_id,keywords),value);
+  }
+
+  template<typename CoeffType>
+  inline
+  ReactionParameterHandle<CoeffType> ReactionSet<CoeffType>::parameter_handle(const std::string & reaction_id, const std::vector<std::string> & keywords) const
   {
      antioch_assert(keywords.size()); // not zero
 
-     CoeffType parameter;
-     // when CoeffType is vectorizable, we want
-     // to have as little rewriting as possible
-     set_zero(parameter);
+     ReactionParameterHandle<CoeffType> handle;
 
-     unsigned int r = this->reaction_by_id(reaction_id);
+     // 1 find the reaction
+     handle._reaction = this->reaction_by_id(reaction_id);
 
      // 1 parse high level
-     KineticsModel::Parameters paramKin = string_to_kin_enum(keywords[0]);
-     ReactionType::Parameters paramChem = string_to_chem_enum(keywords[0]);
+     handle._kinetics_parameter = string_to_kin_enum(keywords[0]);
+     handle._chemical_parameter = string_to_chem_enum(keywords[0]);
 
 // provide the necessary enum,
 // index of reaction rate if kinetics
 // index of species if chemical
-     if(paramKin != KineticsModel::Parameters::NOT_FOUND)
+     if(handle._kinetics_parameter != KineticsModel::Parameters::NOT_FOUND)
      {
           // which rate? Duplicate want an unsigned int, falloff a keyword
-          unsigned int nr(0); // default is one rate
           std::string unit("SI"); // default internal parameter unit system
-          int l(-1); // if vectorized parameter
 
-          this->find_kinetics_model_parameter(r,keywords,nr,unit,l);
+          this->find_kinetics_model_parameter(handle._reaction,keywords,handle._rate,unit,handle._l);
 
-          // let's get this
-          parameter = reaction(r).get_parameter_of_rate(paramKin, nr, unit);
+          // same conversion as reset_parameter_of_rate
+          if(unit != "SI")
+            handle._SI_factor = Units<typename value_type<CoeffType>::type>(unit).get_SI_factor();
 
-     }else if(paramChem != ReactionType::Parameters::NOT_FOUND)
-     {
-          unsigned int species = std::numeric_limits<unsigned int>::max(); // sensible default
+          handle._reduce_energy = (handle._l < 0 &&
+                                   handle._kinetics_parameter == KineticsModel::Parameters::E &&
+                                   unit != "K");
 
-          this->find_chemical_process_parameter(paramChem, keywords, species);
-
-          // let's get this
-          parameter = reaction(r).get_parameter_of_chemical_process(paramChem, species);
+     }else if(handle._chemical_parameter != ReactionType::Parameters::NOT_FOUND)
+     {
+          this->find_chemical_process_parameter(handle._chemical_parameter, keywords, handle._species);
      }else
      {
          antioch_error();
      }
 
-     return parameter;
+     return handle;
+  }
+
+  template<typename CoeffType>
+  inline
+  void ReactionSet<CoeffType>::parameter_handles(const std::vector<std::string> & reaction_ids,
+                                                 const std::vector<std::vector<std::string> > & keywords,
+                                                 std::vector<ReactionParameterHandle<CoeffType> > & handles) const
+  {
+     antioch_assert_equal_to(reaction_ids.size(),keywords.size());
 
+     handles.resize(reaction_ids.size());
+     for(unsigned int i = 0; i < reaction_ids.size(); i++)
+       handles[i] = this->parameter_handle(reaction_ids[i],keywords[i]);
   }
 
   template<typename CoeffType>
-  template <typename ParamType>
   inline
-  void ReactionSet<CoeffType>::set_parameter_of_reaction(const std::string & reaction_id, const std::vector<std::string> & keywords, ParamType value)
+  void ReactionSet<CoeffType>::apply_parameter(const ReactionParameterHandle<CoeffType> & handle, CoeffType value)
   {
-     antioch_assert(keywords.size()); // not zero
+     antioch_assert_less(handle._reaction,this->n_reactions());
 
-      // 1 find the reaction
-      unsigned int r = this->reaction_by_id(reaction_id);
+     if(handle._kinetics_parameter != KineticsModel::Parameters::NOT_FOUND)
+     {
+          CoeffType new_coef = value * handle._SI_factor;
+          if(handle._reduce_energy)
+            new_coef = new_coef / Constants::R_universal<typename value_type<CoeffType>::type>();
+
+          KineticsType<CoeffType>& rate = this->reaction(handle._reaction).forward_rate(handle._rate);
+          (handle._l < 0)?reset_internal_parameter_of_rate(rate, handle._kinetics_parameter, new_coef):
+                          reset_internal_parameter_of_rate(rate, handle._kinetics_parameter, new_coef, handle._l);
+          this->reaction(handle._reaction).update_rate_tables();
+     }else
+     {
+          this->reaction(handle._reaction).set_parameter_of_chemical_process(handle._chemical_parameter, value, handle._species);
+     }
+  }
 
-      // 1 parse high level
-      KineticsModel::Parameters paramKin = string_to_kin_enum(keywords[0]);
-      ReactionType::Parameters paramChem = string_to_chem_enum(keywords[0]);
-// provide the necessary enum,
-// index of reaction rate if kinetics
-// index of species if chemical
-      if(paramKin != KineticsModel::Parameters::NOT_FOUND)
-      {
-          // which rate? Duplicate want an unsigned int, falloff a keyword
-           unsigned int nr(0); // default is one rate
-           std::string unit("SI"); // default internal parameter unit system
-           int l(-1); // for vectorized parameter
+  template<typename CoeffType>
+  template <typename ParamType>
+  inline
+  void ReactionSet<CoeffType>::set_parameter(const ReactionParameterHandle<CoeffType> & handle, ParamType value)
+  {
+     this->apply_parameter(handle,value);
+     this->update_rate_table(handle);
+  }
 
-           this->find_kinetics_model_parameter(r,keywords,nr,unit,l);
+  template<typename CoeffType>
+  template <typename VectorParamType>
+  inline
+  void ReactionSet<CoeffType>::set_parameters(const std::vector<ReactionParameterHandle<CoeffType> > & handles, const VectorParamType & values)
+  {
+     antioch_assert_equal_to(handles.size(),values.size());
 
-           // let's set this
-           (l < 0)?this->reaction(r).set_parameter_of_rate(paramKin, value, nr, unit):
-                   this->reaction(r).set_parameter_of_rate(paramKin, value, nr, l, unit);
+     for(unsigned int i = 0; i < handles.size(); i++)
+       {
+         this->apply_parameter(handles[i],values[i]);
+         this->update_rate_table(handles[i]);
+       }
+  }
 
-      }else if(paramChem != ReactionType::Parameters::NOT_FOUND)
-      {
-           unsigned int species = std::numeric_limits<unsigned int>::max(); // sensible default
+  template<typename CoeffType>
+  inline
+  void ReactionSet<CoeffType>::update_rate_table(const ReactionParameterHandle<CoeffType> & handle)
+  {
+     // a suspended table is rebuilt by finalize(), and the efficiencies
+     // are applied on top of the tabulated k(T)
+     if( _rate_table && !_rate_table_stale &&
+         handle._kinetics_parameter != KineticsModel::Parameters::NOT_FOUND )
+       _rate_table->tabulate(handle._reaction);
+  }
 
-           this->find_chemical_process_parameter(paramChem, keywords, species);
+  template<typename CoeffType>
+  inline
+  CoeffType ReactionSet<CoeffType>::get_parameter(const ReactionParameterHandle<CoeffType> & handle) const
+  {
+     antioch_assert_less(handle._reaction,this->n_reactions());
 
-           // let's set this
-           this->reaction(r).set_parameter_of_chemical_process(paramChem, value, species);
-      }else
-      {
-          antioch_error();
-      }
+     if(handle._kinetics_parameter != KineticsModel::Parameters::NOT_FOUND)
+     {
+          const KineticsType<CoeffType>& rate = this->reaction(handle._reaction).forward_rate(handle._rate);
+          return (handle._l < 0)?rate.get_parameter(handle._kinetics_parameter):
+                                 rate.get_parameter(handle._kinetics_parameter,handle._l);
+     }
 
+     return this->reaction(handle._reaction).get_parameter_of_chemical_process(handle._chemical_parameter, handle._species);
   }
 
   template<typename CoeffType>
@@ -827,11 +1799,13 @@ namespace Antioch
     fwd_conc.resize(this->n_reactions(),1);
     bkwd_conc.resize(this->n_reactions(),1);
 
+    const StateType total_concentration = Antioch::total_concentration<StateType>( molar_densities );
+
     // compute reaction forward rates & other reaction-sized arrays
     for (unsigned int rxn=0; rxn<this->n_reactions(); rxn++)
       {
         const Reaction<CoeffType>& reaction = this->reaction(rxn);
-        kfwd_const[rxn] = reaction.compute_forward_rate_coefficient(molar_densities,conditions);
+        kfwd_const[rxn] = reaction.compute_forward_rate_coefficient(molar_densities,conditions,total_concentration);
         kfwd[rxn] = kfwd_const[rxn];
 
         for (unsigned int r=0; r<reaction.n_reactants(); r++)
@@ -0,0 +1,310 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+
+
+#ifndef ANTIOCH_STOICHIOMETRY_MATRIX_H
+#define ANTIOCH_STOICHIOMETRY_MATRIX_H
+
+// Antioch
+#include "antioch/antioch_asserts.h"
+#include "antioch/metaprogramming.h"
+#include "antioch/reaction_set.h"
+
+// C++
+#include <vector>
+
+namespace Antioch
+{
+
+  //! Sparse net stoichiometry matrix of a ReactionSet
+  /*!
+   * Compressed row storage of the n_species x n_reactions matrix
+   * \f$ \nu_{s,r} = \nu''_{s,r} - \nu'_{s,r} \f$. Rows are species and,
+   * within a row, the reactions are sorted by increasing index.
+   * Species appearing on both sides of a reaction have their coefficients
+   * merged, zero entries are not stored.
+   *
+   * The species source terms are then the matrix-vector product
+   * \f$ \dot{\omega}_s = \sum_r \nu_{s,r} \dot{q}_r \f$. Each row is
+   * written by a single species, so multiply() on disjoint species ranges
+   * can be run concurrently without write conflicts.
+   *
+   * This is a snapshot: if the ReactionSet is modified, build() must be
+   * called again.
+   */
+  template<typename CoeffType=double>
+  class StoichiometryMatrix
+  {
+  public:
+
+    //! Constructor, builds the matrix from the reaction set.
+    StoichiometryMatrix( const ReactionSet<CoeffType>& reaction_set );
+
+    ~StoichiometryMatrix();
+
+    //! (Re)build the matrix from the reaction set.
+    void build();
+
+    const ReactionSet<CoeffType>& reaction_set() const;
+
+    //! \returns the number of rows (species).
+    unsigned int n_species() const;
+
+    //! \returns the number of columns (reactions).
+    unsigned int n_reactions() const;
+
+    //! \returns the number of stored entries.
+    unsigned int n_nonzeros() const;
+
+    //! Row s owns the entries [row_offsets()[s],row_offsets()[s+1])
+    const std::vector<unsigned int>& row_offsets() const;
+
+    //! Reaction index of each stored entry
+    const std::vector<unsigned int>& reaction_ids() const;
+
+    //! Net stoichiometric coefficient of each stored entry
+    const std::vector<CoeffType>& values() const;
+
+    //! \returns the net stoichiometric coefficient of species s in reaction rxn.
+    CoeffType operator()( unsigned int s, unsigned int rxn ) const;
+
+    //! sources = nu * rates
+    /*!
+     * \p sources is overwritten, \p rates is of size n_reactions().
+     */
+    template <typename VectorReactionsType, typename VectorStateType>
+    void multiply( const VectorReactionsType& rates,
+                   VectorStateType& sources ) const;
+
+    //! sources = nu * rates, restricted to the species [first_species,end_species)
+    /*!
+     * The other entries of \p sources are not touched.
+     */
+    template <typename VectorReactionsType, typename VectorStateType>
+    void multiply( const VectorReactionsType& rates,
+                   VectorStateType& sources,
+                   unsigned int first_species,
+                   unsigned int end_species ) const;
+
+  private:
+
+    StoichiometryMatrix();
+
+    const ReactionSet<CoeffType>& _reaction_set;
+
+    std::vector<unsigned int> _row_offsets;
+
+    std::vector<unsigned int> _reaction_ids;
+
+    std::vector<CoeffType> _values;
+  };
+
+  /* ------------------------- Inline Functions -------------------------*/
+  template<typename CoeffType>
+  inline
+  StoichiometryMatrix<CoeffType>::StoichiometryMatrix( const ReactionSet<CoeffType>& reaction_set )
+    : _reaction_set(reaction_set)
+  {
+    this->build();
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  StoichiometryMatrix<CoeffType>::~StoichiometryMatrix()
+  {
+    return;
+  }
+
+  template<typename CoeffType>
+  inline
+  const ReactionSet<CoeffType>& StoichiometryMatrix<CoeffType>::reaction_set() const
+  {
+    return _reaction_set;
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int StoichiometryMatrix<CoeffType>::n_species() const
+  {
+    return _row_offsets.size() - 1;
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int StoichiometryMatrix<CoeffType>::n_reactions() const
+  {
+    return _reaction_set.n_reactions();
+  }
+
+  template<typename CoeffType>
+  inline
+  unsigned int StoichiometryMatrix<CoeffType>::n_nonzeros() const
+  {
+    return _values.size();
+  }
+
+  template<typename CoeffType>
+  inline
+  const std::vector<unsigned int>& StoichiometryMatrix<CoeffType>::row_offsets() const
+  {
+    return _row_offsets;
+  }
+
+  template<typename CoeffType>
+  inline
+  const std::vector<unsigned int>& StoichiometryMatrix<CoeffType>::reaction_ids() const
+  {
+    return _reaction_ids;
+  }
+
+  template<typename CoeffType>
+  inline
+  const std::vector<CoeffType>& StoichiometryMatrix<CoeffType>::values() const
+  {
+    return _values;
+  }
+
+  template<typename CoeffType>
+  inline
+  CoeffType StoichiometryMatrix<CoeffType>::operator()( unsigned int s, unsigned int rxn ) const
+  {
+    antioch_assert_less( s, this->n_species() );
+    antioch_assert_less( rxn, this->n_reactions() );
+
+    for( unsigned int i = _row_offsets[s]; i < _row_offsets[s+1]; i++ )
+      {
+        if( _reaction_ids[i] == rxn )
+          return _values[i];
+      }
+
+    return 0;
+  }
+
+  template<typename CoeffType>
+  inline
+  void StoichiometryMatrix<CoeffType>::build()
+  {
+    const unsigned int n_species = _reaction_set.n_species();
+    const unsigned int n_reactions = _reaction_set.n_reactions();
+
+    // per species list of (reaction, coefficient), reactions are
+    // visited in order so each list is sorted
+    std::vector<std::vector<unsigned int> > rows_ids(n_species);
+    std::vector<std::vector<CoeffType> > rows_values(n_species);
+
+    // net coefficient of the current reaction, and the species it touches
+    std::vector<CoeffType> net(n_species,0);
+    std::vector<unsigned int> touched;
+
+    for( unsigned int rxn = 0; rxn < n_reactions; rxn++ )
+      {
+        const Reaction<CoeffType>& reaction = _reaction_set.reaction(rxn);
+
+        touched.clear();
+
+        for( unsigned int r = 0; r < reaction.n_reactants(); r++ )
+          {
+            const unsigned int s = reaction.reactant_id(r);
+            touched.push_back(s);
+            net[s] -= static_cast<CoeffType>(reaction.reactant_stoichiometric_coefficient(r));
+          }
+
+        for( unsigned int p = 0; p < reaction.n_products(); p++ )
+          {
+            const unsigned int s = reaction.product_id(p);
+            touched.push_back(s);
+            net[s] += static_cast<CoeffType>(reaction.product_stoichiometric_coefficient(p));
+          }
+
+        for( unsigned int i = 0; i < touched.size(); i++ )
+          {
+            const unsigned int s = touched[i];
+
+            // a species seen twice has already been stored and reset
+            if( net[s] != 0 )
+              {
+                rows_ids[s].push_back(rxn);
+                rows_values[s].push_back(net[s]);
+                net[s] = 0;
+              }
+          }
+      }
+
+    _row_offsets.assign(n_species+1,0);
+    for( unsigned int s = 0; s < n_species; s++ )
+      _row_offsets[s+1] = _row_offsets[s] + rows_ids[s].size();
+
+    _reaction_ids.resize(_row_offsets[n_species]);
+    _values.resize(_row_offsets[n_species]);
+
+    for( unsigned int s = 0; s < n_species; s++ )
+      {
+        for( unsigned int i = 0; i < rows_ids[s].size(); i++ )
+          {
+            _reaction_ids[_row_offsets[s] + i] = rows_ids[s][i];
+            _values[_row_offsets[s] + i] = rows_values[s][i];
+          }
+      }
+
+    return;
+  }
+
+  template<typename CoeffType>
+  template <typename VectorReactionsType, typename VectorStateType>
+  inline
+  void StoichiometryMatrix<CoeffType>::multiply( const VectorReactionsType& rates,
+                                                 VectorStateType& sources ) const
+  {
+    this->multiply( rates, sources, 0, this->n_species() );
+  }
+
+  template<typename CoeffType>
+  template <typename VectorReactionsType, typename VectorStateType>
+  inline
+  void StoichiometryMatrix<CoeffType>::multiply( const VectorReactionsType& rates,
+                                                 VectorStateType& sources,
+                                                 unsigned int first_species,
+                                                 unsigned int end_species ) const
+  {
+    antioch_assert_equal_to( rates.size(), this->n_reactions() );
+    antioch_assert_equal_to( sources.size(), this->n_species() );
+    antioch_assert_less_equal( first_species, end_species );
+    antioch_assert_less_equal( end_species, this->n_species() );
+
+    for( unsigned int s = first_species; s < end_species; s++ )
+      {
+        Antioch::set_zero(sources[s]);
+
+        for( unsigned int i = _row_offsets[s]; i < _row_offsets[s+1]; i++ )
+          sources[s] += _values[i] * rates[_reaction_ids[i]];
+      }
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_STOICHIOMETRY_MATRIX_H
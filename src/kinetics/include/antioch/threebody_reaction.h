@@ -79,10 +79,25 @@ namespace Antioch
     StateType compute_forward_rate_coefficient( const VectorStateType& molar_densities,
                                                 const KineticsConditions<StateType,VectorStateType>& conditions ) const;
 
+    //! \p total_concentration is sum_s c_s, only the non-unity efficiencies are applied to it
+    template <typename StateType, typename VectorStateType>
+    StateType compute_forward_rate_coefficient( const VectorStateType& molar_densities,
+                                                const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                const StateType& total_concentration ) const;
+
+    //!
+    template <typename StateType, typename VectorStateType>
+    void compute_forward_rate_coefficient_and_derivatives( const VectorStateType& molar_densities,
+                                                           const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                           StateType& kfwd,
+                                                           StateType& dkfwd_dT,
+                                                           VectorStateType& dkfwd_dX) const;
+
     //!
     template <typename StateType, typename VectorStateType>
     void compute_forward_rate_coefficient_and_derivatives( const VectorStateType& molar_densities,
                                                            const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                           const StateType& total_concentration,
                                                            StateType& kfwd,
                                                            StateType& dkfwd_dT,
                                                            VectorStateType& dkfwd_dX) const;
@@ -98,8 +113,6 @@ namespace Antioch
                                                    const KineticsModel::KineticsModel kin)
     :Reaction<CoeffType>(n_species,equation,reversible,ReactionType::THREE_BODY,kin)
   {
-    Reaction<CoeffType>::_efficiencies.resize(n_species);
-    std::fill (Reaction<CoeffType>::_efficiencies.begin(), Reaction<CoeffType>::_efficiencies.end(), 1.);
     return;
   }
 
@@ -118,13 +131,19 @@ namespace Antioch
   StateType ThreeBodyReaction<CoeffType>::compute_forward_rate_coefficient( const VectorStateType& molar_densities,
                                                                             const KineticsConditions<StateType,VectorStateType>& conditions  ) const
   {
-    //k(T,[M]) = (sum eff_i * C_i) * ...
-    StateType kfwd = (this->efficiency(0) * molar_densities[0] );
+    return this->compute_forward_rate_coefficient( molar_densities, conditions,
+                                                   total_concentration<StateType>(molar_densities) );
+  }
 
-    for (unsigned int s=1; s<this->n_species(); s++)
-      {
-        kfwd += ( this->efficiency(s) * molar_densities[s] );
-      }
+  template <typename CoeffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  StateType ThreeBodyReaction<CoeffType>::compute_forward_rate_coefficient( const VectorStateType& molar_densities,
+                                                                            const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                                            const StateType& total_concentration ) const
+  {
+    //k(T,[M]) = (sum eff_i * C_i) * ...
+    StateType kfwd = this->third_body_concentration( molar_densities, total_concentration );
 
     //... alpha(T)
     kfwd *= (*this->_forward_rate[0])(conditions);
@@ -143,6 +162,21 @@ namespace Antioch
                                                                                        StateType& kfwd,
                                                                                        StateType& dkfwd_dT,
                                                                                        VectorStateType& dkfwd_dX) const
+  {
+    this->compute_forward_rate_coefficient_and_derivatives( molar_densities, conditions,
+                                                            total_concentration<StateType>(molar_densities),
+                                                            kfwd, dkfwd_dT, dkfwd_dX );
+  }
+
+  template <typename CoeffType>
+  template<typename StateType, typename VectorStateType>
+  inline
+  void ThreeBodyReaction<CoeffType>::compute_forward_rate_coefficient_and_derivatives( const VectorStateType &molar_densities,
+                                                                                       const KineticsConditions<StateType,VectorStateType>& conditions,
+                                                                                       const StateType& total_concentration,
+                                                                                       StateType& kfwd,
+                                                                                       StateType& dkfwd_dT,
+                                                                                       VectorStateType& dkfwd_dX) const
   {
     antioch_assert_equal_to(dkfwd_dX.size(),this->n_species());
 
@@ -150,21 +184,20 @@ namespace Antioch
     //dk_dCi = alpha(T) * eps_i
     this->_forward_rate[0]->compute_rate_and_derivative(conditions,kfwd,dkfwd_dT);
 
-    dkfwd_dX[0] = kfwd;
-    StateType coef = (this->efficiency(0) * molar_densities[0]);
-
-    for (unsigned int s=1; s<this->n_species(); s++)
+    for (unsigned int s=0; s<this->n_species(); s++)
       {
-        coef += ( this->efficiency(s) * molar_densities[s] );
         dkfwd_dX[s] = kfwd;
       }
 
+    const StateType coef = this->third_body_concentration( molar_densities, total_concentration );
+
     kfwd *= coef;
     dkfwd_dT *= coef;
 
-    for (unsigned int s=0; s<this->n_species(); s++)
+    // eps_i = 1 except for the stored corrections
+    for (unsigned int k=0; k<this->n_efficiency_corrections(); k++)
       {
-        dkfwd_dX[s] *= this->efficiency(s);
+        dkfwd_dX[this->efficiency_correction_species(k)] *= this->efficiency_correction(k);
       }
 
     antioch_assert(!has_nan(kfwd));
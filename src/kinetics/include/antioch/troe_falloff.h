@@ -81,7 +81,7 @@ namespace Antioch
    *                                                                             \right]^2
    *                                                                  \right]^2}
    *     \\
-   *     & = \log_{10}\left(F\right) \left[\frac{\partial \log_{10}\left(F_\text{cent}\right)}{\partial T} \frac{1}{F_\text{cent}}
+   *     & = \log_{10}\left(F\right) \left[\frac{\partial \log_{10}\left(F_\text{cent}\right)}{\partial T} \frac{1}{\log_{10}\left(F_\text{cent}\right)}
    *                                      - 2\left[\frac{\log_{10}\left(P_r\right) + c}{n - d \left[\log_{10}\left(P_r\right) + c\right]}\right]^2
    *                                                  \left[\frac{\frac{\partial \log_{10}\left(P_r\right)}{\partial T} + \frac{\partial c}{\partial T}}
    *                                                             {\log_{10}\left(P_r\right) + c}
@@ -96,10 +96,13 @@ namespace Antioch
    *     \frac{\partial F}{\partial T} & = \ln(10) F  \frac{\partial \log_{10}\left(F\right)}{\partial T} \\\\\\\\
    *     \frac{\partial P_r}{\partial c_i} & = \frac{k_0}{k_\infty} \\
    *     \frac{\partial \log_{10}(P_r)}{\partial c_i} & = \frac{1}{\ln(10) P_r} \frac{\partial P_r}{\partial c_i} = \frac{1}{\ln(10) [\mathrm{M}]}\\\\
-   *     \frac{\partial \log_{10}\left(F\right)}{\partial c_i} & = -\frac{\log_{10}^2\left(F\right)}{\log_{10}\left(F_\text{cent}\right)}
+   *     \frac{\partial \log_{10}\left(F\right)}{\partial c_i} & = -2\log_{10}\left(F\right)
+   *                                                               \frac{\log_{10}\left(P_r\right) + c}{n - d\left[\log_{10}\left(P_r\right) + c\right]}
+   *                                                               \frac{n}{\left(n - d\left[\log_{10}\left(P_r\right) + c\right]\right)^2}
    *                                                               \frac{\partial \log_{10}\left(P_r\right)}{\partial c_i}
-   *                                                               \left(1 - \frac{1}{n - d\left[\log_{10}\left(P_r\right) + c\right]}\right)
-   *                                                               \left(\log_{10}\left(P_r\right) + c\right) \\
+   *                                                               \frac{1}{1 + \left[\frac{\log_{10}\left(P_r\right) + c}
+   *                                                                                        {n - d\left(\log_{10}\left(P_r\right) + c\right)}
+   *                                                                             \right]^2} \\
    *     \frac{\partial F}{\partial c_i} & = \ln(10) F \frac{\partial \log_{10}\left(F\right)}{\partial c_i} 
    * \end{split}
    * \f]
@@ -143,6 +146,13 @@ namespace Antioch
                            StateType &dF_dT,
                            VectorStateType &dF_dX) const;
 
+    //! \f$\partial \ln F/\partial \ln P_r\f$, 0 if \f$F_{\text{cent}}\f$ or \f$P_r\f$ is 0
+    /*! The same expression as the concentration derivatives of F_and_derivatives,
+        \f$\partial P_r/\partial c_i = P_r/[\mathrm{M}]\f$, without the species loop. */
+    template <typename StateType>
+    StateType dlnF_dlnPr(const StateType &T,
+                         const StateType &Pr) const;
+
   private:
 
     unsigned int n_spec;
@@ -348,7 +358,6 @@ namespace Antioch
     this->Fcent_and_derivatives(T,Fcent,dFcent_dT);
     antioch_assert(!has_nan(Fcent));
 
-    StateType dlog10Fcent_dT = Constants::log10_to_log<CoeffType>()*dFcent_dT/Fcent;
     // Compute log(Fcent) once
     StateType logFcent = ant_log(Fcent);
     // n and c and derivatives
@@ -358,19 +367,22 @@ namespace Antioch
     StateType dc_dT = - _c_coeff * dFcent_dT/Fcent;
     ANTIOCH_AUTO(StateType) dn_dT = - _n_coeff * dFcent_dT/Fcent;
 
+    // x = (log10Pr + c)/(n - d*(log10Pr + c)), written as y/D
+    StateType y = log10Pr + c;
+    StateType D = n - d * y;
+    StateType x = y/D;
+    StateType one_plus_x2 = 1 + x*x;
+
     //log10F
-    StateType logF = logFcent/(1 + ant_pow(((log10Pr + c)/(n - d*(log10Pr + c) )),2));
-    StateType dlogF_dT = logF * (dlog10Fcent_dT / Fcent 
-                                     - 2 * ant_pow((log10Pr + c)/(n - d * (log10Pr + c)),2)
-                                       * ((dlog10Pr_dT + dc_dT)/(log10Pr + c) -
-                                          (dn_dT - d * (dlog10Pr_dT + dc_dT))/(n - d * (log10Pr + c))
-                                         )
-                                       / (1 + ant_pow((log10Pr + c)/(n - d * (log10Pr + c)),2))
-                                    );
+    StateType logF = logFcent/one_plus_x2;
+    // dlogF_dT = (dlogFcent_dT - 2 logF x dx_dT)/(1 + x^2), dx_dT = (dy_dT D - y dD_dT)/D^2
+    StateType dy_dT = dlog10Pr_dT + dc_dT;
+    StateType dD_dT = dn_dT - d * dy_dT;
+    StateType dlogF_dT = (dFcent_dT/Fcent - 2 * logF * x * (dy_dT * D - y * dD_dT)/(D*D))/one_plus_x2;
     VectorStateType dlogF_dX = Antioch::zero_clone(dF_dX);
     for(unsigned int ip = 0; ip < dlog10Pr_dX.size(); ip++)
-      {//dlogF_dX = - logF^2/log(Fcent) * dlog10Pr_dX * (1 - 1/(n - d * (log10Pr + c))) * (log10Pr + c)
-        dlogF_dX[ip] = - ant_pow(logF,2)/logFcent * dlog10Pr_dX[ip] *(1 - 1/(n - d * (log10Pr + c))) * (log10Pr + c);
+      {//dlogF_dX = - 2 logF x dx_dX/(1 + x^2), dx_dX = n/D^2 dlog10Pr_dX
+        dlogF_dX[ip] = - 2 * logF * x * n/(D*D) * dlog10Pr_dX[ip]/one_plus_x2;
       }
 
     F = ant_exp(logF);
@@ -388,6 +400,38 @@ namespace Antioch
   }
 
 
+  template <typename CoeffType>
+  template <typename StateType>
+  inline
+  StateType TroeFalloff<CoeffType>::dlnF_dlnPr(const StateType &T,
+                                                 const StateType &Pr) const
+  {
+    StateType Fcent = this->Fcent(T);
+    antioch_assert(!has_nan(Fcent));
+
+    StateType logFcent = ant_log(Fcent);
+    StateType  d = Antioch::constant_clone(T, CoeffType(0.14L));
+    StateType  c = - CoeffType(0.4L) - _c_coeff * logFcent;
+    StateType  n = CoeffType(0.75L) - _n_coeff * logFcent;
+
+    // x = (log10Pr + c)/(n - d*(log10Pr + c)), written as y/D
+    StateType y = Constants::log10_to_log<CoeffType>() * ant_log(Pr) + c;
+    StateType D = n - d * y;
+    StateType x = y/D;
+    StateType one_plus_x2 = 1 + x*x;
+    StateType logF = logFcent/one_plus_x2;
+
+    // dlogF_dlog10Pr = - 2 logF x n/D^2/(1 + x^2), dlog10Pr_dlnPr = 1/ln(10)
+    StateType dlnF = - 2 * logF * x * n/(D*D)/one_plus_x2 * Constants::log10_to_log<CoeffType>();
+
+    typename Antioch::rebind<StateType, bool>::type Fcent_is_nonzero = (Fcent != Antioch::zero_clone(T));
+    typename Antioch::rebind<StateType, bool>::type Pr_is_nonzero = (Pr != Antioch::zero_clone(T));
+
+    return Antioch::if_else(Fcent_is_nonzero,
+                            StateType(Antioch::if_else(Pr_is_nonzero, dlnF, Antioch::zero_clone(T))),
+                            Antioch::zero_clone(T));
+  }
+
   template<typename CoeffType>
   inline
   TroeFalloff<CoeffType>::TroeFalloff(const unsigned int nspec, const CoeffType alpha,
@@ -0,0 +1,198 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+#ifndef ANTIOCH_BINARY_PARSER_H
+#define ANTIOCH_BINARY_PARSER_H
+
+// Antioch
+#include "antioch/antioch_asserts.h"
+#include "antioch/parser_base.h"
+#include "antioch/parsing_enum.h"
+
+// C++
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Antioch
+{
+  // Forward declarations
+  template <typename NumericType>
+  class ReactionSet;
+
+  /*! Layout of the binary mechanism snapshots.
+
+    A snapshot starts with a fixed header:
+    - the 8 characters magic `ANTIOCHB',
+    - a 32-bit marker (0x01020304) used to reject snapshots of the other endianness,
+    - the 32-bit format version,
+    - the 32-bit size of the stored reals (4, 8 or sizeof(long double)),
+    - the 32-bit number of sections.
+
+    Each section is then a 32-bit tag, a 64-bit payload length in bytes
+    and the payload. Unknown tags are skipped, so a newer writer can add
+    sections without breaking older readers. Every value is stored
+    in SI units, exactly as held by the in-memory objects, so loading
+    a snapshot performs no unit conversion and no text parsing.
+  */
+  namespace BinarySnapshot
+  {
+    const char magic[8] = {'A','N','T','I','O','C','H','B'};
+
+    const unsigned int endianness_marker = 0x01020304;
+
+    const unsigned int version = 1;
+
+    enum Section{ SPECIES = 1,
+                  VIBRATIONAL,
+                  ELECTRONIC,
+                  THERMO,
+                  TRANSPORT,
+                  REACTIONS };
+  }
+
+  /*!\class BinaryParser
+
+    Reads a binary mechanism snapshot, see write_binary_snapshot().
+    The whole file is loaded with a single read, or the parser is
+    built directly from an in-memory image, which allows one process
+    to read the file and broadcast the bytes to the others.
+
+    All the sections live in the same snapshot: change_file() is a no-op,
+    so that the ChemicalMixture constructor taking a parser, which
+    redirects the parser to its vibrational and electronic data files,
+    picks those data from the snapshot as well. Reactions are not
+    streamed through the generic reaction interface but directly
+    rebuilt by read_reaction_set().
+  */
+  template <typename NumericType>
+  class BinaryParser: public ParserBase<NumericType>
+  {
+  public:
+    BinaryParser(const std::string & filename, bool verbose = true);
+
+    //! parses the snapshot image \p image, named \p name in the messages
+    BinaryParser(const std::vector<char> & image, bool verbose = true,
+                 const std::string & name = "<memory>");
+
+    ~BinaryParser(){};
+
+    //! all the data are in the snapshot, nothing to do
+    void change_file(const std::string & /*filename*/){}
+
+    //! \return true if the snapshot has a reaction section
+    bool initialize();
+
+    /// species
+    //! reads the species set
+    const std::vector<std::string> species_list();
+
+    //! reads the mandatory data
+    void read_chemical_species(ChemicalMixture<NumericType> & chem_mixture);
+
+    //! reads the vibrational data
+    void read_vibrational_data(ChemicalMixture<NumericType> & chem_mixture);
+
+    //! reads the electronic data
+    void read_electronic_data(ChemicalMixture<NumericType> & chem_mixture);
+
+    /// transport
+    //! reads the transport data
+    void read_transport_data(TransportMixture<NumericType> & transport_mixture);
+
+    /// thermo
+    //! reads the thermo, the snapshot must hold NASA7 curve fits
+    void read_thermodynamic_data(NASAThermoMixture<NumericType, NASA7CurveFit<NumericType> >& thermo)
+    {this->read_thermodynamic_data_root(thermo,7,false);}
+
+    //! reads the thermo, the snapshot must hold NASA9 (or CEA) curve fits
+    void read_thermodynamic_data(NASAThermoMixture<NumericType, NASA9CurveFit<NumericType> >& thermo)
+    {this->read_thermodynamic_data_root(thermo,9,false);}
+
+    //! reads the thermo, the snapshot must hold NASA9 (or CEA) curve fits
+    void read_thermodynamic_data(NASAThermoMixture<NumericType, CEACurveFit<NumericType> >& thermo)
+    {this->read_thermodynamic_data_root(thermo,9,true);}
+
+    /// reaction
+    //! rebuilds and adds all the reactions of the snapshot
+    void read_reaction_set(ReactionSet<NumericType> & reaction_set);
+
+    //! \return true if the snapshot has the section \p section
+    bool has_section(BinarySnapshot::Section section) const;
+
+  private:
+
+    //! Sequential decoder of one section
+    class Cursor
+    {
+    public:
+      Cursor(const BinaryParser<NumericType> & parser, BinarySnapshot::Section section);
+
+      unsigned int  read_uint();
+      int           read_int();
+      bool          read_bool();
+      NumericType   read_real();
+      std::string   read_string();
+
+      //! consistency check, the section must be entirely read
+      void finalize() const;
+
+    private:
+      void read_bytes(void * dest, std::size_t n);
+
+      const BinaryParser<NumericType> & _parser;
+      std::size_t _pos;
+      std::size_t _end;
+    };
+
+    friend class Cursor;
+
+    //! validates the header and indexes the sections
+    void index_sections();
+
+    template <typename CurveType>
+    void read_thermodynamic_data_root(NASAThermoMixture<NumericType, CurveType>& thermo,
+                                      unsigned int n_coeffs, bool cea_input);
+
+    //! species index of \p name in \p chem_mixture, error if absent
+    unsigned int species_index(const ChemicalMixture<NumericType> & chem_mixture,
+                               const std::string & name) const;
+
+    //! reads the vibrational or electronic levels
+    void read_levels(ChemicalMixture<NumericType> & chem_mixture, BinarySnapshot::Section section);
+
+    std::vector<char> _image;
+
+    unsigned int _real_size;
+
+    //! payload (offset, length) of each section
+    std::map<unsigned int, std::pair<std::size_t,std::size_t> > _sections;
+  };
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_BINARY_PARSER_H
@@ -0,0 +1,493 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+#ifndef ANTIOCH_BINARY_SNAPSHOT_WRITER_H
+#define ANTIOCH_BINARY_SNAPSHOT_WRITER_H
+
+// Antioch
+#include "antioch/antioch_asserts.h"
+#include "antioch/binary_parser.h"
+#include "antioch/chemical_mixture.h"
+#include "antioch/transport_mixture.h"
+#include "antioch/nasa_mixture.h"
+#include "antioch/reaction_set.h"
+#include "antioch/kinetics_parsing.h"
+
+// C++
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Antioch
+{
+  /*!\class BinarySnapshotWriter
+
+    Serializes a mechanism in the binary snapshot format read by
+    BinaryParser, see BinarySnapshot for the layout. The text parsers
+    are used once to build the objects, the snapshot then stores them
+    as they are held in memory:
+    - the species characteristics, vibrational and electronic levels,
+    - the NASA curve fits (coefficients and temperature bounds),
+    - the transport data of the species having some,
+    - the reactions, with their rate constants in SI units.
+
+    Rate constants with a reference temperature are stored with the
+    reduced pre-exponential factor and a reference temperature of
+    KineticsModel::Tref(), which reloads the same coefficients bit for
+    bit. Reals are stored with the precision of \p NumericType.
+  */
+  template <typename NumericType>
+  class BinarySnapshotWriter
+  {
+  public:
+
+    //! encodes the species of \p chem_mixture
+    BinarySnapshotWriter(const ChemicalMixture<NumericType> & chem_mixture);
+
+    ~BinarySnapshotWriter(){};
+
+    //! encodes the curve fits of \p thermo, which must be complete
+    template <typename CurveType>
+    void add_thermo(const NASAThermoMixture<NumericType,CurveType> & thermo);
+
+    //! encodes the transport data of \p transport_mixture
+    void add_transport(const TransportMixture<NumericType> & transport_mixture);
+
+    //! encodes the reactions of \p reaction_set
+    void add_reactions(const ReactionSet<NumericType> & reaction_set);
+
+    //! \return the snapshot as bytes, e.g. to broadcast it
+    std::vector<char> image() const;
+
+    //! writes the snapshot in \p filename
+    void write(const std::string & filename) const;
+
+  private:
+
+    typedef std::vector<char> Buffer;
+
+    Buffer & new_section(BinarySnapshot::Section section);
+
+    static void write_bytes(Buffer & buffer, const void * data, std::size_t n);
+
+    static void write_uint(Buffer & buffer, unsigned int value);
+
+    static void write_int(Buffer & buffer, int value);
+
+    static void write_real(Buffer & buffer, NumericType value);
+
+    static void write_string(Buffer & buffer, const std::string & value);
+
+    //! parameters of \p rate in the order build_rate() expects them
+    static std::vector<NumericType> rate_data(const KineticsType<NumericType> & rate);
+
+    const ChemicalMixture<NumericType> & _chem_mixture;
+
+    std::vector<std::pair<unsigned int, Buffer> > _sections;
+  };
+
+  template <typename NumericType>
+  inline
+  BinarySnapshotWriter<NumericType>::BinarySnapshotWriter(const ChemicalMixture<NumericType> & chem_mixture)
+    : _chem_mixture(chem_mixture)
+  {
+    const unsigned int n_species = chem_mixture.n_species();
+
+    Buffer & species = this->new_section(BinarySnapshot::SPECIES);
+    write_uint(species, n_species);
+    for(unsigned int s = 0; s < n_species; s++)
+      {
+        const ChemicalSpecies<NumericType> & chem_species = *chem_mixture.chemical_species()[s];
+        write_string(species, chem_species.species());
+        write_real(species, chem_species.molar_mass());
+        write_real(species, chem_species.formation_enthalpy());
+        write_real(species, chem_species.n_tr_dofs());
+        write_int(species, chem_species.charge());
+      }
+
+    Buffer & vibrational = this->new_section(BinarySnapshot::VIBRATIONAL);
+    write_uint(vibrational, n_species);
+    for(unsigned int s = 0; s < n_species; s++)
+      {
+        const ChemicalSpecies<NumericType> & chem_species = *chem_mixture.chemical_species()[s];
+        write_string(vibrational, chem_species.species());
+        write_uint(vibrational, chem_species.theta_v().size());
+        for(unsigned int l = 0; l < chem_species.theta_v().size(); l++)
+          {
+            write_real(vibrational, chem_species.theta_v()[l]);
+            write_uint(vibrational, chem_species.ndg_v()[l]);
+          }
+      }
+
+    Buffer & electronic = this->new_section(BinarySnapshot::ELECTRONIC);
+    write_uint(electronic, n_species);
+    for(unsigned int s = 0; s < n_species; s++)
+      {
+        const ChemicalSpecies<NumericType> & chem_species = *chem_mixture.chemical_species()[s];
+        write_string(electronic, chem_species.species());
+        write_uint(electronic, chem_species.theta_e().size());
+        for(unsigned int l = 0; l < chem_species.theta_e().size(); l++)
+          {
+            write_real(electronic, chem_species.theta_e()[l]);
+            write_uint(electronic, chem_species.ndg_e()[l]);
+          }
+      }
+  }
+
+  template <typename NumericType>
+  template <typename CurveType>
+  inline
+  void BinarySnapshotWriter<NumericType>::add_thermo(const NASAThermoMixture<NumericType,CurveType> & thermo)
+  {
+    if(!thermo.check())
+      antioch_error_msg("ERROR: cannot write a snapshot of an incomplete NASA thermo mixture!");
+
+    const unsigned int n_species = _chem_mixture.n_species();
+
+    Buffer & section = this->new_section(BinarySnapshot::THERMO);
+    write_uint(section, thermo.curve_fit(0).n_coeffs());
+    write_uint(section, n_species);
+    for(unsigned int s = 0; s < n_species; s++)
+      {
+        const CurveType & fit = thermo.curve_fit(s);
+        antioch_assert_equal_to(fit.n_coeffs(), thermo.curve_fit(0).n_coeffs());
+
+        write_string(section, _chem_mixture.chemical_species()[s]->species());
+
+        write_uint(section, fit.temperatures().size());
+        for(unsigned int t = 0; t < fit.temperatures().size(); t++)
+          write_real(section, fit.temperatures()[t]);
+
+        write_uint(section, fit.n_intervals() * fit.n_coeffs());
+        for(unsigned int i = 0; i < fit.n_intervals(); i++)
+          for(unsigned int c = 0; c < fit.n_coeffs(); c++)
+            write_real(section, fit.coefficients(i)[c]);
+      }
+  }
+
+  template <typename NumericType>
+  inline
+  void BinarySnapshotWriter<NumericType>::add_transport(const TransportMixture<NumericType> & transport_mixture)
+  {
+    unsigned int n_species = 0;
+    for(unsigned int s = 0; s < transport_mixture.n_species(); s++)
+      if(transport_mixture.transport_species()[s])
+        n_species++;
+
+    Buffer & section = this->new_section(BinarySnapshot::TRANSPORT);
+    write_uint(section, n_species);
+    for(unsigned int s = 0; s < transport_mixture.n_species(); s++)
+      {
+        // species without transport data are left out, as in the text files
+        if(!transport_mixture.transport_species()[s])
+          continue;
+
+        const TransportSpecies<NumericType> & species = transport_mixture.transport_species(s);
+        write_string(section, _chem_mixture.chemical_species()[s]->species());
+        write_real(section, species.LJ_depth());
+        write_real(section, species.LJ_diameter());
+        write_real(section, species.dipole_moment());
+        write_real(section, species.polarizability());
+        write_real(section, species.rotational_relaxation());
+        write_real(section, species.M());
+      }
+  }
+
+  template <typename NumericType>
+  inline
+  void BinarySnapshotWriter<NumericType>::add_reactions(const ReactionSet<NumericType> & reaction_set)
+  {
+    Buffer & section = this->new_section(BinarySnapshot::REACTIONS);
+    write_uint(section, reaction_set.n_reactions());
+    for(unsigned int r = 0; r < reaction_set.n_reactions(); r++)
+      {
+        const Reaction<NumericType> & reaction = reaction_set.reaction(r);
+
+        write_string(section, reaction.id());
+        write_string(section, reaction.equation());
+        write_uint(section, reaction.reversible());
+        write_uint(section, reaction.type());
+        write_uint(section, reaction.kinetics_model());
+
+        write_uint(section, reaction.n_reactants());
+        for(unsigned int p = 0; p < reaction.n_reactants(); p++)
+          {
+            write_string(section, reaction.reactant_name(p));
+            write_uint(section, reaction.reactant_stoichiometric_coefficient(p));
+            write_real(section, reaction.reactant_partial_order(p));
+          }
+
+        write_uint(section, reaction.n_products());
+        for(unsigned int p = 0; p < reaction.n_products(); p++)
+          {
+            write_string(section, reaction.product_name(p));
+            write_uint(section, reaction.product_stoichiometric_coefficient(p));
+            write_real(section, reaction.product_partial_order(p));
+          }
+
+        write_uint(section, reaction.n_rate_constants());
+        for(unsigned int k = 0; k < reaction.n_rate_constants(); k++)
+          {
+            const std::vector<NumericType> data = rate_data(reaction.forward_rate(k));
+            write_uint(section, reaction.forward_rate(k).type());
+            write_uint(section, data.size());
+            for(unsigned int i = 0; i < data.size(); i++)
+              write_real(section, data[i]);
+          }
+
+        write_uint(section, reaction.n_efficiency_corrections());
+        for(unsigned int k = 0; k < reaction.n_efficiency_corrections(); k++)
+          {
+            write_string(section, _chem_mixture.chemical_species()[reaction.efficiency_correction_species(k)]->species());
+            write_real(section, reaction.efficiency_correction(k));
+          }
+
+        if(reaction.type() == ReactionType::TROE_FALLOFF ||
+           reaction.type() == ReactionType::TROE_FALLOFF_THREE_BODY)
+          {
+            write_real(section, reaction.get_parameter_of_chemical_process(ReactionType::TROE_ALPHA));
+            write_real(section, reaction.get_parameter_of_chemical_process(ReactionType::TROE_T1));
+            write_real(section, reaction.get_parameter_of_chemical_process(ReactionType::TROE_T2));
+            write_real(section, reaction.get_parameter_of_chemical_process(ReactionType::TROE_T3));
+          }
+
+        if(reaction.type() == ReactionType::PLOG)
+          {
+            const PlogReaction<NumericType> & plog = static_cast<const PlogReaction<NumericType> &>(reaction);
+            for(unsigned int k = 0; k < reaction.n_rate_constants(); k++)
+              write_real(section, plog.pressure(k));
+          }
+
+        if(reaction.type() == ReactionType::CHEBYSHEV)
+          {
+            const ChebyshevReaction<NumericType> & cheb = static_cast<const ChebyshevReaction<NumericType> &>(reaction);
+            write_real(section, cheb.Tmin());
+            write_real(section, cheb.Tmax());
+            write_real(section, cheb.Pmin());
+            write_real(section, cheb.Pmax());
+            write_uint(section, cheb.n_temperature_coefficients());
+            write_uint(section, cheb.n_pressure_coefficients());
+            for(unsigned int t = 0; t < cheb.n_temperature_coefficients(); t++)
+              for(unsigned int p = 0; p < cheb.n_pressure_coefficients(); p++)
+                write_real(section, cheb.coefficient(t,p));
+          }
+      }
+  }
+
+  template <typename NumericType>
+  inline
+  std::vector<char> BinarySnapshotWriter<NumericType>::image() const
+  {
+    Buffer image(BinarySnapshot::magic, BinarySnapshot::magic + sizeof(BinarySnapshot::magic));
+    write_uint(image, BinarySnapshot::endianness_marker);
+    write_uint(image, BinarySnapshot::version);
+    write_uint(image, sizeof(NumericType));
+    write_uint(image, _sections.size());
+
+    for(unsigned int i = 0; i < _sections.size(); i++)
+      {
+        const uint64_t length = _sections[i].second.size();
+        write_uint(image, _sections[i].first);
+        write_bytes(image, &length, sizeof(length));
+        image.insert(image.end(), _sections[i].second.begin(), _sections[i].second.end());
+      }
+
+    return image;
+  }
+
+  template <typename NumericType>
+  inline
+  void BinarySnapshotWriter<NumericType>::write(const std::string & filename) const
+  {
+    const Buffer image = this->image();
+
+    std::ofstream doc(filename.c_str(), std::ios::out | std::ios::binary);
+    if(!doc.is_open())
+      antioch_file_error(filename);
+
+    doc.write(&image[0], image.size());
+    if(!doc.good())
+      antioch_error_msg("ERROR: could not write binary snapshot " + filename);
+  }
+
+  template <typename NumericType>
+  inline
+  typename BinarySnapshotWriter<NumericType>::Buffer &
+  BinarySnapshotWriter<NumericType>::new_section(BinarySnapshot::Section section)
+  {
+    for(unsigned int i = 0; i < _sections.size(); i++)
+      if(_sections[i].first == static_cast<unsigned int>(section))
+        antioch_error_msg("ERROR: section already added to the binary snapshot!");
+
+    _sections.push_back(std::make_pair(static_cast<unsigned int>(section), Buffer()));
+
+    return _sections.back().second;
+  }
+
+  template <typename NumericType>
+  inline
+  void BinarySnapshotWriter<NumericType>::write_bytes(Buffer & buffer, const void * data, std::size_t n)
+  {
+    const char * bytes = static_cast<const char *>(data);
+    buffer.insert(buffer.end(), bytes, bytes + n);
+  }
+
+  template <typename NumericType>
+  inline
+  void BinarySnapshotWriter<NumericType>::write_uint(Buffer & buffer, unsigned int value)
+  {
+    const uint32_t stored = value;
+    write_bytes(buffer, &stored, sizeof(stored));
+  }
+
+  template <typename NumericType>
+  inline
+  void BinarySnapshotWriter<NumericType>::write_int(Buffer & buffer, int value)
+  {
+    const int32_t stored = value;
+    write_bytes(buffer, &stored, sizeof(stored));
+  }
+
+  template <typename NumericType>
+  inline
+  void BinarySnapshotWriter<NumericType>::write_real(Buffer & buffer, NumericType value)
+  {
+    // zero the padding of extended precision types, snapshots are reproducible
+    char bytes[sizeof(NumericType)];
+    std::memset(bytes, 0, sizeof(bytes));
+    std::memcpy(bytes, &value, sizeof(value));
+    write_bytes(buffer, bytes, sizeof(bytes));
+  }
+
+  template <typename NumericType>
+  inline
+  void BinarySnapshotWriter<NumericType>::write_string(Buffer & buffer, const std::string & value)
+  {
+    write_uint(buffer, value.size());
+    write_bytes(buffer, value.data(), value.size());
+  }
+
+  template <typename NumericType>
+  inline
+  std::vector<NumericType> BinarySnapshotWriter<NumericType>::rate_data(const KineticsType<NumericType> & rate)
+  {
+    const NumericType Tref = KineticsModel::Tref<NumericType>();
+
+    std::vector<NumericType> data;
+    switch(rate.type())
+      {
+      case(KineticsModel::CONSTANT):
+        {
+          const ConstantRate<NumericType> & k = static_cast<const ConstantRate<NumericType>&>(rate);
+          data.push_back(k.Cf());
+        }
+        break;
+
+      case(KineticsModel::HERCOURT_ESSEN):
+        {
+          const HercourtEssenRate<NumericType> & k = static_cast<const HercourtEssenRate<NumericType>&>(rate);
+          data.push_back(k.Cf());
+          data.push_back(k.eta());
+          data.push_back(Tref);
+        }
+        break;
+
+      case(KineticsModel::BERTHELOT):
+        {
+          const BerthelotRate<NumericType> & k = static_cast<const BerthelotRate<NumericType>&>(rate);
+          data.push_back(k.Cf());
+          data.push_back(k.D());
+        }
+        break;
+
+      case(KineticsModel::ARRHENIUS):
+        {
+          const ArrheniusRate<NumericType> & k = static_cast<const ArrheniusRate<NumericType>&>(rate);
+          data.push_back(k.Cf());
+          data.push_back(k.Ea());
+          data.push_back(k.rscale());
+        }
+        break;
+
+      case(KineticsModel::BHE):
+        {
+          const BerthelotHercourtEssenRate<NumericType> & k = static_cast<const BerthelotHercourtEssenRate<NumericType>&>(rate);
+          data.push_back(k.Cf());
+          data.push_back(k.eta());
+          data.push_back(k.D());
+          data.push_back(Tref);
+        }
+        break;
+
+      case(KineticsModel::KOOIJ):
+        {
+          const KooijRate<NumericType> & k = static_cast<const KooijRate<NumericType>&>(rate);
+          data.push_back(k.Cf());
+          data.push_back(k.eta());
+          data.push_back(k.Ea());
+          data.push_back(Tref);
+          data.push_back(k.rscale());
+        }
+        break;
+
+      case(KineticsModel::VANTHOFF):
+        {
+          const VantHoffRate<NumericType> & k = static_cast<const VantHoffRate<NumericType>&>(rate);
+          data.push_back(k.Cf());
+          data.push_back(k.eta());
+          data.push_back(k.Ea());
+          data.push_back(k.D());
+          data.push_back(Tref);
+          data.push_back(k.rscale());
+        }
+        break;
+
+      case(KineticsModel::PHOTOCHEM):
+        {
+          const PhotochemicalRate<NumericType,std::vector<NumericType> > & k =
+            static_cast<const PhotochemicalRate<NumericType,std::vector<NumericType> >&>(rate);
+          data = k.lambda_grid();
+          const std::vector<NumericType> cross_section = k.cross_section();
+          data.insert(data.end(), cross_section.begin(), cross_section.end());
+        }
+        break;
+
+      default:
+        {
+          antioch_error();
+        }
+
+      } // switch(rate.type())
+
+    return data;
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_BINARY_SNAPSHOT_WRITER_H
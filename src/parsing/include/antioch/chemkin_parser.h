@@ -204,6 +204,19 @@ namespace Antioch{
          /*! return true is alpha*/
          bool Troe_T3_parameter(   NumericType & T3,    std::string & T3_unit,    std::string & def_unit) const;
 
+         /*! return true if pressure of the PLOG rate constant*/
+         bool rate_constant_pressure_parameter(NumericType & P, std::string & P_unit, std::string & def_unit) const;
+
+         /*! return true if TCHEB is given*/
+         bool Chebyshev_temperature_range(NumericType & Tmin, NumericType & Tmax, std::string & T_unit, std::string & def_unit) const;
+
+         /*! return true if PCHEB is given*/
+         bool Chebyshev_pressure_range(NumericType & Pmin, NumericType & Pmax, std::string & P_unit, std::string & def_unit) const;
+
+         /*! return true if CHEB is given*/
+         bool Chebyshev_coefficients(unsigned int & n_T, unsigned int & n_P, std::vector<NumericType> & coeffs,
+                                     std::string & coeffs_unit, std::string & def_unit) const;
+
         private:
 
           //! reads the thermo, NASA generalist
@@ -290,6 +303,15 @@ namespace Antioch{
           NumericType                      _Troe_T2;
           NumericType                      _Troe_T3;
 
+          std::vector<NumericType>         _plog_pressures;
+          NumericType                      _cheb_Tmin;
+          NumericType                      _cheb_Tmax;
+          NumericType                      _cheb_Pmin;
+          NumericType                      _cheb_Pmax;
+          unsigned int                     _cheb_n_T;
+          unsigned int                     _cheb_n_P;
+          std::vector<NumericType>         _cheb_coeffs;
+
           std::map<ParsingKey,std::string> _map;
           std::map<ParsingKey,std::string> _default_unit;
 
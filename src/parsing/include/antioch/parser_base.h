@@ -287,6 +287,36 @@ namespace Antioch
                                    std::string & /*def_unit*/) const
     {antioch_not_implemented_msg(_not_implemented); return false;}
 
+    /*! \return true if the current rate constant has a PLOG pressure*/
+    virtual bool rate_constant_pressure_parameter(NumericType & /*P*/,
+                                                  std::string & /*P_unit*/,
+                                                  std::string & /*def_unit*/) const
+    {antioch_not_implemented_msg(_not_implemented); return false;}
+
+    /*! \return true if the Chebyshev temperature range is given*/
+    virtual bool Chebyshev_temperature_range(NumericType & /*Tmin*/,
+                                             NumericType & /*Tmax*/,
+                                             std::string & /*T_unit*/,
+                                             std::string & /*def_unit*/) const
+    {antioch_not_implemented_msg(_not_implemented); return false;}
+
+    /*! \return true if the Chebyshev pressure range is given*/
+    virtual bool Chebyshev_pressure_range(NumericType & /*Pmin*/,
+                                          NumericType & /*Pmax*/,
+                                          std::string & /*P_unit*/,
+                                          std::string & /*def_unit*/) const
+    {antioch_not_implemented_msg(_not_implemented); return false;}
+
+    /*! \return true if Chebyshev coefficients, temperature-major,
+        log10 of the rate constant. As for the pre-exponential
+        parameter, def_unit is only the [quantity-1] unit.*/
+    virtual bool Chebyshev_coefficients(unsigned int & /*n_T*/,
+                                        unsigned int & /*n_P*/,
+                                        std::vector<NumericType> & /*coeffs*/,
+                                        std::string & /*coeffs_unit*/,
+                                        std::string & /*def_unit*/) const
+    {antioch_not_implemented_msg(_not_implemented); return false;}
+
     /*! \return name of file*/
     const std::string file() const {return _file;}
 
@@ -31,7 +31,8 @@ namespace Antioch
 {
   enum ParsingType{ASCII = 0,
                    XML,
-                   CHEMKIN};
+                   CHEMKIN,
+                   BINARY};
 
   enum ParsingKey{SPECIES_SET = 0,
                   SPECIES_DATA,
@@ -74,6 +75,14 @@ namespace Antioch
                   TROE_F_TS,
                   TROE_F_TSS,
                   TROE_F_TSSS,
+                  PLOG_PRESSURE,
+                  CHEBYSHEV_TMIN,
+                  CHEBYSHEV_TMAX,
+                  CHEBYSHEV_PMIN,
+                  CHEBYSHEV_PMAX,
+                  CHEBYSHEV_COEFFICIENTS,
+                  CHEBYSHEV_N_T,
+                  CHEBYSHEV_N_P,
 //
                   TRANSPORT,
                   LJ_WELLDEPTH,
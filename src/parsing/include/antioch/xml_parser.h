@@ -62,8 +62,8 @@ namespace Antioch{
   /*!\class XMLParser
 
     Nothing is stored, this parser is based on the tinyxml2
-    implementation. Please note that no other file should include
-    the `tinyxml2_imp.h' header.
+    implementation. Please note that no other file than the XMLParser
+    and XMLStreamParser sources should include the `tinyxml2_imp.h' header.
 
     The defaults units are based and derived on Cantera:
     -   pre-exponential parameters in (m3/kmol)^(m-1)/s
@@ -235,13 +235,58 @@ namespace Antioch{
     /*! return true if a Troe parameter in a GRI way*/
     bool Troe_GRI_parameter( NumericType & pa, unsigned int index ) const;
 
-  private:
+    /*! return true if pressure of the PLOG rate constant*/
+    bool rate_constant_pressure_parameter( NumericType & P,
+                                           std::string & P_unit,
+                                           std::string & def_unit ) const;
+
+    /*! return true if Tmin and Tmax of a Chebyshev reaction*/
+    bool Chebyshev_temperature_range( NumericType & Tmin, NumericType & Tmax,
+                                      std::string & T_unit,
+                                      std::string & def_unit ) const;
+
+    /*! return true if Pmin and Pmax of a Chebyshev reaction*/
+    bool Chebyshev_pressure_range( NumericType & Pmin, NumericType & Pmax,
+                                   std::string & P_unit,
+                                   std::string & def_unit ) const;
+
+    /*! return true if coefficients of a Chebyshev reaction*/
+    bool Chebyshev_coefficients( unsigned int & n_T, unsigned int & n_P,
+                                 std::vector<NumericType> & coeffs,
+                                 std::string & coeffs_unit,
+                                 std::string & def_unit ) const;
+
+  protected:
+
+    //! Constructor for derived parsers that manage their own input
+    /*! Sets up the name maps but neither loads the file nor
+        calls initialize(). */
+    XMLParser(const std::string & filename, const std::string & phase_name,
+              bool verbose, bool load_document);
+
+    //! Parse the NASA intervals of one <species> element
+    /*! Fills temps with Tmin followed by every Tmax and values with the
+        coefficients of all intervals, ready for add_curve_fit(). */
+    void read_species_curve_fit( const std::string & species_name,
+                                 const tinyxml2::XMLElement * species_elem,
+                                 const std::string & nasa_xml_section,
+                                 std::vector<NumericType> & temps,
+                                 std::vector<NumericType> & values ) const;
+
+    //! Parse the <transport> block of one <species> element into the mixture
+    void read_species_transport( TransportMixture<NumericType> & transport_mixture,
+                                 const std::string & species_name,
+                                 const tinyxml2::XMLElement * species_elem );
+
+    //! True if the <thermo> block of the <species> element is NASA7, false if NASA9
+    bool species_is_nasa7( const tinyxml2::XMLElement * species_elem ) const;
+
 
     //! Read the transport property given by the particular ParsingKey
     /*! Currently, we don't support unit conversion for these properties,
         so we just error out if the specified units aren't what we expected. */
     NumericType read_transport_property(const std::string & species_name,
-                                        tinyxml2::XMLElement * species_elem,
+                                        const tinyxml2::XMLElement * species_elem,
                                         ParsingKey key,
                                         const std::string & expected_unit);
 
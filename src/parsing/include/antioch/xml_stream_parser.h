@@ -0,0 +1,216 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+#ifndef ANTIOCH_XML_STREAM_PARSER_H
+#define ANTIOCH_XML_STREAM_PARSER_H
+
+// Antioch
+#include "antioch/xml_parser.h"
+
+// C++
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Antioch
+{
+  /*!\class XMLTagScanner
+
+    Forward-only tokenizer over the markup of an XML file. The file
+    is read through a fixed-size buffer; only the tag currently being
+    scanned is held in memory, unless an element is explicitly
+    captured with capture_element(). Comments, CDATA sections,
+    processing instructions and DOCTYPE declarations are skipped.
+  */
+  class XMLTagScanner
+  {
+  public:
+
+    enum TagKind{ START_TAG,   // <tag ...>
+                  END_TAG,     // </tag>
+                  EMPTY_TAG }; // <tag .../>
+
+    XMLTagScanner( std::size_t buffer_size = 65536 );
+
+    //! (Re)open filename and position the scanner at its beginning
+    void open( const std::string & filename );
+
+    //! Offset in the file of the next character to be scanned
+    std::streamoff tell() const
+    { return _buffer_offset + static_cast<std::streamoff>(_pos); }
+
+    //! Resume scanning at offset, as returned by tell()
+    void seek( std::streamoff offset );
+
+    //! Advance to the next tag, false at end of file
+    /*! name is the element name, tag the full markup `<...>'. */
+    bool next_tag( TagKind & kind, std::string & name, std::string & tag );
+
+    //! Skip the content of the element whose start tag was just read
+    void skip_element( const std::string & name );
+
+    //! Read the element whose start tag was just read
+    /*! element holds the whole markup, from start_tag to the
+        matching end tag, ready to be handed to an XML parser. */
+    void capture_element( const std::string & name,
+                          const std::string & start_tag,
+                          std::string & element );
+
+    //! Value of attribute in the markup tag, false if absent
+    static bool attribute( const std::string & tag,
+                           const std::string & attribute,
+                           std::string & value );
+
+  private:
+
+    //! Refill the buffer, false at end of file
+    bool fill();
+
+    //! Next character of the file, false at end of file
+    bool get( char & c );
+
+    //! Consume characters up to and including delimiter
+    void skip_past( const char * delimiter );
+
+    //! Read the element content until its matching end tag
+    void read_to_end_tag( const std::string & name );
+
+    std::string _filename;
+
+    std::ifstream _stream;
+
+    std::vector<char> _buffer;
+    std::streamoff _buffer_offset;
+    std::size_t _pos;
+    std::size_t _end;
+
+    //! While capturing, every consumed character is appended here
+    std::string * _capture;
+  };
+
+  /*!\class XMLStreamParser
+
+    Streaming counterpart of XMLParser for large mechanisms. The file is
+    never loaded as a whole: each pass scans it with an XMLTagScanner and
+    only one <species> or <reaction> element at a time is parsed into
+    a small XML document. The reaction getters and the unit handling are
+    those of XMLParser, applied to that element.
+
+    Thermo and transport are read in a single pass over the speciesData
+    section, looking species up by name, instead of one sibling search
+    per species of the mixture.
+
+    Usage is the same as for an XMLParser given a phase name:
+    \code
+    XMLStreamParser<double> parser(filename,"gri30_mix",false);
+    ChemicalMixture<double> mixture(parser.species_list());
+    ReactionSet<double> reaction_set(mixture);
+    read_reaction_set_data(false,reaction_set,&parser);
+    \endcode
+  */
+  template <typename NumericType = double>
+  class XMLStreamParser: public XMLParser<NumericType>
+  {
+  public:
+
+    //! As for XMLParser, phase_name "NONE" selects the first phase of the file
+    XMLStreamParser(const std::string & filename, const std::string & phase_name, bool verbose = true);
+
+    XMLStreamParser() = delete;
+
+    virtual ~XMLStreamParser() = default;
+
+    void change_file(const std::string & filename);
+
+    /*! Go to the reaction data section of the phase, false if there is none */
+    bool initialize();
+
+    //! reads the species set
+    const std::vector<std::string> species_list();
+
+    //! See XMLParser::is_nasa7_curve_fit_type()
+    bool is_nasa7_curve_fit_type() const;
+
+    //! reads the thermo, NASA generalist, no templates for virtual
+    void read_thermodynamic_data(NASAThermoMixture<NumericType, NASA7CurveFit<NumericType> >& thermo);
+
+    //! reads the thermo, NASA generalist, no templates for virtual
+    void read_thermodynamic_data(NASAThermoMixture<NumericType, NASA9CurveFit<NumericType> >& thermo);
+
+    //! reads the thermo, NASA generalist, no templates for virtual
+    void read_thermodynamic_data(NASAThermoMixture<NumericType, CEACurveFit<NumericType> >& /*thermo*/)
+    {antioch_error_msg("ERROR: XML Parsing only supports parsing for NASA7CurveFit and NASA9CurveFit!");}
+
+    virtual void read_transport_data(TransportMixture<NumericType> & transport_mixture);
+
+    /*! go to next reaction*/
+    bool reaction();
+
+  private:
+
+    //! Find the phase and the names of its data sections
+    void read_phase();
+
+    //! Position scanner inside the data section section_name whose id is datasrc
+    /*! An empty datasrc selects the first such section. The offset of
+        the section is kept, so later passes seek to it directly. */
+    bool find_data_section( XMLTagScanner & scanner,
+                            const std::string & section_name,
+                            const std::string & datasrc ) const;
+
+    //! Parse the next <species> element of the current speciesData section
+    /*! Returns NULL at the end of the section. When wanted is not
+        empty, species absent from it are skipped without being parsed. */
+    const tinyxml2::XMLElement * next_species( XMLTagScanner & scanner,
+                                               tinyxml2::XMLDocument & doc,
+                                               const std::map<std::string,unsigned int> & wanted,
+                                               std::string & name ) const;
+
+    template <typename ThermoType>
+    void read_thermodynamic_data_root(ThermoType & thermo);
+
+    std::vector<std::string> _species_list;
+    bool _has_species_array;
+
+    //! ids of the speciesData and reactionData sections, empty for the first one
+    std::string _species_datasrc;
+    std::string _reaction_datasrc;
+    bool _has_reaction_data;
+
+    //! Offset of the content of the data sections found so far
+    mutable std::map<std::string,std::streamoff> _section_offsets;
+
+    //! reaction pass
+    XMLTagScanner _scanner;
+    bool _in_reaction_data;
+    std::string _element;
+    std::unique_ptr<tinyxml2::XMLDocument> _reaction_doc;
+  };
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_XML_STREAM_PARSER_H
@@ -50,6 +50,12 @@ namespace Antioch
     //! The number of intervals for this NASA9 curve fit
     unsigned int n_intervals() const;
 
+    //! The number of coefficients in each interval
+    unsigned int n_coeffs() const;
+
+    //! The temperatures bounding the intervals
+    const std::vector<CoeffType>& temperatures() const;
+
     //! The interval the input temperature lies in
     /*!
       @returns which curve fit interval the input temperature
@@ -112,6 +118,16 @@ namespace Antioch
   unsigned int NASACurveFitBase<CoeffType>::n_intervals() const
   { return _coefficients.size() / _n_coeffs; }
 
+  template<typename CoeffType>
+  inline
+  unsigned int NASACurveFitBase<CoeffType>::n_coeffs() const
+  { return _n_coeffs; }
+
+  template<typename CoeffType>
+  inline
+  const std::vector<CoeffType>& NASACurveFitBase<CoeffType>::temperatures() const
+  { return _temp; }
+
   template<typename CoeffType>
   template<typename StateType>
   inline
@@ -62,13 +62,13 @@ const UnitBaseConstant::UnitBaseStore<long double> storage_unit;
 const UnitBaseConstant::SIPrefixeStore<long double> storage_prefixe;
 
 inline
-const UnitBaseConstant::UnitBaseStore<long double>  known_units()
+const UnitBaseConstant::UnitBaseStore<long double> & known_units()
 {
    return storage_unit;
 }
 
 inline
-const UnitBaseConstant::SIPrefixeStore<long double> known_prefixes()
+const UnitBaseConstant::SIPrefixeStore<long double> & known_prefixes()
 {
   return storage_prefixe;
 }
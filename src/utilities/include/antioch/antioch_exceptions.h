@@ -78,6 +78,18 @@ namespace Antioch
     {}
   };
 
+  /*!
+   * A class representing a failed time integration, e.g. a step size
+   * falling below the resolution of the time variable.
+   */
+  class FailedIntegration : public std::runtime_error
+  {
+  public:
+    FailedIntegration (const std::string &description)
+      : std::runtime_error (description)
+    {}
+  };
+
   /*!
    * A class representing error in units
    */
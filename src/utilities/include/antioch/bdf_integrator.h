@@ -0,0 +1,747 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+
+
+
+#ifndef ANTIOCH_BDF_INTEGRATOR_H
+#define ANTIOCH_BDF_INTEGRATOR_H
+
+// Antioch
+#include "antioch/antioch_asserts.h"
+#include "antioch/antioch_exceptions.h"
+#include "antioch/dense_lu_solver.h"
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace Antioch
+{
+  //! Variable order, variable step BDF integrator for stiff systems
+  /*!
+   * The solution history is kept as backward differences on an equally
+   * spaced grid, rescaled on each step size change (the quasi-constant
+   * step formulation of Shampine and Reichelt). The implicit equations
+   * are solved by a simplified Newton iteration. The Jacobian is only
+   * reevaluated when the iteration fails to converge, and the iteration
+   * matrix is only refactorized when the step size or the order change,
+   * so that a factorization serves many steps.
+   *
+   * SystemType must provide
+   * \code
+   * unsigned int n_equations() const;
+   * void rhs( Scalar t, const std::vector<Scalar>& y, std::vector<Scalar>& dy_dt );
+   * void jacobian( Scalar t, const std::vector<Scalar>& y, std::vector<Scalar>& J );
+   * \endcode
+   * where J is row major, J[i*n+j] = d(dy_dt[i])/dy_j.
+   */
+  template<typename Scalar=double>
+  class BDFIntegrator
+  {
+  public:
+
+    BDFIntegrator();
+
+    ~BDFIntegrator();
+
+    //! Local error test: \f$ |e_i| \le \epsilon_a + \epsilon_r |y_i| \f$ in RMS norm
+    void set_tolerances( const Scalar relative_tolerance, const Scalar absolute_tolerance );
+
+    //! Between 1 and 5, defaults to 5
+    void set_max_order( const unsigned int max_order );
+
+    //! Defaults to infinity
+    void set_max_step_size( const Scalar max_step_size );
+
+    //! 0, the default, lets the integrator choose
+    void set_initial_step_size( const Scalar initial_step_size );
+
+    //! Maximum number of steps of an integrate() call
+    void set_max_steps( const unsigned int max_steps );
+
+    //! Advance \p y from \p t_start to \p t_end
+    /*! Throws FailedIntegration if the step size underflows or the
+     *  maximum number of steps is exceeded. */
+    template<typename SystemType>
+    void integrate( SystemType& system, const Scalar t_start, const Scalar t_end,
+                    std::vector<Scalar>& y );
+
+    //! \name Statistics of the last integrate() call
+    //! @{
+    unsigned int n_steps() const;
+
+    unsigned int n_rejected_steps() const;
+
+    unsigned int n_rhs_evaluations() const;
+
+    unsigned int n_jacobian_evaluations() const;
+
+    unsigned int n_factorizations() const;
+
+    //! Step size the integrator would have taken next
+    Scalar last_step_size() const;
+
+    unsigned int last_order() const;
+    //! @}
+
+    static const unsigned int max_supported_order = 5;
+
+  private:
+
+    //! Rescale the differences of order <= \p order to a step size \p factor times larger
+    void change_step_size( const unsigned int order, const Scalar factor );
+
+    //! R(order,factor) of the difference rescaling, (order+1) x (order+1) row major
+    void step_change_matrix( const unsigned int order, const Scalar factor,
+                             std::vector<Scalar>& R ) const;
+
+    Scalar rms_norm( const std::vector<Scalar>& x, const std::vector<Scalar>& scale ) const;
+
+    //! Simplified Newton iteration for the implicit BDF equations
+    /*! Sets _y_new and _d (the correction to the prediction).
+     *  \returns true on convergence. */
+    template<typename SystemType>
+    bool solve_implicit_system( SystemType& system, const Scalar t_new, const Scalar c,
+                                const Scalar newton_tolerance, unsigned int& n_iterations );
+
+    template<typename SystemType>
+    Scalar initial_step_size( SystemType& system, const Scalar t, const Scalar t_end,
+                              const std::vector<Scalar>& y, const std::vector<Scalar>& f );
+
+    //! Form I - c J and factorize it
+    void factorize_iteration_matrix( const Scalar c );
+
+    Scalar _relative_tolerance;
+    Scalar _absolute_tolerance;
+    unsigned int _max_order;
+    Scalar _max_step_size;
+    Scalar _initial_step_size;
+    unsigned int _max_steps;
+
+    unsigned int _n_steps;
+    unsigned int _n_rejected_steps;
+    unsigned int _n_rhs_evaluations;
+    unsigned int _n_jacobian_evaluations;
+    unsigned int _n_factorizations;
+    Scalar _step_size;
+    unsigned int _order;
+
+    //! _gamma[k] = sum_{j=1}^{k} 1/j, the leading coefficient of order k
+    std::vector<Scalar> _gamma;
+
+    //! backward differences, (max_supported_order+3) rows of n values
+    std::vector<std::vector<Scalar> > _differences;
+
+    std::vector<Scalar> _jacobian;
+    std::vector<Scalar> _iteration_matrix;
+    DenseLUSolver<Scalar> _lu;
+
+    std::vector<Scalar> _f;
+    std::vector<Scalar> _y_predict;
+    std::vector<Scalar> _y_new;
+    std::vector<Scalar> _psi;
+    std::vector<Scalar> _d;
+    std::vector<Scalar> _dy;
+    std::vector<Scalar> _scale;
+    std::vector<Scalar> _error;
+
+    //! coefficients of the rescaled differences of one component
+    std::vector<Scalar> _work;
+  };
+
+  /* ------------------------- Inline Functions -------------------------*/
+  template<typename Scalar>
+  inline
+  BDFIntegrator<Scalar>::BDFIntegrator()
+    : _relative_tolerance(1e-6),
+      _absolute_tolerance(1e-12),
+      _max_order(max_supported_order),
+      _max_step_size(std::numeric_limits<Scalar>::infinity()),
+      _initial_step_size(0),
+      _max_steps(100000),
+      _n_steps(0),
+      _n_rejected_steps(0),
+      _n_rhs_evaluations(0),
+      _n_jacobian_evaluations(0),
+      _n_factorizations(0),
+      _step_size(0),
+      _order(1),
+      _gamma(max_supported_order+1,0),
+      _differences(max_supported_order+3)
+  {
+    for( unsigned int k = 1; k <= max_supported_order; k++ )
+      _gamma[k] = _gamma[k-1] + 1/static_cast<Scalar>(k);
+  }
+
+  template<typename Scalar>
+  inline
+  BDFIntegrator<Scalar>::~BDFIntegrator()
+  {
+    return;
+  }
+
+  template<typename Scalar>
+  inline
+  void BDFIntegrator<Scalar>::set_tolerances( const Scalar relative_tolerance, const Scalar absolute_tolerance )
+  {
+    antioch_assert_greater( relative_tolerance, Scalar(0) );
+    antioch_assert_greater_equal( absolute_tolerance, Scalar(0) );
+
+    _relative_tolerance = relative_tolerance;
+    _absolute_tolerance = absolute_tolerance;
+  }
+
+  template<typename Scalar>
+  inline
+  void BDFIntegrator<Scalar>::set_max_order( const unsigned int max_order )
+  {
+    antioch_assert_greater( max_order, 0 );
+    antioch_assert_less_equal( max_order, max_supported_order );
+
+    _max_order = max_order;
+  }
+
+  template<typename Scalar>
+  inline
+  void BDFIntegrator<Scalar>::set_max_step_size( const Scalar max_step_size )
+  {
+    antioch_assert_greater( max_step_size, Scalar(0) );
+    _max_step_size = max_step_size;
+  }
+
+  template<typename Scalar>
+  inline
+  void BDFIntegrator<Scalar>::set_initial_step_size( const Scalar initial_step_size )
+  {
+    antioch_assert_greater_equal( initial_step_size, Scalar(0) );
+    _initial_step_size = initial_step_size;
+  }
+
+  template<typename Scalar>
+  inline
+  void BDFIntegrator<Scalar>::set_max_steps( const unsigned int max_steps )
+  {
+    _max_steps = max_steps;
+  }
+
+  template<typename Scalar>
+  inline
+  unsigned int BDFIntegrator<Scalar>::n_steps() const
+  {
+    return _n_steps;
+  }
+
+  template<typename Scalar>
+  inline
+  unsigned int BDFIntegrator<Scalar>::n_rejected_steps() const
+  {
+    return _n_rejected_steps;
+  }
+
+  template<typename Scalar>
+  inline
+  unsigned int BDFIntegrator<Scalar>::n_rhs_evaluations() const
+  {
+    return _n_rhs_evaluations;
+  }
+
+  template<typename Scalar>
+  inline
+  unsigned int BDFIntegrator<Scalar>::n_jacobian_evaluations() const
+  {
+    return _n_jacobian_evaluations;
+  }
+
+  template<typename Scalar>
+  inline
+  unsigned int BDFIntegrator<Scalar>::n_factorizations() const
+  {
+    return _n_factorizations;
+  }
+
+  template<typename Scalar>
+  inline
+  Scalar BDFIntegrator<Scalar>::last_step_size() const
+  {
+    return _step_size;
+  }
+
+  template<typename Scalar>
+  inline
+  unsigned int BDFIntegrator<Scalar>::last_order() const
+  {
+    return _order;
+  }
+
+  template<typename Scalar>
+  inline
+  Scalar BDFIntegrator<Scalar>::rms_norm( const std::vector<Scalar>& x, const std::vector<Scalar>& scale ) const
+  {
+    using std::sqrt;
+
+    Scalar sum = 0;
+    for( unsigned int i = 0; i < x.size(); i++ )
+      sum += (x[i]/scale[i])*(x[i]/scale[i]);
+
+    return sqrt(sum/static_cast<Scalar>(x.size()));
+  }
+
+  template<typename Scalar>
+  inline
+  void BDFIntegrator<Scalar>::step_change_matrix( const unsigned int order, const Scalar factor,
+                                                  std::vector<Scalar>& R ) const
+  {
+    const unsigned int m = order+1;
+    R.assign(m*m,0);
+
+    // cumulative products down the columns of
+    // M(0,j) = 1, M(i,j) = (i - 1 - factor j)/i for i,j >= 1
+    for( unsigned int j = 0; j < m; j++ )
+      R[j] = 1;
+
+    for( unsigned int i = 1; i < m; i++ )
+      for( unsigned int j = 1; j < m; j++ )
+        R[i*m+j] = R[(i-1)*m+j] * ( static_cast<Scalar>(i) - 1 - factor*static_cast<Scalar>(j) ) / static_cast<Scalar>(i);
+  }
+
+  template<typename Scalar>
+  inline
+  void BDFIntegrator<Scalar>::change_step_size( const unsigned int order, const Scalar factor )
+  {
+    const unsigned int m = order+1;
+
+    std::vector<Scalar> R, U;
+    this->step_change_matrix( order, factor, R );
+    this->step_change_matrix( order, 1, U );
+
+    // RU = R U
+    std::vector<Scalar> RU(m*m,0);
+    for( unsigned int i = 0; i < m; i++ )
+      for( unsigned int k = 0; k < m; k++ )
+        for( unsigned int j = 0; j < m; j++ )
+          RU[i*m+j] += R[i*m+k]*U[k*m+j];
+
+    // D[0:m] = RU^T D[0:m]
+    const unsigned int n = _differences[0].size();
+    for( unsigned int e = 0; e < n; e++ )
+      {
+        for( unsigned int j = 0; j < m; j++ )
+          {
+            _work[j] = 0;
+            for( unsigned int i = 0; i < m; i++ )
+              _work[j] += RU[i*m+j]*_differences[i][e];
+          }
+        for( unsigned int j = 0; j < m; j++ )
+          _differences[j][e] = _work[j];
+      }
+  }
+
+  template<typename Scalar>
+  inline
+  void BDFIntegrator<Scalar>::factorize_iteration_matrix( const Scalar c )
+  {
+    const unsigned int n = _f.size();
+
+    for( unsigned int i = 0; i < n; i++ )
+      for( unsigned int j = 0; j < n; j++ )
+        _iteration_matrix[i*n+j] = ( i == j ? 1 : 0 ) - c*_jacobian[i*n+j];
+
+    _n_factorizations++;
+
+    if( !_lu.factorize(_iteration_matrix) )
+      throw FailedIntegration("ERROR: singular BDF iteration matrix!");
+  }
+
+  template<typename Scalar>
+  template<typename SystemType>
+  inline
+  bool BDFIntegrator<Scalar>::solve_implicit_system( SystemType& system, const Scalar t_new, const Scalar c,
+                                                     const Scalar newton_tolerance, unsigned int& n_iterations )
+  {
+    using std::pow;
+
+    const unsigned int max_iterations = 4;
+    const unsigned int n = _f.size();
+
+    _y_new = _y_predict;
+    std::fill( _d.begin(), _d.end(), 0 );
+
+    Scalar dy_norm_old = -1;
+    bool converged = false;
+
+    for( n_iterations = 1; n_iterations <= max_iterations; n_iterations++ )
+      {
+        system.rhs( t_new, _y_new, _f );
+        _n_rhs_evaluations++;
+
+        bool finite = true;
+        for( unsigned int i = 0; i < n; i++ )
+          finite = finite && ( std::abs(_f[i]) <= std::numeric_limits<Scalar>::max() );
+        if( !finite )
+          break;
+
+        for( unsigned int i = 0; i < n; i++ )
+          _dy[i] = c*_f[i] - _psi[i] - _d[i];
+        _lu.solve(_dy);
+
+        const Scalar dy_norm = this->rms_norm( _dy, _scale );
+
+        Scalar rate = -1;
+        if( dy_norm_old >= 0 )
+          rate = dy_norm / dy_norm_old;
+
+        // diverging, or not converging within the remaining iterations
+        if( rate >= 0 &&
+            ( rate >= 1 ||
+              pow(rate, static_cast<Scalar>(max_iterations - n_iterations + 1))/(1 - rate)*dy_norm > newton_tolerance ) )
+          break;
+
+        for( unsigned int i = 0; i < n; i++ )
+          {
+            _y_new[i] += _dy[i];
+            _d[i] += _dy[i];
+          }
+
+        if( dy_norm == 0 ||
+            ( rate >= 0 && rate/(1 - rate)*dy_norm < newton_tolerance ) )
+          {
+            converged = true;
+            break;
+          }
+
+        dy_norm_old = dy_norm;
+      }
+
+    n_iterations = std::min( n_iterations, max_iterations );
+
+    return converged;
+  }
+
+  template<typename Scalar>
+  template<typename SystemType>
+  inline
+  Scalar BDFIntegrator<Scalar>::initial_step_size( SystemType& system, const Scalar t, const Scalar t_end,
+                                                   const std::vector<Scalar>& y, const std::vector<Scalar>& f )
+  {
+    using std::abs;
+    using std::max;
+    using std::min;
+    using std::sqrt;
+
+    const unsigned int n = y.size();
+
+    for( unsigned int i = 0; i < n; i++ )
+      _scale[i] = _absolute_tolerance + _relative_tolerance*abs(y[i]);
+
+    const Scalar d0 = this->rms_norm( y, _scale );
+    const Scalar d1 = this->rms_norm( f, _scale );
+
+    Scalar h0 = ( d0 < 1e-5 || d1 < 1e-5 ) ? Scalar(1e-6) : Scalar(0.01)*d0/d1;
+    h0 = min( h0, t_end - t );
+
+    // one explicit Euler step to estimate the second derivative
+    for( unsigned int i = 0; i < n; i++ )
+      _y_new[i] = y[i] + h0*f[i];
+
+    system.rhs( t + h0, _y_new, _error );
+    _n_rhs_evaluations++;
+
+    for( unsigned int i = 0; i < n; i++ )
+      _dy[i] = _error[i] - f[i];
+
+    const Scalar d2 = this->rms_norm( _dy, _scale ) / h0;
+
+    Scalar h1;
+    if( d1 <= 1e-15 && d2 <= 1e-15 )
+      h1 = max( Scalar(1e-6), h0*Scalar(1e-3) );
+    else
+      h1 = sqrt( Scalar(0.01)/max(d1,d2) );
+
+    return min( 100*h0, h1 );
+  }
+
+  template<typename Scalar>
+  template<typename SystemType>
+  inline
+  void BDFIntegrator<Scalar>::integrate( SystemType& system, const Scalar t_start, const Scalar t_end,
+                                         std::vector<Scalar>& y )
+  {
+    using std::abs;
+    using std::max;
+    using std::min;
+    using std::pow;
+    using std::sqrt;
+
+    const unsigned int n = system.n_equations();
+    antioch_assert_equal_to( y.size(), n );
+    antioch_assert_greater_equal( t_end, t_start );
+
+    const Scalar min_factor = 0.2;
+    const Scalar max_factor = 10;
+    const unsigned int max_iterations = 4;
+    const Scalar eps = std::numeric_limits<Scalar>::epsilon();
+
+    _n_steps = 0;
+    _n_rejected_steps = 0;
+    _n_rhs_evaluations = 0;
+    _n_jacobian_evaluations = 0;
+    _n_factorizations = 0;
+    _order = 1;
+
+    if( t_end == t_start )
+      return;
+
+    for( unsigned int k = 0; k < _differences.size(); k++ )
+      _differences[k].assign(n,0);
+    _jacobian.resize(n*n);
+    _iteration_matrix.resize(n*n);
+    _lu.resize(n);
+    _f.resize(n);
+    _y_predict.resize(n);
+    _y_new.resize(n);
+    _psi.resize(n);
+    _d.resize(n);
+    _dy.resize(n);
+    _scale.resize(n);
+    _error.resize(n);
+    _work.resize(max_supported_order+3);
+
+    const Scalar newton_tolerance = max( 10*eps/_relative_tolerance, min( Scalar(0.03), sqrt(_relative_tolerance) ) );
+
+    Scalar t = t_start;
+
+    system.rhs( t, y, _f );
+    _n_rhs_evaluations++;
+
+    Scalar h = _initial_step_size;
+    if( h == 0 )
+      h = this->initial_step_size( system, t, t_end, y, _f );
+    h = min( h, _max_step_size );
+
+    _differences[0] = y;
+    for( unsigned int i = 0; i < n; i++ )
+      _differences[1][i] = h*_f[i];
+
+    system.jacobian( t, y, _jacobian );
+    _n_jacobian_evaluations++;
+
+    unsigned int order = 1;
+    unsigned int n_equal_steps = 0;
+    bool factorized = false;
+
+    // error constants of the BDF formulas, 1/(k+1)
+    std::vector<Scalar> error_const(max_supported_order+2);
+    for( unsigned int k = 0; k < error_const.size(); k++ )
+      error_const[k] = 1/static_cast<Scalar>(k+1);
+
+    while( t < t_end )
+      {
+        if( _n_steps >= _max_steps )
+          throw FailedIntegration("ERROR: maximum number of BDF steps exceeded!");
+
+        const Scalar min_step = 10*abs( std::nextafter(t, std::numeric_limits<Scalar>::infinity()) - t );
+
+        if( h > _max_step_size )
+          {
+            this->change_step_size( order, _max_step_size/h );
+            h = _max_step_size;
+            n_equal_steps = 0;
+            factorized = false;
+          }
+        else if( h < min_step )
+          {
+            this->change_step_size( order, min_step/h );
+            h = min_step;
+            n_equal_steps = 0;
+            factorized = false;
+          }
+
+        // the Jacobian is current if evaluated at this step
+        bool current_jacobian = false;
+        bool step_accepted = false;
+        Scalar t_new = t;
+        Scalar error_norm = 0;
+        Scalar safety = 0;
+
+        while( !step_accepted )
+          {
+            if( h < min_step )
+              throw FailedIntegration("ERROR: BDF step size too small!");
+
+            t_new = t + h;
+            if( t_new > t_end )
+              {
+                t_new = t_end;
+                this->change_step_size( order, (t_new - t)/h );
+                n_equal_steps = 0;
+                factorized = false;
+              }
+            h = t_new - t;
+
+            // prediction and history term
+            for( unsigned int i = 0; i < n; i++ )
+              {
+                _y_predict[i] = 0;
+                for( unsigned int k = 0; k <= order; k++ )
+                  _y_predict[i] += _differences[k][i];
+
+                _scale[i] = _absolute_tolerance + _relative_tolerance*abs(_y_predict[i]);
+
+                _psi[i] = 0;
+                for( unsigned int k = 1; k <= order; k++ )
+                  _psi[i] += _differences[k][i]*_gamma[k];
+                _psi[i] /= _gamma[order];
+              }
+
+            const Scalar c = h/_gamma[order];
+
+            bool converged = false;
+            unsigned int n_iterations = 0;
+            while( !converged )
+              {
+                if( !factorized )
+                  {
+                    this->factorize_iteration_matrix(c);
+                    factorized = true;
+                  }
+
+                converged = this->solve_implicit_system( system, t_new, c, newton_tolerance, n_iterations );
+
+                if( !converged )
+                  {
+                    if( current_jacobian )
+                      break;
+
+                    system.jacobian( t_new, _y_predict, _jacobian );
+                    _n_jacobian_evaluations++;
+                    factorized = false;
+                    current_jacobian = true;
+                  }
+              }
+
+            if( !converged )
+              {
+                _n_rejected_steps++;
+                h *= 0.5;
+                this->change_step_size( order, 0.5 );
+                n_equal_steps = 0;
+                factorized = false;
+                continue;
+              }
+
+            safety = Scalar(0.9)*static_cast<Scalar>(2*max_iterations + 1)/static_cast<Scalar>(2*max_iterations + n_iterations);
+
+            for( unsigned int i = 0; i < n; i++ )
+              {
+                _scale[i] = _absolute_tolerance + _relative_tolerance*abs(_y_new[i]);
+                _error[i] = error_const[order]*_d[i];
+              }
+            error_norm = this->rms_norm( _error, _scale );
+
+            if( error_norm > 1 )
+              {
+                // the Newton iteration went well, the factorization is kept
+                _n_rejected_steps++;
+                const Scalar factor = max( min_factor, safety*pow(error_norm, -1/static_cast<Scalar>(order+1)) );
+                h *= factor;
+                this->change_step_size( order, factor );
+                n_equal_steps = 0;
+              }
+            else
+              step_accepted = true;
+          }
+
+        _n_steps++;
+        n_equal_steps++;
+        t = t_new;
+
+        // update the differences
+        for( unsigned int i = 0; i < n; i++ )
+          {
+            _differences[order+2][i] = _d[i] - _differences[order+1][i];
+            _differences[order+1][i] = _d[i];
+          }
+        for( unsigned int k = order+1; k-- > 0; )
+          for( unsigned int i = 0; i < n; i++ )
+            _differences[k][i] += _differences[k+1][i];
+
+        if( n_equal_steps < order+1 )
+          continue;
+
+        // order and step size selection
+        const Scalar infinity = std::numeric_limits<Scalar>::infinity();
+
+        Scalar error_m_norm = infinity;
+        if( order > 1 )
+          {
+            for( unsigned int i = 0; i < n; i++ )
+              _error[i] = error_const[order-1]*_differences[order][i];
+            error_m_norm = this->rms_norm( _error, _scale );
+          }
+
+        Scalar error_p_norm = infinity;
+        if( order < _max_order )
+          {
+            for( unsigned int i = 0; i < n; i++ )
+              _error[i] = error_const[order+1]*_differences[order+2][i];
+            error_p_norm = this->rms_norm( _error, _scale );
+          }
+
+        const Scalar error_norms[3] = { error_m_norm, error_norm, error_p_norm };
+        Scalar max_factor_found = 0;
+        int delta_order = 0;
+        for( int k = 0; k < 3; k++ )
+          {
+            const Scalar factor = ( error_norms[k] == 0 ) ? infinity :
+              pow( error_norms[k], -1/static_cast<Scalar>(order + k) );
+            if( factor > max_factor_found )
+              {
+                max_factor_found = factor;
+                delta_order = k - 1;
+              }
+          }
+
+        order = static_cast<unsigned int>( static_cast<int>(order) + delta_order );
+
+        const Scalar factor = min( max_factor, safety*max_factor_found );
+        h *= factor;
+        this->change_step_size( order, factor );
+        n_equal_steps = 0;
+        factorized = false;
+      }
+
+    y = _differences[0];
+
+    _step_size = h;
+    _order = order;
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_BDF_INTEGRATOR_H
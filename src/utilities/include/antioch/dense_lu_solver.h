@@ -0,0 +1,187 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+
+
+
+#ifndef ANTIOCH_DENSE_LU_SOLVER_H
+#define ANTIOCH_DENSE_LU_SOLVER_H
+
+// Antioch
+#include "antioch/antioch_asserts.h"
+
+// C++
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace Antioch
+{
+  //! LU factorization with partial pivoting of a dense square matrix
+  /*!
+   * Matrices are stored row major, entry (i,j) of an n x n matrix at
+   * i*n+j. The factors are kept so that a factorization can be reused
+   * for several right hand sides.
+   */
+  template<typename Scalar=double>
+  class DenseLUSolver
+  {
+  public:
+
+    DenseLUSolver( unsigned int n = 0 );
+
+    ~DenseLUSolver();
+
+    void resize( unsigned int n );
+
+    unsigned int size() const;
+
+    //! Factorize \p matrix
+    /*! \returns false if the matrix is numerically singular, the
+     *  factors are then unusable. */
+    bool factorize( const std::vector<Scalar>& matrix );
+
+    //! Overwrite \p rhs with the solution of A x = rhs
+    void solve( std::vector<Scalar>& rhs ) const;
+
+  private:
+
+    unsigned int _n;
+
+    //! L (unit diagonal, strictly lower part) and U, row major
+    std::vector<Scalar> _lu;
+
+    //! row exchanged with row k at step k
+    std::vector<unsigned int> _pivots;
+  };
+
+  /* ------------------------- Inline Functions -------------------------*/
+  template<typename Scalar>
+  inline
+  DenseLUSolver<Scalar>::DenseLUSolver( unsigned int n )
+    : _n(0)
+  {
+    this->resize(n);
+  }
+
+  template<typename Scalar>
+  inline
+  DenseLUSolver<Scalar>::~DenseLUSolver()
+  {
+    return;
+  }
+
+  template<typename Scalar>
+  inline
+  void DenseLUSolver<Scalar>::resize( unsigned int n )
+  {
+    _n = n;
+    _lu.resize(n*n);
+    _pivots.resize(n);
+  }
+
+  template<typename Scalar>
+  inline
+  unsigned int DenseLUSolver<Scalar>::size() const
+  {
+    return _n;
+  }
+
+  template<typename Scalar>
+  inline
+  bool DenseLUSolver<Scalar>::factorize( const std::vector<Scalar>& matrix )
+  {
+    using std::abs;
+
+    antioch_assert_equal_to( matrix.size(), _n*_n );
+
+    _lu = matrix;
+
+    for( unsigned int k = 0; k < _n; k++ )
+      {
+        // partial pivoting
+        unsigned int p = k;
+        Scalar max_entry = abs(_lu[k*_n+k]);
+        for( unsigned int i = k+1; i < _n; i++ )
+          if( abs(_lu[i*_n+k]) > max_entry )
+            {
+              max_entry = abs(_lu[i*_n+k]);
+              p = i;
+            }
+
+        _pivots[k] = p;
+
+        if( max_entry == 0 || max_entry != max_entry )
+          return false;
+
+        if( p != k )
+          for( unsigned int j = 0; j < _n; j++ )
+            std::swap( _lu[k*_n+j], _lu[p*_n+j] );
+
+        const Scalar inv_pivot = 1/_lu[k*_n+k];
+        for( unsigned int i = k+1; i < _n; i++ )
+          {
+            Scalar& l_ik = _lu[i*_n+k];
+            if( l_ik == 0 )
+              continue;
+
+            l_ik *= inv_pivot;
+            for( unsigned int j = k+1; j < _n; j++ )
+              _lu[i*_n+j] -= l_ik * _lu[k*_n+j];
+          }
+      }
+
+    return true;
+  }
+
+  template<typename Scalar>
+  inline
+  void DenseLUSolver<Scalar>::solve( std::vector<Scalar>& rhs ) const
+  {
+    antioch_assert_equal_to( rhs.size(), _n );
+
+    // rows were exchanged in order during the factorization
+    for( unsigned int k = 0; k < _n; k++ )
+      if( _pivots[k] != k )
+        std::swap( rhs[k], rhs[_pivots[k]] );
+
+    // L y = P b
+    for( unsigned int i = 1; i < _n; i++ )
+      for( unsigned int j = 0; j < i; j++ )
+        rhs[i] -= _lu[i*_n+j] * rhs[j];
+
+    // U x = y
+    for( unsigned int i = _n; i-- > 0; )
+      {
+        for( unsigned int j = i+1; j < _n; j++ )
+          rhs[i] -= _lu[i*_n+j] * rhs[j];
+        rhs[i] /= _lu[i*_n+i];
+      }
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_DENSE_LU_SOLVER_H
@@ -0,0 +1,775 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+
+
+
+#ifndef ANTIOCH_ISAT_TABLE_H
+#define ANTIOCH_ISAT_TABLE_H
+
+// Antioch
+#include "antioch/antioch_asserts.h"
+
+// C++
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace Antioch
+{
+  //! In situ adaptive tabulation of a smooth mapping f(x)
+  /*!
+   * Each record of the table holds a point \f$ x_0 \f$, the mapping
+   * \f$ f_0 = f(x_0) \f$, its gradient \f$ A = \partial f/\partial x \f$
+   * and an ellipsoid of accuracy, the region around \f$ x_0 \f$ where the
+   * linear approximation \f$ f_0 + A (x - x_0) \f$ is deemed accurate
+   * (Pope, Combust. Theory Modelling 1, 1997). A query
+   * - retrieves the linear approximation when \f$ x \f$ lies in the
+   *   ellipsoid of the record found by the binary tree search, or of one
+   *   of the most recently used records (secondary search);
+   * - otherwise evaluates \f$ f(x) \f$ directly. If the approximation of
+   *   the record found by the tree is within tolerance at \f$ x \f$, its
+   *   ellipsoid is grown to include \f$ x \f$, else a new record is added
+   *   at \f$ x \f$ and the tree leaf split by the plane bisecting the two
+   *   points.
+   *
+   * Distances are measured on inputs divided by set_input_scales() and
+   * errors as the 2-norm of the output errors divided by
+   * set_output_scales(). The initial ellipsoid of a record is
+   * \f$ \{ \delta : |B A \delta| \le \epsilon \} \f$, B being the output
+   * scaling, bounded by a ball of radius set_max_radius(). Ellipsoids are
+   * grown by the rank one update that keeps the conjugate directions.
+   *
+   * The table holds at most set_max_records() records, the least
+   * recently used one is evicted to make room for a new one.
+   *
+   * MappingType must provide
+   * \code
+   * unsigned int n_inputs() const;
+   * unsigned int n_outputs() const;
+   * void evaluate( const std::vector<Scalar>& x, std::vector<Scalar>& f );
+   * void gradient( const std::vector<Scalar>& x, const std::vector<Scalar>& f,
+   *                std::vector<Scalar>& A );
+   * \endcode
+   * where f = f(x), already evaluated by the table, and A is row major,
+   * A[i*n_inputs()+j] = df_i/dx_j. A table serves a
+   * single mapping, and is not thread safe.
+   */
+  template<typename Scalar=double>
+  class ISATTable
+  {
+  public:
+
+    ISATTable();
+
+    ~ISATTable();
+
+    //! Scaled error allowed for the linear approximation, defaults to 1e-4
+    void set_tolerance( const Scalar tolerance );
+
+    //! Inputs are divided by \p scales when measuring distances, defaults to 1
+    /*! The scales must be set before the first query. */
+    void set_input_scales( const std::vector<Scalar>& scales );
+
+    //! Output errors are divided by \p scales, defaults to 1
+    void set_output_scales( const std::vector<Scalar>& scales );
+
+    //! Largest radius of an ellipsoid of accuracy, in scaled inputs, defaults to 1
+    void set_max_radius( const Scalar radius );
+
+    //! Memory cap, in records, defaults to 100000
+    void set_max_records( const unsigned int max_records );
+
+    //! Records tested after a failed tree search, defaults to 10
+    void set_max_secondary_searches( const unsigned int max_searches );
+
+    //! Tabulated or directly evaluated \p f at \p x
+    template<typename MappingType>
+    void query( MappingType& mapping, const std::vector<Scalar>& x, std::vector<Scalar>& f );
+
+    //! Remove all records, the statistics are kept
+    void clear();
+
+    unsigned int n_records() const;
+
+    //! Bytes held by the records and the tree
+    std::size_t memory_usage() const;
+
+    //! \name Statistics since construction or reset_statistics()
+    //! @{
+    unsigned long n_queries() const;
+
+    //! Queries answered by the linear approximation, from either search
+    unsigned long n_retrieves() const;
+
+    //! Retrieves from the secondary search
+    unsigned long n_secondary_retrieves() const;
+
+    //! Direct evaluations, n_grows() + n_adds()
+    unsigned long n_misses() const;
+
+    unsigned long n_grows() const;
+
+    unsigned long n_adds() const;
+
+    unsigned long n_evictions() const;
+
+    void reset_statistics();
+    //! @}
+
+  private:
+
+    struct Record
+    {
+      std::vector<Scalar> x;
+      std::vector<Scalar> f;
+      //! gradient, row major
+      std::vector<Scalar> A;
+      //! ellipsoid of accuracy (x-x0)^T M (x-x0) <= 1, scaled inputs, row major
+      std::vector<Scalar> M;
+      //! leaf of the tree
+      int node;
+      //! least recently used list
+      int previous;
+      int next;
+    };
+
+    struct Node
+    {
+      //! record of a leaf, -1 for a cutting plane
+      int record;
+      int parent;
+      //! children of a cutting plane, right when normal.x > offset
+      int left;
+      int right;
+      std::vector<Scalar> normal;
+      Scalar offset;
+    };
+
+    void initialize( const unsigned int n_inputs, const unsigned int n_outputs );
+
+    //! Leaf reached by the tree search from the scaled input
+    int find_leaf( const std::vector<Scalar>& x_scaled ) const;
+
+    bool in_ellipsoid( const Record& record, const std::vector<Scalar>& x_scaled ) const;
+
+    //! Scaled error of the linear approximation of \p record against \p f at \p x
+    Scalar approximation_error( const Record& record, const std::vector<Scalar>& x,
+                                const std::vector<Scalar>& f );
+
+    void approximate( const Record& record, const std::vector<Scalar>& x,
+                      std::vector<Scalar>& f ) const;
+
+    //! Smallest rank one expansion of the ellipsoid of \p record containing \p x_scaled
+    void grow( Record& record, const std::vector<Scalar>& x_scaled );
+
+    //! New record at \p x, \p f being the mapping evaluated at \p x
+    template<typename MappingType>
+    void add( MappingType& mapping, const std::vector<Scalar>& x,
+              const std::vector<Scalar>& x_scaled, const std::vector<Scalar>& f );
+
+    void evict_least_recently_used();
+
+    //! Move \p r to the front of the least recently used list
+    void touch( const int r );
+
+    void unlink( const int r );
+
+    int new_node();
+
+    Scalar _tolerance;
+    std::vector<Scalar> _input_scales;
+    std::vector<Scalar> _output_scales;
+    Scalar _max_radius;
+    unsigned int _max_records;
+    unsigned int _max_secondary_searches;
+
+    unsigned int _n_inputs;
+    unsigned int _n_outputs;
+
+    std::vector<Record> _records;
+    std::vector<int> _free_records;
+    std::vector<Node> _nodes;
+    std::vector<int> _free_nodes;
+    int _root;
+    unsigned int _n_records;
+
+    //! most and least recently used records
+    int _head;
+    int _tail;
+
+    unsigned long _n_queries;
+    unsigned long _n_retrieves;
+    unsigned long _n_secondary_retrieves;
+    unsigned long _n_grows;
+    unsigned long _n_adds;
+    unsigned long _n_evictions;
+
+    std::vector<Scalar> _x_scaled;
+    std::vector<Scalar> _f_linear;
+    std::vector<Scalar> _Md;
+  };
+
+  /* ------------------------- Inline Functions -------------------------*/
+  template<typename Scalar>
+  inline
+  ISATTable<Scalar>::ISATTable()
+    : _tolerance(1e-4),
+      _max_radius(1),
+      _max_records(100000),
+      _max_secondary_searches(10),
+      _n_inputs(0),
+      _n_outputs(0),
+      _root(-1),
+      _n_records(0),
+      _head(-1),
+      _tail(-1)
+  {
+    this->reset_statistics();
+  }
+
+  template<typename Scalar>
+  inline
+  ISATTable<Scalar>::~ISATTable()
+  {
+    return;
+  }
+
+  template<typename Scalar>
+  inline
+  void ISATTable<Scalar>::set_tolerance( const Scalar tolerance )
+  {
+    antioch_assert_greater( tolerance, Scalar(0) );
+    _tolerance = tolerance;
+  }
+
+  template<typename Scalar>
+  inline
+  void ISATTable<Scalar>::set_input_scales( const std::vector<Scalar>& scales )
+  {
+    antioch_assert( _input_scales.empty() || scales.size() == _input_scales.size() );
+    _input_scales = scales;
+  }
+
+  template<typename Scalar>
+  inline
+  void ISATTable<Scalar>::set_output_scales( const std::vector<Scalar>& scales )
+  {
+    antioch_assert( _output_scales.empty() || scales.size() == _output_scales.size() );
+    _output_scales = scales;
+  }
+
+  template<typename Scalar>
+  inline
+  void ISATTable<Scalar>::set_max_radius( const Scalar radius )
+  {
+    antioch_assert_greater( radius, Scalar(0) );
+    _max_radius = radius;
+  }
+
+  template<typename Scalar>
+  inline
+  void ISATTable<Scalar>::set_max_records( const unsigned int max_records )
+  {
+    antioch_assert_greater( max_records, 0 );
+    _max_records = max_records;
+
+    while( _n_records > _max_records )
+      this->evict_least_recently_used();
+  }
+
+  template<typename Scalar>
+  inline
+  void ISATTable<Scalar>::set_max_secondary_searches( const unsigned int max_searches )
+  {
+    _max_secondary_searches = max_searches;
+  }
+
+  template<typename Scalar>
+  inline
+  unsigned int ISATTable<Scalar>::n_records() const
+  {
+    return _n_records;
+  }
+
+  template<typename Scalar>
+  inline
+  std::size_t ISATTable<Scalar>::memory_usage() const
+  {
+    std::size_t n_scalars = 0;
+    for( unsigned int r = 0; r < _records.size(); r++ )
+      n_scalars += _records[r].x.capacity() + _records[r].f.capacity()
+                 + _records[r].A.capacity() + _records[r].M.capacity();
+    for( unsigned int n = 0; n < _nodes.size(); n++ )
+      n_scalars += _nodes[n].normal.capacity();
+
+    return n_scalars*sizeof(Scalar) + _records.capacity()*sizeof(Record)
+         + _nodes.capacity()*sizeof(Node)
+         + (_free_records.capacity() + _free_nodes.capacity())*sizeof(int);
+  }
+
+  template<typename Scalar>
+  inline
+  unsigned long ISATTable<Scalar>::n_queries() const
+  {
+    return _n_queries;
+  }
+
+  template<typename Scalar>
+  inline
+  unsigned long ISATTable<Scalar>::n_retrieves() const
+  {
+    return _n_retrieves;
+  }
+
+  template<typename Scalar>
+  inline
+  unsigned long ISATTable<Scalar>::n_secondary_retrieves() const
+  {
+    return _n_secondary_retrieves;
+  }
+
+  template<typename Scalar>
+  inline
+  unsigned long ISATTable<Scalar>::n_misses() const
+  {
+    return _n_grows + _n_adds;
+  }
+
+  template<typename Scalar>
+  inline
+  unsigned long ISATTable<Scalar>::n_grows() const
+  {
+    return _n_grows;
+  }
+
+  template<typename Scalar>
+  inline
+  unsigned long ISATTable<Scalar>::n_adds() const
+  {
+    return _n_adds;
+  }
+
+  template<typename Scalar>
+  inline
+  unsigned long ISATTable<Scalar>::n_evictions() const
+  {
+    return _n_evictions;
+  }
+
+  template<typename Scalar>
+  inline
+  void ISATTable<Scalar>::reset_statistics()
+  {
+    _n_queries = 0;
+    _n_retrieves = 0;
+    _n_secondary_retrieves = 0;
+    _n_grows = 0;
+    _n_adds = 0;
+    _n_evictions = 0;
+  }
+
+  template<typename Scalar>
+  inline
+  void ISATTable<Scalar>::clear()
+  {
+    _records.clear();
+    _free_records.clear();
+    _nodes.clear();
+    _free_nodes.clear();
+    _root = -1;
+    _n_records = 0;
+    _head = -1;
+    _tail = -1;
+  }
+
+  template<typename Scalar>
+  inline
+  void ISATTable<Scalar>::initialize( const unsigned int n_inputs, const unsigned int n_outputs )
+  {
+    _n_inputs = n_inputs;
+    _n_outputs = n_outputs;
+
+    if( _input_scales.empty() )
+      _input_scales.resize( n_inputs, 1 );
+    if( _output_scales.empty() )
+      _output_scales.resize( n_outputs, 1 );
+
+    antioch_assert_equal_to( _input_scales.size(), n_inputs );
+    antioch_assert_equal_to( _output_scales.size(), n_outputs );
+
+    _x_scaled.resize( n_inputs );
+    _f_linear.resize( n_outputs );
+    _Md.resize( n_inputs );
+  }
+
+  template<typename Scalar>
+  template<typename MappingType>
+  inline
+  void ISATTable<Scalar>::query( MappingType& mapping, const std::vector<Scalar>& x,
+                                 std::vector<Scalar>& f )
+  {
+    if( _n_inputs == 0 )
+      this->initialize( mapping.n_inputs(), mapping.n_outputs() );
+
+    antioch_assert_equal_to( mapping.n_inputs(), _n_inputs );
+    antioch_assert_equal_to( mapping.n_outputs(), _n_outputs );
+    antioch_assert_equal_to( x.size(), _n_inputs );
+    antioch_assert_equal_to( f.size(), _n_outputs );
+
+    _n_queries++;
+
+    for( unsigned int j = 0; j < _n_inputs; j++ )
+      _x_scaled[j] = x[j]/_input_scales[j];
+
+    if( _root < 0 )
+      {
+        mapping.evaluate( x, f );
+        this->add( mapping, x, _x_scaled, f );
+        return;
+      }
+
+    // primary retrieve
+    const int leaf_record = _nodes[this->find_leaf(_x_scaled)].record;
+    if( this->in_ellipsoid( _records[leaf_record], _x_scaled ) )
+      {
+        this->approximate( _records[leaf_record], x, f );
+        this->touch( leaf_record );
+        _n_retrieves++;
+        return;
+      }
+
+    // secondary retrieve, most recently used records first
+    int r = _head;
+    for( unsigned int i = 0; i < _max_secondary_searches && r >= 0; i++, r = _records[r].next )
+      {
+        if( r != leaf_record && this->in_ellipsoid( _records[r], _x_scaled ) )
+          {
+            this->approximate( _records[r], x, f );
+            this->touch( r );
+            _n_retrieves++;
+            _n_secondary_retrieves++;
+            return;
+          }
+      }
+
+    // direct evaluation, then grow or add
+    mapping.evaluate( x, f );
+
+    if( this->approximation_error( _records[leaf_record], x, f ) <= _tolerance )
+      {
+        this->grow( _records[leaf_record], _x_scaled );
+        this->touch( leaf_record );
+        _n_grows++;
+      }
+    else
+      this->add( mapping, x, _x_scaled, f );
+  }
+
+  template<typename Scalar>
+  inline
+  int ISATTable<Scalar>::find_leaf( const std::vector<Scalar>& x_scaled ) const
+  {
+    antioch_assert_greater_equal( _root, 0 );
+
+    int n = _root;
+    while( _nodes[n].record < 0 )
+      {
+        const Node& node = _nodes[n];
+        Scalar projection = 0;
+        for( unsigned int j = 0; j < _n_inputs; j++ )
+          projection += node.normal[j]*x_scaled[j];
+        n = ( projection > node.offset ) ? node.right : node.left;
+      }
+
+    return n;
+  }
+
+  template<typename Scalar>
+  inline
+  bool ISATTable<Scalar>::in_ellipsoid( const Record& record, const std::vector<Scalar>& x_scaled ) const
+  {
+    Scalar distance = 0;
+    for( unsigned int i = 0; i < _n_inputs; i++ )
+      {
+        const Scalar d_i = x_scaled[i] - record.x[i]/_input_scales[i];
+        const Scalar* M_i = &record.M[i*_n_inputs];
+        Scalar Md_i = 0;
+        for( unsigned int j = 0; j < _n_inputs; j++ )
+          Md_i += M_i[j]*( x_scaled[j] - record.x[j]/_input_scales[j] );
+        distance += d_i*Md_i;
+      }
+
+    return ( distance <= 1 );
+  }
+
+  template<typename Scalar>
+  inline
+  void ISATTable<Scalar>::approximate( const Record& record, const std::vector<Scalar>& x,
+                                       std::vector<Scalar>& f ) const
+  {
+    for( unsigned int i = 0; i < _n_outputs; i++ )
+      {
+        const Scalar* A_i = &record.A[i*_n_inputs];
+        Scalar f_i = record.f[i];
+        for( unsigned int j = 0; j < _n_inputs; j++ )
+          f_i += A_i[j]*( x[j] - record.x[j] );
+        f[i] = f_i;
+      }
+  }
+
+  template<typename Scalar>
+  inline
+  Scalar ISATTable<Scalar>::approximation_error( const Record& record, const std::vector<Scalar>& x,
+                                                 const std::vector<Scalar>& f )
+  {
+    using std::sqrt;
+
+    this->approximate( record, x, _f_linear );
+
+    Scalar error = 0;
+    for( unsigned int i = 0; i < _n_outputs; i++ )
+      {
+        const Scalar e_i = ( f[i] - _f_linear[i] )/_output_scales[i];
+        error += e_i*e_i;
+      }
+
+    return sqrt(error);
+  }
+
+  template<typename Scalar>
+  inline
+  void ISATTable<Scalar>::grow( Record& record, const std::vector<Scalar>& x_scaled )
+  {
+    // M' = M + gamma (M d)(M d)^T with s = d^T M d: d^T M' d = s + gamma s^2 = 1,
+    // and M' <= M as gamma < 0 so that the old ellipsoid is kept
+    Scalar s = 0;
+    for( unsigned int i = 0; i < _n_inputs; i++ )
+      {
+        const Scalar* M_i = &record.M[i*_n_inputs];
+        Scalar Md_i = 0;
+        for( unsigned int j = 0; j < _n_inputs; j++ )
+          Md_i += M_i[j]*( x_scaled[j] - record.x[j]/_input_scales[j] );
+        _Md[i] = Md_i;
+        s += ( x_scaled[i] - record.x[i]/_input_scales[i] )*Md_i;
+      }
+
+    if( s <= 1 )
+      return;
+
+    const Scalar gamma = (1 - s)/(s*s);
+    for( unsigned int i = 0; i < _n_inputs; i++ )
+      for( unsigned int j = 0; j < _n_inputs; j++ )
+        record.M[i*_n_inputs+j] += gamma*_Md[i]*_Md[j];
+  }
+
+  template<typename Scalar>
+  template<typename MappingType>
+  inline
+  void ISATTable<Scalar>::add( MappingType& mapping, const std::vector<Scalar>& x,
+                               const std::vector<Scalar>& x_scaled, const std::vector<Scalar>& f )
+  {
+    if( _n_records >= _max_records )
+      this->evict_least_recently_used();
+
+    int r;
+    if( _free_records.empty() )
+      {
+        r = _records.size();
+        _records.push_back( Record() );
+      }
+    else
+      {
+        r = _free_records.back();
+        _free_records.pop_back();
+      }
+
+    Record& record = _records[r];
+    record.x = x;
+    record.f = f;
+    record.A.resize( _n_outputs*_n_inputs );
+    record.M.resize( _n_inputs*_n_inputs );
+
+    mapping.gradient( x, f, record.A );
+
+    // {d : |B A S d| <= tol}, S the input scaling and B the output one,
+    // bounded by the ball of radius max_radius
+    const Scalar inv_tol2 = 1/(_tolerance*_tolerance);
+    const Scalar inv_radius2 = 1/(_max_radius*_max_radius);
+    for( unsigned int i = 0; i < _n_inputs; i++ )
+      for( unsigned int j = 0; j <= i; j++ )
+        {
+          Scalar M_ij = 0;
+          for( unsigned int k = 0; k < _n_outputs; k++ )
+            M_ij += record.A[k*_n_inputs+i]*record.A[k*_n_inputs+j]
+                    /(_output_scales[k]*_output_scales[k]);
+          M_ij *= _input_scales[i]*_input_scales[j]*inv_tol2;
+          if( i == j )
+            M_ij += inv_radius2;
+          record.M[i*_n_inputs+j] = M_ij;
+          record.M[j*_n_inputs+i] = M_ij;
+        }
+
+    // new leaf, splitting the leaf reached by x if any
+    const int leaf = this->new_node();
+    _nodes[leaf].record = r;
+    record.node = leaf;
+
+    if( _root < 0 )
+      {
+        _nodes[leaf].parent = -1;
+        _root = leaf;
+      }
+    else
+      {
+        const int old_leaf = this->find_leaf( x_scaled );
+        const Record& old_record = _records[_nodes[old_leaf].record];
+
+        const int plane = this->new_node();
+        Node& node = _nodes[plane];
+        node.record = -1;
+        node.parent = _nodes[old_leaf].parent;
+        node.normal.resize( _n_inputs );
+        node.offset = 0;
+        for( unsigned int j = 0; j < _n_inputs; j++ )
+          {
+            const Scalar x0_j = old_record.x[j]/_input_scales[j];
+            node.normal[j] = x_scaled[j] - x0_j;
+            node.offset += node.normal[j]*( x_scaled[j] + x0_j )/2;
+          }
+        node.left = old_leaf;
+        node.right = leaf;
+
+        if( node.parent < 0 )
+          _root = plane;
+        else if( _nodes[node.parent].left == old_leaf )
+          _nodes[node.parent].left = plane;
+        else
+          _nodes[node.parent].right = plane;
+
+        _nodes[old_leaf].parent = plane;
+        _nodes[leaf].parent = plane;
+      }
+
+    record.previous = -1;
+    record.next = -1;
+    this->touch( r );
+
+    _n_records++;
+    _n_adds++;
+  }
+
+  template<typename Scalar>
+  inline
+  void ISATTable<Scalar>::evict_least_recently_used()
+  {
+    antioch_assert_greater_equal( _tail, 0 );
+
+    const int r = _tail;
+    this->unlink( r );
+
+    // the sibling of the leaf takes the place of their parent
+    const int leaf = _records[r].node;
+    const int plane = _nodes[leaf].parent;
+    if( plane < 0 )
+      _root = -1;
+    else
+      {
+        const int sibling = ( _nodes[plane].left == leaf ) ? _nodes[plane].right : _nodes[plane].left;
+        const int grandparent = _nodes[plane].parent;
+
+        _nodes[sibling].parent = grandparent;
+        if( grandparent < 0 )
+          _root = sibling;
+        else if( _nodes[grandparent].left == plane )
+          _nodes[grandparent].left = sibling;
+        else
+          _nodes[grandparent].right = sibling;
+
+        _free_nodes.push_back( plane );
+      }
+    _free_nodes.push_back( leaf );
+
+    _free_records.push_back( r );
+    _n_records--;
+    _n_evictions++;
+  }
+
+  template<typename Scalar>
+  inline
+  void ISATTable<Scalar>::unlink( const int r )
+  {
+    Record& record = _records[r];
+
+    if( record.previous >= 0 )
+      _records[record.previous].next = record.next;
+    else if( _head == r )
+      _head = record.next;
+
+    if( record.next >= 0 )
+      _records[record.next].previous = record.previous;
+    else if( _tail == r )
+      _tail = record.previous;
+
+    record.previous = -1;
+    record.next = -1;
+  }
+
+  template<typename Scalar>
+  inline
+  void ISATTable<Scalar>::touch( const int r )
+  {
+    if( _head == r )
+      return;
+
+    this->unlink( r );
+
+    _records[r].next = _head;
+    if( _head >= 0 )
+      _records[_head].previous = r;
+    _head = r;
+    if( _tail < 0 )
+      _tail = r;
+  }
+
+  template<typename Scalar>
+  inline
+  int ISATTable<Scalar>::new_node()
+  {
+    if( _free_nodes.empty() )
+      {
+        _nodes.push_back( Node() );
+        return _nodes.size() - 1;
+      }
+
+    const int n = _free_nodes.back();
+    _free_nodes.pop_back();
+    return n;
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_ISAT_TABLE_H
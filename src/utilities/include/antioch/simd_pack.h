@@ -0,0 +1,320 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+#ifndef ANTIOCH_SIMD_PACK_H
+#define ANTIOCH_SIMD_PACK_H
+
+// C++
+#include <cmath>
+#include <cstddef> // std::size_t
+#include <iostream>
+
+// Antioch
+#include "antioch/vector_math.h"
+
+//! Accuracy of exp, log and pow of SIMDPack, see vector_math.h
+/*! LIBM keeps the <cmath> results, FULL or FAST evaluate all the lanes
+ *  with the vectorized kernels. Define before including Antioch headers. */
+#ifndef ANTIOCH_SIMD_PACK_MATH_ACCURACY
+#define ANTIOCH_SIMD_PACK_MATH_ACCURACY Antioch::MathAccuracy::LIBM
+#endif
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+namespace Antioch
+{
+  //! Elementwise kernels of SIMDPack
+  /*! Portable fallback, loops over the lanes and leaves the
+   *  vectorization to the compiler. Specialized below with intrinsics
+   *  for the widths of the instruction sets enabled at compile time
+   *  (-mavx2, -mavx512f). Loads and stores are unaligned: before
+   *  C++17 std::allocator ignores over-alignment, so packs stored in
+   *  a std::vector have only the alignment of the scalar. */
+  template <typename T, std::size_t N>
+  struct SIMDPackKernel
+  {
+    static void add(const T* a, const T* b, T* out) { for (std::size_t i = 0; i != N; ++i) out[i] = a[i] + b[i]; }
+    static void sub(const T* a, const T* b, T* out) { for (std::size_t i = 0; i != N; ++i) out[i] = a[i] - b[i]; }
+    static void mul(const T* a, const T* b, T* out) { for (std::size_t i = 0; i != N; ++i) out[i] = a[i] * b[i]; }
+    static void div(const T* a, const T* b, T* out) { for (std::size_t i = 0; i != N; ++i) out[i] = a[i] / b[i]; }
+
+    static void sqrt(const T* a, T* out)
+    {
+      using std::sqrt;
+      for (std::size_t i = 0; i != N; ++i) out[i] = sqrt(a[i]);
+    }
+
+    static void max(const T* a, const T* b, T* out) { for (std::size_t i = 0; i != N; ++i) out[i] = (a[i] < b[i]) ? b[i] : a[i]; }
+    static void min(const T* a, const T* b, T* out) { for (std::size_t i = 0; i != N; ++i) out[i] = (b[i] < a[i]) ? b[i] : a[i]; }
+  };
+
+#define ANTIOCH_SIMD_PACK_KERNEL(Scalar, Width, Prefix, Suffix) \
+  template <> \
+  struct SIMDPackKernel<Scalar,Width> \
+  { \
+    static void add(const Scalar* a, const Scalar* b, Scalar* out) \
+    { Prefix##_storeu_##Suffix(out, Prefix##_add_##Suffix(Prefix##_loadu_##Suffix(a), Prefix##_loadu_##Suffix(b))); } \
+    static void sub(const Scalar* a, const Scalar* b, Scalar* out) \
+    { Prefix##_storeu_##Suffix(out, Prefix##_sub_##Suffix(Prefix##_loadu_##Suffix(a), Prefix##_loadu_##Suffix(b))); } \
+    static void mul(const Scalar* a, const Scalar* b, Scalar* out) \
+    { Prefix##_storeu_##Suffix(out, Prefix##_mul_##Suffix(Prefix##_loadu_##Suffix(a), Prefix##_loadu_##Suffix(b))); } \
+    static void div(const Scalar* a, const Scalar* b, Scalar* out) \
+    { Prefix##_storeu_##Suffix(out, Prefix##_div_##Suffix(Prefix##_loadu_##Suffix(a), Prefix##_loadu_##Suffix(b))); } \
+    static void sqrt(const Scalar* a, Scalar* out) \
+    { Prefix##_storeu_##Suffix(out, Prefix##_sqrt_##Suffix(Prefix##_loadu_##Suffix(a))); } \
+    /* same NaN propagation as the fallback: the second operand when unordered */ \
+    static void max(const Scalar* a, const Scalar* b, Scalar* out) \
+    { Prefix##_storeu_##Suffix(out, Prefix##_max_##Suffix(Prefix##_loadu_##Suffix(b), Prefix##_loadu_##Suffix(a))); } \
+    static void min(const Scalar* a, const Scalar* b, Scalar* out) \
+    { Prefix##_storeu_##Suffix(out, Prefix##_min_##Suffix(Prefix##_loadu_##Suffix(b), Prefix##_loadu_##Suffix(a))); } \
+  }
+
+#ifdef __AVX2__
+  ANTIOCH_SIMD_PACK_KERNEL(double, 4, _mm256, pd);
+  ANTIOCH_SIMD_PACK_KERNEL(float,  8, _mm256, ps);
+#endif
+
+#ifdef __AVX512F__
+  ANTIOCH_SIMD_PACK_KERNEL(double, 8,  _mm512, pd);
+  ANTIOCH_SIMD_PACK_KERNEL(float,  16, _mm512, ps);
+#endif
+
+#undef ANTIOCH_SIMD_PACK_KERNEL
+
+  //! Fixed width pack of N scalars, evaluated lane by lane
+  /*! A StateType storing N cells (temperatures, densities...) on the
+   *  stack: no heap allocation and no expression templates, so
+   *  temporaries cost no more than their N scalars. The arithmetic and
+   *  the <cmath> functions are found by argument dependent lookup, as
+   *  for valarray, so the existing kinetics, thermo and transport code
+   *  evaluates N cells at once through the cmath_shims.h idiom.
+   *
+   *  Scalars convert implicitly to a pack with all lanes set, so mixed
+   *  scalar/pack arithmetic needs no extra overload. Comparisons give
+   *  a SIMDPack<bool,N>, to be reduced with Antioch::conjunction() /
+   *  disjunction() or used as Antioch::if_else() condition.
+   *
+   *  Include simd_pack_utils_decl.h before Antioch headers and
+   *  simd_pack_utils.h after, as for the other vector types.
+   */
+  template <typename T, std::size_t N>
+  class SIMDPack
+  {
+  public:
+
+    typedef T value_type;
+
+    //! All lanes to zero
+    SIMDPack()
+    {
+      for (std::size_t i = 0; i != N; ++i)
+        _data[i] = T(0);
+    }
+
+    //! All lanes to value
+    SIMDPack(const T& value)
+    {
+      for (std::size_t i = 0; i != N; ++i)
+        _data[i] = value;
+    }
+
+    //! Lane by lane conversion
+    template <typename T2>
+    explicit SIMDPack(const SIMDPack<T2,N>& other)
+    {
+      for (std::size_t i = 0; i != N; ++i)
+        _data[i] = T(other[i]);
+    }
+
+    static std::size_t size() { return N; }
+
+    T& operator[](std::size_t i) { return _data[i]; }
+
+    const T& operator[](std::size_t i) const { return _data[i]; }
+
+    T* data() { return _data; }
+
+    const T* data() const { return _data; }
+
+    SIMDPack& operator+=(const SIMDPack& b) { SIMDPackKernel<T,N>::add(_data, b._data, _data); return *this; }
+    SIMDPack& operator-=(const SIMDPack& b) { SIMDPackKernel<T,N>::sub(_data, b._data, _data); return *this; }
+    SIMDPack& operator*=(const SIMDPack& b) { SIMDPackKernel<T,N>::mul(_data, b._data, _data); return *this; }
+    SIMDPack& operator/=(const SIMDPack& b) { SIMDPackKernel<T,N>::div(_data, b._data, _data); return *this; }
+
+    // Arithmetic, found by argument dependent lookup only. Being
+    // non-template, they accept scalars through the converting
+    // constructor.
+
+    friend SIMDPack operator+(const SIMDPack& a) { return a; }
+
+    friend SIMDPack operator-(const SIMDPack& a)
+    {
+      SIMDPack out;
+      for (std::size_t i = 0; i != N; ++i)
+        out._data[i] = -a._data[i];
+      return out;
+    }
+
+    friend SIMDPack operator+(SIMDPack a, const SIMDPack& b) { return a += b; }
+    friend SIMDPack operator-(SIMDPack a, const SIMDPack& b) { return a -= b; }
+    friend SIMDPack operator*(SIMDPack a, const SIMDPack& b) { return a *= b; }
+    friend SIMDPack operator/(SIMDPack a, const SIMDPack& b) { return a /= b; }
+
+#define ANTIOCH_SIMD_PACK_COMPARISON(op) \
+    friend SIMDPack<bool,N> operator op (const SIMDPack& a, const SIMDPack& b) \
+    { \
+      SIMDPack<bool,N> out; \
+      for (std::size_t i = 0; i != N; ++i) \
+        out[i] = (a._data[i] op b._data[i]); \
+      return out; \
+    }
+
+    ANTIOCH_SIMD_PACK_COMPARISON(==)
+    ANTIOCH_SIMD_PACK_COMPARISON(!=)
+    ANTIOCH_SIMD_PACK_COMPARISON(<)
+    ANTIOCH_SIMD_PACK_COMPARISON(<=)
+    ANTIOCH_SIMD_PACK_COMPARISON(>)
+    ANTIOCH_SIMD_PACK_COMPARISON(>=)
+    ANTIOCH_SIMD_PACK_COMPARISON(&&)
+    ANTIOCH_SIMD_PACK_COMPARISON(||)
+
+#undef ANTIOCH_SIMD_PACK_COMPARISON
+
+    friend SIMDPack<bool,N> operator!(const SIMDPack& a)
+    {
+      SIMDPack<bool,N> out;
+      for (std::size_t i = 0; i != N; ++i)
+        out[i] = !a._data[i];
+      return out;
+    }
+
+    // <cmath>, lane by lane
+
+#define ANTIOCH_SIMD_PACK_UNARY(funcname) \
+    friend SIMDPack funcname (const SIMDPack& a) \
+    { \
+      using std::funcname; \
+      SIMDPack out; \
+      for (std::size_t i = 0; i != N; ++i) \
+        out._data[i] = funcname(a._data[i]); \
+      return out; \
+    }
+
+#define ANTIOCH_SIMD_PACK_BINARY(funcname) \
+    friend SIMDPack funcname (const SIMDPack& a, const SIMDPack& b) \
+    { \
+      using std::funcname; \
+      SIMDPack out; \
+      for (std::size_t i = 0; i != N; ++i) \
+        out._data[i] = funcname(a._data[i], b._data[i]); \
+      return out; \
+    }
+
+    ANTIOCH_SIMD_PACK_UNARY(log10)
+    ANTIOCH_SIMD_PACK_UNARY(sin)
+    ANTIOCH_SIMD_PACK_UNARY(cos)
+    ANTIOCH_SIMD_PACK_UNARY(tan)
+    ANTIOCH_SIMD_PACK_UNARY(asin)
+    ANTIOCH_SIMD_PACK_UNARY(acos)
+    ANTIOCH_SIMD_PACK_UNARY(atan)
+    ANTIOCH_SIMD_PACK_UNARY(sinh)
+    ANTIOCH_SIMD_PACK_UNARY(cosh)
+    ANTIOCH_SIMD_PACK_UNARY(tanh)
+    ANTIOCH_SIMD_PACK_UNARY(abs)
+    ANTIOCH_SIMD_PACK_UNARY(fabs)
+    ANTIOCH_SIMD_PACK_UNARY(ceil)
+    ANTIOCH_SIMD_PACK_UNARY(floor)
+
+    ANTIOCH_SIMD_PACK_BINARY(atan2)
+    ANTIOCH_SIMD_PACK_BINARY(fmod)
+
+#undef ANTIOCH_SIMD_PACK_UNARY
+#undef ANTIOCH_SIMD_PACK_BINARY
+
+    // all the lanes at once, ANTIOCH_SIMD_PACK_MATH_ACCURACY
+
+    friend SIMDPack exp(const SIMDPack& a)
+    {
+      SIMDPack out;
+      vector_exp(a._data, out._data, N, ANTIOCH_SIMD_PACK_MATH_ACCURACY);
+      return out;
+    }
+
+    friend SIMDPack log(const SIMDPack& a)
+    {
+      SIMDPack out;
+      vector_log(a._data, out._data, N, ANTIOCH_SIMD_PACK_MATH_ACCURACY);
+      return out;
+    }
+
+    friend SIMDPack pow(const SIMDPack& a, const SIMDPack& b)
+    {
+      SIMDPack out;
+      vector_pow(a._data, b._data, out._data, N, ANTIOCH_SIMD_PACK_MATH_ACCURACY);
+      return out;
+    }
+
+    friend SIMDPack sqrt(const SIMDPack& a)
+    {
+      SIMDPack out;
+      SIMDPackKernel<T,N>::sqrt(a._data, out._data);
+      return out;
+    }
+
+    // Lane by lane, not the reductions Antioch::max(in) / min(in)
+    friend SIMDPack max(const SIMDPack& a, const SIMDPack& b)
+    {
+      SIMDPack out;
+      SIMDPackKernel<T,N>::max(a._data, b._data, out._data);
+      return out;
+    }
+
+    friend SIMDPack min(const SIMDPack& a, const SIMDPack& b)
+    {
+      SIMDPack out;
+      SIMDPackKernel<T,N>::min(a._data, b._data, out._data);
+      return out;
+    }
+
+    friend std::ostream& operator<<(std::ostream& output, const SIMDPack& a)
+    {
+      output << '{';
+      for (std::size_t i = 0; i != N; ++i)
+        output << (i ? "," : "") << a._data[i];
+      output << '}';
+      return output;
+    }
+
+  private:
+
+    T _data[N];
+  };
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_SIMD_PACK_H
@@ -0,0 +1,566 @@
+//-----------------------------------------------------------------------bl-
+//--------------------------------------------------------------------------
+//
+// Antioch - A Gas Dynamics Thermochemistry Library
+//
+// Copyright (C) 2014-2016 Paul T. Bauman, Benjamin S. Kirk,
+//                         Sylvain Plessis, Roy H. Stonger
+//
+// Copyright (C) 2013 The PECOS Development Team
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the Version 2.1 GNU Lesser General
+// Public License as published by the Free Software Foundation.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc. 51 Franklin Street, Fifth Floor,
+// Boston, MA  02110-1301  USA
+//
+//-----------------------------------------------------------------------el-
+
+#ifndef ANTIOCH_VECTOR_MATH_H
+#define ANTIOCH_VECTOR_MATH_H
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <cstddef> // std::size_t
+#include <cstring> // std::memcpy
+#include <limits>
+
+#include <stdint.h>
+
+/*!
+ * Array versions of exp, log and pow. The kernels for double are
+ * branch-free, so that the loops over the arrays are vectorized by
+ * the compiler (-O3, or -O2 -ftree-vectorize), float is evaluated
+ * through the double kernels. Other types (long double, AD types...)
+ * are forwarded to <cmath> whatever the accuracy.
+ *
+ * The kernels only pay off once vectorized with 256 bit registers or
+ * wider (-mavx2 -mfma, -march=native...): scalar, or SSE2 only, they
+ * are slower than glibc and LIBM should be kept.
+ *
+ * Maximum errors measured against glibc on 10^6 arguments, in units
+ * in the last place (ulp) of a double or relative:
+ * \f[
+ *     \begin{array}{llll}\toprule
+ *            & \text{FULL}       & \text{FAST}            & \text{domain}\\\midrule
+ *     \exp   & 1 \text{ ulp}     & 3 \times 10^{-13}      & \text{all}\\
+ *     \log   & 1 \text{ ulp}     & 1.5 \times 10^{-12}    & \text{all}\\
+ *     pow    & 1 \text{ ulp}     & (1 + |y \ln x|)\, 10^{-12} & \text{all}\\\bottomrule
+ *     \end{array}
+ * \f]
+ * For float, FULL and FAST both give the float rounding of the
+ * double result, i.e. 1 ulp of float at most.
+ *
+ * Special values (0, infinities, NaN, negative arguments, subnormals)
+ * give the same results as <cmath>.
+ */
+namespace Antioch
+{
+  namespace MathAccuracy
+  {
+    enum MathAccuracy { LIBM = 0, //!< <cmath>, one scalar at a time
+                        FULL,     //!< in-tree kernels, 1 ulp
+                        FAST };   //!< in-tree kernels, about 1e-12 relative
+  }
+
+  //! out[i] = exp(in[i]), in == out is allowed
+  template <typename T>
+  void vector_exp( const T* in, T* out, std::size_t n,
+                   MathAccuracy::MathAccuracy accuracy = MathAccuracy::FULL );
+
+  //! out[i] = log(in[i]), in == out is allowed
+  template <typename T>
+  void vector_log( const T* in, T* out, std::size_t n,
+                   MathAccuracy::MathAccuracy accuracy = MathAccuracy::FULL );
+
+  //! out[i] = pow(base[i],exponent[i]), in-place allowed
+  template <typename T>
+  void vector_pow( const T* base, const T* exponent, T* out, std::size_t n,
+                   MathAccuracy::MathAccuracy accuracy = MathAccuracy::FULL );
+
+  //! out[i] = pow(base[i],exponent), in-place allowed
+  template <typename T>
+  void vector_pow( const T* base, const T& exponent, T* out, std::size_t n,
+                   MathAccuracy::MathAccuracy accuracy = MathAccuracy::FULL );
+
+
+  //! Scalar kernels, inlined in the array loops
+  /*! Generic version, <cmath> */
+  template <typename T>
+  struct VectorMathKernel
+  {
+    template <bool fast>
+    static T exp( const T& x ) { using std::exp; return exp(x); }
+
+    template <bool fast>
+    static T log( const T& x ) { using std::log; return log(x); }
+
+    static const std::size_t pow_chunk = 256;
+
+    template <bool fast>
+    static void pow_array( const T* x, const T* y, T* out, std::size_t n )
+    {
+      using std::pow;
+      for( std::size_t i = 0; i < n; i++ )
+        out[i] = pow(x[i],y[i]);
+    }
+  };
+
+  //! Kernels for double
+  /*!
+   * exp: Cody-Waite reduction x = k ln(2) + r, |r| <= ln(2)/2, Taylor
+   * polynomial of exp(r) and scaling by 2^k in two halves to reach the
+   * subnormals without branches.
+   *
+   * log: reduction x = 2^k (1+f), sqrt(2)/2 <= 1+f < sqrt(2), and the
+   * fdlibm polynomial in s = f/(2+f).
+   *
+   * pow: exp(y log(x)) with log(x) as a double-double, so that the
+   * error on y log(x) is not amplified by the exponential.
+   */
+  template <>
+  struct VectorMathKernel<double>
+  {
+    static uint64_t bits( double x )
+    {
+      uint64_t i;
+      std::memcpy(&i, &x, sizeof(double));
+      return i;
+    }
+
+    static double from_bits( uint64_t i )
+    {
+      double x;
+      std::memcpy(&x, &i, sizeof(double));
+      return x;
+    }
+
+    //! c ? a : b through bit masks
+    /*! Selects of doubles are otherwise turned into branches under
+     *  -ftrapping-math (the default), and the loops are not vectorized. */
+    static double select( bool c, double a, double b )
+    {
+      const uint64_t mask = -static_cast<uint64_t>(c);
+      return from_bits( (bits(a) & mask) | (bits(b) & ~mask) );
+    }
+
+    //! 2^52 + 2^51, adding it rounds to an integer kept in the low bits
+    static double shifter() { return 6755399441055744.0; }
+
+    //! hi + lo = a + b exactly, |a| >= |b|
+    static void fast_two_sum( double a, double b, double& hi, double& lo )
+    {
+      hi = a + b;
+      lo = b - (hi - a);
+    }
+
+    //! hi + lo = a + b exactly
+    static void two_sum( double a, double b, double& hi, double& lo )
+    {
+      hi = a + b;
+      const double bb = hi - a;
+      lo = (a - (hi - bb)) + (b - bb);
+    }
+
+    //! hi + lo = a * b exactly
+    /*! With a hardware fma, Dekker's splitting would be broken by the
+     *  contractions of the compiler (-ffp-contract=fast, GCC default),
+     *  so the fma is used explicitly. */
+    static void two_prod( double a, double b, double& hi, double& lo )
+    {
+#ifdef FP_FAST_FMA
+      hi = a * b;
+      lo = std::fma( a, b, -hi );
+#else
+      const double split = 134217729.0; // 2^27 + 1
+      const double ca = split * a;
+      const double a_hi = ca - (ca - a);
+      const double a_lo = a - a_hi;
+      const double cb = split * b;
+      const double b_hi = cb - (cb - b);
+      const double b_lo = b - b_hi;
+      hi = a * b;
+      lo = ((a_hi * b_hi - hi) + a_hi * b_lo + a_lo * b_hi) + a_lo * b_lo;
+#endif
+    }
+
+    //! exp(x + tail), |tail| small compared to ulp(x)
+    template <bool fast>
+    static double exp_tail( double x, double tail )
+    {
+      const double log2e  = 1.44269504088896338700e+00;
+      const double ln2_hi = 6.93147180369123816490e-01; // trailing zeros, k*ln2_hi exact
+      const double ln2_lo = 1.90821492927058770002e-10;
+
+      // Conditions are combined with & rather than &&, and values chosen
+      // by select(): everything is evaluated, without branches.
+
+      // beyond these, exp overflows or underflows whatever k
+      const bool is_nan = (x != x);
+      double xc = select( x > 709.8, 709.8, x );
+      xc = select( x < -745.2, -745.2, xc );
+      xc = select( is_nan, 0., xc );
+
+      const double t = xc * log2e + shifter();
+      const double kd = t - shifter();
+      const int64_t k = static_cast<int64_t>(bits(t) - bits(shifter()));
+
+      // the tail is meaningless once x is clamped
+      const double r = (xc - kd * ln2_hi) - kd * ln2_lo + select( xc == x, tail, 0. );
+
+      double p;
+      if( fast )
+        p = 1. + r * (1. + r * (1./2 + r * (1./6 + r * (1./24 + r * (1./120 + r * (1./720
+            + r * (1./5040 + r * (1./40320 + r * (1./362880 + r * (1./3628800)))))))))); // r^11/11! < 1e-13
+      else
+        {
+          // 1 + r + r^2/2 + r^2 * (...) keeps the first terms exact enough for 1 ulp
+          const double q = r * r * r * (1./6 + r * (1./24 + r * (1./120 + r * (1./720
+                           + r * (1./5040 + r * (1./40320 + r * (1./362880 + r * (1./3628800
+                           + r * (1./39916800 + r * (1./479001600 + r * (1./6227020800.)))))))))));
+          p = 1. + (r + (0.5 * r * r + q));
+        }
+
+      // 2^k = 2^k1 * 2^k2, both normal for -1076 <= k <= 1025
+      const int64_t k1 = k / 2;
+      const int64_t k2 = k - k1;
+      const double s1 = from_bits( static_cast<uint64_t>(k1 + 1023) << 52 );
+      const double s2 = from_bits( static_cast<uint64_t>(k2 + 1023) << 52 );
+
+      // NaN added to exp(0) = 1
+      return (p * s1) * s2 + select( is_nan, x, 0. );
+    }
+
+    template <bool fast>
+    static double exp( double x )
+    {
+      return exp_tail<fast>(x, 0.);
+    }
+
+    //! Reduction of log: x = 2^k m, sqrt(2)/2 <= m < sqrt(2), f = m - 1
+    static void log_reduce( double x, double& f, double& k )
+    {
+      // subnormals scaled to normal numbers
+      const bool subnormal = (x < 2.2250738585072014e-308);
+      const double xs = x * select( subnormal, 18014398509481984.0, 1. ); // 2^54
+
+      const uint64_t ix = bits(xs);
+      const uint64_t mantissa = ix & 0x000fffffffffffffULL;
+
+      // m >= sqrt(2) is halved
+      const uint64_t high = (mantissa >= 0x0006a09e667f3bcdULL);
+      const double m = from_bits( mantissa | ((1023 - high) << 52) );
+      f = m - 1.;
+
+      // k as a double, without an int64 conversion (none before AVX-512)
+      const uint64_t e = (ix >> 52) + high - 54 * static_cast<uint64_t>(subnormal) - 1023;
+      k = from_bits( bits(shifter()) + e ) - shifter();
+    }
+
+    //! s (hfsq + R) of fdlibm, log(1+f) = f - hfsq + s (hfsq + R)
+    template <bool fast>
+    static double log_poly( double f, double& hfsq, double& s )
+    {
+      const double Lg1 = 6.666666666666735130e-01;
+      const double Lg2 = 3.999999999940941908e-01;
+      const double Lg3 = 2.857142874366239149e-01;
+      const double Lg4 = 2.222219843214978396e-01;
+      const double Lg5 = 1.818357216161805012e-01;
+      const double Lg6 = 1.531383769920937332e-01;
+      const double Lg7 = 1.479819860511658591e-01;
+
+      s = f / (2. + f);
+      const double z = s * s;
+      double R;
+      if( fast )
+        // without Lg7 z^7, about 1e-12 relative
+        R = z * (Lg1 + z * (Lg2 + z * (Lg3 + z * (Lg4 + z * (Lg5 + z * Lg6)))));
+      else
+        {
+          const double w = z * z;
+          const double t1 = w * (Lg2 + w * (Lg4 + w * Lg6));
+          const double t2 = z * (Lg1 + w * (Lg3 + w * (Lg5 + w * Lg7)));
+          R = t2 + t1;
+        }
+      hfsq = 0.5 * f * f;
+      return s * (hfsq + R);
+    }
+
+    template <bool fast>
+    static double log( double x )
+    {
+      const double ln2_hi = 6.93147180369123816490e-01;
+      const double ln2_lo = 1.90821492927058770002e-10;
+      const double inf = std::numeric_limits<double>::infinity();
+
+      // special values are added to log(1) = 0, rather than selected,
+      // so that the regular evaluation is not moved under a branch
+      const bool regular = (x > 0.) & (x < inf);
+      double special = select( x == 0., -inf, std::numeric_limits<double>::quiet_NaN() ); // x < 0 or NaN
+      special = select( x == inf, inf, special );
+      special = select( regular, 0., special );
+
+      double f, k;
+      log_reduce( select( regular, x, 1. ), f, k );
+
+      double hfsq, s;
+      const double sR = log_poly<fast>( f, hfsq, s );
+
+      return ( k * ln2_hi - ((hfsq - (sR + k * ln2_lo)) - f) ) + special;
+    }
+
+    //! log(x) = hi + lo, x > 0 finite
+    static void log_dd( double x, double& hi, double& lo )
+    {
+      const double ln2_hi = 6.93147180369123816490e-01;
+      const double ln2_lo = 1.90821492927058770002e-10;
+
+      double f, k;
+      log_reduce( x, f, k );
+
+      double hfsq, s;
+      const double sR = log_poly<false>( f, hfsq, s );
+
+      // hfsq exactly
+      double hf_hi, hf_lo;
+      two_prod( 0.5 * f, f, hf_hi, hf_lo );
+
+      // k ln2_hi + f - hfsq + sR + k ln2_lo, the first three exactly
+      double a_hi, a_lo;
+      two_sum( k * ln2_hi, f, a_hi, a_lo );
+      double b_hi, b_lo;
+      two_sum( a_hi, -hf_hi, b_hi, b_lo );
+
+      fast_two_sum( b_hi, b_lo + (a_lo - hf_lo + (sR + k * ln2_lo)), hi, lo );
+    }
+
+    //! y log|x| as hi + lo, first pass of pow
+    template <bool fast>
+    static void pow_exponent( double x, double y, double& p_hi, double& p_lo )
+    {
+      using std::fabs;
+      const double inf = std::numeric_limits<double>::infinity();
+      const double ax = fabs(x);
+
+      // log|x| as hi + lo; 0, infinity and NaN are added to log(1) = 0
+      // as in log(), only in hi
+      const bool x_regular = (ax > 0.) & (ax < inf);
+      double special = select( ax == 0., -inf, ax );
+      special = select( x_regular, 0., special );
+      double l_hi, l_lo;
+      if( fast )
+        {
+          l_hi = log<true>( select( x_regular, ax, 1. ) );
+          l_lo = 0.;
+        }
+      else
+        log_dd( select( x_regular, ax, 1. ), l_hi, l_lo );
+      l_hi += special;
+
+      if( fast )
+        {
+          p_hi = y * l_hi;
+          p_lo = 0.;
+        }
+      else
+        {
+          two_prod( y, l_hi, p_hi, p_lo );
+          p_lo += y * l_lo;
+          // the split overflows for huge y, the tail is then meaningless
+          p_lo = select( p_lo - p_lo == 0., p_lo, 0. );
+        }
+    }
+
+    //! pow(x,y) from exp(y log|x|), second pass of pow: sign and special values
+    static double pow_finish( double x, double y, double result_abs )
+    {
+      using std::fabs;
+      const double inf = std::numeric_limits<double>::infinity();
+      const double ax = fabs(x);
+      const double ay = fabs(y);
+
+      // y integer, y odd (y/2 not integer); with floating point tests
+      // only, bit tests are not vectorized
+      const double two52 = 4503599627370496.0;
+      const double t = ay + select( ay < two52, two52, 0. );
+      const bool y_integer = (ay >= two52) | (t - two52 == ay);
+      const double half = 0.5 * ay;
+      const double t_half = half + select( half < two52, two52, 0. );
+      const bool y_odd = y_integer & (half < two52) & (t_half - two52 != half);
+
+      // negative x: odd y changes the sign, non-integer y gives NaN except for 0 and infinity
+      const bool x_negative = (bits(x) >= 0x8000000000000000ULL) & (x == x);
+      double result = select( x_negative & y_odd, -result_abs, result_abs );
+      const bool invalid = x_negative & !y_integer & (ax != 0.) & (ax != inf);
+      result = select( invalid, std::numeric_limits<double>::quiet_NaN(), result );
+
+      const bool one = (y == 0.) | (x == 1.) | ((ax == 1.) & (ay == inf));
+      return select( one, 1., result );
+    }
+
+    //! Number of arguments of pow evaluated pass by pass
+    static const std::size_t pow_chunk = 256;
+
+    //! out[i] = pow(x[i],y[i]), n <= pow_chunk
+    /*! In two passes: the whole kernel is too large to be inlined, and
+     *  then vectorized, by the compiler. */
+    template <bool fast>
+    static void pow_array( const double* x, const double* y, double* out, std::size_t n )
+    {
+      double p_hi[pow_chunk];
+      double p_lo[pow_chunk];
+
+      for( std::size_t i = 0; i < n; i++ )
+        pow_exponent<fast>( x[i], y[i], p_hi[i], p_lo[i] );
+
+      for( std::size_t i = 0; i < n; i++ )
+        out[i] = pow_finish( x[i], y[i], exp_tail<fast>( p_hi[i], p_lo[i] ) );
+    }
+  };
+
+  //! float is evaluated through the double kernels
+  template <>
+  struct VectorMathKernel<float>
+  {
+    template <bool fast>
+    static float exp( float x )
+    { return static_cast<float>( VectorMathKernel<double>::exp<fast>(x) ); }
+
+    template <bool fast>
+    static float log( float x )
+    { return static_cast<float>( VectorMathKernel<double>::log<fast>(x) ); }
+
+    static const std::size_t pow_chunk = VectorMathKernel<double>::pow_chunk;
+
+    template <bool fast>
+    static void pow_array( const float* x, const float* y, float* out, std::size_t n )
+    {
+      double xd[pow_chunk];
+      double yd[pow_chunk];
+      for( std::size_t i = 0; i < n; i++ )
+        {
+          xd[i] = x[i];
+          yd[i] = y[i];
+        }
+
+      VectorMathKernel<double>::pow_array<fast>( xd, yd, xd, n );
+
+      for( std::size_t i = 0; i < n; i++ )
+        out[i] = static_cast<float>(xd[i]);
+    }
+  };
+
+  /* ------------------------- Inline Functions -------------------------*/
+  template <typename T>
+  inline
+  void vector_exp( const T* in, T* out, std::size_t n, MathAccuracy::MathAccuracy accuracy )
+  {
+    switch( accuracy )
+      {
+      case(MathAccuracy::FAST):
+        for( std::size_t i = 0; i < n; i++ )
+          out[i] = VectorMathKernel<T>::template exp<true>(in[i]);
+        break;
+      case(MathAccuracy::FULL):
+        for( std::size_t i = 0; i < n; i++ )
+          out[i] = VectorMathKernel<T>::template exp<false>(in[i]);
+        break;
+      default:
+        {
+          using std::exp;
+          for( std::size_t i = 0; i < n; i++ )
+            out[i] = exp(in[i]);
+        }
+      }
+  }
+
+  template <typename T>
+  inline
+  void vector_log( const T* in, T* out, std::size_t n, MathAccuracy::MathAccuracy accuracy )
+  {
+    switch( accuracy )
+      {
+      case(MathAccuracy::FAST):
+        for( std::size_t i = 0; i < n; i++ )
+          out[i] = VectorMathKernel<T>::template log<true>(in[i]);
+        break;
+      case(MathAccuracy::FULL):
+        for( std::size_t i = 0; i < n; i++ )
+          out[i] = VectorMathKernel<T>::template log<false>(in[i]);
+        break;
+      default:
+        {
+          using std::log;
+          for( std::size_t i = 0; i < n; i++ )
+            out[i] = log(in[i]);
+        }
+      }
+  }
+
+  template <typename T>
+  inline
+  void vector_pow( const T* base, const T* exponent, T* out, std::size_t n,
+                   MathAccuracy::MathAccuracy accuracy )
+  {
+    if( accuracy == MathAccuracy::LIBM )
+      {
+        using std::pow;
+        for( std::size_t i = 0; i < n; i++ )
+          out[i] = pow(base[i],exponent[i]);
+        return;
+      }
+
+    const std::size_t chunk = VectorMathKernel<T>::pow_chunk;
+    for( std::size_t first = 0; first < n; first += chunk )
+      {
+        const std::size_t m = std::min( chunk, n - first );
+        if( accuracy == MathAccuracy::FAST )
+          VectorMathKernel<T>::template pow_array<true>( base + first, exponent + first, out + first, m );
+        else
+          VectorMathKernel<T>::template pow_array<false>( base + first, exponent + first, out + first, m );
+      }
+  }
+
+  template <typename T>
+  inline
+  void vector_pow( const T* base, const T& exponent, T* out, std::size_t n,
+                   MathAccuracy::MathAccuracy accuracy )
+  {
+    // copied, out may alias exponent
+    const T y = exponent;
+
+    if( accuracy == MathAccuracy::LIBM )
+      {
+        using std::pow;
+        for( std::size_t i = 0; i < n; i++ )
+          out[i] = pow(base[i],y);
+        return;
+      }
+
+    const std::size_t chunk = VectorMathKernel<T>::pow_chunk;
+    T exponents[VectorMathKernel<T>::pow_chunk];
+    for( std::size_t i = 0; i < std::min( chunk, n ); i++ )
+      exponents[i] = y;
+
+    for( std::size_t first = 0; first < n; first += chunk )
+      {
+        const std::size_t m = std::min( chunk, n - first );
+        if( accuracy == MathAccuracy::FAST )
+          VectorMathKernel<T>::template pow_array<true>( base + first, exponents, out + first, m );
+        else
+          VectorMathKernel<T>::template pow_array<false>( base + first, exponents, out + first, m );
+      }
+  }
+
+} // end namespace Antioch
+
+#endif // ANTIOCH_VECTOR_MATH_H